@@ -29,8 +29,14 @@ workspace "stratos"
 	filter { "platforms:x64" }
 		architecture "x86_64"
 		
+	-- SIMD math is tested bit for bit against scalar code, so the scalar
+	-- code must not be fused into multiply-adds. MSVC only fuses with /fp:contract.
+	filter { "toolset:not msc*" }
+		buildoptions { "-ffp-contract=off" }
+		
 	filter {}
 	
 include("src/3rdparty/premake5.lua")
 include("src/engine/premake5.lua")
+include("src/bench/premake5.lua")
 include("data/premake5.lua")
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Headless microbenchmarks for the core math, animation, intersection and job
+** system code.
+**
+** Record a baseline on a quiet machine with a Release build:
+**   stratos-bench -out baseline.json
+** then check later builds against it on the same machine:
+**   stratos-bench -baseline baseline.json
+** which exits with 1 if any benchmark regressed. Baselines only mean anything
+** against builds with the same configuration on the same hardware.
+**
+** Times are per item, such as a matrix or a joint, and throughput is printed
+** alongside in millions of items per second.
+*/
+
+#include "st_bench.h"
+#include "st_bench_animation.h"
+#include "st_bench_jobs.h"
+#include "st_bench_math.h"
+#include "st_bench_physics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void print_usage()
+{
+	printf(
+		"usage: stratos-bench [options]\n"
+		"  -list               List benchmarks and exit.\n"
+		"  -filter <text>      Run only benchmarks whose name contains text.\n"
+		"  -out <path>         Write results as JSON.\n"
+		"  -baseline <path>    Compare against results from an earlier -out.\n"
+		"  -threshold <frac>   Slowdown reported as a regression. Default 0.1.\n"
+		"  -sample-ms <ms>     Minimum duration of each sample. Default 20.\n"
+		"  -samples <count>    Samples per benchmark. Default 9.\n");
+}
+
+int main(int argc, const char** argv)
+{
+	st_bench_options_t options;
+	const char* filter = nullptr;
+	const char* out_path = nullptr;
+	const char* baseline_path = nullptr;
+	bool list = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "-list") == 0)
+		{
+			list = true;
+		}
+		else if (strcmp(argv[i], "-filter") == 0 && has_value)
+		{
+			filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "-out") == 0 && has_value)
+		{
+			out_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-baseline") == 0 && has_value)
+		{
+			baseline_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-threshold") == 0 && has_value)
+		{
+			options._threshold = float(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-sample-ms") == 0 && has_value)
+		{
+			options._sample_time = std::chrono::milliseconds(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-samples") == 0 && has_value)
+		{
+			options._sample_count = atoi(argv[++i]);
+		}
+		else
+		{
+			print_usage();
+			return 2;
+		}
+	}
+
+	if (options._sample_count < 1 || options._sample_time.count() < 1 || options._threshold <= 0.0f)
+	{
+		print_usage();
+		return 2;
+	}
+
+	st_bench_registry registry;
+	st_bench_register_math(registry);
+	st_bench_register_animation(registry);
+	st_bench_register_physics(registry);
+	st_bench_register_jobs(registry);
+
+	if (list)
+	{
+		for (const st_bench_decl_t& decl : registry.get_decls())
+		{
+			printf("%s\n", decl._name.c_str());
+		}
+		return 0;
+	}
+
+	st_bench_environment_t baseline_environment;
+	std::vector<st_bench_result_t> baseline;
+	if (baseline_path && !st_bench_read_json(baseline_path, baseline_environment, baseline))
+	{
+		printf("error: could not read baseline %s\n", baseline_path);
+		return 2;
+	}
+
+	st_bench_environment_t environment = st_bench_get_environment();
+	printf("config %s, simd %s, fibers %s, %d cpus\n",
+		environment._config.c_str(),
+		environment._simd.c_str(),
+		environment._fiber_backend.c_str(),
+		environment._cpu_count);
+#if defined(_DEBUG)
+	printf("warning: timing a debug build\n");
+#endif
+
+	std::vector<st_bench_result_t> results;
+	for (const st_bench_decl_t& decl : registry.get_decls())
+	{
+		if (filter && decl._name.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		st_bench_result_t result = st_bench_run(decl, options);
+		printf("%-48s %12.3f ns (min %.3f) %10.2f M/s\n", result._name.c_str(), result._median_ns, result._min_ns, 1e3 / result._median_ns);
+		fflush(stdout);
+		results.push_back(result);
+	}
+	st_bench_shutdown_jobs();
+
+	if (out_path && !st_bench_write_json(out_path, environment, results))
+	{
+		printf("error: could not write %s\n", out_path);
+		return 2;
+	}
+
+	if (baseline_path)
+	{
+		int regression_count = st_bench_compare(baseline_environment, baseline, environment, results, options._threshold);
+		printf("\n%d regression%s\n", regression_count, regression_count == 1 ? "" : "s");
+		return regression_count > 0 ? 1 : 0;
+	}
+
+	return 0;
+}
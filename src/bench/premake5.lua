@@ -0,0 +1,61 @@
+project "stratos-bench"
+	language "C++"
+	cppdialect "C++17"
+	kind "ConsoleApp"
+
+	flags { "MultiProcessorCompile" }
+	
+	defines {
+		"_CRT_SECURE_NO_WARNINGS",
+	}
+	
+	files {
+		"**.h",
+		"**.cpp",
+		
+		"../engine/core/**.h",
+		"../engine/framework/st_compiler_defines.h",
+		"../engine/framework/st_frame_params.h",
+		"../engine/graphics/animation/st_animation.h",
+		"../engine/graphics/animation/st_animation.cpp",
+		"../engine/graphics/geometry/st_debug_geometry.h",
+		"../engine/graphics/geometry/st_debug_geometry.cpp",
+		"../engine/jobs/**.h",
+		"../engine/jobs/**.cpp",
+		"../engine/math/**.h",
+		"../engine/math/**.cpp",
+		"../engine/physics/st_aabb_tree.h",
+		"../engine/physics/st_aabb_tree.cpp",
+		"../engine/physics/st_broadphase.h",
+		"../engine/physics/st_broadphase.cpp",
+		"../engine/physics/st_contact_manifold.h",
+		"../engine/physics/st_contact_manifold.cpp",
+		"../engine/physics/st_contact_solver.h",
+		"../engine/physics/st_contact_solver.cpp",
+		"../engine/physics/st_gjk.h",
+		"../engine/physics/st_gjk.cpp",
+		"../engine/physics/st_intersection.h",
+		"../engine/physics/st_intersection.cpp",
+		"../engine/physics/st_physics_world.h",
+		"../engine/physics/st_physics_world.cpp",
+		"../engine/physics/st_rigid_body.h",
+		"../engine/physics/st_rigid_body.cpp",
+		"../engine/physics/st_shape.h",
+		"../engine/physics/st_shape.cpp",
+		"../engine/system/st_cpu_topology.h",
+		"../engine/system/st_cpu_topology.cpp",
+	}
+	
+	-- Unit tests belong to the engine and have no entry point here.
+	removefiles {
+		"../engine/**.tests.h",
+		"../engine/**.tests.cpp",
+	}
+	
+	includedirs {
+		"../engine",
+	}
+	
+	buildoptions {
+		"/W2 /WX",
+	}
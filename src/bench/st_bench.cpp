@@ -0,0 +1,236 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_bench.h"
+
+#include <jobs/st_fiber.h>
+#include <math/st_simd.h>
+#include <system/st_cpu_topology.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#if defined(ST_MSVC)
+const void* volatile g_st_bench_sink = nullptr;
+#endif
+
+/*
+** Calibration stops growing the iteration count here, so that a benchmark
+** timing nothing at all cannot loop forever.
+*/
+static const int64_t k_st_bench_max_iterations = int64_t(1) << 40;
+
+void st_bench_registry::add(const char* name, st_bench_function_t function, int arg, float tolerance)
+{
+	/* Names are written into the JSON unescaped. */
+	assert(strchr(name, '"') == nullptr && strchr(name, '\\') == nullptr);
+
+	st_bench_decl_t decl;
+	decl._name = name;
+	decl._function = function;
+	decl._arg = arg;
+	decl._tolerance = tolerance;
+	_decls.push_back(decl);
+}
+
+static std::chrono::nanoseconds _st_bench_sample(const st_bench_decl_t& decl, int64_t iterations, int64_t* item_count)
+{
+	st_bench_state state(iterations, decl._arg);
+	decl._function(state);
+	*item_count = iterations * state.get_items_per_iteration();
+	return state.get_elapsed();
+}
+
+st_bench_result_t st_bench_run(const st_bench_decl_t& decl, const st_bench_options_t& options)
+{
+	const double target_ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(options._sample_time).count());
+
+	/* Grow the iteration count until a single sample lasts the sample time. */
+	int64_t iterations = 1;
+	int64_t item_count = 0;
+	while (iterations < k_st_bench_max_iterations)
+	{
+		double elapsed_ns = double(_st_bench_sample(decl, iterations, &item_count).count());
+		if (elapsed_ns >= target_ns)
+		{
+			break;
+		}
+
+		/* Aim a little past the target so the next attempt usually makes it. */
+		double scale = elapsed_ns > 0.0 ? 1.2 * target_ns / elapsed_ns : 100.0;
+		scale = std::min(std::max(scale, 2.0), 100.0);
+		iterations = std::min(int64_t(double(iterations) * scale), k_st_bench_max_iterations);
+	}
+
+	std::vector<double> samples;
+	for (int i = 0; i < options._sample_count; ++i)
+	{
+		double elapsed_ns = double(_st_bench_sample(decl, iterations, &item_count).count());
+		samples.push_back(elapsed_ns / double(std::max<int64_t>(item_count, 1)));
+	}
+	std::sort(samples.begin(), samples.end());
+
+	st_bench_result_t result;
+	result._name = decl._name;
+	result._median_ns = samples[samples.size() / 2];
+	result._min_ns = samples[0];
+	result._iterations = iterations;
+	result._sample_count = int(samples.size());
+	result._tolerance = decl._tolerance;
+	return result;
+}
+
+st_bench_environment_t st_bench_get_environment()
+{
+	st_bench_environment_t environment;
+
+#if defined(_DEBUG)
+	environment._config = "debug";
+#elif defined(_DEVELOPMENT)
+	environment._config = "development";
+#elif defined(_PROFILE)
+	environment._config = "profile";
+#elif defined(_RELEASE)
+	environment._config = "release";
+#else
+	environment._config = "unknown";
+#endif
+
+	environment._simd = st_simd_get_name();
+	environment._fiber_backend = st_fiber::get_backend_name();
+	environment._cpu_count = st_cpu_topology::get().get_cpu_count();
+
+	return environment;
+}
+
+bool st_bench_write_json(const char* path, const st_bench_environment_t& environment, const std::vector<st_bench_result_t>& results)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		return false;
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "\"environment\": {\"config\": \"%s\", \"simd\": \"%s\", \"fiber_backend\": \"%s\", \"cpu_count\": %d},\n",
+		environment._config.c_str(),
+		environment._simd.c_str(),
+		environment._fiber_backend.c_str(),
+		environment._cpu_count);
+	fprintf(file, "\"results\": [\n");
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const st_bench_result_t& result = results[i];
+		fprintf(file, "{\"name\": \"%s\", \"median_ns\": %.4f, \"min_ns\": %.4f, \"iterations\": %lld, \"samples\": %d}%s\n",
+			result._name.c_str(),
+			result._median_ns,
+			result._min_ns,
+			(long long)result._iterations,
+			result._sample_count,
+			i + 1 < results.size() ? "," : "");
+	}
+	fprintf(file, "]\n}\n");
+
+	fclose(file);
+	return true;
+}
+
+bool st_bench_read_json(const char* path, st_bench_environment_t& environment, std::vector<st_bench_result_t>& results)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool found_environment = false;
+	char line[1024];
+	while (fgets(line, sizeof(line), file))
+	{
+		char config[64];
+		char simd[64];
+		char fiber_backend[64];
+		int cpu_count;
+		if (sscanf(line, "\"environment\": {\"config\": \"%63[^\"]\", \"simd\": \"%63[^\"]\", \"fiber_backend\": \"%63[^\"]\", \"cpu_count\": %d",
+			config, simd, fiber_backend, &cpu_count) == 4)
+		{
+			environment._config = config;
+			environment._simd = simd;
+			environment._fiber_backend = fiber_backend;
+			environment._cpu_count = cpu_count;
+			found_environment = true;
+			continue;
+		}
+
+		char name[256];
+		st_bench_result_t result;
+		long long iterations;
+		if (sscanf(line, "{\"name\": \"%255[^\"]\", \"median_ns\": %lf, \"min_ns\": %lf, \"iterations\": %lld, \"samples\": %d",
+			name, &result._median_ns, &result._min_ns, &iterations, &result._sample_count) == 5)
+		{
+			result._name = name;
+			result._iterations = iterations;
+			results.push_back(result);
+		}
+	}
+
+	fclose(file);
+	return found_environment;
+}
+
+static void _st_bench_compare_environment(const char* what, const std::string& baseline, const std::string& current)
+{
+	if (baseline != current)
+	{
+		printf("warning: baseline %s is %s, this run is %s\n", what, baseline.c_str(), current.c_str());
+	}
+}
+
+int st_bench_compare(
+	const st_bench_environment_t& baseline_environment,
+	const std::vector<st_bench_result_t>& baseline,
+	const st_bench_environment_t& environment,
+	const std::vector<st_bench_result_t>& results,
+	float threshold)
+{
+	_st_bench_compare_environment("config", baseline_environment._config, environment._config);
+	_st_bench_compare_environment("simd", baseline_environment._simd, environment._simd);
+	_st_bench_compare_environment("fiber backend", baseline_environment._fiber_backend, environment._fiber_backend);
+	_st_bench_compare_environment("cpu count", std::to_string(baseline_environment._cpu_count), std::to_string(environment._cpu_count));
+
+	printf("\n%-48s %12s %12s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+
+	int regression_count = 0;
+	for (const st_bench_result_t& result : results)
+	{
+		auto it = std::find_if(baseline.begin(), baseline.end(), [&result](const st_bench_result_t& b) { return b._name == result._name; });
+		if (it == baseline.end())
+		{
+			printf("%-48s %12s %12.3f %9s\n", result._name.c_str(), "-", result._median_ns, "new");
+			continue;
+		}
+
+		float tolerance = result._tolerance > 0.0f ? result._tolerance : threshold;
+		double change = result._median_ns / it->_median_ns - 1.0;
+
+		const char* verdict = "";
+		if (change > tolerance)
+		{
+			verdict = "  REGRESSED";
+			regression_count++;
+		}
+		else if (change < -tolerance)
+		{
+			verdict = "  improved";
+		}
+
+		printf("%-48s %12.3f %12.3f %+8.1f%%%s\n", result._name.c_str(), it->_median_ns, result._median_ns, change * 100.0, verdict);
+	}
+
+	return regression_count;
+}
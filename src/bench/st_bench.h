@@ -0,0 +1,190 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <framework/st_compiler_defines.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(ST_MSVC)
+#include <intrin.h>
+#endif
+
+/*
+** Timing loop handed to each benchmark.
+**
+** A benchmark does its setup, then performs get_iterations() repetitions of
+** the operation under test between start() and stop(). The harness picks the
+** iteration count so that each sample runs long enough to time reliably.
+*/
+class st_bench_state
+{
+public:
+	st_bench_state(int64_t iterations, int arg) : _iterations(iterations), _arg(arg) {}
+
+	int64_t get_iterations() const { return _iterations; }
+
+	/*
+	** The argument the benchmark was registered with, e.g. a thread count.
+	*/
+	int get_arg() const { return _arg; }
+
+	/*
+	** Number of operations each iteration performs, when it is more than one.
+	** Results are reported per operation.
+	*/
+	void set_items_per_iteration(int64_t count) { _items_per_iteration = count; }
+	int64_t get_items_per_iteration() const { return _items_per_iteration; }
+
+	void start() { _start = std::chrono::steady_clock::now(); }
+	void stop() { _elapsed += std::chrono::steady_clock::now() - _start; }
+
+	std::chrono::nanoseconds get_elapsed() const { return _elapsed; }
+
+private:
+	int64_t _iterations;
+	int64_t _items_per_iteration = 1;
+	int _arg;
+
+	std::chrono::steady_clock::time_point _start;
+	std::chrono::nanoseconds _elapsed = std::chrono::nanoseconds::zero();
+};
+
+typedef void(*st_bench_function_t)(st_bench_state& state);
+
+/*
+** A registered benchmark.
+**
+** Tolerance overrides the regression threshold for benchmarks that are
+** noisier than the rest, such as those that contend across threads.
+*/
+struct st_bench_decl_t
+{
+	std::string _name;
+	st_bench_function_t _function;
+	int _arg = 0;
+	float _tolerance = 0.0f;
+};
+
+struct st_bench_result_t
+{
+	std::string _name;
+
+	// Time per operation across samples, in nanoseconds.
+	double _median_ns = 0.0;
+	double _min_ns = 0.0;
+
+	int64_t _iterations = 0;
+	int _sample_count = 0;
+
+	float _tolerance = 0.0f;
+};
+
+/*
+** Describes the build and machine the results were gathered on.
+** Comparisons against a baseline from a different build are flagged.
+*/
+struct st_bench_environment_t
+{
+	std::string _config;
+	std::string _simd;
+	std::string _fiber_backend;
+	int _cpu_count = 0;
+};
+
+struct st_bench_options_t
+{
+	// Minimum duration of each timed sample.
+	std::chrono::milliseconds _sample_time{ 20 };
+	int _sample_count = 9;
+
+	// Default fractional slowdown reported as a regression.
+	float _threshold = 0.1f;
+};
+
+/*
+** The set of benchmarks the executable knows about.
+*/
+class st_bench_registry
+{
+public:
+	void add(const char* name, st_bench_function_t function, int arg = 0, float tolerance = 0.0f);
+
+	const std::vector<st_bench_decl_t>& get_decls() const { return _decls; }
+
+private:
+	std::vector<st_bench_decl_t> _decls;
+};
+
+/*
+** Calibrate and time a single benchmark.
+*/
+st_bench_result_t st_bench_run(const st_bench_decl_t& decl, const st_bench_options_t& options);
+
+st_bench_environment_t st_bench_get_environment();
+
+/*
+** Write results as JSON, one result per line.
+*/
+bool st_bench_write_json(const char* path, const st_bench_environment_t& environment, const std::vector<st_bench_result_t>& results);
+
+/*
+** Read results written by st_bench_write_json. Not a general JSON parser.
+*/
+bool st_bench_read_json(const char* path, st_bench_environment_t& environment, std::vector<st_bench_result_t>& results);
+
+/*
+** Print each result next to its baseline and return the number that are
+** slower by more than their tolerance, or the threshold if they have none.
+*/
+int st_bench_compare(
+	const st_bench_environment_t& baseline_environment,
+	const std::vector<st_bench_result_t>& baseline,
+	const st_bench_environment_t& environment,
+	const std::vector<st_bench_result_t>& results,
+	float threshold);
+
+/*
+** Deterministic pseudo-random numbers, so every run times the same inputs.
+*/
+class st_bench_random
+{
+public:
+	explicit st_bench_random(uint32_t seed) : _state(seed) {}
+
+	float next(float low, float high)
+	{
+		_state = _state * 1664525u + 1013904223u;
+		return low + (high - low) * (float(_state >> 8) / float(1 << 24));
+	}
+
+private:
+	uint32_t _state;
+};
+
+#if defined(ST_MSVC)
+extern const void* volatile g_st_bench_sink;
+#endif
+
+/*
+** Keep the compiler from discarding a value or the work that produced it, and
+** from assuming it knows the value afterwards, so loop invariant work is
+** redone each iteration.
+*/
+template<typename T>
+inline void st_bench_keep(const T& value)
+{
+#if defined(ST_MSVC)
+	g_st_bench_sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
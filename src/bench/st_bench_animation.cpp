@@ -0,0 +1,236 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_bench_animation.h"
+#include "st_bench.h"
+
+#include <graphics/animation/st_animation.h>
+
+#include <math/st_affine3f.h>
+#include <math/st_math.h>
+#include <math/st_qts.h>
+#include <math/st_quatf.h>
+
+#include <cstdio>
+#include <vector>
+
+/*
+** A crowd of full size skeletons, each with its own transforms, playing one
+** of a handful of clips at its own phase. Results are reported per joint.
+*/
+static const int k_st_bench_animation_character_count = 1000;
+static const int k_st_bench_animation_joint_count = st_skeleton::k_max_skeleton_joints;
+static const int k_st_bench_animation_clip_count = 16;
+
+struct st_bench_animation_data_t
+{
+	std::vector<st_skeleton> _skeletons;
+	std::vector<st_skeleton_pose> _blended;
+	std::vector<float> _phases;
+
+	/* Two keyframes per clip, in both layouts. */
+	std::vector<st_skeleton_pose> _keys;
+	std::vector<std::vector<st_qts>> _keys_aos;
+};
+
+static st_qts _st_bench_animation_random_qts(st_bench_random& random)
+{
+	st_vec3f axis = { random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f) };
+	axis.normalize();
+
+	st_qts result;
+	result.rotation.make_axis_angle(axis, random.next(-st_PI, st_PI));
+	result.translation = { random.next(-0.5f, 0.5f), random.next(-0.5f, 0.5f), random.next(-0.5f, 0.5f) };
+	result.scale = random.next(0.9f, 1.1f);
+	return result;
+}
+
+static st_bench_animation_data_t& _st_bench_animation_get_data()
+{
+	static st_bench_animation_data_t* data = nullptr;
+	if (data)
+	{
+		return *data;
+	}
+
+	data = new st_bench_animation_data_t;
+	st_bench_random random(0xa91a7105);
+
+	/* A bushy hierarchy: each joint hangs off one of the few joints added before it. */
+	st_skeleton skeleton;
+	char name[32];
+	for (int j = 0; j < k_st_bench_animation_joint_count; ++j)
+	{
+		uint32_t parent = INT_MAX;
+		if (j > 0)
+		{
+			int first = j > 4 ? j - 4 : 0;
+			parent = uint32_t(first + int(random.next(0.0f, float(j - first) - 0.01f)));
+		}
+		snprintf(name, sizeof(name), "joint_%d", j);
+		skeleton.add_joint(name, parent);
+	}
+
+	st_skeleton_pose bind_pose;
+	bind_pose.resize(k_st_bench_animation_joint_count);
+	for (int j = 0; j < k_st_bench_animation_joint_count; ++j)
+	{
+		bind_pose.set(j, _st_bench_animation_random_qts(random));
+	}
+	st_skeleton_apply_pose(&skeleton, bind_pose);
+	for (int j = 0; j < k_st_bench_animation_joint_count; ++j)
+	{
+		skeleton._inv_bind[j] = skeleton._world[j].inverse();
+	}
+
+	data->_skeletons.assign(k_st_bench_animation_character_count, skeleton);
+	data->_blended.assign(k_st_bench_animation_character_count, bind_pose);
+	for (int c = 0; c < k_st_bench_animation_character_count; ++c)
+	{
+		data->_phases.push_back(random.next(0.0f, 1.0f));
+	}
+
+	for (int k = 0; k < 2 * k_st_bench_animation_clip_count; ++k)
+	{
+		st_skeleton_pose key;
+		key.resize(k_st_bench_animation_joint_count);
+		std::vector<st_qts> key_aos;
+		for (int j = 0; j < k_st_bench_animation_joint_count; ++j)
+		{
+			st_qts transform = _st_bench_animation_random_qts(random);
+			key.set(j, transform);
+			key_aos.push_back(transform);
+		}
+		data->_keys.push_back(key);
+		data->_keys_aos.push_back(key_aos);
+	}
+
+	return *data;
+}
+
+template<e_st_pose_blend k_mode>
+static void _st_bench_animation_blend(st_bench_state& state)
+{
+	st_bench_animation_data_t& d = _st_bench_animation_get_data();
+	const int character_count = state.get_arg();
+
+	state.set_items_per_iteration(int64_t(character_count) * k_st_bench_animation_joint_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		for (int c = 0; c < character_count; ++c)
+		{
+			int clip = c % k_st_bench_animation_clip_count;
+			st_skeleton_pose_blend(d._keys[2 * clip], d._keys[2 * clip + 1], d._phases[c], k_mode, d._blended[c]);
+		}
+		st_bench_keep(d._blended[0]._rotations.get_x()[0]);
+	}
+	state.stop();
+}
+
+static void _st_bench_animation_apply_pose(st_bench_state& state)
+{
+	st_bench_animation_data_t& d = _st_bench_animation_get_data();
+	const int character_count = state.get_arg();
+
+	state.set_items_per_iteration(int64_t(character_count) * k_st_bench_animation_joint_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		for (int c = 0; c < character_count; ++c)
+		{
+			st_skeleton_apply_pose(&d._skeletons[c], d._blended[c]);
+		}
+		st_bench_keep(d._skeletons[0]._skin[0]);
+	}
+	state.stop();
+}
+
+/*
+** The per frame work of st_animation_component: blend two keyframes, then
+** build world transforms and the skinning palette.
+*/
+static void _st_bench_animation_update(st_bench_state& state)
+{
+	st_bench_animation_data_t& d = _st_bench_animation_get_data();
+	const int character_count = state.get_arg();
+
+	state.set_items_per_iteration(int64_t(character_count) * k_st_bench_animation_joint_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		for (int c = 0; c < character_count; ++c)
+		{
+			int clip = c % k_st_bench_animation_clip_count;
+			st_skeleton_pose_blend(d._keys[2 * clip], d._keys[2 * clip + 1], d._phases[c], st_pose_blend_nlerp, d._blended[c]);
+			st_skeleton_apply_pose(&d._skeletons[c], d._blended[c]);
+		}
+		st_bench_keep(d._skeletons[0]._skin[0]);
+	}
+	state.stop();
+}
+
+/*
+** The same work one joint at a time on st_qts, for comparison.
+*/
+static void _st_bench_animation_update_aos(st_bench_state& state)
+{
+	st_bench_animation_data_t& d = _st_bench_animation_get_data();
+	const int character_count = state.get_arg();
+
+	state.set_items_per_iteration(int64_t(character_count) * k_st_bench_animation_joint_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		for (int c = 0; c < character_count; ++c)
+		{
+			int clip = c % k_st_bench_animation_clip_count;
+			const std::vector<st_qts>& a = d._keys_aos[2 * clip];
+			const std::vector<st_qts>& b = d._keys_aos[2 * clip + 1];
+			float t = d._phases[c];
+			st_skeleton& skeleton = d._skeletons[c];
+
+			for (int j = 0; j < k_st_bench_animation_joint_count; ++j)
+			{
+				st_qts local;
+				local.rotation = st_quatf_nlerp(a[j].rotation, b[j].rotation, t);
+				local.translation = a[j].translation.scale_result(1.0f - t) + b[j].translation.scale_result(t);
+				local.scale = a[j].scale * (1.0f - t) + b[j].scale * t;
+
+				skeleton._world[j] = local.to_affine();
+				uint32_t parent = skeleton._joints[j]._parent;
+				if (parent < INT_MAX)
+				{
+					skeleton._world[j] *= skeleton._world[parent];
+				}
+				skeleton._skin[j] = skeleton._inv_bind[j] * skeleton._world[j];
+			}
+		}
+		st_bench_keep(d._skeletons[0]._skin[0]);
+	}
+	state.stop();
+}
+
+void st_bench_register_animation(st_bench_registry& registry)
+{
+	char name[64];
+	const int count = k_st_bench_animation_character_count;
+
+	snprintf(name, sizeof(name), "animation/update/characters:%d", count);
+	registry.add(name, _st_bench_animation_update, count);
+
+	snprintf(name, sizeof(name), "animation/update_aos/characters:%d", count);
+	registry.add(name, _st_bench_animation_update_aos, count);
+
+	snprintf(name, sizeof(name), "animation/blend_nlerp/characters:%d", count);
+	registry.add(name, _st_bench_animation_blend<st_pose_blend_nlerp>, count);
+
+	snprintf(name, sizeof(name), "animation/blend_slerp/characters:%d", count);
+	registry.add(name, _st_bench_animation_blend<st_pose_blend_slerp>, count);
+
+	snprintf(name, sizeof(name), "animation/apply_pose/characters:%d", count);
+	registry.add(name, _st_bench_animation_apply_pose, count);
+}
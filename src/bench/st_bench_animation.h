@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+class st_bench_registry;
+
+/*
+** Skeletal animation benchmarks: pose blending and skinning palettes.
+*/
+void st_bench_register_animation(st_bench_registry& registry);
@@ -0,0 +1,304 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_bench_jobs.h"
+#include "st_bench.h"
+
+#include <jobs/st_fiber.h>
+#include <jobs/st_intpool.h>
+#include <jobs/st_job.h>
+#include <jobs/st_queue.h>
+#include <jobs/st_ring_queue.h>
+#include <jobs/st_trace.h>
+
+#include <system/st_cpu_topology.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/*
+** Contended benchmarks run at each of these thread counts, oversubscribing
+** the machine at the top end on purpose.
+*/
+static const int k_st_bench_jobs_thread_counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+/*
+** Timings that depend on the OS scheduler vary far more between runs than
+** single threaded ones.
+*/
+static const float k_st_bench_jobs_contended_tolerance = 0.5f;
+
+static const int k_st_bench_jobs_batch_size = 256;
+static const int k_st_bench_jobs_parallel_for_count = 1 << 16;
+
+/*
+** Runs body(iterations) on get_arg() threads at once, the calling thread
+** among them, and times from release until the last one finishes.
+** Results are reported per operation across all threads.
+*/
+template<typename F>
+static void _st_bench_jobs_contend(st_bench_state& state, const F& body)
+{
+	const int thread_count = state.get_arg();
+	const int64_t iterations = state.get_iterations();
+
+	std::atomic<int> ready_count{ 0 };
+	std::atomic<bool> go{ false };
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < thread_count; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			ready_count.fetch_add(1);
+			while (!go.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			body(iterations);
+		});
+	}
+	while (ready_count.load() < thread_count - 1)
+	{
+		std::this_thread::yield();
+	}
+
+	state.set_items_per_iteration(thread_count);
+	state.start();
+	go.store(true, std::memory_order_release);
+	body(iterations);
+	for (std::thread& t : threads)
+	{
+		t.join();
+	}
+	state.stop();
+}
+
+/*
+** Queues and the integer pool. Each thread holds at most one entry, so pops
+** always find one eventually. A ring queue push can still fail while a
+** preempted consumer holds the slot it wants, so it is retried.
+*/
+static void _st_bench_queue(st_bench_state& state)
+{
+	st_queue queue(1024);
+	_st_bench_jobs_contend(state, [&queue](int64_t iterations)
+	{
+		int value = 0;
+		for (int64_t i = 0; i < iterations; ++i)
+		{
+			queue.push(&value);
+			void* data;
+			while (!queue.pop(&data))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+}
+
+static void _st_bench_ring_queue(st_bench_state& state)
+{
+	st_ring_queue queue(1024);
+	_st_bench_jobs_contend(state, [&queue](int64_t iterations)
+	{
+		int value = 0;
+		for (int64_t i = 0; i < iterations; ++i)
+		{
+			while (!queue.push(&value))
+			{
+				std::this_thread::yield();
+			}
+			void* data;
+			while (!queue.pop(&data))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+}
+
+static void _st_bench_intpool(st_bench_state& state)
+{
+	st_intpool pool(1024);
+	_st_bench_jobs_contend(state, [&pool](int64_t iterations)
+	{
+		for (int64_t i = 0; i < iterations; ++i)
+		{
+			pool.free(pool.alloc());
+		}
+	});
+}
+
+/*
+** Fiber switches, as a round trip to a fiber and back.
+*/
+struct st_bench_fiber_ping_t
+{
+	const st_fiber* _parent;
+	int64_t _count;
+};
+
+static void _st_bench_fiber_ping(void* data)
+{
+	st_bench_fiber_ping_t* ping = static_cast<st_bench_fiber_ping_t*>(data);
+	while (true)
+	{
+		ping->_count++;
+		st_fiber::switch_to(*ping->_parent);
+	}
+}
+
+static void _st_bench_fiber_switch(st_bench_state& state)
+{
+	st_fiber parent = st_fiber::convert_thread(nullptr);
+
+	st_bench_fiber_ping_t ping;
+	ping._parent = &parent;
+	ping._count = 0;
+
+	/* The fiber is left suspended in its loop and freed with its stack. */
+	st_fiber fiber(_st_bench_fiber_ping, &ping, 64 * 1024);
+
+	state.set_items_per_iteration(2);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_fiber::switch_to(fiber);
+	}
+	state.stop();
+
+	st_bench_keep(ping._count);
+}
+
+/*
+** Job scheduling. The job system is restarted only when the worker count
+** changes, so consecutive samples of a benchmark share one instance.
+*/
+static int _st_bench_jobs_worker_count = 0;
+
+void st_bench_startup_jobs(int worker_count)
+{
+	if (_st_bench_jobs_worker_count == worker_count)
+	{
+		return;
+	}
+	st_bench_shutdown_jobs();
+
+	/* Workers go on the first processors in topology order, which fills a NUMA node first. */
+	const st_cpu_topology& topology = st_cpu_topology::get();
+	st_job_cpu_mask_t mask;
+	for (int i = 0; i < worker_count && i < topology.get_cpu_count(); ++i)
+	{
+		mask.set(topology.get_cpu(i)._id);
+	}
+
+	/* Measure scheduling, not recording, as release builds would. */
+	st_trace::set_enabled(false);
+
+	st_job::startup(mask, 1024, 256);
+	_st_bench_jobs_worker_count = worker_count;
+}
+
+void st_bench_shutdown_jobs()
+{
+	if (_st_bench_jobs_worker_count > 0)
+	{
+		st_job::shutdown();
+		_st_bench_jobs_worker_count = 0;
+	}
+}
+
+static void _st_bench_jobs_empty(void* data)
+{
+}
+
+static void _st_bench_jobs_run(st_bench_state& state)
+{
+	st_bench_startup_jobs(state.get_arg());
+
+	std::vector<st_job_decl_t> decls(k_st_bench_jobs_batch_size);
+	for (st_job_decl_t& decl : decls)
+	{
+		decl._entry = _st_bench_jobs_empty;
+		decl._data = nullptr;
+		decl._name = "bench empty";
+	}
+
+	state.set_items_per_iteration(k_st_bench_jobs_batch_size);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_job_counter_t counter;
+		st_job::run(decls.data(), int(decls.size()), &counter);
+		st_job::wait(&counter);
+	}
+	state.stop();
+}
+
+static void _st_bench_jobs_parallel_for(st_bench_state& state)
+{
+	st_bench_startup_jobs(state.get_arg());
+
+	std::vector<float> values(k_st_bench_jobs_parallel_for_count);
+
+	state.set_items_per_iteration(k_st_bench_jobs_parallel_for_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_job::parallel_for(0, k_st_bench_jobs_parallel_for_count, 1024, [&values, it](int begin, int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				values[i] = std::sqrt(float(i + it));
+			}
+		});
+		st_bench_keep(values[0]);
+	}
+	state.stop();
+}
+
+void st_bench_register_jobs(st_bench_registry& registry)
+{
+	char name[64];
+
+	for (int thread_count : k_st_bench_jobs_thread_counts)
+	{
+		float tolerance = thread_count > 1 ? k_st_bench_jobs_contended_tolerance : 0.0f;
+
+		snprintf(name, sizeof(name), "queue/ms/threads:%d", thread_count);
+		registry.add(name, _st_bench_queue, thread_count, tolerance);
+
+		snprintf(name, sizeof(name), "queue/ring/threads:%d", thread_count);
+		registry.add(name, _st_bench_ring_queue, thread_count, tolerance);
+
+		snprintf(name, sizeof(name), "intpool/threads:%d", thread_count);
+		registry.add(name, _st_bench_intpool, thread_count, tolerance);
+	}
+
+	registry.add("fiber/switch", _st_bench_fiber_switch);
+
+	/* Worker counts double up to the number of processors, which is always included. */
+	int cpu_count = st_cpu_topology::get().get_cpu_count();
+	for (int worker_count = 1; ; worker_count *= 2)
+	{
+		worker_count = worker_count < cpu_count ? worker_count : cpu_count;
+
+		snprintf(name, sizeof(name), "job/run/workers:%d", worker_count);
+		registry.add(name, _st_bench_jobs_run, worker_count, k_st_bench_jobs_contended_tolerance);
+
+		snprintf(name, sizeof(name), "job/parallel_for/workers:%d", worker_count);
+		registry.add(name, _st_bench_jobs_parallel_for, worker_count, k_st_bench_jobs_contended_tolerance);
+
+		if (worker_count == cpu_count)
+		{
+			break;
+		}
+	}
+}
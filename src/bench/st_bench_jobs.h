@@ -0,0 +1,26 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+class st_bench_registry;
+
+/*
+** Job system benchmarks: queues, the integer pool, fiber switches and
+** job scheduling.
+*/
+void st_bench_register_jobs(st_bench_registry& registry);
+
+/*
+** Start the job system with a worker on each of the first processors, or
+** keep it running if it already has that many.
+*/
+void st_bench_startup_jobs(int worker_count);
+
+/*
+** Stop the job system if a benchmark started it.
+*/
+void st_bench_shutdown_jobs();
@@ -0,0 +1,641 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_bench_math.h"
+#include "st_bench.h"
+
+#include <math/st_aabb3f.h>
+#include <math/st_affine3f.h>
+#include <math/st_fast_math.h>
+#include <math/st_frustum.h>
+#include <math/st_half.h>
+#include <math/st_mat4f.h>
+#include <math/st_math.h>
+#include <math/st_packed_transform.h>
+#include <math/st_qts.h>
+#include <math/st_quatf.h>
+#include <math/st_vec.h>
+#include <math/st_vec3f_soa.h>
+
+#include <cmath>
+#include <vector>
+
+/*
+** Small enough that the inputs stay in L1, so these time the operation and
+** not the memory system.
+*/
+static const int k_st_bench_math_count = 256;
+
+/*
+** Large enough to show the benefit of the batched kernels.
+*/
+static const int k_st_bench_math_batch_count = 4096;
+
+struct st_bench_math_data_t
+{
+	std::vector<st_mat4f> _matrices_a;
+	std::vector<st_mat4f> _matrices_b;
+	std::vector<st_mat4f> _matrices_out;
+
+	std::vector<st_affine3f> _affines_a;
+	std::vector<st_affine3f> _affines_b;
+	std::vector<st_affine3f> _affines_out;
+
+	std::vector<st_qts> _qts_a;
+	std::vector<st_qts> _qts_b;
+	std::vector<st_qts> _qts_out;
+
+	std::vector<st_quatf> _quats_a;
+	std::vector<st_quatf> _quats_b;
+	std::vector<st_quatf> _quats_out;
+
+	std::vector<st_vec3f> _vec3s_a;
+	std::vector<st_vec3f> _vec3s_b;
+	std::vector<st_vec3f> _vec3s_out;
+
+	std::vector<st_vec4f> _vec4fs[3];
+	std::vector<st_vec4d> _vec4ds[3];
+
+	std::vector<float> _floats;
+	std::vector<float> _positive_floats;
+	std::vector<float> _floats_out;
+	std::vector<float> _floats_out2;
+
+	std::vector<st_vec3f> _points;
+	std::vector<st_vec3f> _points_out;
+	st_vec3f_soa _points_soa;
+	st_vec3f_soa _points_soa_out;
+
+	std::vector<float> _half_range_floats;
+	std::vector<st_half> _halves;
+
+	st_transform_cell _cell;
+	std::vector<st_packed_transform> _packed;
+
+	st_frustum _frustum;
+	std::vector<st_aabb3f> _boxes;
+	std::vector<uint8_t> _visible;
+};
+
+static st_quatf _st_bench_random_rotation(st_bench_random& random)
+{
+	st_vec3f axis = { random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f) };
+	axis.normalize();
+
+	st_quatf q;
+	q.make_axis_angle(axis, random.next(-st_PI, st_PI));
+	return q;
+}
+
+static st_vec3f _st_bench_random_vec3(st_bench_random& random, float range)
+{
+	return { random.next(-range, range), random.next(-range, range), random.next(-range, range) };
+}
+
+static st_qts _st_bench_random_qts(st_bench_random& random)
+{
+	st_qts t;
+	t.rotation = _st_bench_random_rotation(random);
+	t.translation = _st_bench_random_vec3(random, 100.0f);
+	t.scale = random.next(0.5f, 2.0f);
+	return t;
+}
+
+static st_bench_math_data_t& _st_bench_math_get_data()
+{
+	static st_bench_math_data_t* data = nullptr;
+	if (data)
+	{
+		return *data;
+	}
+
+	data = new st_bench_math_data_t;
+	st_bench_random random(0x5eed1234);
+
+	for (int i = 0; i < k_st_bench_math_count; ++i)
+	{
+		st_qts a = _st_bench_random_qts(random);
+		st_qts b = _st_bench_random_qts(random);
+
+		data->_qts_a.push_back(a);
+		data->_qts_b.push_back(b);
+		data->_affines_a.push_back(a.to_affine());
+		data->_affines_b.push_back(b.to_affine());
+		data->_matrices_a.push_back(a.to_mat4f());
+		data->_matrices_b.push_back(b.to_mat4f());
+		data->_quats_a.push_back(a.rotation);
+		data->_quats_b.push_back(b.rotation);
+
+		data->_vec3s_a.push_back(_st_bench_random_vec3(random, 10.0f));
+		data->_vec3s_b.push_back(_st_bench_random_vec3(random, 10.0f));
+
+		for (int j = 0; j < 3; ++j)
+		{
+			st_vec4f v = { random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f) };
+			data->_vec4fs[j].push_back(v);
+			data->_vec4ds[j].push_back(st_vec4d(v));
+		}
+
+		data->_floats.push_back(random.next(-100.0f, 100.0f));
+		data->_positive_floats.push_back(random.next(0.001f, 1000.0f));
+	}
+	data->_qts_out.resize(k_st_bench_math_count);
+	data->_affines_out.resize(k_st_bench_math_count);
+	data->_matrices_out.resize(k_st_bench_math_count);
+	data->_quats_out.resize(k_st_bench_math_count);
+	data->_vec3s_out.resize(k_st_bench_math_count);
+	data->_floats_out.resize(k_st_bench_math_count);
+	data->_floats_out2.resize(k_st_bench_math_count);
+
+	for (int i = 0; i < k_st_bench_math_batch_count; ++i)
+	{
+		data->_points.push_back(_st_bench_random_vec3(random, 100.0f));
+		data->_half_range_floats.push_back(random.next(-60000.0f, 60000.0f));
+	}
+	data->_points_out.resize(k_st_bench_math_batch_count);
+	data->_points_soa.from_aos(data->_points);
+	data->_points_soa_out.resize(k_st_bench_math_batch_count);
+	data->_halves.resize(k_st_bench_math_batch_count);
+	st_half_from_float_batch(data->_half_range_floats.data(), data->_halves.data(), k_st_bench_math_batch_count);
+
+	data->_cell.origin = { -100.0f, -100.0f, -100.0f };
+	data->_cell.size = 200.0f;
+	data->_packed.resize(k_st_bench_math_count);
+	st_packed_transform_pack_batch(data->_qts_a.data(), data->_cell, data->_packed.data(), k_st_bench_math_count);
+
+	// A camera at the origin looking down -z sees about one box in eight.
+	st_mat4f view;
+	view.make_lookat_rh(st_vec3f::zero_vector(), -st_vec3f::z_vector(), st_vec3f::y_vector());
+	st_mat4f projection;
+	projection.make_perspective_rh(st_degrees_to_radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+	data->_frustum.make_from_view_projection(view * projection);
+	for (int i = 0; i < k_st_bench_math_batch_count; ++i)
+	{
+		st_vec3f extents = { random.next(0.1f, 4.0f), random.next(0.1f, 4.0f), random.next(0.1f, 4.0f) };
+		st_aabb3f box;
+		box.make_from_center(data->_points[i], extents);
+		data->_boxes.push_back(box);
+	}
+	data->_visible.resize(k_st_bench_math_batch_count);
+
+	return *data;
+}
+
+/*
+** Runs body once per element per iteration, keeping the output alive.
+*/
+template<typename T, typename F>
+static void _st_bench_math_loop(st_bench_state& state, std::vector<T>& out, const F& body)
+{
+	state.set_items_per_iteration(int64_t(out.size()));
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		for (int i = 0; i < int(out.size()); ++i)
+		{
+			body(i);
+		}
+		st_bench_keep(out[0]);
+	}
+	state.stop();
+}
+
+/*
+** Matrices.
+*/
+static void _st_bench_mat4f_multiply(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._matrices_out, [&d](int i) { d._matrices_out[i] = d._matrices_a[i] * d._matrices_b[i]; });
+}
+
+static void _st_bench_mat4f_multiply_scalar(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._matrices_out, [&d](int i) { d._matrices_out[i] = d._matrices_a[i].multiply_scalar(d._matrices_b[i]); });
+}
+
+static void _st_bench_mat4f_inverse(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._matrices_out, [&d](int i) { d._matrices_out[i] = d._matrices_a[i].inverse(); });
+}
+
+static void _st_bench_mat4f_inverse_scalar(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._matrices_out, [&d](int i)
+	{
+		d._matrices_out[i] = d._matrices_a[i];
+		d._matrices_out[i].invert_scalar();
+	});
+}
+
+static void _st_bench_mat4f_transform_point(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = d._matrices_a[i].transform_point(d._vec3s_a[i]); });
+}
+
+static void _st_bench_mat4f_transform_points(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		d._matrices_a[0].transform_points(d._points.data(), d._points_out.data(), k_st_bench_math_batch_count);
+		st_bench_keep(d._points_out[0]);
+	}
+	state.stop();
+}
+
+static void _st_bench_soa_transform_points(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_vec3f_soa_transform_points(d._matrices_a[0], d._points_soa, d._points_soa_out);
+		st_bench_keep(d._points_soa_out.get_x()[0]);
+	}
+	state.stop();
+}
+
+/*
+** Affine and rotation-translation-scale transforms, against st_mat4f above.
+*/
+static void _st_bench_affine3f_multiply(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._affines_out, [&d](int i) { d._affines_out[i] = d._affines_a[i] * d._affines_b[i]; });
+}
+
+static void _st_bench_affine3f_inverse(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._affines_out, [&d](int i) { d._affines_out[i] = d._affines_a[i].inverse(); });
+}
+
+static void _st_bench_affine3f_transform_point(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = d._affines_a[i].transform_point(d._vec3s_a[i]); });
+}
+
+static void _st_bench_qts_multiply(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._qts_out, [&d](int i) { d._qts_out[i] = d._qts_a[i] * d._qts_b[i]; });
+}
+
+static void _st_bench_qts_inverse(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._qts_out, [&d](int i) { d._qts_out[i] = d._qts_a[i].inverse(); });
+}
+
+static void _st_bench_qts_transform_point(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = d._qts_a[i].transform_point(d._vec3s_a[i]); });
+}
+
+/*
+** Quaternions.
+*/
+static void _st_bench_quatf_multiply(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._quats_out, [&d](int i) { d._quats_out[i] = d._quats_a[i] * d._quats_b[i]; });
+}
+
+static void _st_bench_quatf_rotate_vector(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = d._quats_a[i].rotate_vector(d._vec3s_a[i]); });
+}
+
+static void _st_bench_quatf_normalize(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._quats_out, [&d](int i)
+	{
+		d._quats_out[i] = d._quats_a[i] + d._quats_b[i];
+		d._quats_out[i].normalize();
+	});
+}
+
+static void _st_bench_quatf_normalize_fast(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._quats_out, [&d](int i)
+	{
+		d._quats_out[i] = d._quats_a[i] + d._quats_b[i];
+		d._quats_out[i].normalize_fast();
+	});
+}
+
+static void _st_bench_quatf_make_axis_angle(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._quats_out, [&d](int i) { d._quats_out[i].make_axis_angle(st_vec3f::y_vector(), d._floats[i]); });
+}
+
+static void _st_bench_quatf_make_axis_angle_fast(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._quats_out, [&d](int i) { d._quats_out[i].make_axis_angle_fast(st_vec3f::y_vector(), d._floats[i]); });
+}
+
+static void _st_bench_quatf_to_mat4f(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._matrices_out, [&d](int i) { d._matrices_out[i].make_rotation(d._quats_a[i]); });
+}
+
+/*
+** Vectors.
+*/
+static void _st_bench_vec3f_dot(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i) { d._floats_out[i] = d._vec3s_a[i].dot(d._vec3s_b[i]); });
+}
+
+static void _st_bench_vec3f_cross(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = st_vec3f_cross(d._vec3s_a[i], d._vec3s_b[i]); });
+}
+
+static void _st_bench_vec3f_normal(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = d._vec3s_a[i].normal(); });
+}
+
+static void _st_bench_vec3f_normal_fast(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._vec3s_out, [&d](int i) { d._vec3s_out[i] = d._vec3s_a[i].normal_fast(); });
+}
+
+static void _st_bench_vec4f_multiply_add(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	std::vector<st_vec4f>* v = d._vec4fs;
+	_st_bench_math_loop(state, v[2], [v](int i) { v[2][i] = v[0][i] * v[1][i] + v[2][i]; });
+}
+
+static void _st_bench_vec4d_multiply_add(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	std::vector<st_vec4d>* v = d._vec4ds;
+	_st_bench_math_loop(state, v[2], [v](int i) { v[2][i] = v[0][i] * v[1][i] + v[2][i]; });
+}
+
+static void _st_bench_soa_normalize(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		d._points_soa_out = d._points_soa;
+		st_vec3f_soa_normalize(d._points_soa_out);
+		st_bench_keep(d._points_soa_out.get_x()[0]);
+	}
+	state.stop();
+}
+
+static void _st_bench_aos_normalize(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		d._points_out = d._points;
+		for (st_vec3f& p : d._points_out)
+		{
+			p.normalize();
+		}
+		st_bench_keep(d._points_out[0]);
+	}
+	state.stop();
+}
+
+/*
+** Fast math, each tier against the others.
+*/
+static void _st_bench_rsqrt(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i) { d._floats_out[i] = st_rsqrtf(d._positive_floats[i]); });
+}
+
+static void _st_bench_rsqrt_fast(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i) { d._floats_out[i] = st_rsqrtf_fast(d._positive_floats[i]); });
+}
+
+static void _st_bench_rsqrt_batch(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_rsqrtf_batch(d._positive_floats.data(), d._floats_out.data(), k_st_bench_math_count);
+		st_bench_keep(d._floats_out[0]);
+	}
+	state.stop();
+}
+
+static void _st_bench_sincos(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i)
+	{
+		d._floats_out[i] = st_sinf(d._floats[i]);
+		d._floats_out2[i] = st_cosf(d._floats[i]);
+	});
+}
+
+static void _st_bench_sincos_fast(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i) { st_sincosf_fast(d._floats[i], d._floats_out[i], d._floats_out2[i]); });
+}
+
+static void _st_bench_sincos_batch(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_sincosf_batch(d._floats.data(), d._floats_out.data(), d._floats_out2.data(), k_st_bench_math_count);
+		st_bench_keep(d._floats_out[0]);
+	}
+	state.stop();
+}
+
+static void _st_bench_pow(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i) { d._floats_out[i] = st_powf(d._positive_floats[i], 2.2f); });
+}
+
+static void _st_bench_pow_fast(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._floats_out, [&d](int i) { d._floats_out[i] = st_powf_fast(d._positive_floats[i], 2.2f); });
+}
+
+/*
+** Half precision conversion, one at a time and batched.
+*/
+static void _st_bench_half_from_float(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._halves, [&d](int i) { d._halves[i] = st_half(d._half_range_floats[i]); });
+}
+
+static void _st_bench_half_from_float_batch(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_half_from_float_batch(d._half_range_floats.data(), d._halves.data(), k_st_bench_math_batch_count);
+		st_bench_keep(d._halves[0]);
+	}
+	state.stop();
+}
+
+static void _st_bench_half_to_float_batch(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	std::vector<float> out(k_st_bench_math_batch_count);
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_half_to_float_batch(d._halves.data(), out.data(), k_st_bench_math_batch_count);
+		st_bench_keep(out[0]);
+	}
+	state.stop();
+}
+
+/*
+** Packed transforms.
+*/
+static void _st_bench_packed_transform_pack(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	std::vector<st_packed_transform> out(k_st_bench_math_count);
+	_st_bench_math_loop(state, out, [&](int i) { out[i].pack(d._qts_a[i], d._cell); });
+}
+
+static void _st_bench_packed_transform_unpack(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._qts_out, [&](int i) { d._qts_out[i] = d._packed[i].unpack(d._cell); });
+}
+
+static void _st_bench_packed_transform_unpack_affine_batch(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_packed_transform_unpack_affine_batch(d._packed.data(), d._cell, d._affines_out.data(), k_st_bench_math_count);
+		st_bench_keep(d._affines_out[0]);
+	}
+	state.stop();
+}
+
+/*
+** Culling.
+*/
+static void _st_bench_frustum_cull_scalar(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	_st_bench_math_loop(state, d._visible, [&](int i) { d._visible[i] = d._frustum.intersects(d._boxes[i]) ? 1 : 0; });
+}
+
+static void _st_bench_frustum_cull(st_bench_state& state)
+{
+	st_bench_math_data_t& d = _st_bench_math_get_data();
+	state.set_items_per_iteration(k_st_bench_math_batch_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_bench_keep(st_frustum_cull(d._frustum, d._boxes.data(), k_st_bench_math_batch_count, d._visible.data()));
+	}
+	state.stop();
+}
+
+void st_bench_register_math(st_bench_registry& registry)
+{
+	registry.add("mat4f/multiply", _st_bench_mat4f_multiply);
+	registry.add("mat4f/multiply_scalar", _st_bench_mat4f_multiply_scalar);
+	registry.add("mat4f/inverse", _st_bench_mat4f_inverse);
+	registry.add("mat4f/inverse_scalar", _st_bench_mat4f_inverse_scalar);
+	registry.add("mat4f/transform_point", _st_bench_mat4f_transform_point);
+	registry.add("mat4f/transform_points_aos", _st_bench_mat4f_transform_points);
+	registry.add("mat4f/transform_points_soa", _st_bench_soa_transform_points);
+
+	registry.add("affine3f/multiply", _st_bench_affine3f_multiply);
+	registry.add("affine3f/inverse", _st_bench_affine3f_inverse);
+	registry.add("affine3f/transform_point", _st_bench_affine3f_transform_point);
+	registry.add("qts/multiply", _st_bench_qts_multiply);
+	registry.add("qts/inverse", _st_bench_qts_inverse);
+	registry.add("qts/transform_point", _st_bench_qts_transform_point);
+
+	registry.add("quatf/multiply", _st_bench_quatf_multiply);
+	registry.add("quatf/rotate_vector", _st_bench_quatf_rotate_vector);
+	registry.add("quatf/normalize", _st_bench_quatf_normalize);
+	registry.add("quatf/normalize_fast", _st_bench_quatf_normalize_fast);
+	registry.add("quatf/make_axis_angle", _st_bench_quatf_make_axis_angle);
+	registry.add("quatf/make_axis_angle_fast", _st_bench_quatf_make_axis_angle_fast);
+	registry.add("quatf/to_mat4f", _st_bench_quatf_to_mat4f);
+
+	registry.add("vec3f/dot", _st_bench_vec3f_dot);
+	registry.add("vec3f/cross", _st_bench_vec3f_cross);
+	registry.add("vec3f/normal", _st_bench_vec3f_normal);
+	registry.add("vec3f/normal_fast", _st_bench_vec3f_normal_fast);
+	registry.add("vec3f/normalize_aos", _st_bench_aos_normalize);
+	registry.add("vec3f/normalize_soa", _st_bench_soa_normalize);
+	registry.add("vec4f/multiply_add", _st_bench_vec4f_multiply_add);
+	registry.add("vec4d/multiply_add", _st_bench_vec4d_multiply_add);
+
+	registry.add("fast_math/rsqrt", _st_bench_rsqrt);
+	registry.add("fast_math/rsqrt_fast", _st_bench_rsqrt_fast);
+	registry.add("fast_math/rsqrt_batch", _st_bench_rsqrt_batch);
+	registry.add("fast_math/sincos", _st_bench_sincos);
+	registry.add("fast_math/sincos_fast", _st_bench_sincos_fast);
+	registry.add("fast_math/sincos_batch", _st_bench_sincos_batch);
+	registry.add("fast_math/pow", _st_bench_pow);
+	registry.add("fast_math/pow_fast", _st_bench_pow_fast);
+
+	registry.add("half/from_float", _st_bench_half_from_float);
+	registry.add("half/from_float_batch", _st_bench_half_from_float_batch);
+	registry.add("half/to_float_batch", _st_bench_half_to_float_batch);
+
+	registry.add("packed_transform/pack", _st_bench_packed_transform_pack);
+	registry.add("packed_transform/unpack", _st_bench_packed_transform_unpack);
+	registry.add("packed_transform/unpack_affine_batch", _st_bench_packed_transform_unpack_affine_batch);
+
+	registry.add("frustum/cull_scalar", _st_bench_frustum_cull_scalar);
+	registry.add("frustum/cull", _st_bench_frustum_cull);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+class st_bench_registry;
+
+/*
+** Math library benchmarks: matrices, quaternions, vectors, transforms,
+** fast math and half precision conversion.
+*/
+void st_bench_register_math(st_bench_registry& registry);
@@ -0,0 +1,523 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_bench_physics.h"
+#include "st_bench.h"
+#include "st_bench_jobs.h"
+
+#include <math/st_affine3f.h>
+#include <math/st_math.h>
+#include <math/st_quatf.h>
+#include <math/st_vec3f_soa.h>
+
+#include <framework/st_frame_params.h>
+
+#include <physics/st_broadphase.h>
+#include <physics/st_intersection.h>
+#include <physics/st_physics_world.h>
+#include <physics/st_rigid_body.h>
+#include <physics/st_shape.h>
+
+#include <system/st_cpu_topology.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/*
+** Pairs are placed so that roughly half of them intersect, which keeps the
+** early out and contact generation paths both in the measurement.
+*/
+static const int k_st_bench_physics_pair_count = 64;
+
+typedef bool(*st_bench_intersection_function_t)(const st_shape*, const st_affine3f&, const st_shape*, const st_affine3f&, st_collision_info*);
+
+struct st_bench_physics_data_t
+{
+	st_sphere _sphere;
+	st_plane _plane;
+	st_aabb _aabb;
+	st_oobb _oobb;
+	st_convex_hull _hull;
+
+	std::vector<st_affine3f> _transforms_a;
+	std::vector<st_affine3f> _transforms_b;
+
+	std::vector<st_vec3f> _segment_points;
+	std::vector<st_vec3f> _hull_points;
+	st_vec3f_soa _hull_points_soa;
+};
+
+static st_bench_physics_data_t& _st_bench_physics_get_data()
+{
+	static st_bench_physics_data_t* data = nullptr;
+	if (data)
+	{
+		return *data;
+	}
+
+	data = new st_bench_physics_data_t;
+	st_bench_random random(0xc0111de5);
+
+	data->_sphere._center = st_vec3f::zero_vector();
+	data->_sphere._radius = 1.0f;
+
+	data->_plane._point = st_vec3f::zero_vector();
+	data->_plane._normal = st_vec3f::y_vector();
+
+	data->_aabb._min = { -1.0f, -1.0f, -1.0f };
+	data->_aabb._max = { 1.0f, 1.0f, 1.0f };
+
+	data->_oobb._center = st_vec3f::zero_vector();
+	data->_oobb._half_vectors[0] = { 1.0f, 0.0f, 0.0f };
+	data->_oobb._half_vectors[1] = { 0.0f, 0.5f, 0.0f };
+	data->_oobb._half_vectors[2] = { 0.0f, 0.0f, 0.75f };
+
+	for (int i = 0; i < k_st_bench_physics_pair_count; ++i)
+	{
+		st_vec3f axis = { random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f) };
+		axis.normalize();
+
+		st_quatf rotation_a;
+		rotation_a.make_axis_angle(axis, random.next(-st_PI, st_PI));
+		st_quatf rotation_b;
+		rotation_b.make_axis_angle(axis.scale_result(-1.0f), random.next(-st_PI, st_PI));
+
+		st_affine3f a;
+		a.make_rotation(rotation_a);
+		a.set_translation({ random.next(-1.5f, 1.5f), random.next(-1.5f, 1.5f), random.next(-1.5f, 1.5f) });
+
+		st_affine3f b;
+		b.make_rotation(rotation_b);
+		b.set_translation({ random.next(-1.5f, 1.5f), random.next(-1.5f, 1.5f), random.next(-1.5f, 1.5f) });
+
+		data->_transforms_a.push_back(a);
+		data->_transforms_b.push_back(b);
+
+		for (int j = 0; j < 4; ++j)
+		{
+			data->_segment_points.push_back({ random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f) });
+		}
+	}
+
+	for (int i = 0; i < 256; ++i)
+	{
+		data->_hull_points.push_back({ random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f), random.next(-10.0f, 10.0f) });
+	}
+	data->_hull_points_soa.from_aos(data->_hull_points);
+
+	std::vector<st_vec3f> hull_positions;
+	for (int i = 0; i < 32; ++i)
+	{
+		st_vec3f position = { random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f) };
+		position.normalize();
+		hull_positions.push_back(position);
+	}
+	data->_hull.set_positions(hull_positions);
+
+	return *data;
+}
+
+static void _st_bench_physics_pairs(
+	st_bench_state& state,
+	st_bench_intersection_function_t function,
+	const st_shape* a,
+	const st_shape* b)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+
+	state.set_items_per_iteration(k_st_bench_physics_pair_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		int hit_count = 0;
+		for (int i = 0; i < k_st_bench_physics_pair_count; ++i)
+		{
+			st_collision_info info;
+			hit_count += function(a, d._transforms_a[i], b, d._transforms_b[i], &info) ? 1 : 0;
+			st_bench_keep(info);
+		}
+		st_bench_keep(hit_count);
+	}
+	state.stop();
+}
+
+static void _st_bench_sphere_vs_sphere(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, sphere_vs_sphere, &d._sphere, &d._sphere);
+}
+
+static void _st_bench_sphere_vs_plane(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, sphere_vs_plane, &d._sphere, &d._plane);
+}
+
+static void _st_bench_oobb_vs_plane(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, oobb_vs_plane, &d._oobb, &d._plane);
+}
+
+static void _st_bench_aabb_vs_aabb(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, aabb_vs_aabb, &d._aabb, &d._aabb);
+}
+
+static void _st_bench_separating_axis_test(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, separating_axis_test, &d._oobb, &d._oobb);
+}
+
+static void _st_bench_gjk_sphere_vs_oobb(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, gjk, &d._sphere, &d._oobb);
+}
+
+static void _st_bench_gjk_oobb_vs_oobb(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, gjk, &d._oobb, &d._oobb);
+}
+
+static void _st_bench_gjk_hull_vs_hull(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+	_st_bench_physics_pairs(state, gjk, &d._hull, &d._hull);
+}
+
+static void _st_bench_closest_points_on_lines(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+
+	state.set_items_per_iteration(k_st_bench_physics_pair_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		for (int i = 0; i < k_st_bench_physics_pair_count; ++i)
+		{
+			const st_vec3f* p = &d._segment_points[i * 4];
+			st_vec3f point_a;
+			st_vec3f point_b;
+			bool within = closest_points_on_lines(p[0], p[1], p[2], p[3], point_a, point_b);
+			st_bench_keep(within);
+			st_bench_keep(point_a);
+			st_bench_keep(point_b);
+		}
+	}
+	state.stop();
+}
+
+static void _st_bench_farthest_along_vector(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+
+	state.set_items_per_iteration(int64_t(d._hull_points.size()));
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_vec3f direction = d._transforms_a[it % k_st_bench_physics_pair_count].get_forward();
+		st_vec3f farthest = farthest_along_vector(d._hull_points, direction);
+		st_bench_keep(farthest);
+	}
+	state.stop();
+}
+
+static void _st_bench_farthest_along_vector_soa(st_bench_state& state)
+{
+	st_bench_physics_data_t& d = _st_bench_physics_get_data();
+
+	state.set_items_per_iteration(int64_t(d._hull_points.size()));
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		st_vec3f direction = d._transforms_a[it % k_st_bench_physics_pair_count].get_forward();
+		st_vec3f farthest = farthest_along_vector(d._hull_points_soa, direction);
+		st_bench_keep(farthest);
+	}
+	state.stop();
+}
+
+/*
+** A scene of boxes at a constant density, one in ten static, the rest
+** drifting a little each step. Results are reported per body.
+*/
+static const float k_st_bench_broadphase_volume_per_body = 8.0f;
+static const float k_st_bench_broadphase_dt = 1.0f / 60.0f;
+
+struct st_bench_broadphase_scene_t
+{
+	st_broadphase _broadphase;
+	std::vector<st_broadphase_pair> _pairs;
+
+	std::vector<st_aabb3f> _bounds;
+	std::vector<st_vec3f> _velocities;
+	std::vector<bool> _is_static;
+	float _half_size;
+};
+
+static void _st_bench_broadphase_make_scene(st_bench_broadphase_scene_t& scene, int body_count)
+{
+	st_bench_random random(0xb20ad);
+	scene._half_size = 0.5f * std::cbrt(float(body_count) * k_st_bench_broadphase_volume_per_body);
+
+	for (int i = 0; i < body_count; ++i)
+	{
+		float h = scene._half_size;
+		st_vec3f center = { random.next(-h, h), random.next(-h, h), random.next(-h, h) };
+		st_vec3f extents = { random.next(0.25f, 1.0f), random.next(0.25f, 1.0f), random.next(0.25f, 1.0f) };
+		st_aabb3f bounds;
+		bounds.make_from_center(center, extents);
+
+		bool is_static = i % 10 == 0;
+		scene._bounds.push_back(bounds);
+		scene._is_static.push_back(is_static);
+		scene._velocities.push_back(is_static
+			? st_vec3f::zero_vector()
+			: st_vec3f{ random.next(-2.0f, 2.0f), random.next(-2.0f, 2.0f), random.next(-2.0f, 2.0f) });
+
+		scene._broadphase.add_proxy(&bounds, is_static, nullptr);
+	}
+}
+
+static void _st_bench_broadphase_move(st_bench_broadphase_scene_t& scene)
+{
+	for (int i = 0; i < int(scene._bounds.size()); ++i)
+	{
+		if (scene._is_static[i])
+		{
+			continue;
+		}
+
+		// Turn back at the walls of the volume so the density holds.
+		st_vec3f center = scene._bounds[i].get_center();
+		for (int a = 0; a < 3; ++a)
+		{
+			if (st_absf(center.axes[a]) > scene._half_size && center.axes[a] * scene._velocities[i].axes[a] > 0.0f)
+			{
+				scene._velocities[i].axes[a] = -scene._velocities[i].axes[a];
+			}
+		}
+
+		st_vec3f displacement = scene._velocities[i].scale_result(k_st_bench_broadphase_dt);
+		scene._bounds[i].min += displacement;
+		scene._bounds[i].max += displacement;
+		scene._broadphase.move_proxy(i, scene._bounds[i], displacement);
+	}
+}
+
+static void _st_bench_broadphase(st_bench_state& state)
+{
+	const int body_count = state.get_arg();
+	st_bench_broadphase_scene_t scene;
+	_st_bench_broadphase_make_scene(scene, body_count);
+
+	state.set_items_per_iteration(body_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		_st_bench_broadphase_move(scene);
+		scene._broadphase.find_pairs(scene._pairs);
+		st_bench_keep(scene._pairs.size());
+	}
+	state.stop();
+}
+
+/*
+** Every pair tested against every other, as the world did before the broadphase.
+*/
+static void _st_bench_broadphase_naive(st_bench_state& state)
+{
+	const int body_count = state.get_arg();
+	st_bench_broadphase_scene_t scene;
+	_st_bench_broadphase_make_scene(scene, body_count);
+
+	state.set_items_per_iteration(body_count);
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		_st_bench_broadphase_move(scene);
+		scene._pairs.clear();
+		for (int32_t a = 0; a < body_count; ++a)
+		{
+			for (int32_t b = a + 1; b < body_count; ++b)
+			{
+				if (!(scene._is_static[a] && scene._is_static[b]) && scene._bounds[a].intersects(scene._bounds[b]))
+				{
+					scene._pairs.push_back({ a, b });
+				}
+			}
+		}
+		st_bench_keep(scene._pairs.size());
+	}
+	state.stop();
+}
+
+/*
+** Whole world steps over scenes of boxes resting on a plane, where the
+** contact solver does most of the work. Scenes are given time to settle
+** before timing starts, and sleeping is off unless the name says otherwise,
+** so every body stays in the solver. Results are reported per step.
+*/
+static const int k_st_bench_world_settle_steps = 300;
+// Long enough for the pile to come to rest and fall asleep.
+static const int k_st_bench_world_sleep_steps = 900;
+
+struct st_bench_world_scene_t
+{
+	st_physics_world _world;
+	st_plane _ground_shape;
+	st_oobb _box_shape;
+	std::vector<st_rigid_body*> _bodies;
+	st_frame_params _params;
+
+	~st_bench_world_scene_t()
+	{
+		for (st_rigid_body* body : _bodies)
+		{
+			_world.remove_rigid_body(body);
+			delete body;
+		}
+	}
+};
+
+static st_rigid_body* _st_bench_world_add(st_bench_world_scene_t& scene, st_shape* shape, const st_vec3f& position)
+{
+	st_rigid_body* body = new st_rigid_body(shape, 1.0f);
+	body->set_translation(position);
+	scene._bodies.push_back(body);
+	return body;
+}
+
+static void _st_bench_world_make_ground(st_bench_world_scene_t& scene)
+{
+	scene._ground_shape._point = st_vec3f::zero_vector();
+	scene._ground_shape._normal = st_vec3f::y_vector();
+	_st_bench_world_add(scene, &scene._ground_shape, st_vec3f::zero_vector())->make_static();
+
+	scene._box_shape._center = st_vec3f::zero_vector();
+	scene._box_shape._half_vectors[0] = { 0.5f, 0.0f, 0.0f };
+	scene._box_shape._half_vectors[1] = { 0.0f, 0.5f, 0.0f };
+	scene._box_shape._half_vectors[2] = { 0.0f, 0.0f, 0.5f };
+
+	scene._params._delta_time = std::chrono::microseconds(16667);
+	scene._world.set_sleeping_enabled(false);
+}
+
+static void _st_bench_world_step(st_bench_world_scene_t& scene)
+{
+	scene._world.step(&scene._params);
+	scene._params._dynamic_drawcalls.clear();
+}
+
+static void _st_bench_world_run(st_bench_state& state, st_bench_world_scene_t& scene, int settle_steps = k_st_bench_world_settle_steps)
+{
+	st_bench_startup_jobs(st_cpu_topology::get().get_cpu_count());
+
+	for (st_rigid_body* body : scene._bodies)
+	{
+		scene._world.add_rigid_body(body);
+	}
+	for (int step = 0; step < settle_steps; ++step)
+	{
+		_st_bench_world_step(scene);
+	}
+
+	state.start();
+	for (int64_t it = 0; it < state.get_iterations(); ++it)
+	{
+		_st_bench_world_step(scene);
+	}
+	state.stop();
+}
+
+/*
+** A single column of boxes.
+*/
+static void _st_bench_world_stack(st_bench_state& state)
+{
+	st_bench_world_scene_t scene;
+	_st_bench_world_make_ground(scene);
+	for (int i = 0; i < state.get_arg(); ++i)
+	{
+		_st_bench_world_add(scene, &scene._box_shape, { 0.0f, 0.5f + float(i), 0.0f });
+	}
+
+	_st_bench_world_run(state, scene);
+}
+
+/*
+** Layers of boxes dropped at random orientations, which tumble into a pile.
+*/
+static void _st_bench_world_make_pile(st_bench_world_scene_t& scene, int count)
+{
+	_st_bench_world_make_ground(scene);
+
+	st_bench_random random(0x9113);
+	int side = int(std::ceil(std::sqrt(float(count) / 4.0f)));
+	for (int i = 0; i < count; ++i)
+	{
+		int layer = i / (side * side);
+		int cell = i % (side * side);
+		st_rigid_body* body = _st_bench_world_add(scene, &scene._box_shape, { float(cell % side) * 1.8f, 1.0f + float(layer) * 1.8f, float(cell / side) * 1.8f });
+
+		st_vec3f axis = { random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f) };
+		axis.normalize();
+		st_quatf orientation;
+		orientation.make_axis_angle(axis, random.next(0.0f, 1.0f));
+		body->set_orientation(orientation);
+	}
+}
+
+static void _st_bench_world_pile(st_bench_state& state)
+{
+	st_bench_world_scene_t scene;
+	_st_bench_world_make_pile(scene, state.get_arg());
+	_st_bench_world_run(state, scene);
+}
+
+/*
+** The same pile left to fall asleep, as most scenes spend most of their time.
+*/
+static void _st_bench_world_pile_sleeping(st_bench_state& state)
+{
+	st_bench_world_scene_t scene;
+	_st_bench_world_make_pile(scene, state.get_arg());
+	scene._world.set_sleeping_enabled(true);
+	_st_bench_world_run(state, scene, k_st_bench_world_sleep_steps);
+}
+
+void st_bench_register_physics(st_bench_registry& registry)
+{
+	registry.add("intersection/sphere_vs_sphere", _st_bench_sphere_vs_sphere);
+	registry.add("intersection/sphere_vs_plane", _st_bench_sphere_vs_plane);
+	registry.add("intersection/oobb_vs_plane", _st_bench_oobb_vs_plane);
+	registry.add("intersection/aabb_vs_aabb", _st_bench_aabb_vs_aabb);
+	registry.add("intersection/separating_axis_test", _st_bench_separating_axis_test);
+	registry.add("intersection/gjk/sphere_vs_oobb", _st_bench_gjk_sphere_vs_oobb);
+	registry.add("intersection/gjk/oobb_vs_oobb", _st_bench_gjk_oobb_vs_oobb);
+	registry.add("intersection/gjk/hull_vs_hull", _st_bench_gjk_hull_vs_hull);
+	registry.add("intersection/closest_points_on_lines", _st_bench_closest_points_on_lines);
+	registry.add("intersection/farthest_along_vector", _st_bench_farthest_along_vector);
+	registry.add("intersection/farthest_along_vector_soa", _st_bench_farthest_along_vector_soa);
+
+	const int k_body_counts[] = { 1000, 10000, 50000 };
+	char name[64];
+	for (int count : k_body_counts)
+	{
+		snprintf(name, sizeof(name), "broadphase/find_pairs/bodies:%d", count);
+		registry.add(name, _st_bench_broadphase, count);
+	}
+	registry.add("broadphase/naive/bodies:1000", _st_bench_broadphase_naive, 1000);
+
+	registry.add("world/stack/boxes:10", _st_bench_world_stack, 10);
+	registry.add("world/pile/boxes:200", _st_bench_world_pile, 200);
+	registry.add("world/pile_sleeping/boxes:200", _st_bench_world_pile_sleeping, 200);
+}
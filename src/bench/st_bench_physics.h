@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+class st_bench_registry;
+
+/*
+** Intersection routine benchmarks.
+*/
+void st_bench_register_physics(st_bench_registry& registry);
@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <cstdint>
+
+/*
+** Deterministic pseudo-random numbers for unit tests, so a failure
+** reproduces on every run.
+*/
+class st_test_random
+{
+public:
+	explicit st_test_random(uint32_t seed) : _state(seed) {}
+
+	float next(float low, float high)
+	{
+		_state = _state * 1664525u + 1013904223u;
+		return low + float(_state >> 8) / float(1 << 24) * (high - low);
+	}
+
+private:
+	uint32_t _state;
+};
@@ -64,9 +64,9 @@ void st_entity::translate(const st_vec3f& translation)
 
 void st_entity::rotate(const st_quatf& rotation)
 {
-	st_mat4f rotation_m;
-	rotation_m.make_rotation(rotation);
-	_transform = rotation_m * _transform;
+	st_affine3f rotation_t;
+	rotation_t.make_rotation(rotation);
+	_transform = rotation_t * _transform;
 }
 
 void st_entity::scale(float s)
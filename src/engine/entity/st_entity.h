@@ -6,7 +6,7 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "math/st_mat4f.h"
+#include "math/st_affine3f.h"
 
 #include <memory>
 #include <vector>
@@ -30,14 +30,14 @@ public:
 
 	void debug();
 
-	void translate(const struct st_vec3f& translation);
+	void translate(const st_vec3f& translation);
 	void rotate(const struct st_quatf& rotation);
 	void scale(float s);
 
-	const st_mat4f& get_transform() const { return _transform; }
-	void set_transform(const st_mat4f& t) { _transform = t; }
+	const st_affine3f& get_transform() const { return _transform; }
+	void set_transform(const st_affine3f& t) { _transform = t; }
 
 private:
 	std::vector<std::unique_ptr<class st_component>> _components;
-	st_mat4f _transform;
+	st_affine3f _transform;
 };
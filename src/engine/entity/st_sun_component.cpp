@@ -6,12 +6,11 @@
 
 #include <entity/st_sun_component.h>
 
+#include <math/st_fast_math.h>
 #include <math/st_math.h>
 
 #include <imgui.h>
 
-#include <cmath>
-
 st_sun_component::st_sun_component(
 	st_entity* ent,
 	float azimuth,
@@ -68,14 +67,18 @@ st_vec3f st_sun_component::calculate_direction() const
 	// Given the azimuth and angle, calculate the direction of incoming sunlight.
 	float azimuth_radians = st_degrees_to_radians(_azimuth);
 	float angle_radians = st_degrees_to_radians(_angle);
+	float sin_azimuth, cos_azimuth;
+	float sin_angle, cos_angle;
+	st_sincosf_fast(azimuth_radians, sin_azimuth, cos_azimuth);
+	st_sincosf_fast(angle_radians, sin_angle, cos_angle);
 	st_vec3f negative_dir =
 	{
-		cos(azimuth_radians) * sin(angle_radians),
-		cos(angle_radians),
-		sin(azimuth_radians) * sin(angle_radians),
+		cos_azimuth * sin_angle,
+		cos_angle,
+		sin_azimuth * sin_angle,
 	};
 
-	negative_dir.normalize();
+	negative_dir.normalize_fast();
 
 	return -negative_dir;
 }
@@ -22,7 +22,7 @@ public:
 		class st_entity* ent,
 		float azimuth,
 		float angle,
-		struct st_vec3f color,
+		st_vec3f color,
 		float power);
 	~st_sun_component();
 
@@ -65,11 +65,11 @@ void st_camera::update(st_frame_params* params)
 	_transform.make_identity();
 
 	st_quatf rotation_axis_angle;
-	rotation_axis_angle.make_axis_angle(st_vec3f::y_vector(), st_degrees_to_radians(_yaw));
+	rotation_axis_angle.make_axis_angle_fast(st_vec3f::y_vector(), st_degrees_to_radians(_yaw));
 	st_mat4f yaw_matrix;
 	yaw_matrix.make_rotation(rotation_axis_angle);
 
-	rotation_axis_angle.make_axis_angle(st_vec3f::x_vector(), st_degrees_to_radians(_pitch));
+	rotation_axis_angle.make_axis_angle_fast(st_vec3f::x_vector(), st_degrees_to_radians(_pitch));
 	st_mat4f pitch_matrix;
 	pitch_matrix.make_rotation(rotation_axis_angle);
 	_transform = pitch_matrix * (yaw_matrix * _transform);
@@ -11,6 +11,21 @@
 #define ST_MSVC
 #elif defined(__MINGW32__)
 #define ST_MINGW
+#elif defined(__clang__)
+#define ST_CLANG
+#elif defined(__GNUC__)
+#define ST_GCC
+#endif
+
+// Platforms.
+#if defined(_WIN32)
+#define ST_WINDOWS
+#elif defined(__linux__)
+#define ST_LINUX
+#define ST_POSIX
+#elif defined(__APPLE__)
+#define ST_APPLE
+#define ST_POSIX
 #endif
 
 // Architecture.
@@ -30,3 +45,17 @@
 #define ST_32_BIT
 #endif
 #endif
+
+#if defined(ST_CLANG) || defined(ST_GCC)
+#if defined(__LP64__)
+#define ST_64_BIT
+#else
+#define ST_32_BIT
+#endif
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define ST_X64
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define ST_ARM64
+#endif
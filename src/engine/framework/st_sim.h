@@ -26,5 +26,8 @@ public:
 	void debug();
 
 private:
+	// Entities updated per job. Entity updates are fairly heavy, so keep slices small.
+	static const int k_entity_grain = 16;
+
 	std::vector<class st_entity*> _entities;
 };
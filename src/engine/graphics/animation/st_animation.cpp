@@ -0,0 +1,106 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <graphics/animation/st_animation.h>
+
+#include <cassert>
+#include <cstring>
+
+uint32_t st_skeleton::add_joint(const char* name, uint32_t parent)
+{
+	assert(parent == INT_MAX || parent < _joints.size());
+
+	st_joint joint;
+	strncpy(joint._name, name, sizeof(joint._name) - 1);
+	joint._name[sizeof(joint._name) - 1] = '\0';
+	joint._parent = parent;
+	_joints.push_back(joint);
+
+	st_affine3f identity;
+	identity.make_identity();
+	_world.push_back(identity);
+	_inv_bind.push_back(identity);
+	_skin.push_back(identity);
+
+	return uint32_t(_joints.size() - 1);
+}
+
+void st_skeleton_pose::resize(int count)
+{
+	int previous = size();
+	_rotations.resize(count);
+	_translations.resize(count);
+	_scales.resize(count, 1.0f);
+
+	for (int i = previous; i < count; ++i)
+	{
+		_rotations.set(i, st_quatf::identity());
+		_translations.set(i, st_vec3f::zero_vector());
+	}
+}
+
+st_qts st_skeleton_pose::get(int index) const
+{
+	st_qts transform;
+	transform.rotation = _rotations.get(index);
+	transform.translation = _translations.get(index);
+	transform.scale = _scales[index];
+	return transform;
+}
+
+void st_skeleton_pose::set(int index, const st_qts& transform)
+{
+	_rotations.set(index, transform.rotation);
+	_translations.set(index, transform.translation);
+	_scales[index] = transform.scale;
+}
+
+void st_skeleton_pose_blend(
+	const st_skeleton_pose& a,
+	const st_skeleton_pose& b,
+	float t,
+	e_st_pose_blend mode,
+	st_skeleton_pose& out)
+{
+	assert(a.size() == b.size());
+
+	if (mode == st_pose_blend_slerp)
+	{
+		st_quatf_soa_slerp(a._rotations, b._rotations, t, out._rotations);
+	}
+	else
+	{
+		st_quatf_soa_nlerp(a._rotations, b._rotations, t, out._rotations);
+	}
+	st_vec3f_soa_lerp(a._translations, b._translations, t, out._translations);
+
+	out._scales.resize(a._scales.size());
+	for (size_t i = 0; i < a._scales.size(); ++i)
+	{
+		out._scales[i] = a._scales[i] * (1.0f - t) + b._scales[i] * t;
+	}
+}
+
+void st_skeleton_apply_pose(st_skeleton* skeleton, const st_skeleton_pose& pose)
+{
+	int joint_count = int(skeleton->_joints.size());
+	assert(pose.size() == joint_count);
+
+	// Local transforms of every joint at once, expanded into the world array.
+	st_quatf_soa_to_affine(pose._rotations, pose._translations, pose._scales.data(), skeleton->_world.data());
+
+	// Parents precede their children, so one pass in order resolves the hierarchy.
+	for (int i = 0; i < joint_count; ++i)
+	{
+		uint32_t parent = skeleton->_joints[i]._parent;
+		if (parent < INT_MAX)
+		{
+			skeleton->_world[i] *= skeleton->_world[parent];
+		}
+	}
+
+	st_affine3f_multiply_batch(skeleton->_inv_bind.data(), skeleton->_world.data(), skeleton->_skin.data(), joint_count);
+}
@@ -6,7 +6,10 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "math/st_mat4f.h"
+#include "math/st_affine3f.h"
+#include "math/st_qts.h"
+#include "math/st_quatf_soa.h"
+#include "math/st_vec3f_soa.h"
 
 #include <chrono>
 #include <climits>
@@ -16,25 +19,73 @@ struct st_joint
 {
 	char _name[32];
 
-	st_mat4f _world;
-	st_mat4f _inv_bind;
-	st_mat4f _skin;
-
 	uint32_t _parent = INT_MAX;
 };
 
+/*
+** Joints and their transforms, in parallel arrays indexed by joint.
+** A joint's parent always comes before it.
+*/
 struct st_skeleton
 {
 	static const uint32_t k_max_skeleton_joints = 75;
 
-	std::vector<st_joint*> _joints;
+	std::vector<st_joint> _joints;
+
+	std::vector<st_affine3f> _world;
+	std::vector<st_affine3f> _inv_bind;
+	std::vector<st_affine3f> _skin;
+
+	/*
+	** Add a joint with identity transforms.
+	** @param parent Index of the parent joint, or INT_MAX for a root.
+	** @returns The index of the new joint.
+	*/
+	uint32_t add_joint(const char* name, uint32_t parent);
 };
 
+/*
+** Local transform of every joint in a skeleton, stored by component so that
+** whole poses can be blended a register at a time.
+*/
 struct st_skeleton_pose
 {
-	std::vector<st_mat4f> _transforms;
+	st_quatf_soa _rotations;
+	st_vec3f_soa _translations;
+	std::vector<float> _scales;
+
+	/*
+	** Change the number of joints. New joints get the identity transform.
+	*/
+	void resize(int count);
+	int size() const { return _rotations.size(); }
+
+	st_qts get(int index) const;
+	void set(int index, const st_qts& transform);
+};
+
+enum e_st_pose_blend
+{
+	st_pose_blend_nlerp,
+	st_pose_blend_slerp,
 };
 
+/*
+** Blend two poses of the same skeleton; out may alias either input.
+** Rotations use the chosen interpolation; translation and scale are linear.
+*/
+void st_skeleton_pose_blend(
+	const st_skeleton_pose& a,
+	const st_skeleton_pose& b,
+	float t,
+	e_st_pose_blend mode,
+	st_skeleton_pose& out);
+
+/*
+** Compute world transforms and the skinning palette for a pose.
+*/
+void st_skeleton_apply_pose(st_skeleton* skeleton, const st_skeleton_pose& pose);
+
 struct st_animation
 {
 	float _length;
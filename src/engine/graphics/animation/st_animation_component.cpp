@@ -18,6 +18,8 @@ st_animation_component::st_animation_component(st_entity* ent, st_model_data* mo
 {
 	_skeleton = model->_skeleton;
 	assert(_skeleton != 0);
+
+	_blended_pose = new st_skeleton_pose();
 }
 
 st_animation_component::~st_animation_component()
@@ -28,6 +30,8 @@ st_animation_component::~st_animation_component()
 	{
 		delete _playing;
 	}
+
+	delete _blended_pose;
 }
 
 void st_animation_component::update(st_frame_params* params)
@@ -37,33 +41,28 @@ void st_animation_component::update(st_frame_params* params)
 		_playing->_time += std::chrono::duration_cast<std::chrono::milliseconds>(params->_delta_time);
 
 		float local_time = (_playing->_time.count() % 1000) / 1000.0f;
-		uint32_t frame = (uint32_t)(local_time * _playing->_animation->_rate);
+		float frame_position = local_time * _playing->_animation->_rate;
+		uint32_t frame = (uint32_t)frame_position;
+		float blend = frame_position - (float)frame;
 		// Safety.
 		frame = frame % _playing->_animation->_rate;
+		uint32_t next_frame = (frame + 1) % _playing->_animation->_rate;
 
-		// For now, no interpolation. Select the closest frame.
-		for (uint32_t joint_index = 0; joint_index < _skeleton->_joints.size(); ++joint_index)
-		{
-			st_joint* j = _skeleton->_joints[joint_index];
-
-			st_mat4f parent_matrix;
-			parent_matrix.make_identity();
-			if (j->_parent < INT_MAX)
-			{
-				parent_matrix = _skeleton->_joints[j->_parent]->_world;
-			}
-			j->_world = _playing->_animation->_poses[frame]._transforms[joint_index] * parent_matrix;
-			j->_skin = j->_inv_bind * j->_world;
-		}
+		// Blend the neighbouring frames, then rebuild the world transforms and skinning palette.
+		st_skeleton_pose_blend(
+			_playing->_animation->_poses[frame],
+			_playing->_animation->_poses[next_frame],
+			blend,
+			st_pose_blend_nlerp,
+			*_blended_pose);
+		st_skeleton_apply_pose(_skeleton, *_blended_pose);
 	}
 	
 #if DEBUG_DRAW_SKELETON
 	for (uint32_t joint_index = 0; joint_index < _skeleton->_joints.size(); ++joint_index)
 	{
-		st_joint* j = _skeleton->_joints[joint_index];
-
 		st_dynamic_drawcall drawcall;
-		draw_debug_sphere(0.4f, j->_world * get_entity()->get_transform(), &drawcall);
+		draw_debug_sphere(0.4f, (_skeleton->_world[joint_index] * get_entity()->get_transform()).to_mat4f(), &drawcall);
 
 		while (params->_dynamic_drawcall_lock.test_and_set(std::memory_order_acquire)) {}
 		params->_dynamic_drawcalls.push_back(drawcall);
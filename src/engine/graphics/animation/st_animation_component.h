@@ -26,4 +26,5 @@ public:
 private:
 	struct st_skeleton* _skeleton = 0;
 	struct st_animation_playback* _playing = 0;
+	struct st_skeleton_pose* _blended_pose = 0;
 };
@@ -6,4 +6,6 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-void draw_debug_sphere(float radius, const struct st_mat4f& transform, struct st_dynamic_drawcall* drawcall);
+#include <math/st_math_fwd.h>
+
+void draw_debug_sphere(float radius, const st_mat4f& transform, struct st_dynamic_drawcall* drawcall);
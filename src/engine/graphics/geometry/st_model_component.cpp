@@ -27,6 +27,12 @@ st_model_component::st_model_component(st_entity* entity, st_model_data* model,
 		(uint32_t)model->_vertices.size(),
 		&model->_indices[0],
 		(uint32_t)model->_indices.size());
+
+	_local_bounds.make_empty();
+	for (auto& v : model->_vertices)
+	{
+		_local_bounds.merge(v._position);
+	}
 }
 
 st_model_component::~st_model_component()
@@ -37,8 +43,10 @@ void st_model_component::update(st_frame_params* params)
 {
 	st_static_drawcall draw_call;
 	draw_call._name = "st_model_component";
-	draw_call._transform = get_entity()->get_transform();
+	draw_call._transform = get_entity()->get_transform().to_mat4f();
 	draw_call._material = _material.get();
+	draw_call._bounds = _local_bounds.transform(get_entity()->get_transform());
+	draw_call._has_bounds = true;
 	_geometry->draw(draw_call);
 	draw_call._draw_mode = st_primitive_topology_triangles;
 
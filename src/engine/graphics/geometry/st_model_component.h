@@ -8,6 +8,8 @@
 
 #include <entity/st_component.h>
 
+#include <math/st_aabb3f.h>
+
 #include <cstdint>
 #include <memory>
 
@@ -25,4 +27,7 @@ public:
 private:
 	std::unique_ptr<class st_material> _material = nullptr;
 	std::unique_ptr<class st_geometry> _geometry = nullptr;
+
+	// Bounds of the model's vertices, before the entity's transform.
+	st_aabb3f _local_bounds;
 };
@@ -13,7 +13,9 @@
 #include <graphics/geometry/st_vertex_attribute.h>
 #include <graphics/st_graphics.h>
 
+#include <math/st_affine3f.h>
 #include <math/st_mat4f.h>
+#include <math/st_qts.h>
 
 #include <cassert>
 #include <cstdint>
@@ -37,7 +39,7 @@ void parse_coordinate_system(std::ifstream &file, st_egg_parser_state* state);
 void parse_texture_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state);
 void parse_vertex_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state);
 void parse_poly_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state);
-void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state, uint32_t depth = 0);
+void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state, uint32_t parent = INT_MAX);
 void parse_joint_anim_data(std::ifstream &file, st_animation* animation, st_model_data* model, st_egg_parser_state* state, uint32_t depth = 0);
 
 void convert_vec3_z_up_to_y_up(st_vec3f& input)
@@ -47,19 +49,19 @@ void convert_vec3_z_up_to_y_up(st_vec3f& input)
 	input.y = -vz;
 }
 
-void convert_mat4_z_up_to_y_up(st_mat4f& input)
+static constexpr st_mat4f k_z_up_to_y_up =
 {
-	st_mat4f conversion;
-	float conv_data[4][4] =
 	{
 		{ 1.0f, 0.0f, 0.0f, 0.0f },
 		{ 0.0f, 0.0f, -1.0f, 0.0f },
 		{ 0.0f, 1.0f, 0.0f, 0.0f },
 		{ 0.0f, 0.0f, 0.0f, 1.0f },
-	};
-	memcpy(conversion.data, conv_data, sizeof(float) * 16);
+	}
+};
 
-	input *= conversion;
+void convert_mat4_z_up_to_y_up(st_mat4f& input)
+{
+	input *= k_z_up_to_y_up;
 
 	// Swap the z and y translations.
 	float tz = input.data[3][2];
@@ -296,20 +298,17 @@ void parse_poly_data(std::ifstream &file, st_model_data* model, st_egg_parser_st
 	}
 }
 
-void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state, uint32_t depth)
+void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_state* state, uint32_t parent)
 {
-	st_joint* j = new st_joint;
-	j->_parent = depth > 0 ? depth - 1 : INT_MAX;
-	// Push the joint now.
-	model->_skeleton->_joints.push_back(j);
+	st_skeleton* skeleton = model->_skeleton;
 
 	st_mat4f local_matrix;
 
 	char data[128];
 
-	// Get the name.
+	// Get the name, and push the joint now so that it precedes its children.
 	file >> data;
-	strcpy_s(j->_name, data);
+	uint32_t index = skeleton->add_joint(data, parent);
 
 	while (strcmp(data, "{") != 0)
 	{
@@ -342,14 +341,19 @@ void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_s
 			file >> data; local_matrix.data[3][2] = (float)atof(data);
 			file >> data; local_matrix.data[3][3] = (float)atof(data);
 
-			// Calculate the bind matrix by using the parent's.
-			st_mat4f parent_matrix;
-			parent_matrix.make_identity();
-			if (depth > 0)
+			// Egg matrices are written for row vectors, with the translation in the last row.
+			local_matrix.transpose();
+			st_affine3f local_transform;
+			local_transform.make_from_mat4f(local_matrix);
+
+			// Calculate the bind transform by using the parent's.
+			st_affine3f parent_transform;
+			parent_transform.make_identity();
+			if (parent < INT_MAX)
 			{
-				parent_matrix = model->_skeleton->_joints[depth - 1]->_world;
+				parent_transform = skeleton->_world[parent];
 			}
-			j->_world = local_matrix * parent_matrix;
+			skeleton->_world[index] = local_transform * parent_transform;
 
 			file >> data; open_parens -= 1;
 			file >> data; open_parens -= 1;
@@ -384,7 +388,7 @@ void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_s
 
 				if (joint_index < st_vertex::k_max_joint_weights)
 				{
-					vertex->_joints[joint_index] = depth;
+					vertex->_joints[joint_index] = index;
 					vertex->_weights[joint_index] = influence;
 				}
 				else
@@ -395,7 +399,7 @@ void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_s
 		}
 		else if (strcmp(data, "<Joint>") == 0)
 		{
-			parse_joint_data(file, model, state, depth + 1);
+			parse_joint_data(file, model, state, index);
 		}
 		else if (strcmp(data, "{") == 0)
 		{
@@ -408,9 +412,8 @@ void parse_joint_data(std::ifstream &file, st_model_data* model, st_egg_parser_s
 	}
 
 	// Calculate the inverse bind matrix.
-	j->_inv_bind = j->_world;
-	j->_inv_bind.invert();
-	j->_skin = j->_inv_bind * j->_world;
+	skeleton->_inv_bind[index] = skeleton->_world[index].inverse();
+	skeleton->_skin[index] = skeleton->_inv_bind[index] * skeleton->_world[index];
 }
 
 void egg_to_animation(const char* filename, st_animation* animation, st_model_data* model)
@@ -638,22 +641,21 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 				}
 			}
 
-			// Pre-fill the animation's poses transform vectors. We may not be doing successive
-			// insertion as the joint hierarchy is not guaranteed to be identical.
+			// Size each pose to the skeleton the first time through, with identity transforms.
+			// We may not be doing successive insertion as the joint hierarchy is not guaranteed to be identical.
 			for (uint32_t frame = 0; frame < animation->_rate; ++frame)
 			{
-				for (uint32_t joint = 0; joint < model->_skeleton->_joints.size(); ++joint)
+				if (animation->_poses[frame].size() == 0)
 				{
-					st_mat4f identity;
-					identity.make_identity();
-					animation->_poses[frame]._transforms.push_back(identity);
+					animation->_poses[frame].resize(int(model->_skeleton->_joints.size()));
 				}
 			}
 
-			// Now, take all the data for each frame and create transform matrices.
+			// Now, take all the data for each frame and create pose transforms.
+			// Scales apply before the pose so far; rotations and translations after it.
 			for (uint32_t frame = 0; frame < animation->_rate; ++frame)
 			{
-				st_mat4f pose;
+				st_qts pose;
 				pose.make_identity();
 
 				for (int i = 0; i < strlen(order); ++i)
@@ -661,7 +663,7 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 					if (order[i] == 's' && scale_x.size() > 0)
 					{
 						float value = scale_x[frame % scale_x.size()];
-						pose.scale(value);
+						pose.scale *= value;
 					}
 					else if (order[i] == 'r' && rotate_r.size() > 0)
 					{
@@ -675,7 +677,7 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 						}
 
 						rotation.make_axis_angle(rotation_axis, st_degrees_to_radians(value));
-						pose.rotate(rotation);
+						pose *= st_qts{ rotation, st_vec3f::zero_vector(), 1.0f };
 					}
 					else if (order[i] == 'p' && rotate_p.size() > 0)
 					{
@@ -689,7 +691,7 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 						}
 
 						rotation.make_axis_angle(rotation_axis, st_degrees_to_radians(value));
-						pose.rotate(rotation);
+						pose *= st_qts{ rotation, st_vec3f::zero_vector(), 1.0f };
 					}
 					else if (order[i] == 'h' && rotate_h.size() > 0)
 					{
@@ -703,7 +705,7 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 						}
 
 						rotation.make_axis_angle(rotation_axis, st_degrees_to_radians(value));
-						pose.rotate(rotation);
+						pose *= st_qts{ rotation, st_vec3f::zero_vector(), 1.0f };
 					}
 					else if (order[i] == 't')
 					{
@@ -713,7 +715,7 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 
 						st_vec3f translation = { x_value, y_value, z_value };
 
-						pose.translate(translation);
+						pose.translation += translation;
 					}
 				}
 
@@ -721,13 +723,16 @@ void parse_joint_anim_data(std::ifstream& file, st_animation* animation, st_mode
 				uint32_t j_index = 0;
 				for (j_index = 0; j_index < model->_skeleton->_joints.size(); ++j_index)
 				{
-					if (strcmp(joint_name, model->_skeleton->_joints[j_index]->_name) == 0)
+					if (strcmp(joint_name, model->_skeleton->_joints[j_index]._name) == 0)
 					{
 						break;
 					}
 				}
 
-				animation->_poses[frame]._transforms[j_index] = pose;
+				if (j_index < model->_skeleton->_joints.size())
+				{
+					animation->_poses[frame].set(int(j_index), pose);
+				}
 			}
 		}
 		else if (strcmp(data, "<Table>") == 0)
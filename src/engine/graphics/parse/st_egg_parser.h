@@ -6,6 +6,8 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include <math/st_math_fwd.h>
+
 #include <cstdint>
 #include <functional>
 
@@ -18,8 +20,8 @@ struct st_egg_parser_state
 {
 	uint32_t _first_vertex_index = k_invalid_vertex_index;
 	uint32_t _vertex_format = 0;
-	std::function<void(struct st_vec3f&)> _vector_coordinate_conversion;
-	std::function<void(struct st_mat4f&)> _matrix_coordinate_conversion;
+	std::function<void(st_vec3f&)> _vector_coordinate_conversion;
+	std::function<void(st_mat4f&)> _matrix_coordinate_conversion;
 };
 
 /*
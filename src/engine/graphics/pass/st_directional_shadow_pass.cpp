@@ -17,6 +17,7 @@
 #include <graphics/st_render_marker.h>
 #include <graphics/st_render_texture.h>
 
+#include <math/st_frustum.h>
 #include <math/st_mat4f.h>
 #include <math/st_vec3f.h>
 
@@ -60,8 +61,19 @@ void st_directional_shadow_pass::render(st_command_list* command_list, const st_
 
 	command_list->begin_render_pass(_pass.get(), _framebuffer.get(), clears, std::size(clears));
 
-	for (auto& d : params->_static_drawcalls)
+	// Only geometry inside the shadow map's volume can cast into it.
+	st_frustum frustum;
+	frustum.make_from_view_projection(params->_sun_view * params->_sun_projection);
+	st_cull_static_drawcalls(frustum, params->_static_drawcalls, _visible);
+
+	for (size_t i = 0; i < params->_static_drawcalls.size(); ++i)
 	{
+		if (!_visible[i])
+		{
+			continue;
+		}
+
+		const st_static_drawcall& d = params->_static_drawcalls[i];
 		st_render_marker draw_marker(command_list, d._name.c_str());
 
 		if (d._material->supports_pass(e_st_render_pass_type::shadow))
@@ -6,7 +6,9 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 /*
 ** A render pass that draws the static scene objects to the gbuffer.
@@ -26,4 +28,6 @@ private:
 
 	std::unique_ptr<struct st_render_pass> _pass = nullptr;
 	std::unique_ptr<struct st_framebuffer> _framebuffer = nullptr;
+
+	std::vector<uint8_t> _visible;
 };
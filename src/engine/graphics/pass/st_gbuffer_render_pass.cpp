@@ -16,6 +16,8 @@
 #include <graphics/st_render_marker.h>
 #include <graphics/st_render_texture.h>
 
+#include <math/st_frustum.h>
+
 #include <cassert>
 
 st_gbuffer_render_pass::st_gbuffer_render_pass(
@@ -85,9 +87,19 @@ void st_gbuffer_render_pass::render(st_command_list* command_list, const st_fram
 
 	command_list->begin_render_pass(_pass.get(), _framebuffer.get(), clears, std::size(clears));
 
-	// Draw all static geometry.
-	for (auto& d : params->_static_drawcalls)
+	// Draw the static geometry inside the camera's frustum.
+	st_frustum frustum;
+	frustum.make_from_view_projection(params->_view * params->_projection);
+	st_cull_static_drawcalls(frustum, params->_static_drawcalls, _visible);
+
+	for (size_t i = 0; i < params->_static_drawcalls.size(); ++i)
 	{
+		if (!_visible[i])
+		{
+			continue;
+		}
+
+		const st_static_drawcall& d = params->_static_drawcalls[i];
 		st_render_marker draw_marker(command_list, d._name.c_str());
 
 		if (!d._material)
@@ -96,8 +96,8 @@ void st_ui_render_pass::render(st_command_list* command_list, const st_frame_par
 void st_ui_render_pass::draw_dynamic(
 	st_command_list* command_list,
 	const st_frame_params* params,
-	const struct st_mat4f& proj,
-	const struct st_mat4f& view)
+	const st_mat4f& proj,
+	const st_mat4f& view)
 {
 	command_list->set_scissor(0, 0, params->_width, params->_height);
 
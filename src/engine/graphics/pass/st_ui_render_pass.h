@@ -8,6 +8,8 @@
 
 #include <graphics/st_graphics.h>
 
+#include <math/st_math_fwd.h>
+
 #include <memory>
 
 /*
@@ -27,8 +29,8 @@ private:
 	void draw_dynamic(
 		class st_command_list* command_list,
 		const struct st_frame_params* params,
-		const struct st_mat4f& proj,
-		const struct st_mat4f& view);
+		const st_mat4f& proj,
+		const st_mat4f& view);
 
 	std::unique_ptr<class st_constant_color_material> _default_material = nullptr;
 	std::unique_ptr<struct st_pipeline> _default_state = nullptr;
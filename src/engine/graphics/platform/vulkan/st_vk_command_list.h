@@ -73,8 +73,8 @@ private:
 	// Dynamic geometry buffers.
 	struct st_vk_procedural_vertex
 	{
-		struct st_vec3f _pos;
-		struct st_vec3f _color;
+		st_vec3f _pos;
+		st_vec3f _color;
 	};
 	std::unique_ptr<st_buffer> _dynamic_vertex_buffer = nullptr;
 	std::unique_ptr<st_buffer> _dynamic_index_buffer = nullptr;
@@ -0,0 +1,39 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <graphics/st_drawcall.h>
+
+#include <math/st_frustum.h>
+
+void st_cull_static_drawcalls(
+	const st_frustum& frustum,
+	const std::vector<st_static_drawcall>& drawcalls,
+	std::vector<uint8_t>& out_visible)
+{
+	out_visible.resize(drawcalls.size());
+
+	// Stands in for draw calls without bounds, whose results are ignored.
+	st_aabb3f placeholder;
+	placeholder.make_from_center(st_vec3f::zero_vector(), st_vec3f::zero_vector());
+
+	for (size_t i = 0; i < drawcalls.size(); i += 8)
+	{
+		int count = drawcalls.size() - i < 8 ? int(drawcalls.size() - i) : 8;
+
+		st_aabb3f boxes[8];
+		for (int b = 0; b < count; ++b)
+		{
+			const st_static_drawcall& drawcall = drawcalls[i + b];
+			boxes[b] = drawcall._has_bounds ? drawcall._bounds : placeholder;
+		}
+
+		uint32_t visible = frustum.intersects8(boxes, count);
+		for (int b = 0; b < count; ++b)
+		{
+			out_visible[i + b] = !drawcalls[i + b]._has_bounds || ((visible >> b) & 1u) ? 1 : 0;
+		}
+	}
+}
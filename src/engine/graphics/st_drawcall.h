@@ -8,6 +8,7 @@
 
 #include <graphics/st_graphics.h>
 
+#include <math/st_aabb3f.h>
 #include <math/st_mat4f.h>
 #include <math/st_vec2f.h>
 #include <math/st_vec3f.h>
@@ -43,8 +44,22 @@ struct st_static_drawcall : st_drawcall
 	size_t _index_offset = 0;
 
 	uint32_t _index_count = 0;
+
+	// World space bounds, used for culling when present.
+	st_aabb3f _bounds;
+	bool _has_bounds = false;
 };
 
+/*
+** Test static draw calls against a view frustum, eight at a time.
+** Draw calls without bounds are always visible.
+** @param out_visible Resized to match, receiving 1 for each visible draw call.
+*/
+void st_cull_static_drawcalls(
+	const struct st_frustum& frustum,
+	const std::vector<st_static_drawcall>& drawcalls,
+	std::vector<uint8_t>& out_visible);
+
 /*
 ** Draw call with procedural geometry.
 ** Geometry referenced by this draw call should only last a single frame.
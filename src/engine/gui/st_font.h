@@ -7,6 +7,7 @@
 */
 
 #include "graphics/material/st_material.h"
+#include "math/st_math_fwd.h"
 #include "math/st_vec3f.h"
 
 #include <memory>
@@ -28,9 +29,9 @@ public:
 		const char* text,
 		float x,
 		float y,
-		const struct st_vec3f& color,
-		struct st_vec2f* extent_min = nullptr,
-		struct st_vec2f* extent_max = nullptr);
+		const st_vec3f& color,
+		st_vec2f* extent_min = nullptr,
+		st_vec2f* extent_max = nullptr);
 
 private:
 	std::unique_ptr<struct st_texture> _texture;
@@ -56,11 +57,11 @@ public:
 		class st_command_list* command_list,
 		enum e_st_render_pass_type pass_type,
 		const struct st_frame_params* params,
-		const struct st_mat4f& proj,
-		const struct st_mat4f& view,
-		const struct st_mat4f& transform) override;
+		const st_mat4f& proj,
+		const st_mat4f& view,
+		const st_mat4f& transform) override;
 
-	void set_color(const struct st_vec3f& color) override { _color = color; }
+	void set_color(const st_vec3f& color) override { _color = color; }
 
 	struct st_font_cb
 	{
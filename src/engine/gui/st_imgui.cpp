@@ -17,6 +17,9 @@
 
 #include <gui/imgui_impl_stratos.h>
 
+#include <jobs/st_job.h>
+#include <jobs/st_trace.h>
+
 #include <math/st_mat4f.h>
 #include <math/st_vec4f.h>
 
@@ -87,6 +90,55 @@ void st_imgui::update(st_frame_params* params, st_sim* sim, st_camera* camera)
 		ImGui::Text("Graphics API: %s", api.c_str());
 	}
 
+	if (ImGui::CollapsingHeader("Job System"))
+	{
+		st_job_frame_stats_t stats = st_job::get_frame_stats();
+
+		float total_ms = std::chrono::duration<float, std::milli>(stats._critical_wait_total).count();
+		float max_ms = std::chrono::duration<float, std::milli>(stats._critical_wait_max).count();
+		float average_ms = stats._critical_job_count > 0 ? total_ms / stats._critical_job_count : 0.0f;
+
+		ImGui::Text("Critical jobs: %u", stats._critical_job_count);
+		ImGui::Text("Critical queue wait (avg): %.3f ms", average_ms);
+		ImGui::Text("Critical queue wait (max): %.3f ms", max_ms);
+
+		st_job_fiber_stats_t fiber_stats = st_job::get_fiber_stats();
+
+		const char* k_class_names[] = { "Small", "Large" };
+		for (int i = 0; i < st_job_stack_size_count; ++i)
+		{
+			const st_job_fiber_pool_stats_t& pool = fiber_stats._pools[i];
+			ImGui::Text(
+				"%s fibers: %d in use, %d peak, %d/%d created",
+				k_class_names[i],
+				pool._in_use_count,
+				pool._peak_in_use_count,
+				pool._created_count,
+				pool._max_count);
+			ImGui::Text(
+				"%s stack high water: %zu/%zu KB",
+				k_class_names[i],
+				pool._stack_high_water / 1024,
+				pool._stack_size / 1024);
+		}
+		ImGui::Text("Fiber allocation failures: %u", fiber_stats._starved_count);
+
+#if ST_TRACE_ENABLED
+		bool tracing = st_trace::is_enabled();
+		if (ImGui::Checkbox("Record Trace", &tracing))
+		{
+			st_trace::set_enabled(tracing);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Save Trace"))
+		{
+			extern char g_root_path[256];
+			std::string path = std::string(g_root_path) + "stratos_trace.json";
+			st_trace::write_chrome_trace(path.c_str());
+		}
+#endif
+	}
+
 	camera->debug();
 	sim->debug();
 
@@ -30,9 +30,9 @@ protected:
 	static const float k_button_offset;
 	static const float k_checkbox_offset;
 
-	void draw_outline(struct st_frame_params* params, const struct st_vec2f& min, const struct st_vec2f& max, const struct st_vec3f& color, float offset);
-	void draw_check(struct st_frame_params* params, const struct st_vec2f& min, const struct st_vec2f& max, const struct st_vec3f& color);
-	void draw_fill(struct st_frame_params* params, const struct st_vec2f& min, const struct st_vec2f& max, const struct st_vec3f& color);
+	void draw_outline(struct st_frame_params* params, const st_vec2f& min, const st_vec2f& max, const st_vec3f& color, float offset);
+	void draw_check(struct st_frame_params* params, const st_vec2f& min, const st_vec2f& max, const st_vec3f& color);
+	void draw_fill(struct st_frame_params* params, const st_vec2f& min, const st_vec2f& max, const st_vec3f& color);
 
 private:
 	std::vector<std::unique_ptr<st_constant_color_material>> _materials;
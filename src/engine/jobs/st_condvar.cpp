@@ -6,7 +6,7 @@
 
 #include "st_condvar.h"
 
-st_condvar::st_condvar()
+st_condvar::st_condvar() : _epoch(0), _waiter_count(0)
 {
 }
 
@@ -14,19 +14,38 @@ st_condvar::~st_condvar()
 {
 }
 
-void st_condvar::wait()
+uint64_t st_condvar::prepare_wait()
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	_condvar.wait(lock);
+	_waiter_count.fetch_add(1);
+	return _epoch.load();
 }
 
-void st_condvar::wait_for(int ms)
+void st_condvar::cancel_wait()
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	_condvar.wait_for(lock, std::chrono::milliseconds(ms));
+	_waiter_count.fetch_sub(1);
+}
+
+void st_condvar::wait(uint64_t token)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_condvar.wait(lock, [this, token]() { return _epoch.load() != token; });
+	}
+	_waiter_count.fetch_sub(1);
 }
 
 void st_condvar::wake_all()
 {
+	/* Order whatever the caller published before the check for waiters. */
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_waiter_count.load() == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_epoch.fetch_add(1);
+	}
 	_condvar.notify_all();
 }
@@ -6,11 +6,22 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 
 /*
 ** Condition variable object.
+**
+** Waiting is split in two so that a wake can't be lost between checking for
+** work and going to sleep:
+**
+**	uint64_t token = condvar.prepare_wait();
+**	if (nothing_to_do) condvar.wait(token);
+**	else condvar.cancel_wait();
+**
+** Any wake_all after prepare_wait makes the following wait return immediately.
 */
 class st_condvar
 {
@@ -18,11 +29,19 @@ public:
 	st_condvar();
 	~st_condvar();
 
-	void wait();
-	void wait_for(int ms);
+	uint64_t prepare_wait();
+	void cancel_wait();
+	void wait(uint64_t token);
+
+	/*
+	** Cheap when nothing is waiting; only takes the mutex if a waiter is registered.
+	*/
 	void wake_all();
 
 private:
 	std::condition_variable _condvar;
 	std::mutex _mutex;
+
+	std::atomic<uint64_t> _epoch;
+	std::atomic<int> _waiter_count;
 };
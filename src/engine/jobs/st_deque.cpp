@@ -0,0 +1,136 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_deque.h"
+
+#include <atomic>
+#include <cstdint>
+
+struct st_deque_impl_t
+{
+	/* Top is written by thieves, bottom by the owner. Keep them on separate cache lines. */
+	alignas(64) std::atomic<int64_t> _top;
+	alignas(64) std::atomic<int64_t> _bottom;
+
+	alignas(64) int64_t _mask;
+	std::atomic<void*>* _slots;
+};
+
+st_deque::st_deque(int capacity)
+{
+	auto impl = new st_deque_impl_t;
+
+	/* Round the capacity up to a power of two so indices can wrap with a mask. */
+	int64_t size = 1;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+
+	impl->_top = 0;
+	impl->_bottom = 0;
+	impl->_mask = size - 1;
+	impl->_slots = new std::atomic<void*>[size];
+
+	_impl = impl;
+}
+
+st_deque::~st_deque()
+{
+	st_deque_impl_t* impl = static_cast<st_deque_impl_t*>(_impl);
+	delete[] impl->_slots;
+	delete impl;
+}
+
+bool st_deque::push(void* data)
+{
+	st_deque_impl_t* impl = static_cast<st_deque_impl_t*>(_impl);
+
+	int64_t bottom = impl->_bottom.load(std::memory_order_relaxed);
+	int64_t top = impl->_top.load(std::memory_order_acquire);
+	if (bottom - top > impl->_mask)
+	{
+		return false;
+	}
+
+	impl->_slots[bottom & impl->_mask].store(data, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	impl->_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+	return true;
+}
+
+bool st_deque::pop(void** data)
+{
+	st_deque_impl_t* impl = static_cast<st_deque_impl_t*>(_impl);
+
+	/* Reserve the bottom element before looking at top, so a thief can't also take it. */
+	int64_t bottom = impl->_bottom.load(std::memory_order_relaxed) - 1;
+	impl->_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = impl->_top.load(std::memory_order_relaxed);
+
+	/* Empty. Restore bottom. */
+	if (top > bottom)
+	{
+		impl->_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	*data = impl->_slots[bottom & impl->_mask].load(std::memory_order_relaxed);
+
+	/* More than one element left, the thieves can't reach this one. */
+	if (top < bottom)
+	{
+		return true;
+	}
+
+	/* Last element. Race any thieves for it through top. */
+	bool won = impl->_top.compare_exchange_strong(
+		top,
+		top + 1,
+		std::memory_order_seq_cst,
+		std::memory_order_relaxed);
+	impl->_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+	return won;
+}
+
+bool st_deque::steal(void** data)
+{
+	st_deque_impl_t* impl = static_cast<st_deque_impl_t*>(_impl);
+
+	int64_t top = impl->_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = impl->_bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return false;
+	}
+
+	void* stolen = impl->_slots[top & impl->_mask].load(std::memory_order_relaxed);
+	if (!impl->_top.compare_exchange_strong(
+		top,
+		top + 1,
+		std::memory_order_seq_cst,
+		std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	*data = stolen;
+	return true;
+}
+
+int st_deque::get_count() const
+{
+	st_deque_impl_t* impl = static_cast<st_deque_impl_t*>(_impl);
+
+	int64_t bottom = impl->_bottom.load(std::memory_order_relaxed);
+	int64_t top = impl->_top.load(std::memory_order_relaxed);
+	return bottom > top ? int(bottom - top) : 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Bounded, lock-free work-stealing deque.
+** The owning thread pushes and pops at the bottom (LIFO); any other thread may
+** steal from the top (FIFO).
+** https://www.di.ens.fr/~zappa/readings/ppopp13.pdf
+*/
+class st_deque
+{
+public:
+	st_deque(int capacity);
+	~st_deque();
+
+	/*
+	** Owner only. Fails if the deque is full.
+	*/
+	bool push(void* data);
+
+	/*
+	** Owner only. Removes the most recently pushed element.
+	*/
+	bool pop(void** data);
+
+	/*
+	** Any thread. Removes the oldest element. May fail spuriously when racing
+	** with the owner or another thief.
+	*/
+	bool steal(void** data);
+
+	int get_count() const;
+
+private:
+	void* _impl;
+};
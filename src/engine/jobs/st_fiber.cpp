@@ -6,24 +6,66 @@
 
 #include "st_fiber.h"
 
+#if defined(ST_WINDOWS)
+
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #undef WIN32_LEAN_AND_MEAN
 
+struct st_fiber_impl_t
+{
+	LPVOID _fiber;
+
+	st_fiber::function_t _func;
+	void* _data;
+
+	/* Address near the top of the fiber's stack, recorded when it first runs. */
+	void* _stack_top;
+
+	bool _converted;
+};
+
+static void WINAPI _st_fiber_entry(LPVOID param)
+{
+	st_fiber_impl_t* impl = static_cast<st_fiber_impl_t*>(param);
+
+	char top;
+	impl->_stack_top = &top;
+
+	impl->_func(impl->_data);
+}
+
 st_fiber::st_fiber(function_t func, void* func_data, size_t stack_size)
 {
 	const size_t k_stack_align = 64 * 1024;
 	stack_size = stack_size > k_stack_align ? stack_size : k_stack_align;
 	stack_size = (stack_size + k_stack_align - 1) & ~(k_stack_align - 1);
 
-	_impl = CreateFiber(stack_size, (LPFIBER_START_ROUTINE)func, func_data);
+	auto impl = new st_fiber_impl_t;
+	impl->_func = func;
+	impl->_data = func_data;
+	impl->_stack_top = nullptr;
+	impl->_converted = false;
+	/* Reserve the full stack but commit on demand, so the committed size tracks use. */
+	impl->_fiber = CreateFiberEx(0, stack_size, FIBER_FLAG_FLOAT_SWITCH, _st_fiber_entry, impl);
+
+	_impl = impl;
 }
 
 st_fiber::~st_fiber()
 {
-	if (_impl)
+	st_fiber_impl_t* impl = static_cast<st_fiber_impl_t*>(_impl);
+	if (impl)
 	{
-		DeleteFiber(_impl);
+		if (impl->_converted)
+		{
+			ConvertFiberToThread();
+		}
+		else
+		{
+			DeleteFiber(impl->_fiber);
+		}
+		delete impl;
 	}
 }
 
@@ -39,17 +81,48 @@ st_fiber& st_fiber::operator=(st_fiber&& other)
 
 st_fiber st_fiber::convert_thread(void* data)
 {
+	auto impl = new st_fiber_impl_t;
+	impl->_func = nullptr;
+	impl->_data = data;
+	impl->_stack_top = nullptr;
+	impl->_converted = true;
+	impl->_fiber = ConvertThreadToFiber(impl);
+
 	st_fiber fiber;
-	fiber._impl = ConvertThreadToFiber(data);
+	fiber._impl = impl;
 	return fiber;
 }
 
 void st_fiber::switch_to(const st_fiber& fiber)
 {
-	SwitchToFiber(fiber._impl);
+	SwitchToFiber(static_cast<st_fiber_impl_t*>(fiber._impl)->_fiber);
 }
 
 void* st_fiber::get_data()
 {
-	return GetFiberData();
+	return static_cast<st_fiber_impl_t*>(GetFiberData())->_data;
 }
+
+size_t st_fiber::get_stack_high_water() const
+{
+	st_fiber_impl_t* impl = static_cast<st_fiber_impl_t*>(_impl);
+	if (!impl || !impl->_stack_top)
+	{
+		return 0;
+	}
+
+	/*
+	** Fiber stacks are committed a page at a time as they grow, and never
+	** decommitted. The committed region below the top is the high-water mark.
+	*/
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(impl->_stack_top, &info, sizeof(info));
+	return static_cast<char*>(impl->_stack_top) - static_cast<char*>(info.BaseAddress);
+}
+
+const char* st_fiber::get_backend_name()
+{
+	return "win32";
+}
+
+#endif
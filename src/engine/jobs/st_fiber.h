@@ -8,6 +8,8 @@
 
 #include "framework/st_compiler_defines.h"
 
+#include <cstddef>
+
 #if defined(ST_MINGW)
 #include <sys/types.h>
 #endif
@@ -15,6 +17,10 @@
 /*
 ** A fiber object.
 ** This the execution context for a thread including the registers and stack.
+**
+** On Windows this wraps the native fiber API. On POSIX platforms the context
+** switch is done by a small assembly stub (x86-64 and AArch64), falling back
+** to ucontext elsewhere or when ST_FIBER_UCONTEXT is defined.
 */
 class st_fiber
 {
@@ -32,6 +38,17 @@ public:
 	static void switch_to(const st_fiber& fiber);
 	static void* get_data();
 
+	/*
+	** Approximate number of bytes of stack this fiber has touched so far, at
+	** page granularity. Safe to call on a fiber running on another thread.
+	*/
+	size_t get_stack_high_water() const;
+
+	/*
+	** Name of the context switch implementation compiled in.
+	*/
+	static const char* get_backend_name();
+
 private:
 	void* _impl;
 };
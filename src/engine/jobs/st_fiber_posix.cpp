@@ -0,0 +1,370 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_fiber.h"
+
+#if defined(ST_POSIX)
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if !defined(ST_FIBER_UCONTEXT) && !(defined(ST_LINUX) && (defined(ST_X64) || defined(ST_ARM64)))
+#define ST_FIBER_UCONTEXT
+#endif
+
+#if defined(ST_FIBER_UCONTEXT)
+#include <ucontext.h>
+#endif
+
+struct st_fiber_impl_t
+{
+	/* Saved stack pointer of a suspended fiber, used by the assembly backend. */
+	void* _stack_pointer;
+
+#if defined(ST_FIBER_UCONTEXT)
+	ucontext_t _context;
+#endif
+
+	st_fiber::function_t _func;
+	void* _data;
+
+	/* Mapping for the stack, including the guard page at its lowest address. */
+	void* _stack;
+	size_t _stack_size;
+};
+
+/*
+** The fiber currently running on this thread.
+** Fibers may resume on a different thread than the one they were suspended
+** on, so this must only ever be read through the out-of-line accessors below.
+*/
+static thread_local st_fiber_impl_t* _st_fiber_current = nullptr;
+
+extern "C" void st_fiber_start(st_fiber_impl_t* impl)
+{
+	impl->_func(impl->_data);
+
+	/* Fiber functions must switch away rather than return. */
+	abort();
+}
+
+#if !defined(ST_FIBER_UCONTEXT)
+
+/*
+** Saves the callee-saved registers on the current stack, stores the stack
+** pointer in from_sp, then restores the registers saved on to_sp and returns
+** into that context.
+*/
+extern "C" void st_fiber_switch_context(void** from_sp, void* to_sp);
+
+/*
+** First code run by a new fiber. The fiber impl is passed in a callee-saved
+** register seeded by _st_fiber_init_stack.
+*/
+extern "C" void st_fiber_entry_trampoline();
+
+#if defined(ST_X64)
+
+/*
+** Frame layout, from the saved stack pointer up:
+** mxcsr/x87 control word, r15, r14, r13, r12, rbx, rbp, return address.
+*/
+asm(
+	".text\n"
+	".globl st_fiber_switch_context\n"
+	".type st_fiber_switch_context, %function\n"
+	"st_fiber_switch_context:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	subq $8, %rsp\n"
+	"	stmxcsr (%rsp)\n"
+	"	fnstcw 4(%rsp)\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	ldmxcsr (%rsp)\n"
+	"	fldcw 4(%rsp)\n"
+	"	addq $8, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	".size st_fiber_switch_context, .-st_fiber_switch_context\n"
+
+	".globl st_fiber_entry_trampoline\n"
+	".type st_fiber_entry_trampoline, %function\n"
+	"st_fiber_entry_trampoline:\n"
+	"	movq %r12, %rdi\n"
+	"	call st_fiber_start\n"
+	"	ud2\n"
+	".size st_fiber_entry_trampoline, .-st_fiber_entry_trampoline\n"
+);
+
+static const size_t k_st_fiber_frame_size = 8 * 8;
+
+static void _st_fiber_init_stack(st_fiber_impl_t* impl, uintptr_t top)
+{
+	/* Leave the trampoline with a 16 byte aligned stack, as if it had been called. */
+	uint64_t* frame = reinterpret_cast<uint64_t*>(top - 16 - k_st_fiber_frame_size);
+	frame[0] = 0x037f00001f80ull;
+	frame[1] = 0;
+	frame[2] = 0;
+	frame[3] = 0;
+	frame[4] = reinterpret_cast<uint64_t>(impl);
+	frame[5] = 0;
+	frame[6] = 0;
+	frame[7] = reinterpret_cast<uint64_t>(&st_fiber_entry_trampoline);
+
+	impl->_stack_pointer = frame;
+}
+
+#elif defined(ST_ARM64)
+
+/*
+** Frame layout, from the saved stack pointer up:
+** x19-x28, x29 (frame pointer), x30 (link register), d8-d15, padding.
+*/
+asm(
+	".text\n"
+	".globl st_fiber_switch_context\n"
+	".type st_fiber_switch_context, %function\n"
+	"st_fiber_switch_context:\n"
+	"	sub sp, sp, #176\n"
+	"	stp x19, x20, [sp, #0]\n"
+	"	stp x21, x22, [sp, #16]\n"
+	"	stp x23, x24, [sp, #32]\n"
+	"	stp x25, x26, [sp, #48]\n"
+	"	stp x27, x28, [sp, #64]\n"
+	"	stp x29, x30, [sp, #80]\n"
+	"	stp d8, d9, [sp, #96]\n"
+	"	stp d10, d11, [sp, #112]\n"
+	"	stp d12, d13, [sp, #128]\n"
+	"	stp d14, d15, [sp, #144]\n"
+	"	mov x2, sp\n"
+	"	str x2, [x0]\n"
+	"	mov sp, x1\n"
+	"	ldp x19, x20, [sp, #0]\n"
+	"	ldp x21, x22, [sp, #16]\n"
+	"	ldp x23, x24, [sp, #32]\n"
+	"	ldp x25, x26, [sp, #48]\n"
+	"	ldp x27, x28, [sp, #64]\n"
+	"	ldp x29, x30, [sp, #80]\n"
+	"	ldp d8, d9, [sp, #96]\n"
+	"	ldp d10, d11, [sp, #112]\n"
+	"	ldp d12, d13, [sp, #128]\n"
+	"	ldp d14, d15, [sp, #144]\n"
+	"	add sp, sp, #176\n"
+	"	ret\n"
+	".size st_fiber_switch_context, .-st_fiber_switch_context\n"
+
+	".globl st_fiber_entry_trampoline\n"
+	".type st_fiber_entry_trampoline, %function\n"
+	"st_fiber_entry_trampoline:\n"
+	"	mov x0, x19\n"
+	"	bl st_fiber_start\n"
+	"	brk #0\n"
+	".size st_fiber_entry_trampoline, .-st_fiber_entry_trampoline\n"
+);
+
+static const size_t k_st_fiber_frame_size = 176;
+
+static void _st_fiber_init_stack(st_fiber_impl_t* impl, uintptr_t top)
+{
+	uint64_t* frame = reinterpret_cast<uint64_t*>(top - k_st_fiber_frame_size);
+	for (size_t i = 0; i < k_st_fiber_frame_size / sizeof(uint64_t); ++i)
+	{
+		frame[i] = 0;
+	}
+	frame[0] = reinterpret_cast<uint64_t>(impl);
+	frame[11] = reinterpret_cast<uint64_t>(&st_fiber_entry_trampoline);
+
+	impl->_stack_pointer = frame;
+}
+
+#endif
+
+#else
+
+static void _st_fiber_ucontext_entry(int lo, int hi)
+{
+	/* makecontext only passes ints, so the impl pointer arrives split in two. */
+	uintptr_t bits = (uintptr_t(uint32_t(hi)) << 32) | uintptr_t(uint32_t(lo));
+	st_fiber_start(reinterpret_cast<st_fiber_impl_t*>(bits));
+}
+
+#endif
+
+st_fiber::st_fiber(function_t func, void* func_data, size_t stack_size)
+{
+	const size_t k_stack_align = 64 * 1024;
+	stack_size = stack_size > k_stack_align ? stack_size : k_stack_align;
+	stack_size = (stack_size + k_stack_align - 1) & ~(k_stack_align - 1);
+
+	/* Reserve one extra page below the stack and protect it, so overflow faults. */
+	const size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+
+	auto impl = new st_fiber_impl_t;
+	impl->_func = func;
+	impl->_data = func_data;
+	impl->_stack_size = stack_size + page_size;
+	impl->_stack = mmap(
+		nullptr,
+		impl->_stack_size,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS,
+		-1,
+		0);
+	assert(impl->_stack != MAP_FAILED);
+	mprotect(impl->_stack, page_size, PROT_NONE);
+
+	uintptr_t top = reinterpret_cast<uintptr_t>(impl->_stack) + impl->_stack_size;
+	top &= ~uintptr_t(15);
+
+#if defined(ST_FIBER_UCONTEXT)
+	getcontext(&impl->_context);
+	impl->_context.uc_stack.ss_sp = static_cast<char*>(impl->_stack) + page_size;
+	impl->_context.uc_stack.ss_size = stack_size;
+	impl->_context.uc_link = nullptr;
+
+	uintptr_t bits = reinterpret_cast<uintptr_t>(impl);
+	makecontext(
+		&impl->_context,
+		reinterpret_cast<void(*)()>(_st_fiber_ucontext_entry),
+		2,
+		int(uint32_t(bits)),
+		int(uint32_t(uint64_t(bits) >> 32)));
+	impl->_stack_pointer = nullptr;
+#else
+	_st_fiber_init_stack(impl, top);
+#endif
+
+	_impl = impl;
+}
+
+st_fiber::~st_fiber()
+{
+	st_fiber_impl_t* impl = static_cast<st_fiber_impl_t*>(_impl);
+	if (impl)
+	{
+		if (impl->_stack)
+		{
+			munmap(impl->_stack, impl->_stack_size);
+		}
+		if (_st_fiber_current == impl)
+		{
+			_st_fiber_current = nullptr;
+		}
+		delete impl;
+	}
+}
+
+st_fiber& st_fiber::operator=(st_fiber&& other)
+{
+	if (&other != this)
+	{
+		_impl = other._impl;
+		other._impl = 0;
+	}
+	return *this;
+}
+
+st_fiber st_fiber::convert_thread(void* data)
+{
+	auto impl = new st_fiber_impl_t;
+	impl->_stack_pointer = nullptr;
+	impl->_func = nullptr;
+	impl->_data = data;
+	impl->_stack = nullptr;
+	impl->_stack_size = 0;
+
+	_st_fiber_current = impl;
+
+	st_fiber fiber;
+	fiber._impl = impl;
+	return fiber;
+}
+
+__attribute__((noinline))
+void st_fiber::switch_to(const st_fiber& fiber)
+{
+	st_fiber_impl_t* from = _st_fiber_current;
+	st_fiber_impl_t* to = static_cast<st_fiber_impl_t*>(fiber._impl);
+	assert(from != nullptr && "st_fiber::convert_thread must be called on this thread first");
+
+	_st_fiber_current = to;
+
+#if defined(ST_FIBER_UCONTEXT)
+	swapcontext(&from->_context, &to->_context);
+#else
+	st_fiber_switch_context(&from->_stack_pointer, to->_stack_pointer);
+#endif
+}
+
+__attribute__((noinline))
+void* st_fiber::get_data()
+{
+	return _st_fiber_current->_data;
+}
+
+size_t st_fiber::get_stack_high_water() const
+{
+	st_fiber_impl_t* impl = static_cast<st_fiber_impl_t*>(_impl);
+	if (!impl || !impl->_stack)
+	{
+		return 0;
+	}
+
+	/*
+	** Stack pages are only made resident once touched, and stay resident.
+	** The lowest resident page above the guard page marks the high water.
+	*/
+	const size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+	size_t page_count = impl->_stack_size / page_size;
+
+#if defined(ST_APPLE)
+	std::vector<char> resident(page_count);
+#else
+	std::vector<unsigned char> resident(page_count);
+#endif
+	if (mincore(impl->_stack, impl->_stack_size, resident.data()) != 0)
+	{
+		return 0;
+	}
+
+	for (size_t i = 1; i < page_count; ++i)
+	{
+		if (resident[i] & 1)
+		{
+			return (page_count - i) * page_size;
+		}
+	}
+
+	return 0;
+}
+
+const char* st_fiber::get_backend_name()
+{
+#if defined(ST_FIBER_UCONTEXT)
+	return "ucontext";
+#elif defined(ST_X64)
+	return "asm-x64";
+#else
+	return "asm-arm64";
+#endif
+}
+
+#endif
@@ -71,28 +71,34 @@ st_intpool::~st_intpool()
 int st_intpool::alloc()
 {
 	int index;
+	while (!try_alloc(&index)) {}
+	return index;
+}
+
+bool st_intpool::try_alloc(int* index)
+{
 	st_intpool_impl_t* impl = static_cast<st_intpool_impl_t*>(_impl);
 
 	for (;;)
 	{
 		st_intpool_pointer_t free_list = impl->_free_list;
 
-		if (free_list._part._index != k_st_intpool_invalid_index)
+		if (free_list._part._index == k_st_intpool_invalid_index)
 		{
-			index = free_list._part._index;
-			st_intpool_pointer_t next = impl->_nodes[index]._next;
-
-			st_intpool_pointer_t link;
-			link._part._index = next._part._index;
-			link._part._count = free_list._part._count + 1;
-			if (impl->_free_list._atomic.compare_exchange_strong(free_list._entire, link._entire))
-			{
-				break;
-			}
+			return false;
 		}
-	}
 
-	return index;
+		st_intpool_pointer_t next = impl->_nodes[free_list._part._index]._next;
+
+		st_intpool_pointer_t link;
+		link._part._index = next._part._index;
+		link._part._count = free_list._part._count + 1;
+		if (impl->_free_list._atomic.compare_exchange_strong(free_list._entire, link._entire))
+		{
+			*index = free_list._part._index;
+			return true;
+		}
+	}
 }
 
 void st_intpool::free(int index)
@@ -15,7 +15,16 @@ public:
 	st_intpool(int index_count);
 	~st_intpool();
 
+	/*
+	** Spins until an index is available.
+	*/
 	int alloc();
+
+	/*
+	** Returns false immediately if every index is in use.
+	*/
+	bool try_alloc(int* index);
+
 	void free(int index);
 
 	int get_index_count() const;
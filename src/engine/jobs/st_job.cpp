@@ -7,11 +7,18 @@
 #include "st_job.h"
 
 #include "st_condvar.h"
+#include "st_deque.h"
 #include "st_fiber.h"
 #include "st_intpool.h"
-#include "st_queue.h"
+#include "st_ring_queue.h"
+#include "st_trace.h"
 
+#include <system/st_cpu_topology.h>
+
+#include <algorithm>
 #include <atomic>
+#include <cassert>
+#include <cstdio>
 #include <thread>
 #include <vector>
 
@@ -23,72 +30,293 @@ struct st_job_instance_t
 
 	st_job_decl_t* _decl;
 
-	int32_t* _waiting_count;
+	st_job_counter_t* _waiting_count;
+	st_job_instance_t* _next_waiter;
 
 	int _pool_index;
+	e_st_job_stack_size _stack_size;
+
+	/* Unique across stack size classes, for traces. */
+	int _fiber_id;
 
+	/* Fibers are created the first time their pool index is handed out. */
+	std::atomic<bool> _fiber_created{ false };
 	st_fiber _fiber;
 	st_fiber* _parent_fiber;
 };
 
 struct st_job_system_impl_t
 {
-	st_job_system_impl_t(int queue_size, int fiber_count) :
+	st_job_system_impl_t(int queue_size, const st_job_fiber_config_t& fiber_config) :
 		_main_thread(std::this_thread::get_id()),
-		_job_queue(queue_size),
-		_job_instance_pool(fiber_count),
-		_wait_queue(queue_size)
-	{}
+		_fiber_config(fiber_config),
+		_ready_queue(fiber_config._max_count[st_job_stack_small] + fiber_config._max_count[st_job_stack_large])
+	{
+		for (int i = 0; i < st_job_priority_count; ++i)
+		{
+			_job_queues[i] = new st_ring_queue(queue_size);
+		}
 
-	std::thread::id _main_thread;
+		for (int i = 0; i < st_job_stack_size_count; ++i)
+		{
+			_job_instance_pools[i] = new st_intpool(fiber_config._max_count[i]);
+			_job_instance_data[i] = new st_job_instance_t[fiber_config._max_count[i]];
+			_fiber_created_count[i] = 0;
+			_fiber_in_use_count[i] = 0;
+			_fiber_peak_in_use_count[i] = 0;
+		}
+
+		for (int p = 0; p < st_job_priority_count; ++p)
+		{
+			for (int c = 0; c < st_job_stack_size_count; ++c)
+			{
+				_starved_queues[p][c] = nullptr;
+			}
+		}
+	}
+
+	~st_job_system_impl_t()
+	{
+		for (int i = 0; i < st_job_priority_count; ++i)
+		{
+			delete _job_queues[i];
+		}
 
-	st_queue _job_queue;
+		for (int i = 0; i < st_job_stack_size_count; ++i)
+		{
+			delete _job_instance_pools[i];
+			delete[] _job_instance_data[i];
+		}
 
-	st_intpool _job_instance_pool;
-	st_job_instance_t* _job_instance_data;
+		for (int p = 0; p < st_job_priority_count; ++p)
+		{
+			for (int c = 0; c < st_job_stack_size_count; ++c)
+			{
+				delete _starved_queues[p][c];
+			}
+		}
+	}
 
-	st_queue _wait_queue;
+	std::thread::id _main_thread;
+
+	/*
+	** Shared queues for jobs submitted from threads without a deque of their
+	** own, and for overflow when a deque is full. One per priority.
+	*/
+	st_ring_queue* _job_queues[st_job_priority_count];
+
+	/*
+	** One work-stealing deque per worker, plus one for the main thread, for
+	** each priority. Owners push and pop at the bottom; idle workers steal
+	** from the top.
+	*/
+	std::vector<st_deque*> _deques[st_job_priority_count];
+
+	/*
+	** For each deque, the others in the order its owner tries to steal from
+	** them. Deques owned by workers on the same NUMA node come first.
+	*/
+	std::vector<std::vector<int>> _steal_order;
+	std::vector<int> _steal_local_count;
+
+	/* Processor each worker is pinned to. */
+	std::vector<int> _worker_cpus;
+
+	/* Workers that have created their deques. No worker schedules until all have. */
+	std::atomic<int> _ready_worker_count;
+	int _queue_size;
+
+	st_job_fiber_config_t _fiber_config;
+
+	/*
+	** One pool of job instances per stack size class, each sized to the
+	** maximum fiber count for the class.
+	*/
+	st_intpool* _job_instance_pools[st_job_stack_size_count];
+	st_job_instance_t* _job_instance_data[st_job_stack_size_count];
+
+	std::atomic<int> _fiber_created_count[st_job_stack_size_count];
+	std::atomic<int> _fiber_in_use_count[st_job_stack_size_count];
+	std::atomic<int> _fiber_peak_in_use_count[st_job_stack_size_count];
+
+	/*
+	** Workers that found a job but no free fiber since the last fiber was
+	** released. Releasing a fiber wakes them if this is non-zero.
+	*/
+	std::atomic<int> _starved_worker_count;
+	std::atomic<uint32_t> _starved_count;
+
+	/*
+	** Jobs taken off the queues that couldn't start because every fiber of
+	** their stack size class was in use, by priority and class. Any worker
+	** that finds a free fiber picks them up, ahead of other work of the same
+	** priority. Sized so every queued job could be set aside at once.
+	*/
+	st_ring_queue* _starved_queues[st_job_priority_count][st_job_stack_size_count];
+
+	/*
+	** Parked jobs whose counter has reached zero, waiting for a worker to
+	** resume them. Sized by the fiber count since only parked jobs go here,
+	** so pushes only fail while a pop from the previous lap is finishing.
+	*/
+	st_ring_queue _ready_queue;
 
 	std::vector<std::thread*> _worker_threads;
 
 	st_condvar _work_added;
-	st_condvar _work_exhausted;
+	st_condvar _counter_cleared;
+
+	/* Critical job queue latency for the frame in progress, in nanoseconds. */
+	std::atomic<uint32_t> _critical_job_count;
+	std::atomic<int64_t> _critical_wait_total;
+	std::atomic<int64_t> _critical_wait_max;
+
+	st_job_frame_stats_t _last_frame_stats;
 
 	bool _terminate;
 };
 
-static int _st_job_instance_thread_worker(void* data);
+/*
+** Index of the calling thread's deque, or -1 for threads outside the job system.
+*/
+static thread_local int _st_job_thread_index = -1;
+
+/*
+** Per-thread state for picking steal victims.
+*/
+static thread_local uint32_t _st_job_steal_seed = 0;
+
+/*
+** Per-thread count of scheduling passes. Every k_st_job_background_interval
+** passes, a worker looks at background work first so it can't be starved by
+** a steady stream of higher priority jobs.
+*/
+static thread_local uint32_t _st_job_find_count = 0;
+static const uint32_t k_st_job_background_interval = 16;
+
+static int _st_job_instance_thread_worker(void* data, int thread_index);
 static bool _st_job_schedule(st_job_system_impl_t* impl, st_fiber* parent_fiber);
+static bool _st_job_find(st_job_system_impl_t* impl, const bool* class_starved, st_job_decl_t** decl);
+static bool _st_job_find_priority(st_job_system_impl_t* impl, int priority, const bool* class_starved, st_job_decl_t** decl);
+static void _st_job_record_latency(st_job_system_impl_t* impl, st_job_decl_t* decl);
+static st_job_instance_t* _st_job_alloc_instance(st_job_system_impl_t* impl, e_st_job_stack_size stack_size);
+static void _st_job_free_instance(st_job_system_impl_t* impl, st_job_instance_t* job);
+static void _st_job_push(
+	st_job_system_impl_t* impl,
+	st_job_decl_t* decls,
+	int decl_count,
+	st_job_counter_t* counter,
+	e_st_job_priority priority);
 static void _st_job_run(st_job_system_impl_t* impl, st_fiber* parent_fiber, st_job_instance_t* job);
+static void _st_job_park(st_job_system_impl_t* impl, st_job_instance_t* job);
+static void _st_job_push_ready(st_job_system_impl_t* impl, st_job_instance_t* job);
+static void _st_job_complete(st_job_system_impl_t* impl, st_job_instance_t* job);
 static void _st_job_fiber_worker(void* data);
 
 void st_job::startup(
-	uint32_t hardware_thread_mask,
+	const st_job_cpu_mask_t& cpu_mask,
 	int queue_size,
-	int fiber_count)
+	int fiber_count,
+	const st_job_fiber_config_t& fiber_config)
 {
-	st_job_system_impl_t* impl = new st_job_system_impl_t(queue_size, fiber_count);
+	st_job_fiber_config_t config = fiber_config;
+	config._max_count[st_job_stack_small] = std::max(config._max_count[st_job_stack_small], fiber_count);
+	config._max_count[st_job_stack_large] = std::max(config._max_count[st_job_stack_large], 1);
+
+	st_job_system_impl_t* impl = new st_job_system_impl_t(queue_size, config);
 
 	impl->_terminate = false;
 
-	impl->_job_instance_data = new st_job_instance_t[fiber_count];
+	impl->_critical_job_count = 0;
+	impl->_critical_wait_total = 0;
+	impl->_critical_wait_max = 0;
+
+	impl->_starved_worker_count = 0;
+	impl->_starved_count = 0;
+
+	/*
+	** The pools hand out the lowest indices first and reuse the most recently
+	** freed, so the fibers created here cover the steady state.
+	*/
 	for (int i = 0; i < fiber_count; ++i)
 	{
-		st_job_instance_t* instance = &impl->_job_instance_data[i];
-		instance->_fiber = st_fiber(_st_job_fiber_worker, instance, 64 * 1024);
-		instance->_pool_index = i;
+		st_job_instance_t* instance = &impl->_job_instance_data[st_job_stack_small][i];
+		instance->_fiber = st_fiber(_st_job_fiber_worker, instance, config._stack_size[st_job_stack_small]);
+		instance->_fiber_created.store(true, std::memory_order_release);
 	}
+	impl->_fiber_created_count[st_job_stack_small] = fiber_count;
 
-	int hardware_thread_count = std::thread::hardware_concurrency();
-	for (int i = 0; i < hardware_thread_count; ++i)
+	/* Topology lists processors grouped by node, so workers on a node get neighboring indices. */
+	const st_cpu_topology& topology = st_cpu_topology::get();
+	std::vector<int> deque_nodes;
+	for (int i = 0; i < topology.get_cpu_count(); ++i)
 	{
-		if ((hardware_thread_mask & (1 << i)) != 0)
+		const st_cpu_info_t& cpu = topology.get_cpu(i);
+		if (cpu_mask.test(cpu._id))
 		{
-			impl->_worker_threads.push_back(new std::thread(_st_job_instance_thread_worker, impl));
+			impl->_worker_cpus.push_back(cpu._id);
+			deque_nodes.push_back(cpu._numa_node);
+		}
+	}
+	int worker_count = int(impl->_worker_cpus.size());
+
+	/* The main thread owns the last deque. It isn't pinned, so it has no node. */
+	deque_nodes.push_back(-1);
+
+	int deque_count = worker_count + 1;
+	impl->_steal_order.resize(deque_count);
+	impl->_steal_local_count.resize(deque_count);
+	for (int i = 0; i < deque_count; ++i)
+	{
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			for (int victim = 0; victim < deque_count; ++victim)
+			{
+				bool local = deque_nodes[i] >= 0 && deque_nodes[victim] == deque_nodes[i];
+				if (victim != i && local == (pass == 0))
+				{
+					impl->_steal_order[i].push_back(victim);
+				}
+			}
+			if (pass == 0)
+			{
+				impl->_steal_local_count[i] = int(impl->_steal_order[i].size());
+			}
 		}
 	}
 
+	/*
+	** Workers allocate their own deques once pinned, so the memory is placed
+	** on their node by first touch.
+	*/
+	impl->_queue_size = queue_size;
+	impl->_ready_worker_count = 0;
+	for (int p = 0; p < st_job_priority_count; ++p)
+	{
+		impl->_deques[p].resize(deque_count, nullptr);
+		impl->_deques[p][worker_count] = new st_deque(queue_size);
+
+		for (int c = 0; c < st_job_stack_size_count; ++c)
+		{
+			impl->_starved_queues[p][c] = new st_ring_queue(queue_size * (deque_count + 1));
+		}
+	}
+	_st_job_thread_index = worker_count;
+	ST_TRACE_THREAD_NAME("main");
+	_st_job_steal_seed = uint32_t(worker_count) + 1;
+
 	_impl = impl;
+
+	for (int i = 0; i < worker_count; ++i)
+	{
+		impl->_worker_threads.push_back(new std::thread(_st_job_instance_thread_worker, impl, i));
+	}
+
+	/* Deques must all exist before anyone pushes or steals. */
+	while (impl->_ready_worker_count.load(std::memory_order_acquire) < worker_count)
+	{
+		std::this_thread::yield();
+	}
 }
 
 void st_job::shutdown()
@@ -103,38 +331,208 @@ void st_job::shutdown()
 		delete t;
 	}
 
-	delete[] impl->_job_instance_data;
+	/*
+	** Anything still queued, including jobs set aside for a fiber, goes with
+	** the queues, so nothing carries over to the next startup.
+	*/
+	for (int p = 0; p < st_job_priority_count; ++p)
+	{
+		for (auto& d : impl->_deques[p])
+		{
+			delete d;
+		}
+	}
+	_st_job_thread_index = -1;
+
+	delete impl;
+	_impl = 0;
 }
 
-void st_job::run(st_job_decl_t* decls, int decl_count, int32_t* counter)
+void st_job::run(
+	st_job_decl_t* decls,
+	int decl_count,
+	st_job_counter_t* counter,
+	e_st_job_priority priority)
 {
-	*counter = decl_count;
+	counter->_count = decl_count;
+	counter->_waiters = decl_count > 0 ? 0 : st_job_counter_t::k_done;
+
+	_st_job_push(static_cast<st_job_system_impl_t*>(_impl), decls, decl_count, counter, priority);
+}
+
+void st_job::extend(
+	st_job_decl_t* decls,
+	int decl_count,
+	st_job_counter_t* counter,
+	e_st_job_priority priority)
+{
+	counter->_count += decl_count;
+
+	_st_job_push(static_cast<st_job_system_impl_t*>(_impl), decls, decl_count, counter, priority);
+}
+
+static void _st_job_push(
+	st_job_system_impl_t* impl,
+	st_job_decl_t* decls,
+	int decl_count,
+	st_job_counter_t* counter,
+	e_st_job_priority priority)
+{
+	st_deque* deque = _st_job_thread_index >= 0 ? impl->_deques[priority][_st_job_thread_index] : nullptr;
+
+	/* Only critical jobs are timed, to keep the clock read off the common path. */
+	std::chrono::steady_clock::time_point now;
+	if (priority == st_job_priority_critical)
+	{
+		now = std::chrono::steady_clock::now();
+	}
 
-	st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(_impl);
 	for (int i = 0; i < decl_count; ++i)
 	{
 		decls[i]._pending_count = counter;
-		impl->_job_queue.push(decls + i);
+		decls[i]._priority = priority;
+		decls[i]._queued_time = now;
+		if (deque && deque->push(decls + i))
+		{
+			continue;
+		}
+
+		while (!impl->_job_queues[priority]->push(decls + i))
+		{
+			/* Everything is full. Make sure the workers are draining it, then try again. */
+			impl->_work_added.wake_all();
+			std::this_thread::yield();
+		}
 	}
 
 	impl->_work_added.wake_all();
 }
 
-void st_job::wait(int32_t* counter)
+/*
+** A contiguous slice of a parallel_for, run as a single job.
+*/
+struct st_job_range_t
+{
+	st_job_decl_t _decl;
+	struct st_job_parallel_for_t* _loop;
+	int _begin;
+	int _end;
+};
+
+/*
+** State shared by every slice of one parallel_for call.
+*/
+struct st_job_parallel_for_t
+{
+	st_job_range_function_t _func;
+	void* _data;
+	int _grain;
+	e_st_job_priority _priority;
+
+	st_job_counter_t _counter;
+
+	/*
+	** Slices are handed out from here as ranges are split. Halving stops at
+	** the grain size, so there can be at most two slices per grain.
+	*/
+	st_job_range_t* _ranges;
+	std::atomic<int> _next_range;
+};
+
+static void _st_job_range_entry(void* data)
+{
+	st_job_range_t* range = static_cast<st_job_range_t*>(data);
+	st_job_parallel_for_t* loop = range->_loop;
+
+	/*
+	** Keep the front half and queue the back half until the range is small
+	** enough. The back halves go on this worker's deque, so the largest ones
+	** are the first to be stolen.
+	*/
+	int begin = range->_begin;
+	int end = range->_end;
+	while (end - begin > loop->_grain)
+	{
+		int middle = begin + (end - begin) / 2;
+
+		st_job_range_t* split = &loop->_ranges[loop->_next_range++];
+		split->_decl._entry = _st_job_range_entry;
+		split->_decl._data = split;
+		split->_decl._name = "parallel_for";
+		split->_loop = loop;
+		split->_begin = middle;
+		split->_end = end;
+
+		/* This job is still outstanding, so the count can't reach zero here. */
+		st_job::extend(&split->_decl, 1, &loop->_counter, loop->_priority);
+
+		end = middle;
+	}
+
+	loop->_func(loop->_data, begin, end);
+}
+
+void st_job::parallel_for(
+	int begin,
+	int end,
+	int grain,
+	st_job_range_function_t func,
+	void* data,
+	e_st_job_priority priority)
 {
-	if (*counter > 0)
+	if (end <= begin)
+	{
+		return;
+	}
+
+	grain = grain > 0 ? grain : 1;
+
+	/* Not worth a trip through the queues. */
+	if (end - begin <= grain)
+	{
+		func(data, begin, end);
+		return;
+	}
+
+	st_job_parallel_for_t loop;
+	loop._func = func;
+	loop._data = data;
+	loop._grain = grain;
+	loop._priority = priority;
+	loop._ranges = new st_job_range_t[2 * ((end - begin + grain - 1) / grain) + 1];
+	loop._next_range = 0;
+
+	st_job_range_t* root = &loop._ranges[loop._next_range++];
+	root->_decl._entry = _st_job_range_entry;
+	root->_decl._data = root;
+	root->_decl._name = "parallel_for";
+	root->_loop = &loop;
+	root->_begin = begin;
+	root->_end = end;
+
+	run(&root->_decl, 1, &loop._counter, priority);
+	wait(&loop._counter);
+
+	delete[] loop._ranges;
+}
+
+void st_job::wait(st_job_counter_t* counter)
+{
+	if (counter->_waiters != st_job_counter_t::k_done)
 	{
 		/*
 		** If we're not the main thread, assume we're waiting from within a job.
-		** In this case, push the current job onto the wait list, and reschedule.
+		** In this case, record the counter and reschedule. The scheduler parks the
+		** job on the counter once we've switched off of its fiber, so no other
+		** worker can resume it while it is still running here.
 		*/
 		st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(_impl);
 		if (std::this_thread::get_id() != impl->_main_thread)
 		{
 			st_job_instance_t* job = static_cast<st_job_instance_t*>(st_fiber::get_data());
 			job->_waiting_count = counter;
-			impl->_wait_queue.push(job);
 
+			ST_TRACE_INSTANT("wait", reinterpret_cast<const void*>(job->_decl->_entry), counter, job->_fiber_id);
 			st_fiber::switch_to(*job->_parent_fiber);
 		}
 		/*
@@ -142,26 +540,121 @@ void st_job::wait(int32_t* counter)
 		*/
 		else
 		{
-			while (*reinterpret_cast<std::atomic_int*>(counter) > 0)
+			ST_TRACE_BEGIN("wait", nullptr, counter);
+			while (counter->_waiters != st_job_counter_t::k_done)
 			{
-				impl->_work_exhausted.wait();
+				uint64_t token = impl->_counter_cleared.prepare_wait();
+				if (counter->_waiters != st_job_counter_t::k_done)
+				{
+					impl->_counter_cleared.wait(token);
+				}
+				else
+				{
+					impl->_counter_cleared.cancel_wait();
+				}
 			}
+			ST_TRACE_END("wait");
 		}
 	}
 }
 
-static int _st_job_instance_thread_worker(void* data)
+int st_job::get_thread_count()
+{
+	st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(_impl);
+	return int(impl->_worker_cpus.size()) + 1;
+}
+
+int st_job::get_thread_index()
+{
+	return _st_job_thread_index;
+}
+
+void st_job::begin_frame()
+{
+	st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(_impl);
+
+	st_job_frame_stats_t stats;
+	stats._critical_job_count = impl->_critical_job_count.exchange(0);
+	stats._critical_wait_total = std::chrono::nanoseconds(impl->_critical_wait_total.exchange(0));
+	stats._critical_wait_max = std::chrono::nanoseconds(impl->_critical_wait_max.exchange(0));
+	impl->_last_frame_stats = stats;
+}
+
+st_job_frame_stats_t st_job::get_frame_stats()
+{
+	st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(_impl);
+	return impl->_last_frame_stats;
+}
+
+st_job_fiber_stats_t st_job::get_fiber_stats()
+{
+	st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(_impl);
+
+	st_job_fiber_stats_t stats;
+	for (int c = 0; c < st_job_stack_size_count; ++c)
+	{
+		st_job_fiber_pool_stats_t& pool = stats._pools[c];
+		pool._created_count = impl->_fiber_created_count[c];
+		pool._max_count = impl->_fiber_config._max_count[c];
+		pool._in_use_count = impl->_fiber_in_use_count[c];
+		pool._peak_in_use_count = impl->_fiber_peak_in_use_count[c];
+		pool._stack_size = impl->_fiber_config._stack_size[c];
+
+		for (int i = 0; i < pool._max_count; ++i)
+		{
+			st_job_instance_t* instance = &impl->_job_instance_data[c][i];
+			if (instance->_fiber_created.load(std::memory_order_acquire))
+			{
+				pool._stack_high_water = std::max(pool._stack_high_water, instance->_fiber.get_stack_high_water());
+			}
+		}
+	}
+	stats._starved_count = impl->_starved_count;
+
+	return stats;
+}
+
+static int _st_job_instance_thread_worker(void* data, int thread_index)
 {
 	st_job_system_impl_t* impl = static_cast<st_job_system_impl_t*>(data);
 
+	_st_job_thread_index = thread_index;
+	_st_job_steal_seed = uint32_t(thread_index) + 1;
+
+	st_cpu_topology::pin_current_thread(impl->_worker_cpus[thread_index]);
+
+	for (int p = 0; p < st_job_priority_count; ++p)
+	{
+		impl->_deques[p][thread_index] = new st_deque(impl->_queue_size);
+	}
+
+	impl->_ready_worker_count.fetch_add(1, std::memory_order_release);
+	while (impl->_ready_worker_count.load(std::memory_order_acquire) < int(impl->_worker_cpus.size()))
+	{
+		std::this_thread::yield();
+	}
+
+#if ST_TRACE_ENABLED
+	char thread_name[32];
+	snprintf(thread_name, sizeof(thread_name), "job worker %d", thread_index);
+	ST_TRACE_THREAD_NAME(thread_name);
+#endif
+
 	st_fiber parent_fiber = st_fiber::convert_thread(0);
 
 	while (!impl->_terminate)
 	{
-		if (!_st_job_schedule(impl, &parent_fiber))
+		/* Register as a sleeper before looking, so work added meanwhile isn't missed. */
+		uint64_t token = impl->_work_added.prepare_wait();
+		if (_st_job_schedule(impl, &parent_fiber) || impl->_terminate)
+		{
+			impl->_work_added.cancel_wait();
+		}
+		else
 		{
-			impl->_work_exhausted.wake_all();
-			impl->_work_added.wait_for(1);
+			ST_TRACE_BEGIN("sleep");
+			impl->_work_added.wait(token);
+			ST_TRACE_END("sleep");
 		}
 	}
 
@@ -170,38 +663,205 @@ static int _st_job_instance_thread_worker(void* data)
 
 static bool _st_job_schedule(st_job_system_impl_t* impl, st_fiber* parent_fiber)
 {
-	/* Check for waiting jobs that are ready to run. */
+	/* Resume jobs whose wait has finished before starting new ones. */
 	st_job_instance_t* job;
-	int retry_wait_count = impl->_wait_queue.get_count();
-	while (retry_wait_count-- > 0 && impl->_wait_queue.pop((void**)&job))
+	if (impl->_ready_queue.pop((void**)&job))
+	{
+		ST_TRACE_INSTANT("resume", reinterpret_cast<const void*>(job->_decl->_entry), job->_decl->_pending_count, job->_fiber_id);
+		_st_job_run(impl, parent_fiber, job);
+		return true;
+	}
+
+	/*
+	** Look for queued jobs. A job whose stack class has no free fiber is set
+	** aside so the jobs behind it still get a chance to run, one of which may
+	** be what the fibers in use are waiting on. Once a class is out of fibers,
+	** its set aside jobs are left alone for the rest of the pass, so the
+	** search only ever takes jobs off the other queues and must end.
+	*/
+	bool class_starved[st_job_stack_size_count] = {};
+
+	job = nullptr;
+	st_job_decl_t* decl = nullptr;
+	while (!job && _st_job_find(impl, class_starved, &decl))
 	{
-		if (job->_waiting_count == 0 || job->_waiting_count[0] == 0)
+		if (!class_starved[decl->_stack_size])
 		{
-			_st_job_run(impl, parent_fiber, job);
-			return true;
+			job = _st_job_alloc_instance(impl, decl->_stack_size);
 		}
-		else
+
+		if (!job)
+		{
+			class_starved[decl->_stack_size] = true;
+
+			/* There's room for every queued job, so this only fails while a pop of the previous lap finishes. */
+			while (!impl->_starved_queues[decl->_priority][decl->_stack_size]->push(decl))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/* If nothing can run, the worker sleeps until a fiber is released. */
+	if (!job)
+	{
+		return false;
+	}
+
+	if (decl->_priority == st_job_priority_critical)
+	{
+		_st_job_record_latency(impl, decl);
+	}
+
+	job->_decl = decl;
+
+	_st_job_run(impl, parent_fiber, job);
+
+	return true;
+}
+
+static st_job_instance_t* _st_job_alloc_instance(st_job_system_impl_t* impl, e_st_job_stack_size stack_size)
+{
+	st_intpool* pool = impl->_job_instance_pools[stack_size];
+
+	int index;
+	if (!pool->try_alloc(&index))
+	{
+		impl->_starved_count++;
+
+		/*
+		** Announce ourselves before trying again. Either the retry sees a
+		** fiber released in the meantime, or whoever released it sees us and
+		** issues a wake.
+		*/
+		impl->_starved_worker_count++;
+		if (!pool->try_alloc(&index))
 		{
-			impl->_wait_queue.push(job);
+			return nullptr;
 		}
 	}
 
-	/* Look for queued jobs. */
-	st_job_decl_t* decl;
-	if (impl->_job_queue.pop((void**)&decl))
+	/* The index is ours alone until freed, so the fiber can be created without a lock. */
+	st_job_instance_t* job = &impl->_job_instance_data[stack_size][index];
+	if (!job->_fiber_created.load(std::memory_order_relaxed))
 	{
-		int st_job_index = impl->_job_instance_pool.alloc();
+		job->_fiber = st_fiber(_st_job_fiber_worker, job, impl->_fiber_config._stack_size[stack_size]);
+		job->_fiber_created.store(true, std::memory_order_release);
+		impl->_fiber_created_count[stack_size]++;
+	}
+	job->_pool_index = index;
+	job->_stack_size = stack_size;
+	job->_fiber_id = stack_size == st_job_stack_small ? index : impl->_fiber_config._max_count[st_job_stack_small] + index;
 
-		job = &impl->_job_instance_data[st_job_index];
-		job->_decl = decl;
-		job->_pool_index = st_job_index;
+	int in_use = ++impl->_fiber_in_use_count[stack_size];
+	int peak = impl->_fiber_peak_in_use_count[stack_size];
+	while (in_use > peak && !impl->_fiber_peak_in_use_count[stack_size].compare_exchange_weak(peak, in_use)) {}
 
-		_st_job_run(impl, parent_fiber, job);
+	return job;
+}
+
+static void _st_job_free_instance(st_job_system_impl_t* impl, st_job_instance_t* job)
+{
+	impl->_fiber_in_use_count[job->_stack_size]--;
+	impl->_job_instance_pools[job->_stack_size]->free(job->_pool_index);
+
+	if (impl->_starved_worker_count.load() > 0 && impl->_starved_worker_count.exchange(0) > 0)
+	{
+		impl->_work_added.wake_all();
+	}
+}
+
+static bool _st_job_find(st_job_system_impl_t* impl, const bool* class_starved, st_job_decl_t** decl)
+{
+	/*
+	** Highest priority first, except for the occasional pass that favors
+	** background work. Background is the lowest priority, so rotating the
+	** order by it puts it first and leaves the rest in order.
+	*/
+	int first = ++_st_job_find_count % k_st_job_background_interval == 0 ? st_job_priority_background : 0;
+
+	for (int i = 0; i < st_job_priority_count; ++i)
+	{
+		int p = (first + i) % st_job_priority_count;
+		if (_st_job_find_priority(impl, p, class_starved, decl))
+		{
+			return true;
+		}
+	}
 
+	return false;
+}
+
+static bool _st_job_find_priority(st_job_system_impl_t* impl, int priority, const bool* class_starved, st_job_decl_t** decl)
+{
+	/* Jobs set aside for lack of a fiber have waited longest. */
+	for (int c = 0; c < st_job_stack_size_count; ++c)
+	{
+		if (!class_starved[c] && impl->_starved_queues[priority][c]->pop((void**)decl))
+		{
+			return true;
+		}
+	}
+
+	std::vector<st_deque*>& deques = impl->_deques[priority];
+
+	/* Newest local work first, it's most likely to still be in cache. */
+	if (deques[_st_job_thread_index]->pop((void**)decl))
+	{
+		return true;
+	}
+
+	if (impl->_job_queues[priority]->pop((void**)decl))
+	{
 		return true;
 	}
 
-	return impl->_wait_queue.get_count() != 0;
+	/*
+	** Steal the oldest work from other threads. Try threads on our own node
+	** first, then the rest, starting at a random victim within each group.
+	*/
+	const std::vector<int>& order = impl->_steal_order[_st_job_thread_index];
+	int local_count = impl->_steal_local_count[_st_job_thread_index];
+
+	uint32_t x = _st_job_steal_seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	_st_job_steal_seed = x;
+
+	int group_begin[2] = { 0, local_count };
+	int group_size[2] = { local_count, int(order.size()) - local_count };
+	for (int g = 0; g < 2; ++g)
+	{
+		if (group_size[g] == 0)
+		{
+			continue;
+		}
+
+		int start = int(x % uint32_t(group_size[g]));
+		for (int i = 0; i < group_size[g]; ++i)
+		{
+			int victim = order[group_begin[g] + (start + i) % group_size[g]];
+			if (deques[victim]->steal((void**)decl))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static void _st_job_record_latency(st_job_system_impl_t* impl, st_job_decl_t* decl)
+{
+	int64_t wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - decl->_queued_time).count();
+
+	impl->_critical_job_count++;
+	impl->_critical_wait_total += wait;
+
+	int64_t max = impl->_critical_wait_max;
+	while (wait > max && !impl->_critical_wait_max.compare_exchange_weak(max, wait)) {}
 }
 
 static void _st_job_run(st_job_system_impl_t* impl, st_fiber* parent_fiber, st_job_instance_t* job)
@@ -209,14 +869,90 @@ static void _st_job_run(st_job_system_impl_t* impl, st_fiber* parent_fiber, st_j
 	job->_parent_fiber = parent_fiber;
 	job->_waiting_count = 0;
 
+#if ST_TRACE_ENABLED
+	const char* name = job->_decl->_name ? job->_decl->_name : "job";
+	ST_TRACE_BEGIN(name, reinterpret_cast<const void*>(job->_decl->_entry), job->_decl->_pending_count, job->_fiber_id);
+#endif
+
 	st_fiber::switch_to(job->_fiber);
 
-	if (job->_waiting_count == 0 || job->_waiting_count[0] == 0)
+	ST_TRACE_END(name);
+
+	if (job->_waiting_count == 0)
+	{
+		_st_job_complete(impl, job);
+	}
+	else
 	{
-		impl->_job_instance_pool.free(job->_pool_index);
+		_st_job_park(impl, job);
+	}
+}
+
+static void _st_job_park(st_job_system_impl_t* impl, st_job_instance_t* job)
+{
+	st_job_counter_t* counter = job->_waiting_count;
+
+	/*
+	** Either we get onto the list before the last job of the batch swaps it
+	** out, or we see that it already has and resume straight away.
+	*/
+	uintptr_t head = counter->_waiters;
+	for (;;)
+	{
+		if (head == st_job_counter_t::k_done)
+		{
+			_st_job_push_ready(impl, job);
+			impl->_work_added.wake_all();
+			break;
+		}
+
+		job->_next_waiter = reinterpret_cast<st_job_instance_t*>(head);
+		if (counter->_waiters.compare_exchange_weak(head, reinterpret_cast<uintptr_t>(job)))
+		{
+			break;
+		}
+	}
+}
 
-		(*reinterpret_cast<std::atomic_int*>(job->_decl->_pending_count))--;
+static void _st_job_push_ready(st_job_system_impl_t* impl, st_job_instance_t* job)
+{
+	/*
+	** A consumer that claimed a slot a lap behind holds it until it finishes
+	** reading, even though the queue has room. Wait for it.
+	*/
+	while (!impl->_ready_queue.push(job))
+	{
+		std::this_thread::yield();
+	}
+}
+
+static void _st_job_complete(st_job_system_impl_t* impl, st_job_instance_t* job)
+{
+	st_job_counter_t* counter = job->_decl->_pending_count;
+
+	_st_job_free_instance(impl, job);
+
+	if (--counter->_count > 0)
+	{
+		return;
+	}
+
+	/* Last job of the batch. Hand any parked jobs back to the workers. */
+	st_job_instance_t* waiter = reinterpret_cast<st_job_instance_t*>(counter->_waiters.exchange(st_job_counter_t::k_done));
+
+	bool woke_jobs = waiter != nullptr;
+	while (waiter)
+	{
+		st_job_instance_t* next = waiter->_next_waiter;
+		_st_job_push_ready(impl, waiter);
+		waiter = next;
+	}
+
+	if (woke_jobs)
+	{
+		impl->_work_added.wake_all();
 	}
+	impl->_counter_cleared.wake_all();
 }
 
 static void _st_job_fiber_worker(void* data)
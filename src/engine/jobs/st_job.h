@@ -6,6 +6,9 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 
 /*
@@ -13,6 +16,65 @@
 */
 typedef void(*st_job_function_t)(void* data);
 
+/*
+** Entry point for a slice of a parallel loop, covering [begin, end).
+*/
+typedef void(*st_job_range_function_t)(void* data, int begin, int end);
+
+/*
+** Job priority levels. Each level has its own queues, and workers take work
+** from higher levels first.
+*/
+enum e_st_job_priority
+{
+	// Work the current frame is blocked on, e.g. the sim update fan-out.
+	st_job_priority_critical,
+	st_job_priority_normal,
+	// Long-running work with no frame deadline, e.g. asset decoding.
+	st_job_priority_background,
+	st_job_priority_count,
+};
+
+/*
+** Fiber stack size classes. Each class has its own pool of fibers.
+*/
+enum e_st_job_stack_size
+{
+	st_job_stack_small,
+	// For jobs with deep call stacks or large stack buffers.
+	st_job_stack_large,
+	st_job_stack_size_count,
+};
+
+/*
+** Limits for the fiber pools. Fibers beyond those created at startup are
+** created on demand, up to the maximum for their class.
+*/
+struct st_job_fiber_config_t
+{
+	int _max_count[st_job_stack_size_count] = { 1024, 64 };
+	size_t _stack_size[st_job_stack_size_count] = { 64 * 1024, 1024 * 1024 };
+};
+
+/*
+** Tracks completion of a batch of jobs.
+** Jobs blocked in st_job::wait on the counter are parked on it, and made
+** ready again by whichever job brings the count to zero.
+*/
+struct st_job_counter_t
+{
+	static const uintptr_t k_done = 1;
+
+	std::atomic<int32_t> _count{ 0 };
+
+	/*
+	** Intrusive list of parked jobs. Swapped for k_done by the job that brings
+	** the count to zero, which is the last time the job system touches the
+	** counter, so it may go out of scope as soon as a waiter sees k_done.
+	*/
+	std::atomic<uintptr_t> _waiters{ k_done };
+};
+
 /*
 ** Defines a job.
 */
@@ -21,7 +83,81 @@ struct st_job_decl_t
 	st_job_function_t _entry;
 	void* _data;
 
-	int32_t* _pending_count;
+	st_job_counter_t* _pending_count;
+
+	e_st_job_stack_size _stack_size = st_job_stack_small;
+
+	// Shown in traces. Must be a string literal.
+	const char* _name = nullptr;
+
+	// Filled in by st_job::run.
+	e_st_job_priority _priority;
+	std::chrono::steady_clock::time_point _queued_time;
+};
+
+/*
+** Scheduling statistics gathered over one frame.
+*/
+struct st_job_frame_stats_t
+{
+	uint32_t _critical_job_count = 0;
+
+	// Time critical jobs spent queued before a worker picked them up.
+	std::chrono::nanoseconds _critical_wait_total = std::chrono::nanoseconds::zero();
+	std::chrono::nanoseconds _critical_wait_max = std::chrono::nanoseconds::zero();
+};
+
+/*
+** Set of logical processors to start workers on, one worker per processor.
+** Bit i selects the processor the OS numbers i.
+*/
+struct st_job_cpu_mask_t
+{
+	static const int k_max_cpus = 1024;
+
+	uint64_t _bits[k_max_cpus / 64] = {};
+
+	st_job_cpu_mask_t() {}
+
+	// Selects processors 0 to 63 only.
+	st_job_cpu_mask_t(uint64_t bits) { _bits[0] = bits; }
+
+	static st_job_cpu_mask_t all()
+	{
+		st_job_cpu_mask_t mask;
+		for (auto& bits : mask._bits)
+		{
+			bits = ~uint64_t(0);
+		}
+		return mask;
+	}
+
+	void set(int cpu) { _bits[cpu / 64] |= uint64_t(1) << (cpu % 64); }
+	bool test(int cpu) const { return cpu >= 0 && cpu < k_max_cpus && (_bits[cpu / 64] & (uint64_t(1) << (cpu % 64))) != 0; }
+};
+
+/*
+** Fiber pool usage for one stack size class.
+*/
+struct st_job_fiber_pool_stats_t
+{
+	int _created_count = 0;
+	int _max_count = 0;
+	int _in_use_count = 0;
+	int _peak_in_use_count = 0;
+
+	size_t _stack_size = 0;
+
+	// Deepest stack use seen on any fiber in the pool, at page granularity.
+	size_t _stack_high_water = 0;
+};
+
+struct st_job_fiber_stats_t
+{
+	st_job_fiber_pool_stats_t _pools[st_job_stack_size_count];
+
+	// Times a worker found a job but had no fiber to run it on.
+	uint32_t _starved_count = 0;
 };
 
 /*
@@ -30,16 +166,102 @@ struct st_job_decl_t
 class st_job
 {
 public:
+	/*
+	** A worker is started and pinned on each selected processor available to
+	** the process. fiber_count small fibers are created up front. The pools
+	** grow past that as needed, up to the limits in fiber_config.
+	*/
 	static void startup(
-		uint32_t hardware_thread_mask,
+		const st_job_cpu_mask_t& cpu_mask,
 		int queue_size,
-		int fiber_count);
+		int fiber_count,
+		const st_job_fiber_config_t& fiber_config = st_job_fiber_config_t());
 
 	static void shutdown();
 
-	static void run(st_job_decl_t* decls, int decl_count, int32_t* counter);
+	static void run(
+		st_job_decl_t* decls,
+		int decl_count,
+		st_job_counter_t* counter,
+		e_st_job_priority priority = st_job_priority_normal);
+
+	/*
+	** Add jobs to a batch started by run that hasn't finished yet. The caller
+	** must keep the batch from finishing until this returns, usually by being
+	** one of its jobs.
+	*/
+	static void extend(
+		st_job_decl_t* decls,
+		int decl_count,
+		st_job_counter_t* counter,
+		e_st_job_priority priority = st_job_priority_normal);
+
+	static void wait(st_job_counter_t* counter);
+
+	/*
+	** Run func over [begin, end) in parallel and wait for it to finish.
+	** The range is halved recursively until slices are no larger than grain;
+	** idle workers steal the larger halves. Only one allocation is made per
+	** call, regardless of the size of the range.
+	*/
+	static void parallel_for(
+		int begin,
+		int end,
+		int grain,
+		st_job_range_function_t func,
+		void* data,
+		e_st_job_priority priority = st_job_priority_normal);
+
+	/*
+	** Convenience form taking any callable with the signature void(int begin, int end).
+	*/
+	template<typename T>
+	static void parallel_for(
+		int begin,
+		int end,
+		int grain,
+		const T& func,
+		e_st_job_priority priority = st_job_priority_normal)
+	{
+		parallel_for(
+			begin,
+			end,
+			grain,
+			[](void* data, int range_begin, int range_end)
+			{
+				(*static_cast<const T*>(data))(range_begin, range_end);
+			},
+			const_cast<T*>(&func),
+			priority);
+	}
+
+	/*
+	** Number of threads that run jobs: the workers and the main thread.
+	*/
+	static int get_thread_count();
+
+	/*
+	** Index of the calling thread, below get_thread_count(), for keeping data
+	** per thread. A job only stays on one thread until it waits, so the index
+	** must not be held across a wait. -1 on threads outside the job system.
+	*/
+	static int get_thread_index();
+
+	/*
+	** Close out the statistics for the previous frame and start gathering anew.
+	*/
+	static void begin_frame();
+
+	/*
+	** Statistics for the last completed frame.
+	*/
+	static st_job_frame_stats_t get_frame_stats();
 
-	static void wait(int32_t* counter);
+	/*
+	** Current fiber pool usage. Measuring stack high water marks queries the OS
+	** for every fiber created, so this is meant for debug displays.
+	*/
+	static st_job_fiber_stats_t get_fiber_stats();
 
 private:
 	static void* _impl;
@@ -0,0 +1,204 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_job_graph.h"
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+struct st_job_graph_node_t
+{
+	struct st_job_graph_impl_t* _graph;
+
+	st_job_function_t _entry;
+	void* _data;
+	e_st_job_priority _priority;
+
+	/* Submitted to the job system in place of the node's entry point. */
+	st_job_decl_t _decl;
+
+	std::vector<int> _successors;
+	int _predecessor_count;
+
+	/* Predecessors yet to finish in the current run. */
+	std::atomic<int> _remaining;
+};
+
+struct st_job_graph_impl_t
+{
+	std::vector<st_job_graph_node_t*> _nodes;
+
+	/* Nodes with no predecessors, rebuilt when the graph changes. */
+	std::vector<int> _roots;
+	bool _dirty;
+
+	st_job_decl_t _start_decl;
+	st_job_counter_t* _counter;
+};
+
+static void _st_job_graph_start(void* data);
+static void _st_job_graph_node_entry(void* data);
+static void _st_job_graph_build_roots(st_job_graph_impl_t* impl);
+
+st_job_graph::st_job_graph()
+{
+	auto impl = new st_job_graph_impl_t;
+	impl->_dirty = true;
+	impl->_counter = nullptr;
+
+	impl->_start_decl._entry = _st_job_graph_start;
+	impl->_start_decl._data = impl;
+	impl->_start_decl._name = "job_graph";
+
+	_impl = impl;
+}
+
+st_job_graph::~st_job_graph()
+{
+	st_job_graph_impl_t* impl = static_cast<st_job_graph_impl_t*>(_impl);
+	for (auto& node : impl->_nodes)
+	{
+		delete node;
+	}
+	delete impl;
+}
+
+int st_job_graph::add_node(
+	const char* name,
+	st_job_function_t entry,
+	void* data,
+	e_st_job_priority priority,
+	e_st_job_stack_size stack_size)
+{
+	st_job_graph_impl_t* impl = static_cast<st_job_graph_impl_t*>(_impl);
+
+	auto node = new st_job_graph_node_t;
+	node->_graph = impl;
+	node->_entry = entry;
+	node->_data = data;
+	node->_priority = priority;
+	node->_predecessor_count = 0;
+	node->_remaining = 0;
+
+	node->_decl._entry = _st_job_graph_node_entry;
+	node->_decl._data = node;
+	node->_decl._stack_size = stack_size;
+	node->_decl._name = name;
+
+	impl->_nodes.push_back(node);
+	impl->_dirty = true;
+
+	return int(impl->_nodes.size()) - 1;
+}
+
+void st_job_graph::add_dependency(int before, int after)
+{
+	st_job_graph_impl_t* impl = static_cast<st_job_graph_impl_t*>(_impl);
+	assert(before != after);
+
+	impl->_nodes[before]->_successors.push_back(after);
+	impl->_nodes[after]->_predecessor_count++;
+	impl->_dirty = true;
+}
+
+void st_job_graph::run(st_job_counter_t* counter)
+{
+	st_job_graph_impl_t* impl = static_cast<st_job_graph_impl_t*>(_impl);
+
+	if (impl->_dirty)
+	{
+		_st_job_graph_build_roots(impl);
+		impl->_dirty = false;
+	}
+
+	for (auto& node : impl->_nodes)
+	{
+		node->_remaining.store(node->_predecessor_count, std::memory_order_relaxed);
+	}
+	impl->_counter = counter;
+
+	/*
+	** Roots may have different priorities, so they can't all go in one call
+	** to st_job::run. A single start job holds the batch open while it adds
+	** them.
+	*/
+	st_job::run(&impl->_start_decl, 1, counter, st_job_priority_critical);
+}
+
+int st_job_graph::get_node_count() const
+{
+	st_job_graph_impl_t* impl = static_cast<st_job_graph_impl_t*>(_impl);
+	return int(impl->_nodes.size());
+}
+
+static void _st_job_graph_start(void* data)
+{
+	st_job_graph_impl_t* impl = static_cast<st_job_graph_impl_t*>(data);
+
+	for (int root : impl->_roots)
+	{
+		st_job_graph_node_t* node = impl->_nodes[root];
+		st_job::extend(&node->_decl, 1, impl->_counter, node->_priority);
+	}
+}
+
+static void _st_job_graph_node_entry(void* data)
+{
+	st_job_graph_node_t* node = static_cast<st_job_graph_node_t*>(data);
+	st_job_graph_impl_t* impl = node->_graph;
+
+	node->_entry(node->_data);
+
+	/* This node still counts against the batch, so it can't finish while we add to it. */
+	for (int index : node->_successors)
+	{
+		st_job_graph_node_t* successor = impl->_nodes[index];
+		if (--successor->_remaining == 0)
+		{
+			st_job::extend(&successor->_decl, 1, impl->_counter, successor->_priority);
+		}
+	}
+}
+
+static void _st_job_graph_build_roots(st_job_graph_impl_t* impl)
+{
+	impl->_roots.clear();
+	for (int i = 0; i < int(impl->_nodes.size()); ++i)
+	{
+		if (impl->_nodes[i]->_predecessor_count == 0)
+		{
+			impl->_roots.push_back(i);
+		}
+	}
+
+#if defined(_DEBUG)
+	/* Every node must be reachable from a root without a cycle, or the graph would never finish. */
+	std::vector<int> remaining(impl->_nodes.size());
+	for (int i = 0; i < int(impl->_nodes.size()); ++i)
+	{
+		remaining[i] = impl->_nodes[i]->_predecessor_count;
+	}
+
+	std::vector<int> open = impl->_roots;
+	int visited = 0;
+	while (!open.empty())
+	{
+		int index = open.back();
+		open.pop_back();
+		visited++;
+
+		for (int successor : impl->_nodes[index]->_successors)
+		{
+			if (--remaining[successor] == 0)
+			{
+				open.push_back(successor);
+			}
+		}
+	}
+	assert(visited == int(impl->_nodes.size()) && "st_job_graph has a cycle");
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_job.h"
+
+/*
+** A fixed set of jobs and the order they must run in, built once and run as
+** often as needed, e.g. once per frame.
+** Each node starts as soon as every node it depends on has finished, so nodes
+** with no path between them may run at the same time.
+*/
+class st_job_graph
+{
+public:
+	st_job_graph();
+	~st_job_graph();
+
+	/*
+	** Returns the node's index, for use with add_dependency.
+	** The name is shown in traces and must be a string literal.
+	*/
+	int add_node(
+		const char* name,
+		st_job_function_t entry,
+		void* data,
+		e_st_job_priority priority = st_job_priority_normal,
+		e_st_job_stack_size stack_size = st_job_stack_small);
+
+	/*
+	** Node after won't start until node before has finished.
+	*/
+	void add_dependency(int before, int after);
+
+	/*
+	** Start every node. The counter is cleared once all of them have finished.
+	** The graph must not be run again or modified until then.
+	*/
+	void run(st_job_counter_t* counter);
+
+	int get_node_count() const;
+
+private:
+	void* _impl;
+};
@@ -0,0 +1,154 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_ring_queue.h"
+
+#include <atomic>
+#include <cstdint>
+
+struct st_ring_queue_slot_t
+{
+	/*
+	** Equal to the slot's position when it is free to be written, and to the
+	** position plus one once it holds data ready to be read.
+	*/
+	std::atomic<uint64_t> _sequence;
+	void* _data;
+};
+
+struct st_ring_queue_impl_t
+{
+	/* Producers and consumers advance separate positions. Keep them on separate cache lines. */
+	alignas(64) std::atomic<uint64_t> _push_position;
+	alignas(64) std::atomic<uint64_t> _pop_position;
+
+	alignas(64) uint64_t _mask;
+	st_ring_queue_slot_t* _slots;
+};
+
+st_ring_queue::st_ring_queue(int capacity)
+{
+	auto impl = new st_ring_queue_impl_t;
+
+	/* Round the capacity up to a power of two so positions can wrap with a mask. */
+	uint64_t size = 2;
+	while (size < uint64_t(capacity))
+	{
+		size <<= 1;
+	}
+
+	impl->_push_position = 0;
+	impl->_pop_position = 0;
+	impl->_mask = size - 1;
+	impl->_slots = new st_ring_queue_slot_t[size];
+	for (uint64_t i = 0; i < size; ++i)
+	{
+		impl->_slots[i]._sequence.store(i, std::memory_order_relaxed);
+		impl->_slots[i]._data = 0;
+	}
+
+	_impl = impl;
+}
+
+st_ring_queue::~st_ring_queue()
+{
+	st_ring_queue_impl_t* impl = static_cast<st_ring_queue_impl_t*>(_impl);
+	delete[] impl->_slots;
+	delete impl;
+}
+
+bool st_ring_queue::push(void* data)
+{
+	st_ring_queue_impl_t* impl = static_cast<st_ring_queue_impl_t*>(_impl);
+
+	st_ring_queue_slot_t* slot;
+	uint64_t position = impl->_push_position.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		slot = &impl->_slots[position & impl->_mask];
+		uint64_t sequence = slot->_sequence.load(std::memory_order_acquire);
+		int64_t difference = int64_t(sequence) - int64_t(position);
+
+		/* The slot is free. Claim the position. */
+		if (difference == 0)
+		{
+			if (impl->_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		/* The slot still holds data from the previous lap, so the queue is full. */
+		else if (difference < 0)
+		{
+			return false;
+		}
+		/* Another producer claimed this position first. */
+		else
+		{
+			position = impl->_push_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->_data = data;
+	slot->_sequence.store(position + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool st_ring_queue::pop(void** data)
+{
+	st_ring_queue_impl_t* impl = static_cast<st_ring_queue_impl_t*>(_impl);
+
+	st_ring_queue_slot_t* slot;
+	uint64_t position = impl->_pop_position.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		slot = &impl->_slots[position & impl->_mask];
+		uint64_t sequence = slot->_sequence.load(std::memory_order_acquire);
+		int64_t difference = int64_t(sequence) - int64_t(position + 1);
+
+		/* The slot holds data. Claim the position. */
+		if (difference == 0)
+		{
+			if (impl->_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		/* Nothing has been written here yet, so the queue is empty. */
+		else if (difference < 0)
+		{
+			return false;
+		}
+		/* Another consumer claimed this position first. */
+		else
+		{
+			position = impl->_pop_position.load(std::memory_order_relaxed);
+		}
+	}
+
+	*data = slot->_data;
+
+	/* Hand the slot to the producer that will reach it on the next lap. */
+	slot->_sequence.store(position + impl->_mask + 1, std::memory_order_release);
+
+	return true;
+}
+
+int st_ring_queue::get_count() const
+{
+	st_ring_queue_impl_t* impl = static_cast<st_ring_queue_impl_t*>(_impl);
+
+	uint64_t pop_position = impl->_pop_position.load(std::memory_order_relaxed);
+	uint64_t push_position = impl->_push_position.load(std::memory_order_relaxed);
+	return push_position > pop_position ? int(push_position - pop_position) : 0;
+}
+
+int st_ring_queue::get_capacity() const
+{
+	st_ring_queue_impl_t* impl = static_cast<st_ring_queue_impl_t*>(_impl);
+	return int(impl->_mask + 1);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Bounded, lock-free multi-producer multi-consumer queue.
+** A ring buffer where each slot carries a sequence number, so producers and
+** consumers only contend on a single compare-and-swap each.
+** http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+*/
+class st_ring_queue
+{
+public:
+	st_ring_queue(int capacity);
+	~st_ring_queue();
+
+	/*
+	** Fails if the queue is full.
+	*/
+	bool push(void* data);
+
+	/*
+	** Fails if the queue is empty.
+	*/
+	bool pop(void** data);
+
+	/*
+	** Approximate when other threads are pushing or popping.
+	*/
+	int get_count() const;
+
+	int get_capacity() const;
+
+private:
+	void* _impl;
+};
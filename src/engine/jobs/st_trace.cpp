@@ -0,0 +1,199 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct st_trace_event_t
+{
+	const char* _name;
+	const void* _entry;
+	const void* _counter;
+	uint64_t _time;
+	int32_t _fiber;
+	char _phase;
+};
+
+/* Events per thread. Must be a power of two. */
+static const uint64_t k_st_trace_buffer_size = 1 << 15;
+
+struct st_trace_buffer_t
+{
+	char _thread_name[32];
+	int _thread_id;
+
+	/* Total events written. Only the owning thread stores to it. */
+	std::atomic<uint64_t> _write_count;
+
+	st_trace_event_t _events[k_st_trace_buffer_size];
+};
+
+static std::atomic<bool> _st_trace_enabled{ true };
+
+/* Every buffer ever created. Buffers live until exit so a trace can be written at any time. */
+static std::vector<st_trace_buffer_t*> _st_trace_buffers;
+static std::atomic_flag _st_trace_buffers_lock = ATOMIC_FLAG_INIT;
+
+static thread_local st_trace_buffer_t* _st_trace_thread_buffer = nullptr;
+
+static const std::chrono::steady_clock::time_point _st_trace_epoch = std::chrono::steady_clock::now();
+
+static st_trace_buffer_t* _st_trace_get_buffer()
+{
+	st_trace_buffer_t* buffer = _st_trace_thread_buffer;
+	if (!buffer)
+	{
+		buffer = new st_trace_buffer_t;
+		buffer->_write_count = 0;
+
+		while (_st_trace_buffers_lock.test_and_set(std::memory_order_acquire)) {}
+		buffer->_thread_id = int(_st_trace_buffers.size());
+		_st_trace_buffers.push_back(buffer);
+		_st_trace_buffers_lock.clear(std::memory_order_release);
+
+		snprintf(buffer->_thread_name, sizeof(buffer->_thread_name), "thread %d", buffer->_thread_id);
+
+		_st_trace_thread_buffer = buffer;
+	}
+	return buffer;
+}
+
+static void _st_trace_record(char phase, const char* name, const void* entry, const void* counter, int32_t fiber)
+{
+	if (!_st_trace_enabled.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	st_trace_buffer_t* buffer = _st_trace_get_buffer();
+
+	uint64_t index = buffer->_write_count.load(std::memory_order_relaxed);
+	st_trace_event_t* event = &buffer->_events[index & (k_st_trace_buffer_size - 1)];
+	event->_name = name;
+	event->_entry = entry;
+	event->_counter = counter;
+	event->_time = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - _st_trace_epoch).count());
+	event->_fiber = fiber;
+	event->_phase = phase;
+
+	buffer->_write_count.store(index + 1, std::memory_order_release);
+}
+
+void st_trace::begin(const char* name, const void* entry, const void* counter, int32_t fiber)
+{
+	_st_trace_record('B', name, entry, counter, fiber);
+}
+
+void st_trace::end(const char* name)
+{
+	_st_trace_record('E', name, nullptr, nullptr, -1);
+}
+
+void st_trace::instant(const char* name, const void* entry, const void* counter, int32_t fiber)
+{
+	_st_trace_record('i', name, entry, counter, fiber);
+}
+
+void st_trace::set_thread_name(const char* name)
+{
+	st_trace_buffer_t* buffer = _st_trace_get_buffer();
+	snprintf(buffer->_thread_name, sizeof(buffer->_thread_name), "%s", name);
+}
+
+void st_trace::set_enabled(bool enabled)
+{
+	_st_trace_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool st_trace::is_enabled()
+{
+	return _st_trace_enabled.load(std::memory_order_relaxed);
+}
+
+static void _st_trace_write_string(FILE* file, const char* string)
+{
+	fputc('"', file);
+	for (const char* c = string; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			fputc('\\', file);
+		}
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+bool st_trace::write_chrome_trace(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		return false;
+	}
+
+	while (_st_trace_buffers_lock.test_and_set(std::memory_order_acquire)) {}
+	std::vector<st_trace_buffer_t*> buffers = _st_trace_buffers;
+	_st_trace_buffers_lock.clear(std::memory_order_release);
+
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+	bool first = true;
+	for (st_trace_buffer_t* buffer : buffers)
+	{
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":",
+			first ? "" : ",\n",
+			buffer->_thread_id);
+		_st_trace_write_string(file, buffer->_thread_name);
+		fprintf(file, "}}");
+		first = false;
+
+		/*
+		** Skip the oldest part of a full buffer, it's the part most likely to be
+		** overwritten while we read.
+		*/
+		uint64_t write_count = buffer->_write_count.load(std::memory_order_acquire);
+		uint64_t read_count = write_count < k_st_trace_buffer_size ? write_count : k_st_trace_buffer_size - k_st_trace_buffer_size / 8;
+
+		for (uint64_t i = write_count - read_count; i < write_count; ++i)
+		{
+			const st_trace_event_t& event = buffer->_events[i & (k_st_trace_buffer_size - 1)];
+
+			fprintf(file, ",\n{\"name\":");
+			_st_trace_write_string(file, event._name ? event._name : "");
+			fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d",
+				event._phase,
+				double(event._time) / 1000.0,
+				buffer->_thread_id);
+
+			if (event._phase == 'i')
+			{
+				fprintf(file, ",\"s\":\"t\"");
+			}
+
+			if (event._entry || event._counter || event._fiber >= 0)
+			{
+				fprintf(file, ",\"args\":{\"entry\":\"%p\",\"counter\":\"%p\",\"fiber\":%d}",
+					event._entry,
+					event._counter,
+					event._fiber);
+			}
+
+			fprintf(file, "}");
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	return true;
+}
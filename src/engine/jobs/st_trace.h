@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <cstdint>
+
+/*
+** Tracing is compiled in everywhere but release builds. When compiled out,
+** the ST_TRACE_* macros expand to nothing.
+*/
+#if !defined(ST_TRACE_ENABLED)
+#if defined(_RELEASE)
+#define ST_TRACE_ENABLED 0
+#else
+#define ST_TRACE_ENABLED 1
+#endif
+#endif
+
+/*
+** Lightweight timeline tracing.
+** Each thread records begin, end and instant events into its own ring buffer,
+** overwriting the oldest events when it fills. Recording takes no locks.
+** Buffers can be written out as Chrome trace JSON, viewable in
+** chrome://tracing or https://ui.perfetto.dev.
+**
+** Event names must be string literals, or otherwise outlive the trace.
+*/
+class st_trace
+{
+public:
+	static void begin(const char* name, const void* entry = nullptr, const void* counter = nullptr, int32_t fiber = -1);
+	static void end(const char* name);
+	static void instant(const char* name, const void* entry = nullptr, const void* counter = nullptr, int32_t fiber = -1);
+
+	/*
+	** Names the calling thread in the exported trace.
+	*/
+	static void set_thread_name(const char* name);
+
+	/*
+	** Recording starts enabled. Disabling it leaves a single branch per event.
+	*/
+	static void set_enabled(bool enabled);
+	static bool is_enabled();
+
+	/*
+	** Write every thread's buffered events to a Chrome trace JSON file.
+	** Events recorded while this runs may be missing or, on a thread whose
+	** buffer wraps meanwhile, garbled; call it between frames.
+	*/
+	static bool write_chrome_trace(const char* path);
+};
+
+/*
+** Records a begin event now and the matching end event at the end of the scope.
+*/
+class st_trace_scope
+{
+public:
+	st_trace_scope(const char* name) : _name(name) { st_trace::begin(name); }
+	~st_trace_scope() { st_trace::end(_name); }
+
+private:
+	const char* _name;
+};
+
+#if ST_TRACE_ENABLED
+#define ST_TRACE_CONCAT_IMPL(a, b) a##b
+#define ST_TRACE_CONCAT(a, b) ST_TRACE_CONCAT_IMPL(a, b)
+#define ST_TRACE_SCOPE(name) st_trace_scope ST_TRACE_CONCAT(_st_trace_scope_, __LINE__)(name)
+#define ST_TRACE_BEGIN(...) st_trace::begin(__VA_ARGS__)
+#define ST_TRACE_END(name) st_trace::end(name)
+#define ST_TRACE_INSTANT(...) st_trace::instant(__VA_ARGS__)
+#define ST_TRACE_THREAD_NAME(name) st_trace::set_thread_name(name)
+#else
+#define ST_TRACE_SCOPE(name)
+#define ST_TRACE_BEGIN(...)
+#define ST_TRACE_END(name)
+#define ST_TRACE_INSTANT(...)
+#define ST_TRACE_THREAD_NAME(name)
+#endif
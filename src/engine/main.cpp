@@ -32,6 +32,8 @@
 #include <gui/st_label.h>
 
 #include <jobs/st_job.h>
+#include <jobs/st_job_graph.h>
+#include <jobs/st_trace.h>
 
 #include <physics/st_physics_component.h>
 #include <physics/st_playermove_component.h>
@@ -81,7 +83,7 @@ int main(int argc, const char** argv)
 	set_root_path(argv[0]);
 	e_st_graphics_api api = get_api(argc, argv);
 
-	st_job::startup(0xffff, 256, 256);
+	st_job::startup(st_job_cpu_mask_t::all(), 256, 256);
 
 	std::unique_ptr<st_input> input = std::make_unique<st_input>();
 
@@ -113,9 +115,66 @@ int main(int argc, const char** argv)
 	// TODO: HACK: Commit all loaded resources.
 	//output->submit_loading();
 
+	// The per-frame update runs as a job graph. The camera doesn't depend on
+	// the sim or physics, so it runs alongside them. The sim and physics call
+	// deep into entity and collision code, so they get large stacks.
+	struct st_frame_update_t
+	{
+		st_frame_params* _params;
+		st_camera* _camera;
+		st_sim* _sim;
+		st_physics_world* _world;
+	};
+	st_frame_update_t frame_update = { nullptr, camera.get(), sim.get(), world.get() };
+
+	st_job_graph frame_graph;
+	frame_graph.add_node(
+		"camera",
+		[](void* data)
+		{
+			st_frame_update_t* update = static_cast<st_frame_update_t*>(data);
+			update->_camera->update(update->_params);
+		},
+		&frame_update,
+		st_job_priority_critical);
+	int sim_node = frame_graph.add_node(
+		"sim",
+		[](void* data)
+		{
+			st_frame_update_t* update = static_cast<st_frame_update_t*>(data);
+			update->_sim->update(update->_params);
+		},
+		&frame_update,
+		st_job_priority_critical,
+		st_job_stack_large);
+	int physics_node = frame_graph.add_node(
+		"physics",
+		[](void* data)
+		{
+			st_frame_update_t* update = static_cast<st_frame_update_t*>(data);
+			update->_world->step(update->_params);
+		},
+		&frame_update,
+		st_job_priority_critical,
+		st_job_stack_large);
+	int late_update_node = frame_graph.add_node(
+		"late_update",
+		[](void* data)
+		{
+			st_frame_update_t* update = static_cast<st_frame_update_t*>(data);
+			update->_sim->late_update(update->_params);
+		},
+		&frame_update,
+		st_job_priority_critical,
+		st_job_stack_large);
+	frame_graph.add_dependency(sim_node, physics_node);
+	frame_graph.add_dependency(physics_node, late_update_node);
+
 	// Main loop:
 	while (true)
 	{
+		ST_TRACE_BEGIN("frame");
+
 		if (output->update_swap_chain())
 		{
 			camera->resize(window->get_width(), window->get_height());
@@ -126,26 +185,30 @@ int main(int argc, const char** argv)
 		// Pump messages.
 		if (!window->update())
 		{
+			ST_TRACE_END("frame");
 			break;
 		}
 
+		// Roll over the job system's per-frame statistics.
+		st_job::begin_frame();
+
 		// We pass frame state through the 3 phases using a params object.
 		st_frame_params params;
 
 		// Gather user input and current time.
+		ST_TRACE_BEGIN("input");
 		input->update(&params);
+		ST_TRACE_END("input");
 
-		// Update the camera.
-		camera->update(&params);
-
-		// Run gameplay.
-		sim->update(&params);
+		// Update the camera, run gameplay, step the physics world and perform
+		// the late update.
+		frame_update._params = &params;
 
-		// Step the physics world.
-		world->step(&params);
-
-		// Perform the late update.
-		sim->late_update(&params);
+		ST_TRACE_BEGIN("update");
+		st_job_counter_t frame_counter;
+		frame_graph.run(&frame_counter);
+		st_job::wait(&frame_counter);
+		ST_TRACE_END("update");
 
 		st_imgui::update(&params, sim.get(), camera.get());
 #if 0
@@ -154,7 +217,11 @@ int main(int argc, const char** argv)
 #endif
 
 		// Draw to screen.
+		ST_TRACE_BEGIN("output");
 		output->update(&params);
+		ST_TRACE_END("output");
+
+		ST_TRACE_END("frame");
 	}
 
 	delete g_font;
@@ -0,0 +1,142 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_aabb3f.h"
+
+#include "math/st_affine3f.h"
+#include "math/st_math.h"
+
+#include <cfloat>
+
+void st_aabb3f::make_empty()
+{
+	min = st_vec3f::splat(FLT_MAX);
+	max = st_vec3f::splat(-FLT_MAX);
+}
+
+void st_aabb3f::make_from_points(const st_vec3f* points, int count)
+{
+	make_empty();
+	for (int i = 0; i < count; ++i)
+	{
+		merge(points[i]);
+	}
+}
+
+void st_aabb3f::make_from_center(const st_vec3f& __restrict center, const st_vec3f& __restrict extents)
+{
+	min = center - extents;
+	max = center + extents;
+}
+
+bool st_aabb3f::is_empty() const
+{
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+st_vec3f st_aabb3f::get_center() const
+{
+	return (min + max).scale_result(0.5f);
+}
+
+st_vec3f st_aabb3f::get_extents() const
+{
+	return (max - min).scale_result(0.5f);
+}
+
+float st_aabb3f::get_surface_area() const
+{
+	st_vec3f size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+void st_aabb3f::merge(const st_vec3f& __restrict point)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		min.axes[i] = st_min(min.axes[i], point.axes[i]);
+		max.axes[i] = st_max(max.axes[i], point.axes[i]);
+	}
+}
+
+void st_aabb3f::merge(const st_aabb3f& __restrict b)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		min.axes[i] = st_min(min.axes[i], b.min.axes[i]);
+		max.axes[i] = st_max(max.axes[i], b.max.axes[i]);
+	}
+}
+
+bool st_aabb3f::contains(const st_vec3f& __restrict point) const
+{
+	bool is_inside = true;
+	for (int i = 0; i < 3; ++i)
+	{
+		is_inside = is_inside && point.axes[i] >= min.axes[i] && point.axes[i] <= max.axes[i];
+	}
+	return is_inside;
+}
+
+bool st_aabb3f::contains(const st_aabb3f& __restrict b) const
+{
+	bool is_inside = true;
+	for (int i = 0; i < 3; ++i)
+	{
+		is_inside = is_inside && b.min.axes[i] >= min.axes[i] && b.max.axes[i] <= max.axes[i];
+	}
+	return is_inside;
+}
+
+bool st_aabb3f::intersects(const st_aabb3f& __restrict b) const
+{
+	bool is_overlapping = true;
+	for (int i = 0; i < 3; ++i)
+	{
+		is_overlapping = is_overlapping && min.axes[i] <= b.max.axes[i] && b.min.axes[i] <= max.axes[i];
+	}
+	return is_overlapping;
+}
+
+st_aabb3f st_aabb3f::transform(const st_affine3f& __restrict m) const
+{
+	if (is_empty())
+	{
+		return *this;
+	}
+
+	/*
+	** Arvo's method: start from the translation, then each matrix entry adds
+	** whichever of its products with min and max falls on each side.
+	*/
+	st_aabb3f result;
+	for (int i = 0; i < 3; ++i)
+	{
+		float lo = m.data[i][3];
+		float hi = m.data[i][3];
+		for (int j = 0; j < 3; ++j)
+		{
+			float a = m.data[i][j] * min.axes[j];
+			float b = m.data[i][j] * max.axes[j];
+			lo += st_min(a, b);
+			hi += st_max(a, b);
+		}
+		result.min.axes[i] = lo;
+		result.max.axes[i] = hi;
+	}
+	return result;
+}
+
+st_aabb3f st_aabb3f_merge(const st_aabb3f* boxes, int count)
+{
+	st_aabb3f result;
+	result.make_empty();
+	for (int i = 0; i < count; ++i)
+	{
+		result.merge(boxes[i]);
+	}
+	return result;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math_fwd.h"
+#include "math/st_vec3f.h"
+
+/*
+** Axis aligned bounding box.
+**
+** An empty box has min greater than max on every axis, so that merging
+** anything into it yields that thing.
+*/
+struct st_aabb3f
+{
+	st_vec3f min;
+	st_vec3f max;
+
+	/*
+	** Build an empty box.
+	*/
+	void make_empty();
+
+	/*
+	** Build the smallest box containing the points.
+	*/
+	void make_from_points(const st_vec3f* points, int count);
+
+	/*
+	** Build a box from its center and half extents.
+	*/
+	void make_from_center(const st_vec3f& __restrict center, const st_vec3f& __restrict extents);
+
+	bool is_empty() const;
+
+	st_vec3f get_center() const;
+
+	/*
+	** Get the half extents of the box.
+	*/
+	st_vec3f get_extents() const;
+
+	/*
+	** Get the total area of the six faces, the usual cost of a box in a
+	** bounding volume hierarchy.
+	*/
+	float get_surface_area() const;
+
+	/*
+	** Grow the box to contain a point or another box.
+	*/
+	void merge(const st_vec3f& __restrict point);
+	void merge(const st_aabb3f& __restrict b);
+
+	bool contains(const st_vec3f& __restrict point) const;
+	bool contains(const st_aabb3f& __restrict b) const;
+	bool intersects(const st_aabb3f& __restrict b) const;
+
+	/*
+	** Get the box bounding this one after an affine transform.
+	** The result is exact for the transformed corners, and empty stays empty.
+	*/
+	st_aabb3f transform(const st_affine3f& __restrict m) const;
+};
+
+/*
+** The smallest box containing count boxes; empty when count is zero.
+*/
+st_aabb3f st_aabb3f_merge(const st_aabb3f* boxes, int count);
@@ -0,0 +1,252 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_affine3f.h"
+
+#include "math/st_math.h"
+#include "math/st_simd.h"
+
+void st_affine3f::make_identity()
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			data[i][j] = i == j ? 1.0f : 0.0f;
+		}
+	}
+}
+
+void st_affine3f::make_translation(const st_vec3f& __restrict t)
+{
+	make_identity();
+	data[0][3] = t.x;
+	data[1][3] = t.y;
+	data[2][3] = t.z;
+}
+
+void st_affine3f::make_scaling(float s)
+{
+	make_identity();
+	for (int i = 0; i < 3; ++i)
+	{
+		data[i][i] = s;
+	}
+}
+
+void st_affine3f::make_rotation(const st_quatf& __restrict q)
+{
+	data[0][0] = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+	data[0][1] = 2.0f * (q.x * q.y - q.z * q.w);
+	data[0][2] = 2.0f * (q.x * q.z + q.y * q.w);
+	data[0][3] = 0.0f;
+	data[1][0] = 2.0f * (q.x * q.y + q.z * q.w);
+	data[1][1] = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+	data[1][2] = 2.0f * (q.y * q.z - q.x * q.w);
+	data[1][3] = 0.0f;
+	data[2][0] = 2.0f * (q.x * q.z - q.y * q.w);
+	data[2][1] = 2.0f * (q.y * q.z + q.x * q.w);
+	data[2][2] = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+	data[2][3] = 0.0f;
+}
+
+void st_affine3f::make_from_mat4f(const st_mat4f& __restrict m)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			data[i][j] = m.data[i][j];
+		}
+	}
+}
+
+st_mat4f st_affine3f::to_mat4f() const
+{
+	st_mat4f result;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			result.data[i][j] = data[i][j];
+		}
+	}
+	result.data[3][0] = 0.0f;
+	result.data[3][1] = 0.0f;
+	result.data[3][2] = 0.0f;
+	result.data[3][3] = 1.0f;
+	return result;
+}
+
+void st_affine3f::translate(const st_vec3f& __restrict t)
+{
+	data[0][3] += t.x;
+	data[1][3] += t.y;
+	data[2][3] += t.z;
+}
+
+void st_affine3f::scale(float s)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			data[i][j] *= s;
+		}
+	}
+}
+
+void st_affine3f::rotate(const st_quatf& __restrict q)
+{
+	st_affine3f tmp;
+	tmp.make_rotation(q);
+	(*this) *= tmp;
+}
+
+st_affine3f st_affine3f::operator*(const st_affine3f& __restrict b) const
+{
+	st_affine3f result;
+#if defined(ST_SIMD)
+	/* Each result row combines this transform's rows, with an implicit (0, 0, 0, 1) fourth row. */
+	st_simd4f row0 = st_simd4f_load(data[0]);
+	st_simd4f row1 = st_simd4f_load(data[1]);
+	st_simd4f row2 = st_simd4f_load(data[2]);
+	for (int j = 0; j < 3; ++j)
+	{
+		st_simd4f tmp = st_simd4f_mul(row0, st_simd4f_splat(b.data[j][0]));
+		tmp = st_simd4f_add(tmp, st_simd4f_mul(row1, st_simd4f_splat(b.data[j][1])));
+		tmp = st_simd4f_add(tmp, st_simd4f_mul(row2, st_simd4f_splat(b.data[j][2])));
+		tmp = st_simd4f_add(tmp, st_simd4f_set(0.0f, 0.0f, 0.0f, b.data[j][3]));
+		st_simd4f_store(result.data[j], tmp);
+	}
+#else
+	for (int j = 0; j < 3; ++j)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			float tmp = data[0][i] * b.data[j][0] + data[1][i] * b.data[j][1] + data[2][i] * b.data[j][2];
+			result.data[j][i] = i == 3 ? tmp + b.data[j][3] : tmp;
+		}
+	}
+#endif
+	return result;
+}
+
+st_affine3f& st_affine3f::operator*=(const st_affine3f& __restrict b)
+{
+	(*this) = (*this) * b;
+	return (*this);
+}
+
+st_vec3f st_affine3f::transform_vector(const st_vec3f& __restrict in) const
+{
+	st_vec3f result;
+	result.x = in.x * data[0][0] + in.y * data[0][1] + in.z * data[0][2];
+	result.y = in.x * data[1][0] + in.y * data[1][1] + in.z * data[1][2];
+	result.z = in.x * data[2][0] + in.y * data[2][1] + in.z * data[2][2];
+	return result;
+}
+
+st_vec3f st_affine3f::transform_point(const st_vec3f& __restrict in) const
+{
+	st_vec3f result;
+	result.x = in.x * data[0][0] + in.y * data[0][1] + in.z * data[0][2] + data[0][3];
+	result.y = in.x * data[1][0] + in.y * data[1][1] + in.z * data[1][2] + data[1][3];
+	result.z = in.x * data[2][0] + in.y * data[2][1] + in.z * data[2][2] + data[2][3];
+	return result;
+}
+
+void st_affine3f::invert()
+{
+	/* Invert the linear part, then move the translation through it. */
+	st_mat3f linear = get_linear();
+	linear.invert();
+
+	st_vec3f translation = linear.transform(get_translation());
+
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			data[i][j] = linear.data[i][j];
+		}
+		data[i][3] = -translation.axes[i];
+	}
+}
+
+st_affine3f st_affine3f::inverse() const
+{
+	st_affine3f inverse = (*this);
+	inverse.invert();
+	return inverse;
+}
+
+bool st_affine3f::equal(const st_affine3f& __restrict b) const
+{
+	bool is_not_equal = false;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			is_not_equal = is_not_equal || !st_equalf(data[i][j], b.data[i][j]);
+		}
+	}
+	return !is_not_equal;
+}
+
+st_mat3f st_affine3f::get_linear() const
+{
+	st_mat3f result;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			result.data[i][j] = data[i][j];
+		}
+	}
+	return result;
+}
+
+st_vec3f st_affine3f::get_translation() const
+{
+	return { data[0][3], data[1][3], data[2][3] };
+}
+
+void st_affine3f::set_translation(const st_vec3f& translation)
+{
+	data[0][3] = translation.x;
+	data[1][3] = translation.y;
+	data[2][3] = translation.z;
+}
+
+float st_affine3f::get_scale() const
+{
+	return data[0][0];
+}
+
+st_vec3f st_affine3f::get_forward() const
+{
+	return{ data[0][2], data[1][2], data[2][2] };
+}
+
+st_vec3f st_affine3f::get_up() const
+{
+	return{ data[0][1], data[1][1], data[2][1] };
+}
+
+st_vec3f st_affine3f::get_right() const
+{
+	return{ data[0][0], data[1][0], data[2][0] };
+}
+
+void st_affine3f_multiply_batch(const st_affine3f* a, const st_affine3f* b, st_affine3f* out, int count)
+{
+	/* The product is formed before it is stored, so the output may alias an input. */
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = a[i] * b[i];
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_mat3f.h"
+#include "math/st_mat4f.h"
+#include "math/st_quatf.h"
+#include "math/st_vec3f.h"
+
+/*
+** Floating point 3x4 affine transform.
+**
+** Holds the top three rows of an st_mat4f, whose last row is always
+** (0, 0, 0, 1), with the same indexing: translation is the fourth column.
+** Products follow st_mat4f, so a * b applies a first and then b.
+*/
+struct st_affine3f
+{
+	float data[3][4];
+
+	/*
+	** Build an identity transform.
+	*/
+	void make_identity();
+
+	/*
+	** Build a translation transform.
+	*/
+	void make_translation(const st_vec3f& __restrict t);
+
+	/*
+	** Build a uniform scaling transform.
+	*/
+	void make_scaling(float s);
+
+	/*
+	** Build a rotation transform.
+	*/
+	void make_rotation(const st_quatf& __restrict q);
+
+	/*
+	** Build from the top three rows of a 4x4 matrix.
+	*/
+	void make_from_mat4f(const st_mat4f& __restrict m);
+
+	/*
+	** Expand to a 4x4 matrix, for use at the GPU boundary.
+	*/
+	st_mat4f to_mat4f() const;
+
+	/*
+	** Apply translation after this transform.
+	*/
+	void translate(const st_vec3f& __restrict t);
+
+	/*
+	** Apply uniform scaling before this transform.
+	*/
+	void scale(float s);
+
+	/*
+	** Apply rotation after this transform.
+	*/
+	void rotate(const st_quatf& __restrict q);
+
+	/*
+	** Compose two transforms, this one first.
+	*/
+	st_affine3f operator*(const st_affine3f& __restrict b) const;
+
+	/*
+	** Compose with another transform, storing the result in this one.
+	*/
+	st_affine3f& operator*=(const st_affine3f& __restrict b);
+
+	/*
+	** Transform a vector, ignoring translation.
+	*/
+	st_vec3f transform_vector(const st_vec3f& __restrict in) const;
+
+	/*
+	** Transform a point.
+	*/
+	st_vec3f transform_point(const st_vec3f& __restrict in) const;
+
+	/*
+	** Invert the transform.
+	*/
+	void invert();
+
+	/*
+	** Return the inverse of this transform.
+	*/
+	st_affine3f inverse() const;
+
+	/*
+	** Determine if two transforms are largely equivalent.
+	*/
+	bool equal(const st_affine3f& __restrict b) const;
+
+	/*
+	** Get the rotation and scale portion of the transform.
+	*/
+	st_mat3f get_linear() const;
+
+	/*
+	** Get the translation portion of the transform.
+	*/
+	st_vec3f get_translation() const;
+
+	/*
+	** Set the translation portion of the transform.
+	*/
+	void set_translation(const st_vec3f& translation);
+
+	/*
+	** Get the scale from the diagonal, assuming it is uniform.
+	*/
+	float get_scale() const;
+
+	/*
+	** Get the forward, up and right vectors.
+	** The third, second and first columns respectively, as in st_mat4f.
+	*/
+	st_vec3f get_forward() const;
+	st_vec3f get_up() const;
+	st_vec3f get_right() const;
+};
+
+/*
+** Compose count pairs of transforms, out[i] = a[i] * b[i]. The output may
+** alias either input.
+*/
+void st_affine3f_multiply_batch(const st_affine3f* a, const st_affine3f* b, st_affine3f* out, int count);
@@ -0,0 +1,125 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_constexpr.tests.h"
+#include "st_mat4f.h"
+#include "st_quatf.h"
+#include "st_vec2f.h"
+#include "st_vec3f.h"
+#include "st_vec4f.h"
+
+#include <cassert>
+#include <cstring>
+
+/*
+** The static_asserts below run whenever this file is compiled. Values are
+** chosen to be exactly representable so the comparisons can be exact.
+*/
+
+static constexpr st_mat4f _st_constexpr_test_translation(const st_vec3f& t)
+{
+	st_mat4f m = {};
+	m.make_translation(t);
+	return m;
+}
+
+static constexpr st_mat4f _st_constexpr_test_scaling(float s)
+{
+	st_mat4f m = {};
+	m.make_scaling(s);
+	return m;
+}
+
+static constexpr st_mat4f _st_constexpr_test_rotation(const st_quatf& q)
+{
+	st_mat4f m = {};
+	m.make_rotation(q);
+	return m;
+}
+
+static constexpr st_mat4f _st_constexpr_test_transposed(st_mat4f m)
+{
+	m.transpose();
+	return m;
+}
+
+static constexpr st_quatf _st_constexpr_test_inverse(st_quatf q)
+{
+	q.inverse();
+	return q;
+}
+
+static constexpr bool _st_constexpr_test_equal(const st_vec3f& a, const st_vec3f& b)
+{
+	return a.axes[0] == b.axes[0] && a.axes[1] == b.axes[1] && a.axes[2] == b.axes[2];
+}
+
+static constexpr bool _st_constexpr_test_equal(const st_vec4f& a, const st_vec4f& b)
+{
+	return a.axes[0] == b.axes[0] && a.axes[1] == b.axes[1] && a.axes[2] == b.axes[2] && a.axes[3] == b.axes[3];
+}
+
+static constexpr bool _st_constexpr_test_equal(const st_quatf& a, const st_quatf& b)
+{
+	return a.axes[0] == b.axes[0] && a.axes[1] == b.axes[1] && a.axes[2] == b.axes[2] && a.axes[3] == b.axes[3];
+}
+
+// Vector operations.
+static constexpr st_vec3f k_test_a = { 1.0f, 2.0f, 3.0f };
+static constexpr st_vec3f k_test_b = { 4.0f, -5.0f, 6.0f };
+static_assert(_st_constexpr_test_equal(k_test_a + k_test_b, { 5.0f, -3.0f, 9.0f }), "add");
+static_assert(_st_constexpr_test_equal(k_test_a - k_test_b, { -3.0f, 7.0f, -3.0f }), "subtract");
+static_assert(_st_constexpr_test_equal(k_test_a * k_test_b, { 4.0f, -10.0f, 18.0f }), "multiply");
+static_assert(_st_constexpr_test_equal(k_test_b / k_test_a, { 4.0f, -2.5f, 2.0f }), "divide");
+static_assert(_st_constexpr_test_equal(-k_test_a, { -1.0f, -2.0f, -3.0f }), "negate");
+static_assert(_st_constexpr_test_equal(k_test_a.scale_result(0.5f), { 0.5f, 1.0f, 1.5f }), "scale");
+static_assert(k_test_a.dot(k_test_b) == 12.0f, "dot");
+static_assert(k_test_a.mag2() == 14.0f, "mag2");
+static_assert(k_test_a.dist2(k_test_b) == 67.0f, "dist2");
+static_assert(_st_constexpr_test_equal(st_vec3f_cross(st_vec3f::x_vector(), st_vec3f::y_vector()), st_vec3f::z_vector()), "cross");
+static_assert(_st_constexpr_test_equal(st_vec3f_cross(k_test_a, k_test_b), { 27.0f, 6.0f, -13.0f }), "cross");
+static_assert(st_vec2f::one_vector().dot(st_vec2f::one_vector()) == 2.0f, "vec2");
+static_assert(st_vec3f::one_vector().mag2() == 3.0f, "vec3 one");
+static_assert(_st_constexpr_test_equal(st_vec4f(k_test_a, 1.0f), { 1.0f, 2.0f, 3.0f, 1.0f }), "vec4 from vec3");
+
+// Quaternion operations. A quarter turn about z is (0, 0, sqrt(1/2), sqrt(1/2)),
+// which is not exact, so the exact tests use a half turn.
+static constexpr st_quatf k_test_half_turn_z = { 0.0f, 0.0f, 1.0f, 0.0f };
+static_assert(_st_constexpr_test_equal(st_quatf::identity() * k_test_half_turn_z, k_test_half_turn_z), "identity");
+static_assert(_st_constexpr_test_equal(k_test_half_turn_z * k_test_half_turn_z, { 0.0f, 0.0f, 0.0f, -1.0f }), "multiply");
+static_assert(_st_constexpr_test_equal(_st_constexpr_test_inverse({ 0.0f, 0.0f, 2.0f, 0.0f }), { 0.0f, 0.0f, -0.5f, 0.0f }), "inverse");
+static_assert(_st_constexpr_test_equal(k_test_half_turn_z.rotate_vector(k_test_a), { -1.0f, -2.0f, 3.0f }), "rotate");
+
+// Matrix builders, and transforms composed at compile time.
+static constexpr st_mat4f k_test_translation = _st_constexpr_test_translation(k_test_a);
+static constexpr st_mat4f k_test_scaling = _st_constexpr_test_scaling(2.0f);
+static constexpr st_mat4f k_test_rotation = _st_constexpr_test_rotation(k_test_half_turn_z);
+static constexpr st_mat4f k_test_composed = k_test_scaling.multiply_scalar(k_test_rotation).multiply_scalar(k_test_translation);
+
+static_assert(_st_constexpr_test_equal(k_test_translation.get_translation(), k_test_a), "translation");
+static_assert(k_test_scaling.get_scale() == 2.0f, "scaling");
+static_assert(_st_constexpr_test_equal(k_test_rotation.get_right(), { -1.0f, 0.0f, 0.0f }), "rotation");
+static_assert(_st_constexpr_test_equal(
+	k_test_composed.transform_scalar({ 1.0f, 0.0f, 0.0f, 1.0f }),
+	{ -1.0f, 2.0f, 3.0f, 1.0f }), "scale, then rotate, then translate");
+static_assert(_st_constexpr_test_equal(
+	_st_constexpr_test_transposed(k_test_translation).transform_scalar({ 0.0f, 0.0f, 0.0f, 1.0f }),
+	{ 0.0f, 0.0f, 0.0f, 1.0f }), "transpose");
+
+void st_constexpr_unit_tests()
+{
+	// Test the compile time reference matches the runtime operators bit for bit.
+	st_mat4f runtime_composed = k_test_scaling * k_test_rotation * k_test_translation;
+	assert(memcmp(&runtime_composed, &k_test_composed, sizeof(st_mat4f)) == 0);
+
+	st_vec4f runtime_point = k_test_composed.transform({ 1.0f, 0.0f, 0.0f, 1.0f });
+	st_vec4f folded_point = k_test_composed.transform_scalar({ 1.0f, 0.0f, 0.0f, 1.0f });
+	assert(memcmp(&runtime_point, &folded_point, sizeof(st_vec4f)) == 0);
+
+	// Test the constexpr quaternion rotation agrees with the rotation matrix.
+	st_vec3f rotated = k_test_half_turn_z.rotate_vector(k_test_b);
+	assert(rotated.equal(k_test_rotation.transform_vector(k_test_b)));
+}
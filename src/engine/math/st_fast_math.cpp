@@ -0,0 +1,83 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_fast_math.h"
+
+void st_rsqrtf_batch(const float* in, float* out, int count)
+{
+	int i = 0;
+#if defined(ST_SIMD)
+	st_simd4f half = st_simd4f_splat(0.5f);
+	st_simd4f three_halves = st_simd4f_splat(1.5f);
+	for (; i + 4 <= count; i += 4)
+	{
+		st_simd4f x = st_simd4f_load(in + i);
+		st_simd4f y = st_simd4f_rsqrt_estimate(x);
+
+		/* One Newton-Raphson step: y * (1.5 - 0.5 * x * y * y). */
+		st_simd4f xyy = st_simd4f_mul(st_simd4f_mul(half, x), st_simd4f_mul(y, y));
+		st_simd4f_store(out + i, st_simd4f_mul(y, st_simd4f_sub(three_halves, xyy)));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		out[i] = st_rsqrtf_fast(in[i]);
+	}
+}
+
+void st_sincosf_batch(const float* in, float* out_sin, float* out_cos, int count)
+{
+	int i = 0;
+#if defined(ST_SIMD)
+	st_simd4f zero = st_simd4f_zero();
+	for (; i + 4 <= count; i += 4)
+	{
+		st_simd4f x = st_simd4f_load(in + i);
+
+		st_simd4f q = st_simd4f_round(st_simd4f_mul(x, st_simd4f_splat(k_st_fast_math_two_over_pi)));
+		st_simd4f r = st_simd4f_sub(x, st_simd4f_mul(q, st_simd4f_splat(k_st_fast_math_pi_over_two_a)));
+		r = st_simd4f_sub(r, st_simd4f_mul(q, st_simd4f_splat(k_st_fast_math_pi_over_two_b)));
+		r = st_simd4f_sub(r, st_simd4f_mul(q, st_simd4f_splat(k_st_fast_math_pi_over_two_c)));
+		st_simd4f r2 = st_simd4f_mul(r, r);
+
+		st_simd4f s = st_simd4f_add(st_simd4f_splat(8.3321608736e-3f), st_simd4f_mul(r2, st_simd4f_splat(-1.9515295891e-4f)));
+		s = st_simd4f_add(st_simd4f_splat(-1.6666654611e-1f), st_simd4f_mul(r2, s));
+		s = st_simd4f_add(r, st_simd4f_mul(st_simd4f_mul(r, r2), s));
+
+		st_simd4f c = st_simd4f_add(st_simd4f_splat(-1.388731625493765e-3f), st_simd4f_mul(r2, st_simd4f_splat(2.443315711809948e-5f)));
+		c = st_simd4f_add(st_simd4f_splat(4.166664568298827e-2f), st_simd4f_mul(r2, c));
+		c = st_simd4f_add(
+			st_simd4f_sub(st_simd4f_splat(1.0f), st_simd4f_mul(st_simd4f_splat(0.5f), r2)),
+			st_simd4f_mul(st_simd4f_mul(r2, r2), c));
+
+		/* Quadrant q mod 4, kept in floats: floor(q / 4) is round(q / 4 - 3 / 8) for integer q. */
+		st_simd4f q_div_4 = st_simd4f_round(st_simd4f_sub(st_simd4f_mul(q, st_simd4f_splat(0.25f)), st_simd4f_splat(0.375f)));
+		st_simd4f quadrant = st_simd4f_sub(q, st_simd4f_mul(q_div_4, st_simd4f_splat(4.0f)));
+
+		st_simd4f is_odd = st_simd4f_select(
+			st_simd4f_equal(quadrant, st_simd4f_splat(1.0f)),
+			st_simd4f_equal(quadrant, quadrant),
+			st_simd4f_equal(quadrant, st_simd4f_splat(3.0f)));
+		st_simd4f negate_sin = st_simd4f_greater(quadrant, st_simd4f_splat(1.5f));
+		st_simd4f negate_cos = st_simd4f_select(
+			st_simd4f_greater(quadrant, st_simd4f_splat(2.5f)),
+			zero,
+			st_simd4f_greater(quadrant, st_simd4f_splat(0.5f)));
+
+		st_simd4f sin_result = st_simd4f_select(is_odd, c, s);
+		st_simd4f cos_result = st_simd4f_select(is_odd, s, c);
+		sin_result = st_simd4f_select(negate_sin, st_simd4f_sub(zero, sin_result), sin_result);
+		cos_result = st_simd4f_select(negate_cos, st_simd4f_sub(zero, cos_result), cos_result);
+
+		st_simd4f_store(out_sin + i, sin_result);
+		st_simd4f_store(out_cos + i, cos_result);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		st_sincosf_fast(in[i], out_sin[i], out_cos[i]);
+	}
+}
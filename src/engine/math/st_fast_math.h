@@ -0,0 +1,230 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math.h"
+#include "math/st_simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+/*
+** Approximate math, chosen per call site.
+**
+** Each function comes in tiers:
+** - exact: st_sqrtf, st_sinf, st_cosf, st_acosf and st_powf from st_math.h, backed by libm.
+** - fast: the *_fast functions below, inline and branch-light.
+** - batched: the *_batch functions, which run the fast tier four lanes at a time.
+**
+** The error bounds quoted are verified by st_fast_math_unit_tests.
+*/
+
+/*
+** Exact reciprocal square root.
+*/
+inline float st_rsqrtf(float x)
+{
+	return 1.0f / st_sqrtf(x);
+}
+
+/*
+** Fast reciprocal square root of a positive, finite x.
+** Hardware estimate (or bit trick) refined by Newton-Raphson.
+** Relative error below 1e-6.
+*/
+inline float st_rsqrtf_fast(float x)
+{
+#if defined(ST_SIMD_SSE)
+	float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#elif defined(ST_SIMD_NEON)
+	float y = vrsqrtes_f32(x);
+	y = y * vrsqrtss_f32(x * y, y);
+#else
+	uint32_t bits;
+	memcpy(&bits, &x, sizeof(bits));
+	bits = 0x5f375a86 - (bits >> 1);
+	float y;
+	memcpy(&y, &bits, sizeof(y));
+	y = y * (1.5f - 0.5f * x * y * y);
+	y = y * (1.5f - 0.5f * x * y * y);
+#endif
+	return y * (1.5f - 0.5f * x * y * y);
+}
+
+/*
+** Round to the nearest integer, halfway cases away from zero.
+*/
+inline float st_roundf_fast(float x)
+{
+	return float(int(x + (x >= 0.0f ? 0.5f : -0.5f)));
+}
+
+/*
+** Sine and cosine on the reduced range [-pi/4, pi/4], and the quadrant
+** reduction shared by the fast and batched tiers.
+**
+** Minimax polynomials from Cephes; the reduction subtracts pi/2 in three
+** parts so it stays accurate for |x| up to 8192.
+*/
+const float k_st_fast_math_two_over_pi = 0.636619772367581343f;
+const float k_st_fast_math_pi_over_two_a = 1.5703125f;
+const float k_st_fast_math_pi_over_two_b = 4.837512969970703125e-4f;
+const float k_st_fast_math_pi_over_two_c = 7.54978995489188216e-8f;
+
+inline float st_sinf_reduced(float r, float r2)
+{
+	return r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+}
+
+inline float st_cosf_reduced(float r2)
+{
+	return 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+}
+
+/*
+** Fast sine and cosine of x, for |x| <= 8192.
+** Absolute error below 2e-7.
+*/
+inline void st_sincosf_fast(float x, float& out_sin, float& out_cos)
+{
+	float q = st_roundf_fast(x * k_st_fast_math_two_over_pi);
+	float r = x - q * k_st_fast_math_pi_over_two_a;
+	r = r - q * k_st_fast_math_pi_over_two_b;
+	r = r - q * k_st_fast_math_pi_over_two_c;
+
+	float r2 = r * r;
+	float s = st_sinf_reduced(r, r2);
+	float c = st_cosf_reduced(r2);
+
+	switch (int(q) & 3)
+	{
+	case 0: out_sin = s; out_cos = c; break;
+	case 1: out_sin = c; out_cos = -s; break;
+	case 2: out_sin = -s; out_cos = -c; break;
+	default: out_sin = -c; out_cos = s; break;
+	}
+}
+
+inline float st_sinf_fast(float x)
+{
+	float s, c;
+	st_sincosf_fast(x, s, c);
+	return s;
+}
+
+inline float st_cosf_fast(float x)
+{
+	float s, c;
+	st_sincosf_fast(x, s, c);
+	return c;
+}
+
+/*
+** Fast arc cosine of x in [-1, 1].
+** Polynomial from Abramowitz and Stegun 4.4.46, scaled by sqrt(1 - |x|).
+** Absolute error below 5e-7.
+*/
+const float k_st_fast_math_acos_coefficients[8] =
+{
+	1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f,
+	0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f,
+};
+
+inline float st_acosf_fast(float x)
+{
+	float a = st_absf(x);
+	float p = k_st_fast_math_acos_coefficients[7];
+	for (int i = 6; i >= 0; --i)
+	{
+		p = p * a + k_st_fast_math_acos_coefficients[i];
+	}
+	float r = st_sqrtf(1.0f - a) * p;
+	return x < 0.0f ? st_PI - r : r;
+}
+
+/*
+** Fast natural logarithm of a positive, finite x.
+** Absolute error below 2e-7 for x in [0.5, 2], relative error below 1e-6 elsewhere.
+*/
+inline float st_logf_fast(float x)
+{
+	/* Split x into a mantissa in [sqrt(1/2), sqrt(2)) and a power of two. */
+	uint32_t bits;
+	memcpy(&bits, &x, sizeof(bits));
+	int e = int((bits >> 23) & 0xff) - 127;
+	bits = (bits & 0x007fffff) | 0x3f800000;
+	float m;
+	memcpy(&m, &bits, sizeof(m));
+	if (m > 1.41421356f)
+	{
+		m *= 0.5f;
+		e += 1;
+	}
+
+	float t = m - 1.0f;
+	float z = t * t;
+	float p = 7.0376836292e-2f;
+	p = p * t - 1.1514610310e-1f;
+	p = p * t + 1.1676998740e-1f;
+	p = p * t - 1.2420140846e-1f;
+	p = p * t + 1.4249322787e-1f;
+	p = p * t - 1.6668057665e-1f;
+	p = p * t + 2.0000714765e-1f;
+	p = p * t - 2.4999993993e-1f;
+	p = p * t + 3.3333331174e-1f;
+
+	float fe = float(e);
+	float y = t * z * p;
+	y += fe * -2.12194440e-4f;
+	y += -0.5f * z;
+	return t + y + fe * 0.693359375f;
+}
+
+/*
+** Fast exponential. Inputs are clamped to the finite float range.
+** Relative error below 1e-6.
+*/
+inline float st_expf_fast(float x)
+{
+	x = st_min(st_max(x, -87.0f), 88.0f);
+
+	float n = st_roundf_fast(x * 1.44269504088896341f);
+	float r = x - n * 0.693359375f;
+	r = r - n * -2.12194440e-4f;
+
+	float p = 1.9875691500e-4f;
+	p = p * r + 1.3981999507e-3f;
+	p = p * r + 8.3334519073e-3f;
+	p = p * r + 4.1665795894e-2f;
+	p = p * r + 1.6666665459e-1f;
+	p = p * r + 5.0000001201e-1f;
+	float y = p * r * r + r + 1.0f;
+
+	uint32_t bits = uint32_t(int(n) + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(scale));
+	return y * scale;
+}
+
+/*
+** Fast power for x >= 0.
+** Relative error below 1e-6 * max(1, |y * ln(x)|).
+*/
+inline float st_powf_fast(float x, float y)
+{
+	if (x <= 0.0f)
+	{
+		return y == 0.0f ? 1.0f : 0.0f;
+	}
+	return st_expf_fast(y * st_logf_fast(x));
+}
+
+/*
+** Batched fast tier. Input and output arrays may be the same.
+*/
+void st_rsqrtf_batch(const float* in, float* out, int count);
+void st_sincosf_batch(const float* in, float* out_sin, float* out_cos, int count);
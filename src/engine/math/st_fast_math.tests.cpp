@@ -0,0 +1,159 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_fast_math.tests.h"
+#include "st_fast_math.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+/*
+** Error bounds of the fast tier, measured against double precision libm.
+** These are the bounds documented in st_fast_math.h.
+*/
+static const double k_st_fast_math_test_rsqrt_relative = 1e-6;
+static const double k_st_fast_math_test_sincos_absolute = 2e-7;
+static const double k_st_fast_math_test_acos_absolute = 5e-7;
+static const double k_st_fast_math_test_log_absolute = 2e-7;
+static const double k_st_fast_math_test_log_relative = 1e-6;
+static const double k_st_fast_math_test_exp_relative = 1e-6;
+static const double k_st_fast_math_test_pow_relative = 1e-6;
+
+static double _st_fast_math_test_relative(double value, double expected)
+{
+	return std::fabs(value - expected) / std::fabs(expected);
+}
+
+/*
+** Geometric sweep from lo to hi, covering every binade evenly.
+*/
+static std::vector<float> _st_fast_math_test_geometric(float lo, float hi, int count)
+{
+	std::vector<float> values(count);
+	double ratio = std::log(double(hi) / double(lo)) / double(count - 1);
+	for (int i = 0; i < count; ++i)
+	{
+		values[i] = float(double(lo) * std::exp(ratio * double(i)));
+	}
+	return values;
+}
+
+static std::vector<float> _st_fast_math_test_linear(float lo, float hi, int count)
+{
+	std::vector<float> values(count);
+	for (int i = 0; i < count; ++i)
+	{
+		values[i] = float(double(lo) + (double(hi) - double(lo)) * double(i) / double(count - 1));
+	}
+	return values;
+}
+
+void st_fast_math_unit_tests()
+{
+	const int k_samples = 200003;
+
+	// Test reciprocal square root over the normal float range.
+	{
+		std::vector<float> in = _st_fast_math_test_geometric(1e-30f, 1e30f, k_samples);
+		for (float x : in)
+		{
+			double expected = 1.0 / std::sqrt(double(x));
+			assert(_st_fast_math_test_relative(st_rsqrtf_fast(x), expected) < k_st_fast_math_test_rsqrt_relative);
+		}
+
+		// The batched tier meets the same bound, including the scalar tail.
+		std::vector<float> out(in.size());
+		st_rsqrtf_batch(in.data(), out.data(), int(in.size()));
+		for (size_t i = 0; i < in.size(); ++i)
+		{
+			double expected = 1.0 / std::sqrt(double(in[i]));
+			assert(_st_fast_math_test_relative(out[i], expected) < k_st_fast_math_test_rsqrt_relative);
+		}
+	}
+
+	// Test sine and cosine across the supported range, and densely near zero.
+	{
+		std::vector<float> in = _st_fast_math_test_linear(-8192.0f, 8192.0f, k_samples);
+		std::vector<float> near_zero = _st_fast_math_test_linear(-7.0f, 7.0f, k_samples);
+		in.insert(in.end(), near_zero.begin(), near_zero.end());
+
+		for (float x : in)
+		{
+			float s, c;
+			st_sincosf_fast(x, s, c);
+			assert(std::fabs(s - std::sin(double(x))) < k_st_fast_math_test_sincos_absolute);
+			assert(std::fabs(c - std::cos(double(x))) < k_st_fast_math_test_sincos_absolute);
+			assert(st_sinf_fast(x) == s);
+			assert(st_cosf_fast(x) == c);
+		}
+
+		std::vector<float> out_sin(in.size());
+		std::vector<float> out_cos(in.size());
+		st_sincosf_batch(in.data(), out_sin.data(), out_cos.data(), int(in.size()));
+		for (size_t i = 0; i < in.size(); ++i)
+		{
+			assert(std::fabs(out_sin[i] - std::sin(double(in[i]))) < k_st_fast_math_test_sincos_absolute);
+			assert(std::fabs(out_cos[i] - std::cos(double(in[i]))) < k_st_fast_math_test_sincos_absolute);
+		}
+
+		// Exact quadrant boundaries.
+		float s, c;
+		st_sincosf_fast(0.0f, s, c);
+		assert(s == 0.0f && c == 1.0f);
+	}
+
+	// Test arc cosine across its domain, including both ends.
+	{
+		for (float x : _st_fast_math_test_linear(-1.0f, 1.0f, k_samples))
+		{
+			assert(std::fabs(st_acosf_fast(x) - std::acos(double(x))) < k_st_fast_math_test_acos_absolute);
+		}
+	}
+
+	// Test logarithm near one, where absolute error matters, and across the range.
+	{
+		for (float x : _st_fast_math_test_linear(0.5f, 2.0f, k_samples))
+		{
+			assert(std::fabs(st_logf_fast(x) - std::log(double(x))) < k_st_fast_math_test_log_absolute);
+		}
+		for (float x : _st_fast_math_test_geometric(1e-30f, 1e30f, k_samples))
+		{
+			double expected = std::log(double(x));
+			if (x < 0.5f || x > 2.0f)
+			{
+				assert(_st_fast_math_test_relative(st_logf_fast(x), expected) < k_st_fast_math_test_log_relative);
+			}
+		}
+	}
+
+	// Test exponential across the finite range.
+	{
+		for (float x : _st_fast_math_test_linear(-87.0f, 88.0f, k_samples))
+		{
+			double expected = std::exp(double(x));
+			assert(_st_fast_math_test_relative(st_expf_fast(x), expected) < k_st_fast_math_test_exp_relative);
+		}
+	}
+
+	// Test power, scaling the bound by the magnitude of the exponent.
+	{
+		std::vector<float> bases = _st_fast_math_test_geometric(1e-3f, 1e3f, 1001);
+		std::vector<float> exponents = _st_fast_math_test_linear(-8.0f, 8.0f, 201);
+		for (float x : bases)
+		{
+			for (float y : exponents)
+			{
+				double expected = std::pow(double(x), double(y));
+				double scale = std::fmax(1.0, std::fabs(double(y) * std::log(double(x))));
+				assert(_st_fast_math_test_relative(st_powf_fast(x, y), expected) < k_st_fast_math_test_pow_relative * scale);
+			}
+		}
+
+		assert(st_powf_fast(0.0f, 2.0f) == 0.0f);
+		assert(st_powf_fast(0.0f, 0.0f) == 1.0f);
+	}
+}
@@ -0,0 +1,144 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_frustum.h"
+
+#include "math/st_aabb3f.h"
+#include "math/st_mat4f.h"
+#include "math/st_soa.h"
+#include "math/st_sphere3f.h"
+
+#include <cassert>
+
+void st_frustum::make_from_view_projection(const st_mat4f& __restrict view_projection)
+{
+	/*
+	** Gribb and Hartmann: with clip = M * p, each clip space bound is a plane
+	** formed from rows of M. DirectX clip space puts the near plane at z = 0.
+	*/
+	const float(&m)[4][4] = view_projection.data;
+	for (int j = 0; j < 4; ++j)
+	{
+		planes[st_frustum_plane_left].axes[j] = m[3][j] + m[0][j];
+		planes[st_frustum_plane_right].axes[j] = m[3][j] - m[0][j];
+		planes[st_frustum_plane_bottom].axes[j] = m[3][j] + m[1][j];
+		planes[st_frustum_plane_top].axes[j] = m[3][j] - m[1][j];
+		planes[st_frustum_plane_near].axes[j] = m[2][j];
+		planes[st_frustum_plane_far].axes[j] = m[3][j] - m[2][j];
+	}
+
+	for (st_vec4f& plane : planes)
+	{
+		float inv_mag = 1.0f / st_sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		plane.scale(inv_mag);
+	}
+}
+
+/*
+** Signed distance from the plane to the box center, plus the box's projected
+** radius onto the normal. The box is outside the plane when this is negative.
+** The batched test below follows the same order of operations.
+*/
+static inline float _st_frustum_box_reach(const st_vec4f& plane, const st_vec3f& center, const st_vec3f& extents)
+{
+	float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+	float radius = st_absf(plane.x) * extents.x + st_absf(plane.y) * extents.y + st_absf(plane.z) * extents.z;
+	return distance + radius;
+}
+
+bool st_frustum::intersects(const st_aabb3f& __restrict box) const
+{
+	st_vec3f center = box.get_center();
+	st_vec3f extents = box.get_extents();
+
+	bool is_outside = false;
+	for (const st_vec4f& plane : planes)
+	{
+		is_outside = is_outside || _st_frustum_box_reach(plane, center, extents) < 0.0f;
+	}
+	return !is_outside;
+}
+
+bool st_frustum::intersects(const st_sphere3f& __restrict sphere) const
+{
+	bool is_outside = false;
+	for (const st_vec4f& plane : planes)
+	{
+		float distance = plane.x * sphere.center.x + plane.y * sphere.center.y + plane.z * sphere.center.z + plane.w;
+		is_outside = is_outside || distance < -sphere.radius;
+	}
+	return !is_outside;
+}
+
+uint32_t st_frustum::intersects8(const st_aabb3f* boxes, int count) const
+{
+	assert(count >= 0 && count <= 8);
+
+	/* Centers and extents by component, with unused lanes zeroed and masked off at the end. */
+	float components[6][8] = {};
+	for (int i = 0; i < count; ++i)
+	{
+		st_vec3f center = boxes[i].get_center();
+		st_vec3f extents = boxes[i].get_extents();
+		for (int c = 0; c < 3; ++c)
+		{
+			components[c][i] = center.axes[c];
+			components[3 + c][i] = extents.axes[c];
+		}
+	}
+
+	st_soa_lane_t zero = _st_soa_splat(0.0f);
+
+	uint32_t outside = 0;
+	for (int i = 0; i < 8; i += k_st_soa_width)
+	{
+		st_soa_lane_t cx = _st_soa_loadu(components[0] + i);
+		st_soa_lane_t cy = _st_soa_loadu(components[1] + i);
+		st_soa_lane_t cz = _st_soa_loadu(components[2] + i);
+		st_soa_lane_t ex = _st_soa_loadu(components[3] + i);
+		st_soa_lane_t ey = _st_soa_loadu(components[4] + i);
+		st_soa_lane_t ez = _st_soa_loadu(components[5] + i);
+
+		/* The least reach over all planes is negative exactly when some plane rejects the box. */
+		st_soa_lane_t least_reach = zero;
+		for (int p = 0; p < st_frustum_plane_count; ++p)
+		{
+			const st_vec4f& plane = planes[p];
+
+			st_soa_lane_t distance = _st_soa_mul(_st_soa_splat(plane.x), cx);
+			distance = _st_soa_add(distance, _st_soa_mul(_st_soa_splat(plane.y), cy));
+			distance = _st_soa_add(distance, _st_soa_mul(_st_soa_splat(plane.z), cz));
+			distance = _st_soa_add(distance, _st_soa_splat(plane.w));
+
+			st_soa_lane_t radius = _st_soa_mul(_st_soa_splat(st_absf(plane.x)), ex);
+			radius = _st_soa_add(radius, _st_soa_mul(_st_soa_splat(st_absf(plane.y)), ey));
+			radius = _st_soa_add(radius, _st_soa_mul(_st_soa_splat(st_absf(plane.z)), ez));
+
+			st_soa_lane_t reach = _st_soa_add(distance, radius);
+			least_reach = p == 0 ? reach : _st_soa_min(least_reach, reach);
+		}
+
+		outside |= uint32_t(_st_soa_mask_bits(_st_soa_greater(zero, least_reach))) << i;
+	}
+
+	return ~outside & ((1u << count) - 1u);
+}
+
+int st_frustum_cull(const st_frustum& frustum, const st_aabb3f* boxes, int count, uint8_t* out_visible)
+{
+	int visible_count = 0;
+	for (int i = 0; i < count; i += 8)
+	{
+		int batch_count = st_min(count - i, 8);
+		uint32_t visible = frustum.intersects8(boxes + i, batch_count);
+		for (int b = 0; b < batch_count; ++b)
+		{
+			out_visible[i + b] = uint8_t((visible >> b) & 1u);
+			visible_count += int(out_visible[i + b]);
+		}
+	}
+	return visible_count;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math_fwd.h"
+#include "math/st_vec4f.h"
+
+#include <cstdint>
+
+enum e_st_frustum_plane
+{
+	st_frustum_plane_left,
+	st_frustum_plane_right,
+	st_frustum_plane_bottom,
+	st_frustum_plane_top,
+	st_frustum_plane_near,
+	st_frustum_plane_far,
+
+	st_frustum_plane_count,
+};
+
+/*
+** View frustum as six inward facing planes.
+**
+** Each plane holds a unit normal in xyz and a distance in w, and a point p is
+** on the inside when dot(normal, p) + w >= 0.
+*/
+struct st_frustum
+{
+	st_vec4f planes[st_frustum_plane_count];
+
+	/*
+	** Build from a view * projection matrix, as from st_frame_params, in the
+	** engine's DirectX style clip space where 0 <= z <= w.
+	*/
+	void make_from_view_projection(const st_mat4f& __restrict view_projection);
+
+	/*
+	** Conservative tests, false only when the volume lies entirely outside one
+	** of the planes. Boxes must not be empty.
+	*/
+	bool intersects(const st_aabb3f& __restrict box) const;
+	bool intersects(const st_sphere3f& __restrict sphere) const;
+
+	/*
+	** Test up to eight boxes at once, all six planes a register at a time.
+	** @returns A mask with bit i set when boxes[i] passes intersects.
+	*/
+	uint32_t intersects8(const st_aabb3f* boxes, int count) const;
+};
+
+/*
+** Test an array of boxes eight at a time, writing 1 to out_visible[i] for each
+** box passing st_frustum::intersects and 0 otherwise.
+** @returns The number of visible boxes.
+*/
+int st_frustum_cull(const st_frustum& frustum, const st_aabb3f* boxes, int count, uint8_t* out_visible);
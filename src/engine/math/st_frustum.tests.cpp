@@ -0,0 +1,207 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_frustum.tests.h"
+#include "st_frustum.h"
+
+#include "st_aabb3f.h"
+#include "st_affine3f.h"
+#include "st_mat4f.h"
+#include "st_sphere3f.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+static st_test_random _st_frustum_test_random(0x2545f491);
+
+static st_vec3f _st_frustum_test_random_vector(float lo, float hi)
+{
+	return { _st_frustum_test_random.next(lo, hi), _st_frustum_test_random.next(lo, hi), _st_frustum_test_random.next(lo, hi) };
+}
+
+static st_aabb3f _st_frustum_test_box(const st_vec3f& center, float half)
+{
+	st_aabb3f box;
+	box.make_from_center(center, st_vec3f::splat(half));
+	return box;
+}
+
+void st_frustum_unit_tests()
+{
+	// A camera at the origin looking down -z, as st_camera builds it.
+	st_mat4f view;
+	view.make_lookat_rh(st_vec3f::zero_vector(), -st_vec3f::z_vector(), st_vec3f::y_vector());
+	st_mat4f projection;
+	projection.make_perspective_rh(st_degrees_to_radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+	st_mat4f view_projection = view * projection;
+
+	st_frustum frustum;
+	frustum.make_from_view_projection(view_projection);
+
+	// Test boxes in front, behind, beside, past the far plane and across the near plane.
+	{
+		assert(frustum.intersects(_st_frustum_test_box({ 0.0f, 0.0f, -10.0f }, 0.5f)));
+		assert(!frustum.intersects(_st_frustum_test_box({ 0.0f, 0.0f, 10.0f }, 0.5f)));
+		assert(!frustum.intersects(_st_frustum_test_box({ 100.0f, 0.0f, -10.0f }, 0.5f)));
+		assert(!frustum.intersects(_st_frustum_test_box({ 0.0f, 0.0f, -200.0f }, 0.5f)));
+		assert(frustum.intersects(_st_frustum_test_box({ 0.0f, 0.0f, 0.0f }, 0.5f)));
+	}
+
+	// Test points against clip space, away from the boundary where rounding decides.
+	{
+		int inside_count = 0;
+		for (int i = 0; i < 10000; ++i)
+		{
+			st_vec3f p = { _st_frustum_test_random.next(-50.0f, 50.0f), _st_frustum_test_random.next(-50.0f, 50.0f), _st_frustum_test_random.next(-120.0f, 10.0f) };
+			st_vec4f clip = view_projection.transform(st_vec4f(p, 1.0f));
+
+			float margin = 1e-3f * std::fabs(clip.w);
+			float bounds[] = { clip.w + clip.x, clip.w - clip.x, clip.w + clip.y, clip.w - clip.y, clip.z, clip.w - clip.z };
+			bool is_inside = true;
+			bool is_near_boundary = false;
+			for (float b : bounds)
+			{
+				is_inside = is_inside && b >= 0.0f;
+				is_near_boundary = is_near_boundary || std::fabs(b) < margin;
+			}
+			if (is_near_boundary)
+			{
+				continue;
+			}
+
+			assert(frustum.intersects(_st_frustum_test_box(p, 0.0f)) == is_inside);
+
+			st_sphere3f sphere = { p, 0.0f };
+			assert(frustum.intersects(sphere) == is_inside);
+			inside_count += is_inside ? 1 : 0;
+		}
+		assert(inside_count > 0);
+	}
+
+	// Test the batched tests against the scalar one, for every batch size.
+	{
+		std::vector<st_aabb3f> boxes;
+		for (int i = 0; i < 203; ++i)
+		{
+			st_vec3f center = { _st_frustum_test_random.next(-60.0f, 60.0f), _st_frustum_test_random.next(-60.0f, 60.0f), _st_frustum_test_random.next(-120.0f, 20.0f) };
+			st_aabb3f box;
+			box.make_from_center(center, _st_frustum_test_random_vector(0.0f, 5.0f));
+			boxes.push_back(box);
+		}
+
+		for (int count = 0; count <= 8; ++count)
+		{
+			for (int start = 0; start + count <= int(boxes.size()); start += 8)
+			{
+				uint32_t mask = frustum.intersects8(boxes.data() + start, count);
+				for (int b = 0; b < 8; ++b)
+				{
+					bool expected = b < count && frustum.intersects(boxes[start + b]);
+					assert(((mask >> b) & 1u) == (expected ? 1u : 0u));
+				}
+			}
+		}
+
+		std::vector<uint8_t> visible(boxes.size());
+		int visible_count = st_frustum_cull(frustum, boxes.data(), int(boxes.size()), visible.data());
+		int expected_count = 0;
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			assert(visible[i] == (frustum.intersects(boxes[i]) ? 1 : 0));
+			expected_count += visible[i];
+		}
+		assert(visible_count == expected_count);
+		assert(visible_count > 0 && visible_count < int(boxes.size()));
+	}
+
+	// Test box transform against the transformed corners, and merging.
+	{
+		for (int i = 0; i < 100; ++i)
+		{
+			st_vec3f axis = _st_frustum_test_random_vector(-1.0f, 1.0f);
+			axis.normalize();
+			st_quatf rotation;
+			rotation.make_axis_angle(axis, _st_frustum_test_random.next(-st_PI, st_PI));
+
+			st_affine3f m;
+			m.make_rotation(rotation);
+			m.scale(_st_frustum_test_random.next(0.5f, 2.0f));
+			m.set_translation(_st_frustum_test_random_vector(-10.0f, 10.0f));
+
+			st_aabb3f box;
+			box.make_from_center(_st_frustum_test_random_vector(-5.0f, 5.0f), _st_frustum_test_random_vector(0.0f, 3.0f));
+
+			st_vec3f corners[8];
+			for (int c = 0; c < 8; ++c)
+			{
+				st_vec3f corner = { (c & 1) ? box.max.x : box.min.x, (c & 2) ? box.max.y : box.min.y, (c & 4) ? box.max.z : box.min.z };
+				corners[c] = m.transform_point(corner);
+			}
+			st_aabb3f expected;
+			expected.make_from_points(corners, 8);
+
+			st_aabb3f result = box.transform(m);
+			for (int a = 0; a < 3; ++a)
+			{
+				assert(std::fabs(result.min.axes[a] - expected.min.axes[a]) < 1e-4f);
+				assert(std::fabs(result.max.axes[a] - expected.max.axes[a]) < 1e-4f);
+			}
+		}
+
+		st_aabb3f empty;
+		empty.make_empty();
+		assert(empty.is_empty());
+		st_affine3f identity;
+		identity.make_identity();
+		assert(empty.transform(identity).is_empty());
+
+		st_aabb3f a = _st_frustum_test_box({ 0.0f, 0.0f, 0.0f }, 1.0f);
+		st_aabb3f b = _st_frustum_test_box({ 3.0f, 0.0f, 0.0f }, 1.0f);
+		assert(!a.intersects(b));
+
+		st_aabb3f merged = empty;
+		merged.merge(a);
+		assert(merged.min.equal(a.min) && merged.max.equal(a.max));
+		merged.merge(b);
+		assert(merged.contains({ 1.5f, 0.0f, 0.0f }));
+		assert(merged.intersects(a) && merged.intersects(b));
+
+		st_aabb3f boxes[] = { a, b, empty };
+		st_aabb3f all = st_aabb3f_merge(boxes, 3);
+		assert(all.min.equal(merged.min) && all.max.equal(merged.max));
+		assert(st_aabb3f_merge(boxes, 0).is_empty());
+	}
+
+	// Test sphere bounds, merging and transform.
+	{
+		st_sphere3f sphere;
+		sphere.make_from_aabb(_st_frustum_test_box({ 1.0f, 2.0f, 3.0f }, 1.0f));
+		assert(sphere.center.equal({ 1.0f, 2.0f, 3.0f }));
+		assert(st_equalf(sphere.radius, std::sqrt(3.0f)));
+
+		st_sphere3f a = { { 0.0f, 0.0f, 0.0f }, 1.0f };
+		st_sphere3f b = { { 4.0f, 0.0f, 0.0f }, 1.0f };
+		assert(!a.intersects(b));
+
+		st_sphere3f merged;
+		merged.make_empty();
+		merged.merge(a);
+		merged.merge(b);
+		assert(st_equalf(merged.radius, 3.0f));
+		assert(merged.center.equal({ 2.0f, 0.0f, 0.0f }));
+
+		st_affine3f m;
+		m.make_scaling(2.0f);
+		m.set_translation({ 1.0f, 0.0f, 0.0f });
+		st_sphere3f moved = a.transform(m);
+		assert(moved.center.equal({ 1.0f, 0.0f, 0.0f }));
+		assert(st_equalf(moved.radius, 2.0f));
+	}
+}
@@ -0,0 +1,41 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_half.h"
+
+static_assert(sizeof(st_half) == 2, "st_half must pack to two bytes.");
+
+void st_half_from_float_batch(const float* in, st_half* out, int count)
+{
+	int i = 0;
+#if defined(ST_SIMD_F16C)
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		out[i].bits = st_float_to_half_bits(in[i]);
+	}
+}
+
+void st_half_to_float_batch(const st_half* in, float* out, int count)
+{
+	int i = 0;
+#if defined(ST_SIMD_F16C)
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		_mm256_storeu_ps(out + i, _mm256_cvtph_ps(packed));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		out[i] = st_half_bits_to_float(in[i].bits);
+	}
+}
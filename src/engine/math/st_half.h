@@ -0,0 +1,124 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+/*
+** Convert between single and IEEE 754 half precision bits.
+**
+** Rounds to nearest even, keeps denormals, infinities and NaN payloads, and
+** gives the same bits as the F16C instructions, which are used when present.
+*/
+inline uint16_t st_float_to_half_bits(float f)
+{
+#if defined(ST_SIMD_F16C)
+	return uint16_t(_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(f), _MM_FROUND_TO_NEAREST_INT), 0));
+#else
+	const uint32_t k_f32_infinity = 255u << 23;
+	const uint32_t k_f16_overflow = (127u + 16u) << 23;
+	const uint32_t k_f16_denormal_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint16_t result;
+	if (bits >= k_f16_overflow)
+	{
+		// Infinity, or NaN with the quiet bit set and the top of the payload kept.
+		result = bits > k_f32_infinity ? uint16_t(0x7e00 | ((bits >> 13) & 0x3ff)) : uint16_t(0x7c00);
+	}
+	else if (bits < (113u << 23))
+	{
+		// Denormal or zero: let a float add do the rounding.
+		float magic;
+		memcpy(&magic, &k_f16_denormal_magic, sizeof(magic));
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		value += magic;
+		memcpy(&bits, &value, sizeof(bits));
+		result = uint16_t(bits - k_f16_denormal_magic);
+	}
+	else
+	{
+		uint32_t odd = (bits >> 13) & 1;
+		bits += ((15u - 127u) << 23) + 0xfff;
+		bits += odd;
+		result = uint16_t(bits >> 13);
+	}
+
+	return uint16_t(result | (sign >> 16));
+#endif
+}
+
+inline float st_half_bits_to_float(uint16_t h)
+{
+#if defined(ST_SIMD_F16C)
+	return _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(h)));
+#else
+	const uint32_t k_shifted_exponent = 0x7c00u << 13;
+
+	uint32_t bits = uint32_t(h & 0x7fff) << 13;
+	uint32_t exponent = bits & k_shifted_exponent;
+	bits += (127u - 15u) << 23;
+
+	if (exponent == k_shifted_exponent)
+	{
+		// Infinity or NaN; NaNs come out quiet.
+		bits += (128u - 16u) << 23;
+		if (bits & 0x007fffffu)
+		{
+			bits |= 0x00400000u;
+		}
+	}
+	else if (exponent == 0)
+	{
+		// Denormal: renormalize with a float subtract.
+		const uint32_t k_magic = 113u << 23;
+		bits += 1u << 23;
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		float magic;
+		memcpy(&magic, &k_magic, sizeof(magic));
+		value -= magic;
+		memcpy(&bits, &value, sizeof(bits));
+	}
+
+	bits |= uint32_t(h & 0x8000) << 16;
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+#endif
+}
+
+/*
+** Half precision float, for storage only.
+**
+** Used as the component type of the packed vector types (st_vec3h and so
+** on) for compact vertex streams. Convert to float for arithmetic.
+*/
+struct st_half
+{
+	uint16_t bits;
+
+	st_half() = default;
+	explicit st_half(float f) : bits(st_float_to_half_bits(f)) {}
+
+	explicit operator float() const { return st_half_bits_to_float(bits); }
+};
+
+/*
+** Convert arrays between float and half precision.
+** Eight lanes at a time where F16C is available.
+*/
+void st_half_from_float_batch(const float* in, st_half* out, int count);
+void st_half_to_float_batch(const st_half* in, float* out, int count);
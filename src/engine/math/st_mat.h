@@ -0,0 +1,282 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math_fwd.h"
+#include "math/st_vec.h"
+
+// The float specializations must be visible wherever the template is.
+#include "math/st_mat3f.h"
+#include "math/st_mat4f.h"
+
+/*
+** R by C matrix of T.
+**
+** Follows the conventions of st_mat4f: data is indexed [row][column], vectors
+** are columns, translation is the last column, and a * b applies a first and
+** then b. Products and transforms accumulate in the same order as st_mat4f's
+** scalar reference.
+**
+** The float 3x3 and 4x4 matrices, st_mat3f and st_mat4f, are specializations
+** with their own SIMD paths. This template provides the others, such as the
+** double precision st_mat3d and st_mat4d.
+*/
+template<int R, int C, typename T>
+struct st_mat
+{
+	T data[R][C];
+
+	/*
+	** Build an identity matrix.
+	*/
+	constexpr void make_identity()
+	{
+		static_assert(R == C, "Identity requires a square matrix.");
+		for (int i = 0; i < R; ++i)
+		{
+			for (int j = 0; j < C; ++j)
+			{
+				data[i][j] = i == j ? T(1) : T(0);
+			}
+		}
+	}
+
+	/*
+	** Build a translation matrix.
+	*/
+	constexpr void make_translation(const st_vec<R - 1, T>& __restrict t)
+	{
+		make_identity();
+		for (int i = 0; i < R - 1; ++i)
+		{
+			data[i][C - 1] = t.axes[i];
+		}
+	}
+
+	/*
+	** Build a uniform scaling matrix.
+	*/
+	constexpr void make_scaling(T s)
+	{
+		make_identity();
+		for (int i = 0; i < R - 1; ++i)
+		{
+			data[i][i] = s;
+		}
+	}
+
+	/*
+	** Multiply two matrices, this one applied first.
+	*/
+	constexpr st_mat operator*(const st_mat& __restrict b) const
+	{
+		static_assert(R == C, "Products are only defined for square matrices.");
+		st_mat result = (*this);
+		for (int i = 0; i < R; ++i)
+		{
+			for (int j = 0; j < C; ++j)
+			{
+				T tmp = T(0);
+				for (int k = 0; k < R; ++k)
+				{
+					tmp += data[k][i] * b.data[j][k];
+				}
+				result.data[j][i] = tmp;
+			}
+		}
+		return result;
+	}
+
+	/*
+	** Multiply a matrix by another, storing the result in the first.
+	*/
+	constexpr st_mat& operator*=(const st_mat& __restrict b)
+	{
+		(*this) = (*this) * b;
+		return (*this);
+	}
+
+	/*
+	** Transform a vector by a matrix.
+	*/
+	constexpr st_vec<R, T> transform(const st_vec<C, T>& __restrict in) const
+	{
+		st_vec<R, T> result = st_vec<R, T>::zero_vector();
+		for (int i = 0; i < R; ++i)
+		{
+			T tmp = in.axes[0] * data[i][0];
+			for (int j = 1; j < C; ++j)
+			{
+				tmp += in.axes[j] * data[i][j];
+			}
+			result.axes[i] = tmp;
+		}
+		return result;
+	}
+
+	/*
+	** Transform a point, or a vector ignoring translation, by a homogeneous
+	** matrix.
+	*/
+	constexpr st_vec<R - 1, T> transform_point(const st_vec<C - 1, T>& __restrict in) const
+	{
+		return drop_last(transform(st_vec<C, T>(in, T(1))));
+	}
+
+	constexpr st_vec<R - 1, T> transform_vector(const st_vec<C - 1, T>& __restrict in) const
+	{
+		return drop_last(transform(st_vec<C, T>(in, T(0))));
+	}
+
+	/*
+	** Return the transpose of this matrix.
+	*/
+	constexpr st_mat<C, R, T> transposed() const
+	{
+		st_mat<C, R, T> result = {};
+		for (int i = 0; i < R; ++i)
+		{
+			for (int j = 0; j < C; ++j)
+			{
+				result.data[j][i] = data[i][j];
+			}
+		}
+		return result;
+	}
+
+	/*
+	** Transpose a square matrix in place.
+	*/
+	constexpr void transpose()
+	{
+		(*this) = transposed();
+	}
+
+	/*
+	** Invert the matrix, by Gauss-Jordan elimination with partial pivoting.
+	*/
+	void invert()
+	{
+		static_assert(R == C, "Only square matrices can be inverted.");
+		st_mat result;
+		result.make_identity();
+		st_mat work = (*this);
+
+		for (int column = 0; column < C; ++column)
+		{
+			int pivot = column;
+			for (int row = column + 1; row < R; ++row)
+			{
+				if (std::abs(work.data[row][column]) > std::abs(work.data[pivot][column]))
+				{
+					pivot = row;
+				}
+			}
+			if (pivot != column)
+			{
+				std::swap(work.data[pivot], work.data[column]);
+				std::swap(result.data[pivot], result.data[column]);
+			}
+
+			T inv_pivot = T(1) / work.data[column][column];
+			for (int j = 0; j < C; ++j)
+			{
+				work.data[column][j] *= inv_pivot;
+				result.data[column][j] *= inv_pivot;
+			}
+
+			for (int row = 0; row < R; ++row)
+			{
+				if (row == column) continue;
+				T factor = work.data[row][column];
+				for (int j = 0; j < C; ++j)
+				{
+					work.data[row][j] -= factor * work.data[column][j];
+					result.data[row][j] -= factor * result.data[column][j];
+				}
+			}
+		}
+
+		(*this) = result;
+	}
+
+	/*
+	** Return the inverse of this matrix.
+	*/
+	st_mat inverse() const
+	{
+		st_mat result = (*this);
+		result.invert();
+		return result;
+	}
+
+	/*
+	** Determine if two matrices are largely equivalent.
+	*/
+	bool equal(const st_mat& __restrict b) const
+	{
+		bool is_not_equal = false;
+		for (int i = 0; i < R; ++i)
+		{
+			for (int j = 0; j < C; ++j)
+			{
+				is_not_equal = is_not_equal || !st_vec_component_equal(data[i][j], b.data[i][j]);
+			}
+		}
+		return !is_not_equal;
+	}
+
+	/*
+	** Get and set the translation portion of the matrix, the last column.
+	*/
+	constexpr st_vec<R - 1, T> get_translation() const
+	{
+		st_vec<R - 1, T> result = st_vec<R - 1, T>::zero_vector();
+		for (int i = 0; i < R - 1; ++i)
+		{
+			result.axes[i] = data[i][C - 1];
+		}
+		return result;
+	}
+
+	constexpr void set_translation(const st_vec<R - 1, T>& translation)
+	{
+		for (int i = 0; i < R - 1; ++i)
+		{
+			data[i][C - 1] = translation.axes[i];
+		}
+	}
+
+private:
+	static constexpr st_vec<R - 1, T> drop_last(const st_vec<R, T>& v)
+	{
+		st_vec<R - 1, T> result = st_vec<R - 1, T>::zero_vector();
+		for (int i = 0; i < R - 1; ++i)
+		{
+			result.axes[i] = v.axes[i];
+		}
+		return result;
+	}
+};
+
+/*
+** Convert a matrix to another component type, for example from st_mat4d to
+** st_mat4f at the GPU boundary.
+*/
+template<typename U, int R, int C, typename T>
+constexpr st_mat<R, C, U> st_mat_cast(const st_mat<R, C, T>& m)
+{
+	st_mat<R, C, U> result = {};
+	for (int i = 0; i < R; ++i)
+	{
+		for (int j = 0; j < C; ++j)
+		{
+			result.data[i][j] = static_cast<U>(m.data[i][j]);
+		}
+	}
+	return result;
+}
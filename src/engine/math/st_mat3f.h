@@ -6,13 +6,17 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include "math/st_math_fwd.h"
 #include "math/st_vec2f.h"
 #include "math/st_vec3f.h"
 
 /*
 ** Floating point 3x3 matrix.
+**
+** The float specialization of st_mat (see st_mat.h).
 */
-struct st_mat3f
+template<>
+struct st_mat<3, 3, float>
 {
 	float data[3][3];
 
@@ -7,53 +7,68 @@
 #include "math/st_mat4f.h"
 
 #include "math/st_math.h"
+#include "math/st_simd.h"
 
-void st_mat4f::make_identity()
+#if defined(ST_SIMD)
+/*
+** The SIMD kernels below perform the same operations in the same order as the
+** scalar reference, so their results are bit identical to it.
+*/
+static inline void _st_mat4f_load_columns(const st_mat4f& m, st_simd4f* columns)
 {
-	for (int i = 0; i < 4; ++i)
-	{
-		for (int j = 0; j < 4; ++j)
-		{
-			data[i][j] = i == j ? 1.0f : 0.0f;
-		}
-	}
+	columns[0] = st_simd4f_load(m.data[0]);
+	columns[1] = st_simd4f_load(m.data[1]);
+	columns[2] = st_simd4f_load(m.data[2]);
+	columns[3] = st_simd4f_load(m.data[3]);
+	st_simd4f_transpose(columns[0], columns[1], columns[2], columns[3]);
 }
 
-void st_mat4f::make_translation(const st_vec3f& __restrict t)
+static inline st_simd4f _st_mat4f_transform_xyz(const st_simd4f* columns, float x, float y, float z)
 {
-	make_identity();
-	data[0][3] = t.x;
-	data[1][3] = t.y;
-	data[2][3] = t.z;
-	data[3][3] = 1.0f;
+	st_simd4f result = st_simd4f_mul(st_simd4f_splat(x), columns[0]);
+	result = st_simd4f_add(result, st_simd4f_mul(st_simd4f_splat(y), columns[1]));
+	return st_simd4f_add(result, st_simd4f_mul(st_simd4f_splat(z), columns[2]));
 }
 
-void st_mat4f::make_scaling(float s)
+static inline st_simd4f _st_mat4f_transform(const st_simd4f* columns, float x, float y, float z, float w)
 {
-	make_identity();
-	for (int i = 0; i < 3; ++i)
-	{
-		data[i][i] = s;
-	}
-	data[3][3] = 1.0f;
+	st_simd4f result = _st_mat4f_transform_xyz(columns, x, y, z);
+	return st_simd4f_add(result, st_simd4f_mul(st_simd4f_splat(w), columns[3]));
 }
 
-void st_mat4f::make_rotation(const st_quatf& __restrict q)
+static inline st_simd4f _st_mat4f_transform_point(const st_simd4f* columns, float x, float y, float z)
 {
-	make_identity();
-
-	data[0][0] = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
-	data[0][1] = 2.0f * (q.x * q.y - q.z * q.w);
-	data[0][2] = 2.0f * (q.x * q.z + q.y * q.w);
-	data[1][0] = 2.0f * (q.x * q.y + q.z * q.w);
-	data[1][1] = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
-	data[1][2] = 2.0f * (q.y * q.z - q.x * q.w);
-	data[2][0] = 2.0f * (q.x * q.z - q.y * q.w);
-	data[2][1] = 2.0f * (q.y * q.z + q.x * q.w);
-	data[2][2] = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
-	data[3][3] = 1.0f;
+	/* Multiplying by a w of one is exact, so the translation is added directly. */
+	return st_simd4f_add(_st_mat4f_transform_xyz(columns, x, y, z), columns[3]);
+}
+
+static inline st_vec3f _st_mat4f_store_vec3(st_simd4f v)
+{
+	float result[4];
+	st_simd4f_store(result, v);
+	return { result[0], result[1], result[2] };
 }
 
+/*
+** One row of the inverse, before scaling by the inverse determinant.
+** Column u of the matrix is combined with the 2x2 determinants in k, and
+** sign flips the odd rows.
+*/
+static inline st_simd4f _st_mat4f_inverse_row(const float (&data)[4][4], int u, const float* k, float sign)
+{
+	st_simd4f p0 = st_simd4f_set(sign * data[1][u], -sign * data[0][u], sign * data[0][u], -sign * data[0][u]);
+	st_simd4f q0 = st_simd4f_set(k[5], k[5], k[4], k[3]);
+	st_simd4f p1 = st_simd4f_set(-sign * data[2][u], sign * data[2][u], -sign * data[1][u], sign * data[1][u]);
+	st_simd4f q1 = st_simd4f_set(k[4], k[2], k[2], k[1]);
+	st_simd4f p2 = st_simd4f_set(sign * data[3][u], -sign * data[3][u], sign * data[3][u], -sign * data[2][u]);
+	st_simd4f q2 = st_simd4f_set(k[3], k[1], k[0], k[0]);
+
+	st_simd4f result = st_simd4f_mul(p0, q0);
+	result = st_simd4f_add(result, st_simd4f_mul(p1, q1));
+	return st_simd4f_add(result, st_simd4f_mul(p2, q2));
+}
+#endif
+
 void st_mat4f::translate(const st_vec3f& __restrict t)
 {
 	st_mat4f tmp;
@@ -77,20 +92,46 @@ void st_mat4f::rotate(const st_quatf& __restrict q)
 
 st_mat4f st_mat4f::operator*(const st_mat4f& __restrict b) const
 {
+#if defined(ST_SIMD_AVX2)
+	/* Two result rows at a time, each a combination of this matrix's rows. */
 	st_mat4f result;
-	for (int i = 0; i < 4; ++i)
+	__m256 rows[4];
+	for (int k = 0; k < 4; ++k)
 	{
-		for (int j = 0; j < 4; ++j)
+		rows[k] = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[k]));
+	}
+	for (int j = 0; j < 4; j += 2)
+	{
+		__m256 tmp = _mm256_setzero_ps();
+		for (int k = 0; k < 4; ++k)
+		{
+			__m256 weight = _mm256_set_m128(_mm_set1_ps(b.data[j + 1][k]), _mm_set1_ps(b.data[j][k]));
+			tmp = _mm256_add_ps(tmp, _mm256_mul_ps(rows[k], weight));
+		}
+		_mm256_storeu_ps(result.data[j], tmp);
+	}
+	return result;
+#elif defined(ST_SIMD)
+	st_mat4f result;
+	st_simd4f rows[4];
+	for (int k = 0; k < 4; ++k)
+	{
+		rows[k] = st_simd4f_load(data[k]);
+	}
+	for (int j = 0; j < 4; ++j)
+	{
+		/* Accumulate from zero like the reference, which matters for signed zeros. */
+		st_simd4f tmp = st_simd4f_zero();
+		for (int k = 0; k < 4; ++k)
 		{
-			float tmp = 0.0f;
-			for (int k = 0; k < 4; ++k)
-			{
-				tmp += data[k][i] * b.data[j][k];
-			}
-			result.data[j][i] = tmp;
+			tmp = st_simd4f_add(tmp, st_simd4f_mul(rows[k], st_simd4f_splat(b.data[j][k])));
 		}
+		st_simd4f_store(result.data[j], tmp);
 	}
 	return result;
+#else
+	return multiply_scalar(b);
+#endif
 }
 
 st_mat4f& st_mat4f::operator*=(const st_mat4f& __restrict m)
@@ -101,42 +142,125 @@ st_mat4f& st_mat4f::operator*=(const st_mat4f& __restrict m)
 
 st_vec4f st_mat4f::transform(const st_vec4f& __restrict in) const
 {
+#if defined(ST_SIMD)
+	st_simd4f columns[4];
+	_st_mat4f_load_columns(*this, columns);
+
 	st_vec4f result;
-	result.x = in.x * data[0][0] + in.y * data[0][1] + in.z * data[0][2] + in.w * data[0][3];
-	result.y = in.x * data[1][0] + in.y * data[1][1] + in.z * data[1][2] + in.w * data[1][3];
-	result.z = in.x * data[2][0] + in.y * data[2][1] + in.z * data[2][2] + in.w * data[2][3];
-	result.w = in.x * data[3][0] + in.y * data[3][1] + in.z * data[3][2] + in.w * data[3][3];
+	st_simd4f_store(result.axes, _st_mat4f_transform(columns, in.x, in.y, in.z, in.w));
 	return result;
+#else
+	return transform_scalar(in);
+#endif
 }
 
 st_vec3f st_mat4f::transform_vector(const st_vec3f& __restrict in) const
 {
+#if defined(ST_SIMD)
+	st_simd4f columns[4];
+	_st_mat4f_load_columns(*this, columns);
+	return _st_mat4f_store_vec3(_st_mat4f_transform(columns, in.x, in.y, in.z, 0.0f));
+#else
 	st_vec4f temp = { in.x, in.y, in.z, 0.0f };
 	temp = transform(temp);
 	return { temp.x, temp.y, temp.z };
+#endif
 }
 
 st_vec3f st_mat4f::transform_point(const st_vec3f& __restrict in) const
 {
+#if defined(ST_SIMD)
+	st_simd4f columns[4];
+	_st_mat4f_load_columns(*this, columns);
+	return _st_mat4f_store_vec3(_st_mat4f_transform_point(columns, in.x, in.y, in.z));
+#else
 	st_vec4f temp = { in.x, in.y, in.z, 1.0f };
 	temp = transform(temp);
 	return{ temp.x, temp.y, temp.z };
+#endif
 }
 
-void st_mat4f::transpose()
+void st_mat4f::transform_points(const st_vec3f* in, st_vec3f* out, int count) const
 {
-	st_mat4f tmp;
-	for (int i = 0; i < 4; ++i)
+#if defined(ST_SIMD)
+	st_simd4f columns[4];
+	_st_mat4f_load_columns(*this, columns);
+	for (int i = 0; i < count; ++i)
 	{
-		for (int j = 0; j < 4; ++j)
-		{
-			tmp.data[i][j] = data[j][i];
-		}
+		out[i] = _st_mat4f_store_vec3(_st_mat4f_transform_point(columns, in[i].x, in[i].y, in[i].z));
 	}
-	(*this) = tmp;
+#else
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = transform_point(in[i]);
+	}
+#endif
+}
+
+void st_mat4f::transform_vectors(const st_vec3f* in, st_vec3f* out, int count) const
+{
+#if defined(ST_SIMD)
+	st_simd4f columns[4];
+	_st_mat4f_load_columns(*this, columns);
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = _st_mat4f_store_vec3(_st_mat4f_transform(columns, in[i].x, in[i].y, in[i].z, 0.0f));
+	}
+#else
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = transform_vector(in[i]);
+	}
+#endif
 }
 
 void st_mat4f::invert()
+{
+#if defined(ST_SIMD)
+	/* The twelve 2x2 determinants, s[0..5] followed by c[0..5]. */
+	float sc[12];
+	st_simd4f_store(sc, st_simd4f_sub(
+		st_simd4f_mul(
+			st_simd4f_set(data[0][0], data[0][0], data[0][0], data[1][0]),
+			st_simd4f_set(data[1][1], data[2][1], data[3][1], data[2][1])),
+		st_simd4f_mul(
+			st_simd4f_set(data[0][1], data[0][1], data[0][1], data[1][1]),
+			st_simd4f_set(data[1][0], data[2][0], data[3][0], data[2][0]))));
+	st_simd4f_store(sc + 4, st_simd4f_sub(
+		st_simd4f_mul(
+			st_simd4f_set(data[1][0], data[2][0], data[0][2], data[0][2]),
+			st_simd4f_set(data[3][1], data[3][1], data[1][3], data[2][3])),
+		st_simd4f_mul(
+			st_simd4f_set(data[1][1], data[2][1], data[0][3], data[0][3]),
+			st_simd4f_set(data[3][0], data[3][0], data[1][2], data[2][2]))));
+	st_simd4f_store(sc + 8, st_simd4f_sub(
+		st_simd4f_mul(
+			st_simd4f_set(data[0][2], data[1][2], data[1][2], data[2][2]),
+			st_simd4f_set(data[3][3], data[2][3], data[3][3], data[3][3])),
+		st_simd4f_mul(
+			st_simd4f_set(data[0][3], data[1][3], data[1][3], data[2][3]),
+			st_simd4f_set(data[3][2], data[2][2], data[3][2], data[3][2]))));
+	const float* s = sc;
+	const float* c = sc + 6;
+
+	float inv_det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+	inv_det = 1.0f / inv_det;
+
+	st_simd4f scale = st_simd4f_splat(inv_det);
+	st_simd4f row0 = st_simd4f_mul(_st_mat4f_inverse_row(data, 1, c, 1.0f), scale);
+	st_simd4f row1 = st_simd4f_mul(_st_mat4f_inverse_row(data, 0, c, -1.0f), scale);
+	st_simd4f row2 = st_simd4f_mul(_st_mat4f_inverse_row(data, 3, s, 1.0f), scale);
+	st_simd4f row3 = st_simd4f_mul(_st_mat4f_inverse_row(data, 2, s, -1.0f), scale);
+	st_simd4f_store(data[0], row0);
+	st_simd4f_store(data[1], row1);
+	st_simd4f_store(data[2], row2);
+	st_simd4f_store(data[3], row3);
+#else
+	invert_scalar();
+#endif
+}
+
+void st_mat4f::invert_scalar()
 {
 	float s[6];
 	s[0] = data[0][0] * data[1][1] - data[0][1] * data[1][0];
@@ -189,33 +313,6 @@ st_mat4f st_mat4f::inverse() const
 	return inverse;
 }
 
-void st_mat4f::make_orthographic(float left, float right, float bottom, float top, float z_near, float z_far)
-{
-	float inv_width = 1.0f / (right - left);
-	data[0][0] = 2.0f * inv_width;
-	data[0][1] = 0.0f;
-	data[0][2] = 0.0f;
-	data[0][3] = -(right + left) * inv_width;
-
-	float inv_height = 1.0f / (top - bottom);
-	data[1][0] = 0.0f;
-	data[1][1] = 2.0f * inv_height;
-	data[1][2] = 0.0f;
-	data[1][3] = -(top + bottom) * inv_height;
-
-	float inv_depth = 1.0f / (z_near - z_far);
-	data[2][0] = 0.0f;
-	data[2][1] = 0.0f;
-	// Uses DirectX clip space, as it's narrower than OpenGL.
-	data[2][2] = 1.0f * inv_depth;
-	data[2][3] = z_near * inv_depth;
-
-	data[3][0] = 0.0f;
-	data[3][1] = 0.0f;
-	data[3][2] = 0.0f;
-	data[3][3] = 1.0f;
-}
-
 void st_mat4f::make_perspective_rh(float angle, float aspect, float z_near, float z_far)
 {
 	float a = 1.0f / st_tanf(angle * 0.5f);
@@ -291,35 +388,3 @@ bool st_mat4f::equal(const st_mat4f& __restrict b)
 	}
 	return !is_not_equal;
 }
-
-st_vec3f st_mat4f::get_translation() const
-{
-	return { data[0][3], data[1][3], data[2][3] };
-}
-
-void st_mat4f::set_translation(const st_vec3f& translation)
-{
-	data[0][3] = translation.x;
-	data[1][3] = translation.y;
-	data[2][3] = translation.z;
-}
-
-float st_mat4f::get_scale() const
-{
-	return data[0][0];
-}
-
-st_vec3f st_mat4f::get_forward() const
-{
-	return{ data[0][2], data[1][2], data[2][2] };
-}
-
-st_vec3f st_mat4f::get_up() const
-{
-	return{ data[0][1], data[1][1], data[2][1] };
-}
-
-st_vec3f st_mat4f::get_right() const
-{
-	return{ data[0][0], data[1][0], data[2][0] };
-}
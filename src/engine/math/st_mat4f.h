@@ -6,36 +6,87 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include "math/st_math_fwd.h"
 #include "math/st_quatf.h"
 #include "math/st_vec3f.h"
 #include "math/st_vec4f.h"
 
 /*
 ** Floating point 4x4 matrix.
+**
+** The float specialization of st_mat (see st_mat.h), with SIMD paths for its
+** products, transforms and inverse.
+**
+** The builders, accessors and scalar reference implementations are constexpr,
+** so constant transforms can be composed at compile time with
+** multiply_scalar. The SIMD operators are runtime only.
 */
-struct st_mat4f
+template<>
+struct st_mat<4, 4, float>
 {
 	float data[4][4];
 
 	/*
 	** Build an identity matrix.
 	*/
-	void make_identity();
+	constexpr void make_identity()
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				data[i][j] = i == j ? 1.0f : 0.0f;
+			}
+		}
+	}
 
 	/*
 	** Build a translation matrix.
 	*/
-	void make_translation(const st_vec3f& __restrict t);
+	constexpr void make_translation(const st_vec3f& __restrict t)
+	{
+		make_identity();
+		data[0][3] = t.axes[0];
+		data[1][3] = t.axes[1];
+		data[2][3] = t.axes[2];
+		data[3][3] = 1.0f;
+	}
 
 	/*
 	** Build a uniform scaling matrix.
 	*/
-	void make_scaling(float s);
+	constexpr void make_scaling(float s)
+	{
+		make_identity();
+		for (int i = 0; i < 3; ++i)
+		{
+			data[i][i] = s;
+		}
+		data[3][3] = 1.0f;
+	}
 
 	/*
 	** Build a rotation matrix.
 	*/
-	void make_rotation(const st_quatf& __restrict q);
+	constexpr void make_rotation(const st_quatf& __restrict q)
+	{
+		make_identity();
+
+		const float x = q.axes[0];
+		const float y = q.axes[1];
+		const float z = q.axes[2];
+		const float w = q.axes[3];
+		data[0][0] = 1.0f - 2.0f * (y * y + z * z);
+		data[0][1] = 2.0f * (x * y - z * w);
+		data[0][2] = 2.0f * (x * z + y * w);
+		data[1][0] = 2.0f * (x * y + z * w);
+		data[1][1] = 1.0f - 2.0f * (x * x + z * z);
+		data[1][2] = 2.0f * (y * z - x * w);
+		data[2][0] = 2.0f * (x * z - y * w);
+		data[2][1] = 2.0f * (y * z + x * w);
+		data[2][2] = 1.0f - 2.0f * (x * x + y * y);
+		data[3][3] = 1.0f;
+	}
 
 	/*
 	** Apply translation to the given matrix.
@@ -80,10 +131,33 @@ struct st_mat4f
 	*/
 	st_vec3f transform_point(const st_vec3f& __restrict in) const;
 
+	/*
+	** Transform an array of points by a matrix.
+	** The input and output arrays may be the same.
+	*/
+	void transform_points(const st_vec3f* in, st_vec3f* out, int count) const;
+
+	/*
+	** Transform an array of vectors by a matrix, ignoring translation.
+	** The input and output arrays may be the same.
+	*/
+	void transform_vectors(const st_vec3f* in, st_vec3f* out, int count) const;
+
 	/*
 	** Transpose a matrix.
 	*/
-	void transpose();
+	constexpr void transpose()
+	{
+		st_mat4f tmp = (*this);
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				tmp.data[i][j] = data[j][i];
+			}
+		}
+		(*this) = tmp;
+	}
 
 	/*
 	** Invert the given matrix.
@@ -95,10 +169,70 @@ struct st_mat4f
 	*/
 	st_mat4f inverse() const;
 
+	/*
+	** Scalar implementations of multiply, transform and invert.
+	**
+	** The operators above use SIMD where available (see st_simd.h) and are
+	** expected to match these bit for bit.
+	*/
+	constexpr st_mat4f multiply_scalar(const st_mat4f& __restrict b) const
+	{
+		st_mat4f result = (*this);
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				float tmp = 0.0f;
+				for (int k = 0; k < 4; ++k)
+				{
+					tmp += data[k][i] * b.data[j][k];
+				}
+				result.data[j][i] = tmp;
+			}
+		}
+		return result;
+	}
+
+	constexpr st_vec4f transform_scalar(const st_vec4f& __restrict in) const
+	{
+		return st_vec4f(
+			in.axes[0] * data[0][0] + in.axes[1] * data[0][1] + in.axes[2] * data[0][2] + in.axes[3] * data[0][3],
+			in.axes[0] * data[1][0] + in.axes[1] * data[1][1] + in.axes[2] * data[1][2] + in.axes[3] * data[1][3],
+			in.axes[0] * data[2][0] + in.axes[1] * data[2][1] + in.axes[2] * data[2][2] + in.axes[3] * data[2][3],
+			in.axes[0] * data[3][0] + in.axes[1] * data[3][1] + in.axes[2] * data[3][2] + in.axes[3] * data[3][3]);
+	}
+
+	void invert_scalar();
+
 	/*
 	** Build a orthographic projection matrix.
 	*/
-	void make_orthographic(float left, float right, float bottom, float top, float z_near, float z_far);
+	constexpr void make_orthographic(float left, float right, float bottom, float top, float z_near, float z_far)
+	{
+		float inv_width = 1.0f / (right - left);
+		data[0][0] = 2.0f * inv_width;
+		data[0][1] = 0.0f;
+		data[0][2] = 0.0f;
+		data[0][3] = -(right + left) * inv_width;
+
+		float inv_height = 1.0f / (top - bottom);
+		data[1][0] = 0.0f;
+		data[1][1] = 2.0f * inv_height;
+		data[1][2] = 0.0f;
+		data[1][3] = -(top + bottom) * inv_height;
+
+		float inv_depth = 1.0f / (z_near - z_far);
+		data[2][0] = 0.0f;
+		data[2][1] = 0.0f;
+		// Uses DirectX clip space, as it's narrower than OpenGL.
+		data[2][2] = 1.0f * inv_depth;
+		data[2][3] = z_near * inv_depth;
+
+		data[3][0] = 0.0f;
+		data[3][1] = 0.0f;
+		data[3][2] = 0.0f;
+		data[3][3] = 1.0f;
+	}
 
 	/*
 	** Build a right-handed perspective projection matrix.
@@ -120,39 +254,59 @@ struct st_mat4f
 	**
 	** The fourth column of the matrix.
 	*/
-	st_vec3f get_translation() const;
+	constexpr st_vec3f get_translation() const
+	{
+		return { data[0][3], data[1][3], data[2][3] };
+	}
 
 	/*
 	** Set the translation portion of the matrix.
 	**
 	** The fourth column of the matrix.
 	*/
-	void set_translation(const st_vec3f& translation);
+	constexpr void set_translation(const st_vec3f& translation)
+	{
+		data[0][3] = translation.axes[0];
+		data[1][3] = translation.axes[1];
+		data[2][3] = translation.axes[2];
+	}
 
 	/*
 	** Get the scale from the matrix diagonal.
 	** Only returns a single float, assuming that the matrix has uniform scale.
 	*/
-	float get_scale() const;
+	constexpr float get_scale() const
+	{
+		return data[0][0];
+	}
 
 	/*
 	** Get the forward vector from the matrix.
 	**
 	** The first column of the matrix.
 	*/
-	st_vec3f get_forward() const;
+	constexpr st_vec3f get_forward() const
+	{
+		return { data[0][2], data[1][2], data[2][2] };
+	}
 
 	/*
 	** Get the up vector from the matrix.
 	**
 	** The second column of the matrix.
 	*/
-	st_vec3f get_up() const;
+	constexpr st_vec3f get_up() const
+	{
+		return { data[0][1], data[1][1], data[2][1] };
+	}
 
 	/*
 	** Get the right vector from the matrix.
 	**
 	** The third column of the matrix.
 	*/
-	st_vec3f get_right() const;
+	constexpr st_vec3f get_right() const
+	{
+		return { data[0][0], data[1][0], data[2][0] };
+	}
 };
@@ -0,0 +1,139 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_mat4f.tests.h"
+#include "st_mat4f.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cstring>
+
+/*
+** The SIMD paths must match the scalar reference bit for bit. This only holds
+** when the compiler does not contract the scalar code into fused multiply-adds
+** (-ffp-contract=off on GCC and Clang, which the workspace sets).
+*/
+
+static st_test_random _st_mat4f_test_random(0x12345678);
+
+static st_mat4f _st_mat4f_test_random_matrix()
+{
+	st_mat4f m;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			m.data[i][j] = _st_mat4f_test_random.next(-10.0f, 10.0f);
+		}
+	}
+	return m;
+}
+
+template<typename T>
+static bool _st_mat4f_test_bitwise_equal(const T& a, const T& b)
+{
+	return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+void st_mat4f_unit_tests()
+{
+	const int k_iterations = 10000;
+
+	// Test multiply against the reference.
+	for (int i = 0; i < k_iterations; ++i)
+	{
+		st_mat4f a = _st_mat4f_test_random_matrix();
+		st_mat4f b = _st_mat4f_test_random_matrix();
+		assert(_st_mat4f_test_bitwise_equal(a * b, a.multiply_scalar(b)));
+	}
+
+	// Test signed zeros survive multiply the same way as the reference.
+	{
+		st_mat4f a;
+		st_mat4f b;
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				a.data[i][j] = -0.0f;
+				b.data[i][j] = 1.0f;
+			}
+		}
+		assert(_st_mat4f_test_bitwise_equal(a * b, a.multiply_scalar(b)));
+	}
+
+	// Test invert against the reference.
+	for (int i = 0; i < k_iterations; ++i)
+	{
+		st_mat4f a = _st_mat4f_test_random_matrix();
+		st_mat4f simd = a;
+		st_mat4f scalar = a;
+		simd.invert();
+		scalar.invert_scalar();
+		assert(_st_mat4f_test_bitwise_equal(simd, scalar));
+	}
+
+	// Test inverting a rigid transform.
+	{
+		st_quatf q;
+		q.make_axis_angle(st_vec3f::y_vector(), 0.5f);
+		st_mat4f a;
+		a.make_rotation(q);
+		a.set_translation({ 1.0f, 2.0f, 3.0f });
+
+		st_vec3f p = { 4.0f, -5.0f, 6.0f };
+		st_vec3f round_trip = a.inverse().transform_point(a.transform_point(p));
+		assert((round_trip - p).mag() < 0.0001f);
+	}
+
+	// Test transforms against the reference.
+	for (int i = 0; i < k_iterations; ++i)
+	{
+		st_mat4f a = _st_mat4f_test_random_matrix();
+		st_vec4f v = { _st_mat4f_test_random.next(-10.0f, 10.0f), _st_mat4f_test_random.next(-10.0f, 10.0f), _st_mat4f_test_random.next(-10.0f, 10.0f), _st_mat4f_test_random.next(-10.0f, 10.0f) };
+		assert(_st_mat4f_test_bitwise_equal(a.transform(v), a.transform_scalar(v)));
+
+		st_vec3f p = { v.x, v.y, v.z };
+		st_vec4f point = a.transform_scalar({ v.x, v.y, v.z, 1.0f });
+		st_vec4f vector = a.transform_scalar({ v.x, v.y, v.z, 0.0f });
+		st_vec3f expected_point = { point.x, point.y, point.z };
+		st_vec3f expected_vector = { vector.x, vector.y, vector.z };
+		assert(_st_mat4f_test_bitwise_equal(a.transform_point(p), expected_point));
+		assert(_st_mat4f_test_bitwise_equal(a.transform_vector(p), expected_vector));
+	}
+
+	// Test batched transforms, including in place.
+	{
+		const int k_count = 37;
+		st_mat4f a = _st_mat4f_test_random_matrix();
+		st_vec3f in[k_count];
+		st_vec3f out[k_count];
+		for (int i = 0; i < k_count; ++i)
+		{
+			in[i] = { _st_mat4f_test_random.next(-10.0f, 10.0f), _st_mat4f_test_random.next(-10.0f, 10.0f), _st_mat4f_test_random.next(-10.0f, 10.0f) };
+		}
+
+		a.transform_points(in, out, k_count);
+		for (int i = 0; i < k_count; ++i)
+		{
+			assert(_st_mat4f_test_bitwise_equal(out[i], a.transform_point(in[i])));
+		}
+
+		a.transform_vectors(in, out, k_count);
+		for (int i = 0; i < k_count; ++i)
+		{
+			assert(_st_mat4f_test_bitwise_equal(out[i], a.transform_vector(in[i])));
+		}
+
+		memcpy(out, in, sizeof(in));
+		a.transform_points(out, out, k_count);
+		for (int i = 0; i < k_count; ++i)
+		{
+			assert(_st_mat4f_test_bitwise_equal(out[i], a.transform_point(in[i])));
+		}
+	}
+}
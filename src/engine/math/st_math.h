@@ -11,6 +11,7 @@
 #include <math.h>
 
 #define st_absf fabsf
+#define st_acosf acosf
 #define st_cosf cosf
 #define st_powf powf
 #define st_sinf sinf
@@ -37,3 +38,12 @@ inline bool st_equalf(float a, float b)
 	float diff = st_absf(a - b);
 	return diff < 0.0000005f || diff < st_absf(a * 0.0000005f) || diff < st_absf(b * 0.0000005f);
 }
+
+/*
+** Determine if two doubles are largely equivalent.
+*/
+inline bool st_equald(double a, double b)
+{
+	double diff = fabs(a - b);
+	return diff < 0.000000000001 || diff < fabs(a * 0.000000000001) || diff < fabs(b * 0.000000000001);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Forward declarations of the math types, for headers that only pass them by
+** reference. The vector and matrix names are aliases of templates, so they
+** cannot be forward declared with struct.
+*/
+
+template<int N, typename T> struct st_vec;
+template<int R, int C, typename T> struct st_mat;
+
+struct st_aabb3f;
+struct st_affine3f;
+struct st_half;
+struct st_qts;
+struct st_quatf;
+struct st_sphere3f;
+
+using st_vec2f = st_vec<2, float>;
+using st_vec3f = st_vec<3, float>;
+using st_vec4f = st_vec<4, float>;
+
+using st_vec2d = st_vec<2, double>;
+using st_vec3d = st_vec<3, double>;
+using st_vec4d = st_vec<4, double>;
+
+using st_vec2h = st_vec<2, st_half>;
+using st_vec3h = st_vec<3, st_half>;
+using st_vec4h = st_vec<4, st_half>;
+
+using st_mat3f = st_mat<3, 3, float>;
+using st_mat4f = st_mat<4, 4, float>;
+
+using st_mat3d = st_mat<3, 3, double>;
+using st_mat4d = st_mat<4, 4, double>;
@@ -0,0 +1,208 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_packed_transform.h"
+
+#include "math/st_affine3f.h"
+#include "math/st_qts.h"
+#include "math/st_simd.h"
+
+#include <cmath>
+#include <cstring>
+
+static_assert(sizeof(st_packed_transform) == 16, "st_packed_transform must pack to 16 bytes.");
+
+static const float k_st_packed_rotation_scale = 32767.0f;
+static const float k_st_packed_rotation_inverse_scale = 1.0f / 32767.0f;
+static const float k_st_packed_position_steps = 65535.0f;
+
+/*
+** Per cell constants, hoisted out of the batch loops.
+*/
+struct st_packed_cell_constants_t
+{
+	float origin[4];
+	float inverse_step;
+	float step;
+};
+
+static st_packed_cell_constants_t _st_packed_cell_constants(const st_transform_cell& cell)
+{
+	st_packed_cell_constants_t constants;
+	constants.origin[0] = cell.origin.x;
+	constants.origin[1] = cell.origin.y;
+	constants.origin[2] = cell.origin.z;
+	constants.origin[3] = 0.0f;
+	constants.inverse_step = k_st_packed_position_steps / cell.size;
+	constants.step = cell.size / k_st_packed_position_steps;
+	return constants;
+}
+
+/*
+** The vector and scalar paths round to nearest even and sum the squared
+** rotation as (xx + yy) + (zz + ww), so they give the same bits.
+*/
+static void _st_packed_transform_pack(
+	const st_qts& __restrict transform,
+	const st_packed_cell_constants_t& __restrict constants,
+	st_packed_transform& __restrict out)
+{
+	// q and -q are the same rotation; keeping w non-negative lets unpack skip a sign.
+	const float* q = transform.rotation.axes;
+	float rotation_scale = q[3] < 0.0f ? -k_st_packed_rotation_scale : k_st_packed_rotation_scale;
+
+	const float* p = transform.translation.axes;
+	uint16_t position[4];
+
+#if defined(ST_SIMD_SSE)
+	__m128i rotation = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(q), _mm_set1_ps(rotation_scale)));
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(out.rotation), _mm_packs_epi32(rotation, rotation));
+
+	__m128 offset = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(p[0], p[1], p[2], 0.0f), _mm_loadu_ps(constants.origin)), _mm_set1_ps(constants.inverse_step));
+	offset = _mm_min_ps(_mm_max_ps(offset, _mm_setzero_ps()), _mm_set1_ps(k_st_packed_position_steps));
+
+	// SSE2 has no unsigned saturating pack, so bias into the signed range and back.
+	__m128i bias = _mm_set1_epi32(32768);
+	__m128i steps = _mm_sub_epi32(_mm_cvtps_epi32(offset), bias);
+	steps = _mm_packs_epi32(steps, steps);
+	steps = _mm_xor_si128(steps, _mm_set1_epi16(-32768));
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(position), steps);
+#elif defined(ST_SIMD_NEON)
+	int32x4_t rotation = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(q), vdupq_n_f32(rotation_scale)));
+	vst1_s16(out.rotation, vqmovn_s32(rotation));
+
+	float point[4] = { p[0], p[1], p[2], 0.0f };
+	float32x4_t offset = vmulq_f32(vsubq_f32(vld1q_f32(point), vld1q_f32(constants.origin)), vdupq_n_f32(constants.inverse_step));
+	offset = vminq_f32(vmaxq_f32(offset, vdupq_n_f32(0.0f)), vdupq_n_f32(k_st_packed_position_steps));
+	vst1_u16(position, vqmovun_s32(vcvtnq_s32_f32(offset)));
+#else
+	for (int i = 0; i < 4; ++i)
+	{
+		out.rotation[i] = int16_t(lrintf(q[i] * rotation_scale));
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		float offset = (p[i] - constants.origin[i]) * constants.inverse_step;
+		offset = fminf(fmaxf(offset, 0.0f), k_st_packed_position_steps);
+		position[i] = uint16_t(lrintf(offset));
+	}
+#endif
+
+	memcpy(out.position, position, sizeof(out.position));
+	out.scale = st_half(transform.scale);
+}
+
+static void _st_packed_transform_unpack(
+	const st_packed_transform& __restrict in,
+	const st_packed_cell_constants_t& __restrict constants,
+	st_qts& __restrict out)
+{
+	float* q = out.rotation.axes;
+	float* p = out.translation.axes;
+	float position[4];
+
+#if defined(ST_SIMD_SSE)
+	__m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in.rotation));
+	__m128 rotation = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+	rotation = _mm_mul_ps(rotation, _mm_set1_ps(k_st_packed_rotation_inverse_scale));
+
+	__m128 squares = _mm_mul_ps(rotation, rotation);
+	squares = _mm_add_ps(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 3, 0, 1)));
+	squares = _mm_add_ps(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(1, 0, 3, 2)));
+	_mm_storeu_ps(q, _mm_div_ps(rotation, _mm_sqrt_ps(squares)));
+
+	uint16_t steps_bits[4] = { in.position[0], in.position[1], in.position[2], 0 };
+	__m128i steps = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(steps_bits));
+	__m128 offset = _mm_cvtepi32_ps(_mm_unpacklo_epi16(steps, _mm_setzero_si128()));
+	_mm_storeu_ps(position, _mm_add_ps(_mm_mul_ps(offset, _mm_set1_ps(constants.step)), _mm_loadu_ps(constants.origin)));
+#elif defined(ST_SIMD_NEON)
+	float32x4_t rotation = vcvtq_f32_s32(vmovl_s16(vld1_s16(in.rotation)));
+	rotation = vmulq_f32(rotation, vdupq_n_f32(k_st_packed_rotation_inverse_scale));
+
+	float32x4_t squares = vmulq_f32(rotation, rotation);
+	squares = vaddq_f32(squares, vrev64q_f32(squares));
+	squares = vaddq_f32(squares, vextq_f32(squares, squares, 2));
+	vst1q_f32(q, vdivq_f32(rotation, vsqrtq_f32(squares)));
+
+	uint16_t steps_bits[4] = { in.position[0], in.position[1], in.position[2], 0 };
+	float32x4_t offset = vcvtq_f32_u32(vmovl_u16(vld1_u16(steps_bits)));
+	vst1q_f32(position, vaddq_f32(vmulq_f32(offset, vdupq_n_f32(constants.step)), vld1q_f32(constants.origin)));
+#else
+	for (int i = 0; i < 4; ++i)
+	{
+		q[i] = float(in.rotation[i]) * k_st_packed_rotation_inverse_scale;
+	}
+	float length = sqrtf((q[0] * q[0] + q[1] * q[1]) + (q[2] * q[2] + q[3] * q[3]));
+	for (int i = 0; i < 4; ++i)
+	{
+		q[i] = q[i] / length;
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		position[i] = float(in.position[i]) * constants.step + constants.origin[i];
+	}
+#endif
+
+	p[0] = position[0];
+	p[1] = position[1];
+	p[2] = position[2];
+	out.scale = float(in.scale);
+}
+
+void st_packed_transform::pack(const st_qts& __restrict transform, const st_transform_cell& __restrict cell)
+{
+	_st_packed_transform_pack(transform, _st_packed_cell_constants(cell), *this);
+}
+
+st_qts st_packed_transform::unpack(const st_transform_cell& __restrict cell) const
+{
+	st_qts result;
+	_st_packed_transform_unpack(*this, _st_packed_cell_constants(cell), result);
+	return result;
+}
+
+void st_packed_transform_pack_batch(
+	const st_qts* in,
+	const st_transform_cell& cell,
+	st_packed_transform* out,
+	int count)
+{
+	st_packed_cell_constants_t constants = _st_packed_cell_constants(cell);
+	for (int i = 0; i < count; ++i)
+	{
+		_st_packed_transform_pack(in[i], constants, out[i]);
+	}
+}
+
+void st_packed_transform_unpack_batch(
+	const st_packed_transform* in,
+	const st_transform_cell& cell,
+	st_qts* out,
+	int count)
+{
+	st_packed_cell_constants_t constants = _st_packed_cell_constants(cell);
+	for (int i = 0; i < count; ++i)
+	{
+		_st_packed_transform_unpack(in[i], constants, out[i]);
+	}
+}
+
+void st_packed_transform_unpack_affine_batch(
+	const st_packed_transform* in,
+	const st_transform_cell& cell,
+	st_affine3f* out,
+	int count)
+{
+	st_packed_cell_constants_t constants = _st_packed_cell_constants(cell);
+	for (int i = 0; i < count; ++i)
+	{
+		st_qts transform;
+		_st_packed_transform_unpack(in[i], constants, transform);
+		out[i] = transform.to_affine();
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_half.h"
+#include "math/st_math_fwd.h"
+#include "math/st_vec3f.h"
+
+#include <cstdint>
+
+/*
+** The region of space that packed transforms store their positions in.
+** Positions resolve to size / 65535 and are clamped to the cell.
+*/
+struct st_transform_cell
+{
+	st_vec3f origin;
+	float size;
+};
+
+/*
+** Rotation, translation and uniform scale in 16 bytes, a quarter of an
+** st_mat4f, for per instance uploads and scene snapshots.
+**
+** The rotation is four signed normalized 16 bit components with w kept
+** non-negative, the position three 16 bit fractions of the cell, and the
+** scale a half float. Unpacked rotations are renormalized.
+*/
+struct st_packed_transform
+{
+	int16_t rotation[4];
+	uint16_t position[3];
+	st_half scale;
+
+	/*
+	** Quantize a transform, which must have a normalized rotation.
+	*/
+	void pack(const st_qts& __restrict transform, const st_transform_cell& __restrict cell);
+
+	st_qts unpack(const st_transform_cell& __restrict cell) const;
+};
+
+/*
+** Pack and unpack arrays, the same per element as the members.
+*/
+void st_packed_transform_pack_batch(
+	const st_qts* in,
+	const st_transform_cell& cell,
+	st_packed_transform* out,
+	int count);
+void st_packed_transform_unpack_batch(
+	const st_packed_transform* in,
+	const st_transform_cell& cell,
+	st_qts* out,
+	int count);
+
+/*
+** Unpack straight to affine transforms, the same per element as unpack
+** followed by st_qts::to_affine.
+*/
+void st_packed_transform_unpack_affine_batch(
+	const st_packed_transform* in,
+	const st_transform_cell& cell,
+	st_affine3f* out,
+	int count);
@@ -0,0 +1,103 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_packed_transform.tests.h"
+#include "st_packed_transform.h"
+
+#include "st_affine3f.h"
+#include "st_qts.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+static st_test_random _st_packed_transform_test_random(0x2545f491);
+
+void st_packed_transform_unit_tests()
+{
+	st_transform_cell cell;
+	cell.origin = { -32.0f, 0.0f, 100.0f };
+	cell.size = 64.0f;
+	const float step = cell.size / 65535.0f;
+
+	const int count = 257;
+	std::vector<st_qts> transforms(count);
+	for (int i = 0; i < count; ++i)
+	{
+		st_quatf q(_st_packed_transform_test_random.next(-1.0f, 1.0f), _st_packed_transform_test_random.next(-1.0f, 1.0f), _st_packed_transform_test_random.next(-1.0f, 1.0f), _st_packed_transform_test_random.next(-1.0f, 1.0f));
+		q.normalize();
+		transforms[i].rotation = q;
+		transforms[i].translation = {
+			cell.origin.x + (_st_packed_transform_test_random.next(-1.0f, 1.0f) * 0.5f + 0.5f) * cell.size,
+			cell.origin.y + (_st_packed_transform_test_random.next(-1.0f, 1.0f) * 0.5f + 0.5f) * cell.size,
+			cell.origin.z + (_st_packed_transform_test_random.next(-1.0f, 1.0f) * 0.5f + 0.5f) * cell.size };
+		transforms[i].scale = 1.5f + _st_packed_transform_test_random.next(-1.0f, 1.0f);
+	}
+
+	// Test the batches against the members, bitwise.
+	std::vector<st_packed_transform> packed(count);
+	std::vector<st_qts> unpacked(count);
+	std::vector<st_affine3f> affines(count);
+	st_packed_transform_pack_batch(transforms.data(), cell, packed.data(), count);
+	st_packed_transform_unpack_batch(packed.data(), cell, unpacked.data(), count);
+	st_packed_transform_unpack_affine_batch(packed.data(), cell, affines.data(), count);
+	for (int i = 0; i < count; ++i)
+	{
+		st_packed_transform single;
+		single.pack(transforms[i], cell);
+		assert(memcmp(&single, &packed[i], sizeof(st_packed_transform)) == 0);
+
+		st_qts expected = single.unpack(cell);
+		assert(memcmp(&expected, &unpacked[i], sizeof(st_qts)) == 0);
+
+		st_affine3f expected_affine = expected.to_affine();
+		assert(memcmp(&expected_affine, &affines[i], sizeof(st_affine3f)) == 0);
+	}
+
+	// Test round trip precision.
+	for (int i = 0; i < count; ++i)
+	{
+		const st_qts& a = transforms[i];
+		const st_qts& b = unpacked[i];
+
+		// The rotation may come back negated, so compare rotated vectors.
+		st_vec3f axes[] = { st_vec3f::x_vector(), st_vec3f::y_vector(), st_vec3f::z_vector() };
+		for (const st_vec3f& axis : axes)
+		{
+			st_vec3f d = a.rotation.rotate_vector(axis) - b.rotation.rotate_vector(axis);
+			assert(d.mag() < 2e-4f);
+		}
+		assert(b.rotation.axes[3] >= 0.0f);
+		assert(std::fabs(b.rotation.dot(b.rotation) - 1.0f) < 1e-6f);
+
+		for (int c = 0; c < 3; ++c)
+		{
+			assert(std::fabs(a.translation.axes[c] - b.translation.axes[c]) <= step * 0.5f + 1e-5f);
+		}
+		assert(std::fabs(a.scale - b.scale) <= a.scale * (1.0f / 2048.0f));
+	}
+
+	// Test that positions outside the cell clamp to its faces.
+	{
+		st_qts outside;
+		outside.make_identity();
+		outside.translation = { cell.origin.x - 10.0f, cell.origin.y + cell.size + 10.0f, cell.origin.z };
+
+		st_packed_transform p;
+		p.pack(outside, cell);
+		assert(p.position[0] == 0);
+		assert(p.position[1] == 65535);
+		assert(p.position[2] == 0);
+
+		st_qts clamped = p.unpack(cell);
+		assert(clamped.translation.x == cell.origin.x);
+		assert(std::fabs(clamped.translation.y - (cell.origin.y + cell.size)) < 1e-5f);
+		assert(clamped.rotation.axes[3] == 1.0f);
+	}
+}
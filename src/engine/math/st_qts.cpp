@@ -0,0 +1,67 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_qts.h"
+
+void st_qts::make_identity()
+{
+	rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+	translation = st_vec3f::zero_vector();
+	scale = 1.0f;
+}
+
+st_qts st_qts::operator*(const st_qts& __restrict b) const
+{
+	st_qts result;
+	result.rotation = b.rotation * rotation;
+	result.translation = b.translation + b.rotation.rotate_vector(translation).scale_result(b.scale);
+	result.scale = scale * b.scale;
+	return result;
+}
+
+st_qts& st_qts::operator*=(const st_qts& __restrict b)
+{
+	(*this) = (*this) * b;
+	return (*this);
+}
+
+st_vec3f st_qts::transform_vector(const st_vec3f& __restrict in) const
+{
+	return rotation.rotate_vector(in).scale_result(scale);
+}
+
+st_vec3f st_qts::transform_point(const st_vec3f& __restrict in) const
+{
+	return translation + transform_vector(in);
+}
+
+void st_qts::invert()
+{
+	rotation.conjugate();
+	scale = 1.0f / scale;
+	translation = -rotation.rotate_vector(translation).scale_result(scale);
+}
+
+st_qts st_qts::inverse() const
+{
+	st_qts inverse = (*this);
+	inverse.invert();
+	return inverse;
+}
+
+st_affine3f st_qts::to_affine() const
+{
+	st_affine3f result;
+	result.make_rotation(rotation);
+	result.scale(scale);
+	result.set_translation(translation);
+	return result;
+}
+
+st_mat4f st_qts::to_mat4f() const
+{
+	return to_affine().to_mat4f();
+}
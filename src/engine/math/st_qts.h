@@ -0,0 +1,66 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_affine3f.h"
+#include "math/st_mat4f.h"
+#include "math/st_quatf.h"
+#include "math/st_vec3f.h"
+
+/*
+** Rotation, translation and uniform scale transform.
+**
+** Points are scaled, then rotated, then translated. Products follow st_mat4f,
+** so a * b applies a first and then b. The rotation must be normalized.
+*/
+struct st_qts
+{
+	st_quatf rotation;
+	st_vec3f translation;
+	float scale;
+
+	/*
+	** Build an identity transform.
+	*/
+	void make_identity();
+
+	/*
+	** Compose two transforms, this one first.
+	*/
+	st_qts operator*(const st_qts& __restrict b) const;
+
+	/*
+	** Compose with another transform, storing the result in this one.
+	*/
+	st_qts& operator*=(const st_qts& __restrict b);
+
+	/*
+	** Transform a vector, ignoring translation.
+	*/
+	st_vec3f transform_vector(const st_vec3f& __restrict in) const;
+
+	/*
+	** Transform a point.
+	*/
+	st_vec3f transform_point(const st_vec3f& __restrict in) const;
+
+	/*
+	** Invert the transform.
+	*/
+	void invert();
+
+	/*
+	** Return the inverse of this transform.
+	*/
+	st_qts inverse() const;
+
+	/*
+	** Expand to an affine transform or a 4x4 matrix.
+	*/
+	st_affine3f to_affine() const;
+	st_mat4f to_mat4f() const;
+};
@@ -1,19 +0,0 @@
-/*
-** Stratos Rendering Engine
-**
-** This file is distributed under the MIT License. See LICENSE.txt.
-*/
-
-#include "math/st_quatf.h"
-
-st_quatf::st_quatf()
-{
-}
-
-st_quatf::st_quatf(float nx, float ny, float nz, float nw)
-{
-	x = nx;
-	y = ny;
-	z = nz;
-	w = nw;
-}
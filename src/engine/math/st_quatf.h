@@ -12,19 +12,38 @@
 
 /*
 ** Floating point quaternion object.
+**
+** Operations that need no trigonometry or square root are constexpr, and
+** like the vector types they only touch the axes member.
 */
 struct st_quatf
 {
 	union
 	{
-		struct { float x, y, z, w; };
-		struct { st_vec3f v3; float s; };
-		st_vec4f v4;
 		float axes[4];
+		struct { float x, y, z, w; };
 	};
 
-	st_quatf();
-	st_quatf(float nx, float ny, float nz, float nw);
+	st_quatf() {}
+	constexpr st_quatf(float nx, float ny, float nz, float nw) : axes{ nx, ny, nz, nw } {}
+
+	/*
+	** Build the identity quaternion.
+	*/
+	static constexpr st_quatf identity() { return st_quatf(0.0f, 0.0f, 0.0f, 1.0f); }
+
+	/*
+	** Get the vector part of the quaternion.
+	*/
+	constexpr st_vec3f get_vector() const { return { axes[0], axes[1], axes[2] }; }
+
+	/*
+	** Set the vector part of the quaternion.
+	*/
+	constexpr void set_vector(const st_vec3f& v)
+	{
+		for (int i = 0; i < 3; ++i) axes[i] = v.axes[i];
+	}
 
 	/*
 	** Build a quaternion for an axis and angle.
@@ -33,8 +52,20 @@ struct st_quatf
 	*/
 	inline void make_axis_angle(const st_vec3f& __restrict axis, float angle)
 	{
-		s = st_cosf(angle * 0.5f);
-		v3 = axis.scale_result(st_sinf(angle * 0.5f));
+		w = st_cosf(angle * 0.5f);
+		set_vector(axis.scale_result(st_sinf(angle * 0.5f)));
+	}
+
+	/*
+	** Build a quaternion for an axis and angle using st_sincosf_fast.
+	** @param axis Normalized axis.
+	** @param angle Angle about axis in radians.
+	*/
+	inline void make_axis_angle_fast(const st_vec3f& __restrict axis, float angle)
+	{
+		float sin_half;
+		st_sincosf_fast(angle * 0.5f, sin_half, w);
+		set_vector(axis.scale_result(sin_half));
 	}
 
 	/*
@@ -42,21 +73,16 @@ struct st_quatf
 	** @param b The second quaternion.
 	** @returns The quaternion representing this * b.
 	*/
-	inline st_quatf operator*(const st_quatf& __restrict b) const
+	constexpr st_quatf operator*(const st_quatf& __restrict b) const
 	{
-		st_quatf result;
-		result.v3 = st_vec3f_cross(v3, b.v3);
+		st_vec3f a_v3 = get_vector();
+		st_vec3f b_v3 = b.get_vector();
 
-		st_vec3f tmp1;
-		tmp1 = b.v3.scale_result(s);
-		result.v3 += tmp1;
-		st_vec3f tmp2;
-		tmp2 = v3.scale_result(b.s);
-		result.v3 += tmp2;
+		st_vec3f v = st_vec3f_cross(a_v3, b_v3);
+		v += b_v3.scale_result(axes[3]);
+		v += a_v3.scale_result(b.axes[3]);
 
-		result.s = (s * b.s) - v3.dot(b.v3);
-
-		return result;
+		return st_quatf(v.axes[0], v.axes[1], v.axes[2], (axes[3] * b.axes[3]) - a_v3.dot(b_v3));
 	}
 
 	/*
@@ -64,10 +90,10 @@ struct st_quatf
 	** @param b The second quaternion.
 	** @returns The quaternion representing this + b.
 	*/
-	inline st_quatf operator+(const st_quatf& __restrict b) const
+	constexpr st_quatf operator+(const st_quatf& __restrict b) const
 	{
-		st_quatf result;
-		result.v4 = v4 + b.v4;
+		st_quatf result = (*this);
+		for (int i = 0; i < 4; ++i) result.axes[i] = axes[i] + b.axes[i];
 		return result;
 	}
 
@@ -76,7 +102,7 @@ struct st_quatf
 	** @param b The second quaternion.
 	** @returns A reference to this quaternion, as the result of this + b.
 	*/
-	inline st_quatf& operator+=(const st_quatf& __restrict b)
+	constexpr st_quatf& operator+=(const st_quatf& __restrict b)
 	{
 		(*this) = (*this) + b;
 		return (*this);
@@ -87,10 +113,20 @@ struct st_quatf
 	** @param s The float value to scale by.
 	** @returns The quaternion equivalent to this scaled by s.
 	*/
-	inline st_quatf scale_result(const float s) const
+	constexpr st_quatf scale_result(const float s) const
+	{
+		st_quatf result = (*this);
+		for (int i = 0; i < 4; ++i) result.axes[i] = axes[i] * s;
+		return result;
+	}
+
+	/*
+	** Compute the dot product between this quaternion and another.
+	*/
+	constexpr float dot(const st_quatf& __restrict b) const
 	{
-		st_quatf result;
-		result.v4 = v4.scale_result(s);
+		float result = 0.0f;
+		for (int i = 0; i < 4; ++i) result += axes[i] * b.axes[i];
 		return result;
 	}
 
@@ -98,19 +134,23 @@ struct st_quatf
 	** Conjugate a quaternion in place.
 	** @param q The quaternion.
 	*/
-	inline void conjugate()
+	constexpr void conjugate()
 	{
-		v3.negate();
+		for (int i = 0; i < 3; ++i) axes[i] = -axes[i];
 	}
 
 	/*
 	** Invert a quaternion in place.
 	** @param q The quaternion.
 	*/
-	inline void inverse()
+	constexpr void inverse()
 	{
 		conjugate();
-		v4.scale(1.0f / v4.mag2());
+
+		float mag2 = 0.0f;
+		for (int i = 0; i < 4; ++i) mag2 += axes[i] * axes[i];
+		float inv_mag2 = 1.0f / mag2;
+		for (int i = 0; i < 4; ++i) axes[i] = axes[i] * inv_mag2;
 	}
 
 	/*
@@ -118,6 +158,76 @@ struct st_quatf
 	*/
 	inline void normalize()
 	{
-		v4.normalize();
+		st_vec4f v(axes[0], axes[1], axes[2], axes[3]);
+		v.normalize();
+		(*this) = st_quatf(v.axes[0], v.axes[1], v.axes[2], v.axes[3]);
+	}
+
+	/*
+	** Normalize the quaternion using st_rsqrtf_fast.
+	*/
+	inline void normalize_fast()
+	{
+		st_vec4f v(axes[0], axes[1], axes[2], axes[3]);
+		v.normalize_fast();
+		(*this) = st_quatf(v.axes[0], v.axes[1], v.axes[2], v.axes[3]);
+	}
+
+	/*
+	** Rotate a vector by this quaternion, which must be normalized.
+	** Equivalent to transforming by the matrix from st_mat4f::make_rotation.
+	** @param v The vector to rotate.
+	** @returns The rotated vector.
+	*/
+	constexpr st_vec3f rotate_vector(const st_vec3f& __restrict v) const
+	{
+		st_vec3f u = get_vector();
+		st_vec3f t = st_vec3f_cross(u, v).scale_result(2.0f);
+		return v + t.scale_result(axes[3]) + st_vec3f_cross(u, t);
 	}
 };
+
+/*
+** Above this dot product st_quatf_slerp falls back to st_quatf_nlerp, whose
+** result is indistinguishable there and which avoids dividing by a vanishing sine.
+*/
+const float k_st_quatf_slerp_threshold = 0.9995f;
+
+/*
+** Normalized linear interpolation between two normalized quaternions, along
+** the shorter arc. Cheap, but the angular velocity is not constant in t.
+** @param a The quaternion at t = 0.
+** @param b The quaternion at t = 1.
+** @param t Interpolation parameter in [0, 1].
+*/
+inline st_quatf st_quatf_nlerp(const st_quatf& a, const st_quatf& b, float t)
+{
+	float sign = a.dot(b) < 0.0f ? -1.0f : 1.0f;
+	st_quatf result = a.scale_result(1.0f - t) + b.scale_result(t * sign);
+	result.normalize();
+	return result;
+}
+
+/*
+** Spherical linear interpolation between two normalized quaternions, along
+** the shorter arc, at constant angular velocity.
+** @param a The quaternion at t = 0.
+** @param b The quaternion at t = 1.
+** @param t Interpolation parameter in [0, 1].
+*/
+inline st_quatf st_quatf_slerp(const st_quatf& a, const st_quatf& b, float t)
+{
+	float d = a.dot(b);
+	float sign = d < 0.0f ? -1.0f : 1.0f;
+	d = d * sign;
+	if (d > k_st_quatf_slerp_threshold)
+	{
+		return st_quatf_nlerp(a, b, t);
+	}
+
+	float theta = st_acosf(d);
+	float inv_sin_theta = 1.0f / st_sinf(theta);
+	float weight_a = st_sinf((1.0f - t) * theta) * inv_sin_theta;
+	float weight_b = st_sinf(t * theta) * inv_sin_theta * sign;
+	return a.scale_result(weight_a) + b.scale_result(weight_b);
+}
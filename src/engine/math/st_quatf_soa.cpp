@@ -0,0 +1,382 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_quatf_soa.h"
+
+#include "math/st_affine3f.h"
+#include "math/st_fast_math.h"
+#include "math/st_qts.h"
+#include "math/st_soa.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+static_assert(k_st_vec3f_soa_padding % k_st_soa_width == 0, "SoA padding must be a multiple of the lane width.");
+
+/*
+** Dot product accumulated from zero, in the same order as st_quatf::dot.
+*/
+static inline st_soa_lane_t _st_soa_dot4(
+	st_soa_lane_t ax, st_soa_lane_t ay, st_soa_lane_t az, st_soa_lane_t aw,
+	st_soa_lane_t bx, st_soa_lane_t by, st_soa_lane_t bz, st_soa_lane_t bw)
+{
+	st_soa_lane_t result = _st_soa_add(_st_soa_splat(0.0f), _st_soa_mul(ax, bx));
+	result = _st_soa_add(result, _st_soa_mul(ay, by));
+	result = _st_soa_add(result, _st_soa_mul(az, bz));
+	return _st_soa_add(result, _st_soa_mul(aw, bw));
+}
+
+/*
+** Arc cosine of x in [0, 1], as st_acosf_fast.
+*/
+static inline st_soa_lane_t _st_soa_acos_positive(st_soa_lane_t x)
+{
+	st_soa_lane_t p = _st_soa_splat(k_st_fast_math_acos_coefficients[7]);
+	for (int i = 6; i >= 0; --i)
+	{
+		p = _st_soa_add(_st_soa_mul(p, x), _st_soa_splat(k_st_fast_math_acos_coefficients[i]));
+	}
+	return _st_soa_mul(_st_soa_sqrt(_st_soa_sub(_st_soa_splat(1.0f), x)), p);
+}
+
+/*
+** Sine of x in [0, pi/2]. Above pi/4 it is the cosine of the complement, so
+** both polynomials of st_sincosf_fast stay on their reduced range.
+*/
+static inline st_soa_lane_t _st_soa_sin_quadrant(st_soa_lane_t x)
+{
+	st_soa_mask_t is_upper = _st_soa_greater(x, _st_soa_splat(st_PI * 0.25f));
+	st_soa_lane_t r = _st_soa_select(is_upper, _st_soa_sub(_st_soa_splat(st_PI * 0.5f), x), x);
+	st_soa_lane_t r2 = _st_soa_mul(r, r);
+
+	st_soa_lane_t s = _st_soa_add(_st_soa_splat(8.3321608736e-3f), _st_soa_mul(r2, _st_soa_splat(-1.9515295891e-4f)));
+	s = _st_soa_add(_st_soa_splat(-1.6666654611e-1f), _st_soa_mul(r2, s));
+	s = _st_soa_add(r, _st_soa_mul(_st_soa_mul(r, r2), s));
+
+	st_soa_lane_t c = _st_soa_add(_st_soa_splat(-1.388731625493765e-3f), _st_soa_mul(r2, _st_soa_splat(2.443315711809948e-5f)));
+	c = _st_soa_add(_st_soa_splat(4.166664568298827e-2f), _st_soa_mul(r2, c));
+	c = _st_soa_add(
+		_st_soa_sub(_st_soa_splat(1.0f), _st_soa_mul(_st_soa_splat(0.5f), r2)),
+		_st_soa_mul(_st_soa_mul(r2, r2), c));
+
+	return _st_soa_select(is_upper, c, s);
+}
+
+st_quatf_soa::st_quatf_soa()
+{
+}
+
+st_quatf_soa::st_quatf_soa(int count)
+{
+	resize(count);
+}
+
+st_quatf_soa::st_quatf_soa(const std::vector<st_quatf>& quaternions)
+{
+	from_aos(quaternions);
+}
+
+st_quatf_soa::st_quatf_soa(const st_quatf_soa& other)
+{
+	(*this) = other;
+}
+
+st_quatf_soa::st_quatf_soa(st_quatf_soa&& other)
+{
+	(*this) = std::move(other);
+}
+
+st_quatf_soa::~st_quatf_soa()
+{
+	if (_x)
+	{
+		operator delete[](_x, std::align_val_t(k_st_soa_alignment));
+	}
+}
+
+st_quatf_soa& st_quatf_soa::operator=(const st_quatf_soa& other)
+{
+	if (&other != this)
+	{
+		resize(other._count);
+		if (_count > 0)
+		{
+			memcpy(_x, other._x, sizeof(float) * _count);
+			memcpy(_y, other._y, sizeof(float) * _count);
+			memcpy(_z, other._z, sizeof(float) * _count);
+			memcpy(_w, other._w, sizeof(float) * _count);
+		}
+	}
+	return *this;
+}
+
+st_quatf_soa& st_quatf_soa::operator=(st_quatf_soa&& other)
+{
+	if (&other != this)
+	{
+		std::swap(_x, other._x);
+		std::swap(_y, other._y);
+		std::swap(_z, other._z);
+		std::swap(_w, other._w);
+		std::swap(_count, other._count);
+		std::swap(_capacity, other._capacity);
+	}
+	return *this;
+}
+
+void st_quatf_soa::reserve(int capacity)
+{
+	capacity = (capacity + k_st_vec3f_soa_padding - 1) & ~(k_st_vec3f_soa_padding - 1);
+	if (capacity <= _capacity)
+	{
+		return;
+	}
+
+	/* All four arrays share one allocation. */
+	float* data = static_cast<float*>(operator new[](
+		sizeof(float) * 4 * capacity,
+		std::align_val_t(k_st_soa_alignment)));
+	memset(data, 0, sizeof(float) * 4 * capacity);
+
+	if (_x)
+	{
+		memcpy(data, _x, sizeof(float) * _count);
+		memcpy(data + capacity, _y, sizeof(float) * _count);
+		memcpy(data + 2 * capacity, _z, sizeof(float) * _count);
+		memcpy(data + 3 * capacity, _w, sizeof(float) * _count);
+		operator delete[](_x, std::align_val_t(k_st_soa_alignment));
+	}
+
+	_x = data;
+	_y = data + capacity;
+	_z = data + 2 * capacity;
+	_w = data + 3 * capacity;
+	_capacity = capacity;
+}
+
+void st_quatf_soa::resize(int count)
+{
+	assert(count >= 0);
+	reserve(count);
+	_count = count;
+}
+
+st_quatf st_quatf_soa::get(int index) const
+{
+	assert(index >= 0 && index < _count);
+	return { _x[index], _y[index], _z[index], _w[index] };
+}
+
+void st_quatf_soa::set(int index, const st_quatf& q)
+{
+	assert(index >= 0 && index < _count);
+	_x[index] = q.x;
+	_y[index] = q.y;
+	_z[index] = q.z;
+	_w[index] = q.w;
+}
+
+void st_quatf_soa::from_aos(const st_quatf* quaternions, int count)
+{
+	resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		_x[i] = quaternions[i].x;
+		_y[i] = quaternions[i].y;
+		_z[i] = quaternions[i].z;
+		_w[i] = quaternions[i].w;
+	}
+}
+
+void st_quatf_soa::from_aos(const std::vector<st_quatf>& quaternions)
+{
+	from_aos(quaternions.data(), int(quaternions.size()));
+}
+
+void st_quatf_soa::to_aos(st_quatf* quaternions) const
+{
+	for (int i = 0; i < _count; ++i)
+	{
+		quaternions[i] = { _x[i], _y[i], _z[i], _w[i] };
+	}
+}
+
+void st_quatf_soa::to_aos(std::vector<st_quatf>& quaternions) const
+{
+	quaternions.resize(_count);
+	to_aos(quaternions.data());
+}
+
+/*
+** Shared body of nlerp and slerp: out = normalize(a * weight_a + b * weight_b),
+** with the weights chosen per lane by the template parameter.
+*/
+template<bool k_is_spherical>
+static void _st_quatf_soa_interpolate(const st_quatf_soa& a, const st_quatf_soa& b, float t, st_quatf_soa& out)
+{
+	assert(a.size() == b.size());
+	out.resize(a.size());
+
+	const float* ax = a.get_x();
+	const float* ay = a.get_y();
+	const float* az = a.get_z();
+	const float* aw = a.get_w();
+	const float* bx = b.get_x();
+	const float* by = b.get_y();
+	const float* bz = b.get_z();
+	const float* bw = b.get_w();
+	float* ox = out.get_x();
+	float* oy = out.get_y();
+	float* oz = out.get_z();
+	float* ow = out.get_w();
+
+	st_soa_lane_t zero = _st_soa_splat(0.0f);
+	st_soa_lane_t one = _st_soa_splat(1.0f);
+	st_soa_lane_t negative_one = _st_soa_splat(-1.0f);
+	st_soa_lane_t lane_t = _st_soa_splat(t);
+	st_soa_lane_t lane_one_minus_t = _st_soa_splat(1.0f - t);
+	st_soa_lane_t threshold = _st_soa_splat(k_st_quatf_slerp_threshold);
+
+	int count = _st_soa_lane_count(a.size());
+	for (int i = 0; i < count; i += k_st_soa_width)
+	{
+		st_soa_lane_t x0 = _st_soa_load(ax + i);
+		st_soa_lane_t y0 = _st_soa_load(ay + i);
+		st_soa_lane_t z0 = _st_soa_load(az + i);
+		st_soa_lane_t w0 = _st_soa_load(aw + i);
+		st_soa_lane_t x1 = _st_soa_load(bx + i);
+		st_soa_lane_t y1 = _st_soa_load(by + i);
+		st_soa_lane_t z1 = _st_soa_load(bz + i);
+		st_soa_lane_t w1 = _st_soa_load(bw + i);
+
+		/* Flip b onto the same hemisphere as a to take the shorter arc. */
+		st_soa_lane_t d = _st_soa_dot4(x0, y0, z0, w0, x1, y1, z1, w1);
+		st_soa_lane_t sign = _st_soa_select(_st_soa_greater(zero, d), negative_one, one);
+
+		st_soa_lane_t weight_a = lane_one_minus_t;
+		st_soa_lane_t weight_b = _st_soa_mul(lane_t, sign);
+		if (k_is_spherical)
+		{
+			/* Nearly parallel lanes keep the nlerp weights, as st_quatf_slerp does. */
+			d = _st_soa_min(_st_soa_mul(d, sign), one);
+			st_soa_mask_t is_linear = _st_soa_greater(d, threshold);
+
+			st_soa_lane_t theta = _st_soa_acos_positive(d);
+			st_soa_lane_t inv_sin_theta = _st_soa_div(one, _st_soa_sin_quadrant(theta));
+			st_soa_lane_t spherical_a = _st_soa_mul(_st_soa_sin_quadrant(_st_soa_mul(lane_one_minus_t, theta)), inv_sin_theta);
+			st_soa_lane_t spherical_b = _st_soa_mul(_st_soa_mul(_st_soa_sin_quadrant(_st_soa_mul(lane_t, theta)), inv_sin_theta), sign);
+
+			weight_a = _st_soa_select(is_linear, weight_a, spherical_a);
+			weight_b = _st_soa_select(is_linear, weight_b, spherical_b);
+		}
+
+		st_soa_lane_t x = _st_soa_add(_st_soa_mul(x0, weight_a), _st_soa_mul(x1, weight_b));
+		st_soa_lane_t y = _st_soa_add(_st_soa_mul(y0, weight_a), _st_soa_mul(y1, weight_b));
+		st_soa_lane_t z = _st_soa_add(_st_soa_mul(z0, weight_a), _st_soa_mul(z1, weight_b));
+		st_soa_lane_t w = _st_soa_add(_st_soa_mul(w0, weight_a), _st_soa_mul(w1, weight_b));
+
+		/* Scale by the reciprocal of the magnitude, like st_quatf::normalize. */
+		st_soa_lane_t scale = _st_soa_div(one, _st_soa_sqrt(_st_soa_dot4(x, y, z, w, x, y, z, w)));
+		_st_soa_store(ox + i, _st_soa_mul(x, scale));
+		_st_soa_store(oy + i, _st_soa_mul(y, scale));
+		_st_soa_store(oz + i, _st_soa_mul(z, scale));
+		_st_soa_store(ow + i, _st_soa_mul(w, scale));
+	}
+}
+
+void st_quatf_soa_nlerp(const st_quatf_soa& a, const st_quatf_soa& b, float t, st_quatf_soa& out)
+{
+	_st_quatf_soa_interpolate<false>(a, b, t, out);
+}
+
+void st_quatf_soa_slerp(const st_quatf_soa& a, const st_quatf_soa& b, float t, st_quatf_soa& out)
+{
+	_st_quatf_soa_interpolate<true>(a, b, t, out);
+}
+
+void st_quatf_soa_to_affine(
+	const st_quatf_soa& rotations,
+	const st_vec3f_soa& translations,
+	const float* scales,
+	st_affine3f* out)
+{
+	assert(rotations.size() == translations.size());
+
+	const float* qx = rotations.get_x();
+	const float* qy = rotations.get_y();
+	const float* qz = rotations.get_z();
+	const float* qw = rotations.get_w();
+	const float* tx = translations.get_x();
+	const float* ty = translations.get_y();
+	const float* tz = translations.get_z();
+
+	st_soa_lane_t one = _st_soa_splat(1.0f);
+	st_soa_lane_t two = _st_soa_splat(2.0f);
+
+	/* The scales and the output are not padded, so the last partial register is done one at a time. */
+	int count = rotations.size();
+	int i = 0;
+	for (; i + k_st_soa_width <= count; i += k_st_soa_width)
+	{
+		st_soa_lane_t x = _st_soa_load(qx + i);
+		st_soa_lane_t y = _st_soa_load(qy + i);
+		st_soa_lane_t z = _st_soa_load(qz + i);
+		st_soa_lane_t w = _st_soa_load(qw + i);
+		st_soa_lane_t s = _st_soa_loadu(scales + i);
+
+		/* Rotation terms in the order of st_affine3f::make_rotation, then scaled. */
+		st_soa_lane_t rows[3][4];
+		rows[0][0] = _st_soa_sub(one, _st_soa_mul(two, _st_soa_add(_st_soa_mul(y, y), _st_soa_mul(z, z))));
+		rows[0][1] = _st_soa_mul(two, _st_soa_sub(_st_soa_mul(x, y), _st_soa_mul(z, w)));
+		rows[0][2] = _st_soa_mul(two, _st_soa_add(_st_soa_mul(x, z), _st_soa_mul(y, w)));
+		rows[1][0] = _st_soa_mul(two, _st_soa_add(_st_soa_mul(x, y), _st_soa_mul(z, w)));
+		rows[1][1] = _st_soa_sub(one, _st_soa_mul(two, _st_soa_add(_st_soa_mul(x, x), _st_soa_mul(z, z))));
+		rows[1][2] = _st_soa_mul(two, _st_soa_sub(_st_soa_mul(y, z), _st_soa_mul(x, w)));
+		rows[2][0] = _st_soa_mul(two, _st_soa_sub(_st_soa_mul(x, z), _st_soa_mul(y, w)));
+		rows[2][1] = _st_soa_mul(two, _st_soa_add(_st_soa_mul(y, z), _st_soa_mul(x, w)));
+		rows[2][2] = _st_soa_sub(one, _st_soa_mul(two, _st_soa_add(_st_soa_mul(x, x), _st_soa_mul(y, y))));
+		for (int r = 0; r < 3; ++r)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				rows[r][c] = _st_soa_mul(rows[r][c], s);
+			}
+		}
+		rows[0][3] = _st_soa_load(tx + i);
+		rows[1][3] = _st_soa_load(ty + i);
+		rows[2][3] = _st_soa_load(tz + i);
+
+		/* Transpose out through the stack, one transform per lane. */
+		float lanes[3][4][k_st_soa_width];
+		for (int r = 0; r < 3; ++r)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				_st_soa_storeu(lanes[r][c], rows[r][c]);
+			}
+		}
+		for (int l = 0; l < k_st_soa_width; ++l)
+		{
+			for (int r = 0; r < 3; ++r)
+			{
+				for (int c = 0; c < 4; ++c)
+				{
+					out[i + l].data[r][c] = lanes[r][c][l];
+				}
+			}
+		}
+	}
+	for (; i < count; ++i)
+	{
+		st_qts qts;
+		qts.rotation = rotations.get(i);
+		qts.translation = translations.get(i);
+		qts.scale = scales[i];
+		out[i] = qts.to_affine();
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math_fwd.h"
+#include "math/st_quatf.h"
+#include "math/st_vec3f_soa.h"
+
+#include <vector>
+
+/*
+** Quaternions stored as separate x, y, z and w arrays.
+**
+** Aligned and padded like st_vec3f_soa, so kernels can always operate on
+** whole registers. Lanes past size() are padding and hold unspecified values.
+*/
+class st_quatf_soa
+{
+public:
+	st_quatf_soa();
+	explicit st_quatf_soa(int count);
+	explicit st_quatf_soa(const std::vector<st_quatf>& quaternions);
+	st_quatf_soa(const st_quatf_soa& other);
+	st_quatf_soa(st_quatf_soa&& other);
+	~st_quatf_soa();
+
+	st_quatf_soa& operator=(const st_quatf_soa& other);
+	st_quatf_soa& operator=(st_quatf_soa&& other);
+
+	/*
+	** Change the number of quaternions, preserving existing values.
+	*/
+	void resize(int count);
+	int size() const { return _count; }
+
+	st_quatf get(int index) const;
+	void set(int index, const st_quatf& q);
+
+	/*
+	** Convert from and to the array of structures layout.
+	*/
+	void from_aos(const st_quatf* quaternions, int count);
+	void from_aos(const std::vector<st_quatf>& quaternions);
+	void to_aos(st_quatf* quaternions) const;
+	void to_aos(std::vector<st_quatf>& quaternions) const;
+
+	float* get_x() { return _x; }
+	float* get_y() { return _y; }
+	float* get_z() { return _z; }
+	float* get_w() { return _w; }
+	const float* get_x() const { return _x; }
+	const float* get_y() const { return _y; }
+	const float* get_z() const { return _z; }
+	const float* get_w() const { return _w; }
+
+private:
+	void reserve(int capacity);
+
+	float* _x = nullptr;
+	float* _y = nullptr;
+	float* _z = nullptr;
+	float* _w = nullptr;
+	int _count = 0;
+	int _capacity = 0;
+};
+
+/*
+** Batched kernels over st_quatf_soa.
+**
+** Outputs of type st_quatf_soa are resized to match the inputs and may alias
+** them. Inputs must be normalized.
+*/
+
+/*
+** Normalized linear interpolation of each pair, the same per element as
+** st_quatf_nlerp.
+*/
+void st_quatf_soa_nlerp(const st_quatf_soa& a, const st_quatf_soa& b, float t, st_quatf_soa& out);
+
+/*
+** Spherical linear interpolation of each pair, using the fast tier arc cosine
+** and sine and renormalizing. Within 1e-6 of st_quatf_slerp per component,
+** and the same as st_quatf_nlerp above k_st_quatf_slerp_threshold.
+*/
+void st_quatf_soa_slerp(const st_quatf_soa& a, const st_quatf_soa& b, float t, st_quatf_soa& out);
+
+/*
+** Expand rotation, translation and uniform scale triples to affine
+** transforms, the same per element as st_qts::to_affine.
+** @param scales One scale per rotation.
+** @param out Receives rotations.size() transforms.
+*/
+void st_quatf_soa_to_affine(
+	const st_quatf_soa& rotations,
+	const st_vec3f_soa& translations,
+	const float* scales,
+	st_affine3f* out);
@@ -0,0 +1,158 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_quatf_soa.tests.h"
+#include "st_quatf_soa.h"
+
+#include "st_affine3f.h"
+#include "st_qts.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+static const float k_st_quatf_soa_test_slerp_absolute = 1e-6f;
+
+static st_test_random _st_quatf_soa_test_random(0x7f4a7c15);
+
+static std::vector<st_quatf> _st_quatf_soa_test_random_quaternions(int count)
+{
+	std::vector<st_quatf> quaternions(count);
+	for (int i = 0; i < count; ++i)
+	{
+		st_quatf q(_st_quatf_soa_test_random.next(-1.0f, 1.0f), _st_quatf_soa_test_random.next(-1.0f, 1.0f), _st_quatf_soa_test_random.next(-1.0f, 1.0f), _st_quatf_soa_test_random.next(-1.0f, 1.0f));
+		q.normalize();
+		quaternions[i] = q;
+	}
+	return quaternions;
+}
+
+static bool _st_quatf_soa_test_bitwise_equal(const st_quatf& a, const st_quatf& b)
+{
+	return memcmp(&a, &b, sizeof(st_quatf)) == 0;
+}
+
+void st_quatf_soa_unit_tests()
+{
+	// Odd sizes exercise the partial register at the end of each array.
+	const int k_counts[] = { 0, 1, 3, 8, 17, 75 };
+	const float k_ts[] = { 0.0f, 0.25f, 0.5f, 0.9f, 1.0f };
+
+	for (int count : k_counts)
+	{
+		std::vector<st_quatf> a = _st_quatf_soa_test_random_quaternions(count);
+		std::vector<st_quatf> b = _st_quatf_soa_test_random_quaternions(count);
+
+		// Nearly parallel pairs, on both hemispheres, take the linear path in slerp.
+		for (int i = 0; i + 1 < count; i += 4)
+		{
+			st_quatf nudge(a[i].x + 0.001f, a[i].y, a[i].z, a[i].w);
+			nudge.normalize();
+			b[i] = nudge;
+			b[i + 1] = a[i + 1].scale_result(-1.0f);
+		}
+
+		st_quatf_soa soa_a(a);
+		st_quatf_soa soa_b(b);
+
+		// Test conversion round trip.
+		{
+			std::vector<st_quatf> round_trip;
+			soa_a.to_aos(round_trip);
+			assert(int(round_trip.size()) == count);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_quatf_soa_test_bitwise_equal(round_trip[i], a[i]));
+			}
+		}
+
+		for (float t : k_ts)
+		{
+			// Test nlerp, bitwise against the scalar reference.
+			st_quatf_soa out;
+			st_quatf_soa_nlerp(soa_a, soa_b, t, out);
+			assert(out.size() == count);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_quatf_soa_test_bitwise_equal(out.get(i), st_quatf_nlerp(a[i], b[i], t)));
+			}
+
+			// Test slerp against the exact scalar reference, and nlerp where they agree to switch.
+			st_quatf_soa_slerp(soa_a, soa_b, t, out);
+			for (int i = 0; i < count; ++i)
+			{
+				st_quatf expected = st_quatf_slerp(a[i], b[i], t);
+				for (int c = 0; c < 4; ++c)
+				{
+					assert(std::fabs(out.get(i).axes[c] - expected.axes[c]) < k_st_quatf_soa_test_slerp_absolute);
+				}
+				if (std::fabs(a[i].dot(b[i])) > k_st_quatf_slerp_threshold)
+				{
+					assert(_st_quatf_soa_test_bitwise_equal(out.get(i), expected));
+				}
+			}
+		}
+
+		// Test output aliasing an input.
+		{
+			st_quatf_soa aliased = soa_a;
+			st_quatf_soa_nlerp(aliased, soa_b, 0.5f, aliased);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_quatf_soa_test_bitwise_equal(aliased.get(i), st_quatf_nlerp(a[i], b[i], 0.5f)));
+			}
+		}
+
+		// Test expansion to affine transforms, bitwise against st_qts::to_affine.
+		{
+			st_vec3f_soa translations(count);
+			std::vector<float> scales(count);
+			for (int i = 0; i < count; ++i)
+			{
+				translations.set(i, { _st_quatf_soa_test_random.next(-1.0f, 1.0f) * 10.0f, _st_quatf_soa_test_random.next(-1.0f, 1.0f) * 10.0f, _st_quatf_soa_test_random.next(-1.0f, 1.0f) * 10.0f });
+				scales[i] = 1.5f + _st_quatf_soa_test_random.next(-1.0f, 1.0f);
+			}
+
+			std::vector<st_affine3f> out(count);
+			st_quatf_soa_to_affine(soa_a, translations, scales.data(), out.data());
+			for (int i = 0; i < count; ++i)
+			{
+				st_qts qts;
+				qts.rotation = a[i];
+				qts.translation = translations.get(i);
+				qts.scale = scales[i];
+				st_affine3f expected = qts.to_affine();
+				assert(memcmp(&out[i], &expected, sizeof(st_affine3f)) == 0);
+			}
+		}
+	}
+
+	// Test the scalar references at the ends of the range and along the shorter arc.
+	{
+		st_quatf a = st_quatf::identity();
+		st_quatf b;
+		b.make_axis_angle(st_vec3f::y_vector(), st_PI * 0.5f);
+
+		st_quatf start = st_quatf_slerp(a, b, 0.0f);
+		st_quatf end = st_quatf_slerp(a, b, 1.0f);
+		for (int c = 0; c < 4; ++c)
+		{
+			assert(std::fabs(start.axes[c] - a.axes[c]) < 1e-6f);
+			assert(std::fabs(end.axes[c] - b.axes[c]) < 1e-6f);
+		}
+
+		// Halfway through a quarter turn, starting from the negated end to check the shorter arc.
+		st_quatf half;
+		half.make_axis_angle(st_vec3f::y_vector(), st_PI * 0.25f);
+		st_quatf mid = st_quatf_slerp(a, b.scale_result(-1.0f), 0.5f);
+		for (int c = 0; c < 4; ++c)
+		{
+			assert(std::fabs(mid.axes[c] - half.axes[c]) < 1e-6f);
+		}
+	}
+}
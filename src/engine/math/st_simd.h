@@ -0,0 +1,208 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Compile time selection of the SIMD instruction set used by the math library.
+**
+** SSE2 is the baseline on x64. AVX2 is used when the compiler targets it
+** (/arch:AVX2 or -mavx2), and NEON on ARM64. Define ST_MATH_SCALAR to force
+** the portable scalar paths, which are kept as the reference implementation.
+*/
+
+#if !defined(ST_MATH_SCALAR)
+#if defined(__AVX2__)
+#define ST_SIMD_AVX2
+#define ST_SIMD_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ST_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define ST_SIMD_NEON
+#endif
+#endif
+
+#if defined(ST_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(ST_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(ST_SIMD_SSE) || defined(ST_SIMD_NEON)
+#define ST_SIMD
+#endif
+
+/*
+** Hardware half precision conversion. Every AVX2 part has F16C, but GCC and
+** Clang only enable it on request (-mf16c or a -march that includes it).
+*/
+#if defined(ST_SIMD_SSE) && (defined(__F16C__) || (defined(_MSC_VER) && defined(ST_SIMD_AVX2)))
+#define ST_SIMD_F16C
+#endif
+
+/*
+** Lets constexpr functions choose a SIMD path at runtime and a scalar path
+** during constant evaluation. Where the compiler lacks the builtin, types
+** that need it fall back to their scalar paths.
+*/
+#if defined(__clang__)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define ST_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#elif defined(__GNUC__)
+#if __GNUC__ >= 9
+#define ST_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#elif defined(_MSC_VER)
+#if _MSC_VER >= 1925
+#define ST_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+
+/*
+** Name of the instruction set selected for this build.
+*/
+inline const char* st_simd_get_name()
+{
+#if defined(ST_SIMD_AVX2)
+	return "avx2";
+#elif defined(ST_SIMD_SSE)
+	return "sse2";
+#elif defined(ST_SIMD_NEON)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
+
+#if defined(ST_SIMD)
+
+/*
+** Four wide float vector and the handful of operations the math kernels need.
+** Comparisons return a lane mask, all bits set where true, for use with select.
+** Mask bits packs a mask into the low four bits of an int, lane 0 lowest.
+** Round goes to the nearest integer, ties to even, and is valid below 2^31.
+** The reciprocal square root estimate has at least 12 bits of precision.
+**
+** Multiplies and adds are kept separate, never fused, so that kernels written
+** in the same operation order as the scalar code produce identical results.
+*/
+#if defined(ST_SIMD_SSE)
+typedef __m128 st_simd4f;
+
+inline st_simd4f st_simd4f_set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+inline st_simd4f st_simd4f_splat(float a) { return _mm_set1_ps(a); }
+inline st_simd4f st_simd4f_zero() { return _mm_setzero_ps(); }
+inline st_simd4f st_simd4f_load(const float* p) { return _mm_loadu_ps(p); }
+inline void st_simd4f_store(float* p, st_simd4f a) { _mm_storeu_ps(p, a); }
+inline st_simd4f st_simd4f_add(st_simd4f a, st_simd4f b) { return _mm_add_ps(a, b); }
+inline st_simd4f st_simd4f_sub(st_simd4f a, st_simd4f b) { return _mm_sub_ps(a, b); }
+inline st_simd4f st_simd4f_mul(st_simd4f a, st_simd4f b) { return _mm_mul_ps(a, b); }
+inline st_simd4f st_simd4f_div(st_simd4f a, st_simd4f b) { return _mm_div_ps(a, b); }
+inline st_simd4f st_simd4f_sqrt(st_simd4f a) { return _mm_sqrt_ps(a); }
+inline st_simd4f st_simd4f_min(st_simd4f a, st_simd4f b) { return _mm_min_ps(a, b); }
+inline st_simd4f st_simd4f_max(st_simd4f a, st_simd4f b) { return _mm_max_ps(a, b); }
+inline st_simd4f st_simd4f_greater(st_simd4f a, st_simd4f b) { return _mm_cmpgt_ps(a, b); }
+inline st_simd4f st_simd4f_equal(st_simd4f a, st_simd4f b) { return _mm_cmpeq_ps(a, b); }
+inline st_simd4f st_simd4f_round(st_simd4f a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+inline st_simd4f st_simd4f_rsqrt_estimate(st_simd4f a) { return _mm_rsqrt_ps(a); }
+inline st_simd4f st_simd4f_select(st_simd4f mask, st_simd4f a, st_simd4f b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+inline int st_simd4f_mask_bits(st_simd4f mask) { return _mm_movemask_ps(mask); }
+
+inline void st_simd4f_transpose(st_simd4f& r0, st_simd4f& r1, st_simd4f& r2, st_simd4f& r3)
+{
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+}
+#elif defined(ST_SIMD_NEON)
+typedef float32x4_t st_simd4f;
+
+inline st_simd4f st_simd4f_set(float a, float b, float c, float d)
+{
+	const float v[4] = { a, b, c, d };
+	return vld1q_f32(v);
+}
+inline st_simd4f st_simd4f_splat(float a) { return vdupq_n_f32(a); }
+inline st_simd4f st_simd4f_zero() { return vdupq_n_f32(0.0f); }
+inline st_simd4f st_simd4f_load(const float* p) { return vld1q_f32(p); }
+inline void st_simd4f_store(float* p, st_simd4f a) { vst1q_f32(p, a); }
+inline st_simd4f st_simd4f_add(st_simd4f a, st_simd4f b) { return vaddq_f32(a, b); }
+inline st_simd4f st_simd4f_sub(st_simd4f a, st_simd4f b) { return vsubq_f32(a, b); }
+inline st_simd4f st_simd4f_mul(st_simd4f a, st_simd4f b) { return vmulq_f32(a, b); }
+inline st_simd4f st_simd4f_div(st_simd4f a, st_simd4f b) { return vdivq_f32(a, b); }
+inline st_simd4f st_simd4f_sqrt(st_simd4f a) { return vsqrtq_f32(a); }
+inline st_simd4f st_simd4f_min(st_simd4f a, st_simd4f b) { return vminq_f32(a, b); }
+inline st_simd4f st_simd4f_max(st_simd4f a, st_simd4f b) { return vmaxq_f32(a, b); }
+inline st_simd4f st_simd4f_greater(st_simd4f a, st_simd4f b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline st_simd4f st_simd4f_equal(st_simd4f a, st_simd4f b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+inline st_simd4f st_simd4f_round(st_simd4f a) { return vrndnq_f32(a); }
+inline st_simd4f st_simd4f_rsqrt_estimate(st_simd4f a)
+{
+	st_simd4f e = vrsqrteq_f32(a);
+	return vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+}
+inline st_simd4f st_simd4f_select(st_simd4f mask, st_simd4f a, st_simd4f b)
+{
+	return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+}
+inline int st_simd4f_mask_bits(st_simd4f mask)
+{
+	const uint32_t k_bits[4] = { 1, 2, 4, 8 };
+	return int(vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask), vld1q_u32(k_bits))));
+}
+
+inline void st_simd4f_transpose(st_simd4f& r0, st_simd4f& r1, st_simd4f& r2, st_simd4f& r3)
+{
+	float32x4x2_t t01 = vtrnq_f32(r0, r1);
+	float32x4x2_t t23 = vtrnq_f32(r2, r3);
+	r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+	r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+	r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+#endif
+
+/*
+** Four wide double vector, for the double precision vector types. A single
+** register on AVX2, otherwise a pair of two wide registers.
+*/
+#if defined(ST_SIMD_AVX2)
+typedef __m256d st_simd4d;
+
+inline st_simd4d st_simd4d_splat(double a) { return _mm256_set1_pd(a); }
+inline st_simd4d st_simd4d_load(const double* p) { return _mm256_loadu_pd(p); }
+inline void st_simd4d_store(double* p, st_simd4d a) { _mm256_storeu_pd(p, a); }
+inline st_simd4d st_simd4d_add(st_simd4d a, st_simd4d b) { return _mm256_add_pd(a, b); }
+inline st_simd4d st_simd4d_sub(st_simd4d a, st_simd4d b) { return _mm256_sub_pd(a, b); }
+inline st_simd4d st_simd4d_mul(st_simd4d a, st_simd4d b) { return _mm256_mul_pd(a, b); }
+inline st_simd4d st_simd4d_div(st_simd4d a, st_simd4d b) { return _mm256_div_pd(a, b); }
+#elif defined(ST_SIMD_SSE)
+struct st_simd4d { __m128d lo, hi; };
+
+inline st_simd4d st_simd4d_splat(double a) { return { _mm_set1_pd(a), _mm_set1_pd(a) }; }
+inline st_simd4d st_simd4d_load(const double* p) { return { _mm_loadu_pd(p), _mm_loadu_pd(p + 2) }; }
+inline void st_simd4d_store(double* p, st_simd4d a) { _mm_storeu_pd(p, a.lo); _mm_storeu_pd(p + 2, a.hi); }
+inline st_simd4d st_simd4d_add(st_simd4d a, st_simd4d b) { return { _mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi) }; }
+inline st_simd4d st_simd4d_sub(st_simd4d a, st_simd4d b) { return { _mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi) }; }
+inline st_simd4d st_simd4d_mul(st_simd4d a, st_simd4d b) { return { _mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi) }; }
+inline st_simd4d st_simd4d_div(st_simd4d a, st_simd4d b) { return { _mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi) }; }
+#elif defined(ST_SIMD_NEON)
+struct st_simd4d { float64x2_t lo, hi; };
+
+inline st_simd4d st_simd4d_splat(double a) { return { vdupq_n_f64(a), vdupq_n_f64(a) }; }
+inline st_simd4d st_simd4d_load(const double* p) { return { vld1q_f64(p), vld1q_f64(p + 2) }; }
+inline void st_simd4d_store(double* p, st_simd4d a) { vst1q_f64(p, a.lo); vst1q_f64(p + 2, a.hi); }
+inline st_simd4d st_simd4d_add(st_simd4d a, st_simd4d b) { return { vaddq_f64(a.lo, b.lo), vaddq_f64(a.hi, b.hi) }; }
+inline st_simd4d st_simd4d_sub(st_simd4d a, st_simd4d b) { return { vsubq_f64(a.lo, b.lo), vsubq_f64(a.hi, b.hi) }; }
+inline st_simd4d st_simd4d_mul(st_simd4d a, st_simd4d b) { return { vmulq_f64(a.lo, b.lo), vmulq_f64(a.hi, b.hi) }; }
+inline st_simd4d st_simd4d_div(st_simd4d a, st_simd4d b) { return { vdivq_f64(a.lo, b.lo), vdivq_f64(a.hi, b.hi) }; }
+#endif
+
+#endif
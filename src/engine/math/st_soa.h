@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Lane abstraction shared by the structure of arrays kernels. Internal to the
+** math library's translation units; not part of any public interface.
+*/
+
+#include "math/st_math.h"
+#include "math/st_simd.h"
+
+#include <cstddef>
+
+/*
+** The widest register available to this build. Component arrays are aligned
+** and padded for it, so whole-array kernels need no tail handling.
+*/
+#if defined(ST_SIMD_AVX2)
+typedef __m256 st_soa_lane_t;
+typedef __m256 st_soa_mask_t;
+static const int k_st_soa_width = 8;
+
+static inline st_soa_lane_t _st_soa_load(const float* p) { return _mm256_load_ps(p); }
+static inline st_soa_lane_t _st_soa_loadu(const float* p) { return _mm256_loadu_ps(p); }
+static inline void _st_soa_store(float* p, st_soa_lane_t a) { _mm256_store_ps(p, a); }
+static inline void _st_soa_storeu(float* p, st_soa_lane_t a) { _mm256_storeu_ps(p, a); }
+static inline st_soa_lane_t _st_soa_splat(float a) { return _mm256_set1_ps(a); }
+static inline st_soa_lane_t _st_soa_add(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_add_ps(a, b); }
+static inline st_soa_lane_t _st_soa_sub(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_sub_ps(a, b); }
+static inline st_soa_lane_t _st_soa_mul(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_mul_ps(a, b); }
+static inline st_soa_lane_t _st_soa_div(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_div_ps(a, b); }
+static inline st_soa_lane_t _st_soa_sqrt(st_soa_lane_t a) { return _mm256_sqrt_ps(a); }
+static inline st_soa_lane_t _st_soa_min(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_min_ps(a, b); }
+static inline st_soa_lane_t _st_soa_max(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_max_ps(a, b); }
+static inline st_soa_mask_t _st_soa_greater(st_soa_lane_t a, st_soa_lane_t b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline st_soa_lane_t _st_soa_select(st_soa_mask_t m, st_soa_lane_t a, st_soa_lane_t b) { return _mm256_blendv_ps(b, a, m); }
+static inline int _st_soa_mask_bits(st_soa_mask_t m) { return _mm256_movemask_ps(m); }
+static inline st_soa_lane_t _st_soa_iota() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+#elif defined(ST_SIMD)
+typedef st_simd4f st_soa_lane_t;
+typedef st_simd4f st_soa_mask_t;
+static const int k_st_soa_width = 4;
+
+static inline st_soa_lane_t _st_soa_load(const float* p) { return st_simd4f_load(p); }
+static inline st_soa_lane_t _st_soa_loadu(const float* p) { return st_simd4f_load(p); }
+static inline void _st_soa_store(float* p, st_soa_lane_t a) { st_simd4f_store(p, a); }
+static inline void _st_soa_storeu(float* p, st_soa_lane_t a) { st_simd4f_store(p, a); }
+static inline st_soa_lane_t _st_soa_splat(float a) { return st_simd4f_splat(a); }
+static inline st_soa_lane_t _st_soa_add(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_add(a, b); }
+static inline st_soa_lane_t _st_soa_sub(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_sub(a, b); }
+static inline st_soa_lane_t _st_soa_mul(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_mul(a, b); }
+static inline st_soa_lane_t _st_soa_div(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_div(a, b); }
+static inline st_soa_lane_t _st_soa_sqrt(st_soa_lane_t a) { return st_simd4f_sqrt(a); }
+static inline st_soa_lane_t _st_soa_min(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_min(a, b); }
+static inline st_soa_lane_t _st_soa_max(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_max(a, b); }
+static inline st_soa_mask_t _st_soa_greater(st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_greater(a, b); }
+static inline st_soa_lane_t _st_soa_select(st_soa_mask_t m, st_soa_lane_t a, st_soa_lane_t b) { return st_simd4f_select(m, a, b); }
+static inline int _st_soa_mask_bits(st_soa_mask_t m) { return st_simd4f_mask_bits(m); }
+static inline st_soa_lane_t _st_soa_iota() { return st_simd4f_set(0.0f, 1.0f, 2.0f, 3.0f); }
+#else
+typedef float st_soa_lane_t;
+typedef bool st_soa_mask_t;
+static const int k_st_soa_width = 1;
+
+static inline st_soa_lane_t _st_soa_load(const float* p) { return *p; }
+static inline st_soa_lane_t _st_soa_loadu(const float* p) { return *p; }
+static inline void _st_soa_store(float* p, st_soa_lane_t a) { *p = a; }
+static inline void _st_soa_storeu(float* p, st_soa_lane_t a) { *p = a; }
+static inline st_soa_lane_t _st_soa_splat(float a) { return a; }
+static inline st_soa_lane_t _st_soa_add(st_soa_lane_t a, st_soa_lane_t b) { return a + b; }
+static inline st_soa_lane_t _st_soa_sub(st_soa_lane_t a, st_soa_lane_t b) { return a - b; }
+static inline st_soa_lane_t _st_soa_mul(st_soa_lane_t a, st_soa_lane_t b) { return a * b; }
+static inline st_soa_lane_t _st_soa_div(st_soa_lane_t a, st_soa_lane_t b) { return a / b; }
+static inline st_soa_lane_t _st_soa_sqrt(st_soa_lane_t a) { return st_sqrtf(a); }
+static inline st_soa_lane_t _st_soa_min(st_soa_lane_t a, st_soa_lane_t b) { return a < b ? a : b; }
+static inline st_soa_lane_t _st_soa_max(st_soa_lane_t a, st_soa_lane_t b) { return a > b ? a : b; }
+static inline st_soa_mask_t _st_soa_greater(st_soa_lane_t a, st_soa_lane_t b) { return a > b; }
+static inline st_soa_lane_t _st_soa_select(st_soa_mask_t m, st_soa_lane_t a, st_soa_lane_t b) { return m ? a : b; }
+static inline int _st_soa_mask_bits(st_soa_mask_t m) { return m ? 1 : 0; }
+static inline st_soa_lane_t _st_soa_iota() { return 0.0f; }
+#endif
+
+/*
+** Alignment of every SoA allocation, one cache line.
+*/
+static const size_t k_st_soa_alignment = 64;
+
+/*
+** Number of lanes touched when processing count elements a register at a time.
+*/
+static inline int _st_soa_lane_count(int count)
+{
+	return (count + k_st_soa_width - 1) & ~(k_st_soa_width - 1);
+}
@@ -0,0 +1,95 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_sphere3f.h"
+
+#include "math/st_aabb3f.h"
+#include "math/st_affine3f.h"
+#include "math/st_math.h"
+
+void st_sphere3f::make_empty()
+{
+	center = st_vec3f::zero_vector();
+	radius = -1.0f;
+}
+
+void st_sphere3f::make_from_aabb(const st_aabb3f& __restrict box)
+{
+	if (box.is_empty())
+	{
+		make_empty();
+		return;
+	}
+	center = box.get_center();
+	radius = box.get_extents().mag();
+}
+
+bool st_sphere3f::is_empty() const
+{
+	return radius < 0.0f;
+}
+
+void st_sphere3f::merge(const st_sphere3f& __restrict b)
+{
+	if (b.is_empty())
+	{
+		return;
+	}
+	if (is_empty())
+	{
+		(*this) = b;
+		return;
+	}
+
+	st_vec3f offset = b.center - center;
+	float distance = offset.mag();
+
+	// One already contains the other.
+	if (distance + b.radius <= radius)
+	{
+		return;
+	}
+	if (distance + radius <= b.radius)
+	{
+		(*this) = b;
+		return;
+	}
+
+	float new_radius = (distance + radius + b.radius) * 0.5f;
+	center += offset.scale_result((new_radius - radius) / distance);
+	radius = new_radius;
+}
+
+bool st_sphere3f::contains(const st_vec3f& __restrict point) const
+{
+	return center.dist2(point) <= radius * radius && !is_empty();
+}
+
+bool st_sphere3f::intersects(const st_sphere3f& __restrict b) const
+{
+	float radii = radius + b.radius;
+	return center.dist2(b.center) <= radii * radii && !is_empty() && !b.is_empty();
+}
+
+st_sphere3f st_sphere3f::transform(const st_affine3f& __restrict m) const
+{
+	if (is_empty())
+	{
+		return *this;
+	}
+
+	float scale2 = 0.0f;
+	for (int j = 0; j < 3; ++j)
+	{
+		st_vec3f column = { m.data[0][j], m.data[1][j], m.data[2][j] };
+		scale2 = st_max(scale2, column.mag2());
+	}
+
+	st_sphere3f result;
+	result.center = m.transform_point(center);
+	result.radius = radius * st_sqrtf(scale2);
+	return result;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math_fwd.h"
+#include "math/st_vec3f.h"
+
+/*
+** Bounding sphere. A negative radius marks an empty sphere.
+*/
+struct st_sphere3f
+{
+	st_vec3f center;
+	float radius;
+
+	/*
+	** Build an empty sphere.
+	*/
+	void make_empty();
+
+	/*
+	** Build the sphere circumscribing a box.
+	*/
+	void make_from_aabb(const st_aabb3f& __restrict box);
+
+	bool is_empty() const;
+
+	/*
+	** Grow the sphere to contain another. The result is the smallest sphere
+	** containing both.
+	*/
+	void merge(const st_sphere3f& __restrict b);
+
+	bool contains(const st_vec3f& __restrict point) const;
+	bool intersects(const st_sphere3f& __restrict b) const;
+
+	/*
+	** Get the sphere bounding this one after an affine transform, scaling the
+	** radius by the largest axis scale.
+	*/
+	st_sphere3f transform(const st_affine3f& __restrict m) const;
+};
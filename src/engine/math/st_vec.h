@@ -0,0 +1,504 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_fast_math.h"
+#include "math/st_half.h"
+#include "math/st_math.h"
+#include "math/st_math_fwd.h"
+#include "math/st_simd.h"
+
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+/*
+** Component storage for st_vec.
+**
+** Two to four component vectors also name their components x, y, z and w.
+** axes is the first member of the union so that construction activates it,
+** and the constexpr operations below only ever touch axes, as constant
+** evaluation may not read an inactive union member.
+*/
+template<int N, typename T>
+struct st_vec_data
+{
+	T axes[N];
+
+	st_vec_data() = default;
+	template<typename... Args>
+	constexpr st_vec_data(Args... args) : axes{ args... } {}
+};
+
+template<typename T>
+struct st_vec_data<2, T>
+{
+	union
+	{
+		T axes[2];
+		struct { T x, y; };
+	};
+
+	st_vec_data() = default;
+	constexpr st_vec_data(T nx, T ny) : axes{ nx, ny } {}
+};
+
+template<typename T>
+struct st_vec_data<3, T>
+{
+	union
+	{
+		T axes[3];
+		struct { T x, y, z; };
+	};
+
+	st_vec_data() = default;
+	constexpr st_vec_data(T nx, T ny, T nz) : axes{ nx, ny, nz } {}
+};
+
+template<typename T>
+struct st_vec_data<4, T>
+{
+	union
+	{
+		T axes[4];
+		struct { T x, y, z, w; };
+	};
+
+	st_vec_data() = default;
+	constexpr st_vec_data(T nx, T ny, T nz, T nw) : axes{ nx, ny, nz, nw } {}
+};
+
+/*
+** Element-wise kernels behind the st_vec operators.
+**
+** The generic kernels are plain loops. Four component float and double
+** vectors use SIMD at runtime and the loops during constant evaluation; both
+** give identical results as each lane is a single IEEE operation.
+*/
+template<int N, typename T>
+struct st_vec_kernels_scalar
+{
+	static constexpr void add(T* out, const T* a, const T* b) { for (int i = 0; i < N; ++i) out[i] = a[i] + b[i]; }
+	static constexpr void sub(T* out, const T* a, const T* b) { for (int i = 0; i < N; ++i) out[i] = a[i] - b[i]; }
+	static constexpr void mul(T* out, const T* a, const T* b) { for (int i = 0; i < N; ++i) out[i] = a[i] * b[i]; }
+	static constexpr void div(T* out, const T* a, const T* b) { for (int i = 0; i < N; ++i) out[i] = a[i] / b[i]; }
+	static constexpr void scale(T* out, const T* a, T s) { for (int i = 0; i < N; ++i) out[i] = a[i] * s; }
+};
+
+template<int N, typename T>
+struct st_vec_kernels : st_vec_kernels_scalar<N, T>
+{
+};
+
+#if defined(ST_SIMD) && defined(ST_IS_CONSTANT_EVALUATED)
+template<>
+struct st_vec_kernels<4, float>
+{
+	typedef st_vec_kernels_scalar<4, float> scalar;
+
+	static constexpr void add(float* out, const float* a, const float* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::add(out, a, b);
+		else st_simd4f_store(out, st_simd4f_add(st_simd4f_load(a), st_simd4f_load(b)));
+	}
+	static constexpr void sub(float* out, const float* a, const float* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::sub(out, a, b);
+		else st_simd4f_store(out, st_simd4f_sub(st_simd4f_load(a), st_simd4f_load(b)));
+	}
+	static constexpr void mul(float* out, const float* a, const float* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::mul(out, a, b);
+		else st_simd4f_store(out, st_simd4f_mul(st_simd4f_load(a), st_simd4f_load(b)));
+	}
+	static constexpr void div(float* out, const float* a, const float* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::div(out, a, b);
+		else st_simd4f_store(out, st_simd4f_div(st_simd4f_load(a), st_simd4f_load(b)));
+	}
+	static constexpr void scale(float* out, const float* a, float s)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::scale(out, a, s);
+		else st_simd4f_store(out, st_simd4f_mul(st_simd4f_load(a), st_simd4f_splat(s)));
+	}
+};
+
+template<>
+struct st_vec_kernels<4, double>
+{
+	typedef st_vec_kernels_scalar<4, double> scalar;
+
+	static constexpr void add(double* out, const double* a, const double* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::add(out, a, b);
+		else st_simd4d_store(out, st_simd4d_add(st_simd4d_load(a), st_simd4d_load(b)));
+	}
+	static constexpr void sub(double* out, const double* a, const double* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::sub(out, a, b);
+		else st_simd4d_store(out, st_simd4d_sub(st_simd4d_load(a), st_simd4d_load(b)));
+	}
+	static constexpr void mul(double* out, const double* a, const double* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::mul(out, a, b);
+		else st_simd4d_store(out, st_simd4d_mul(st_simd4d_load(a), st_simd4d_load(b)));
+	}
+	static constexpr void div(double* out, const double* a, const double* b)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::div(out, a, b);
+		else st_simd4d_store(out, st_simd4d_div(st_simd4d_load(a), st_simd4d_load(b)));
+	}
+	static constexpr void scale(double* out, const double* a, double s)
+	{
+		if (ST_IS_CONSTANT_EVALUATED()) scalar::scale(out, a, s);
+		else st_simd4d_store(out, st_simd4d_mul(st_simd4d_load(a), st_simd4d_splat(s)));
+	}
+};
+#endif
+
+/*
+** Tolerant comparison of vector components, see st_equalf.
+*/
+inline bool st_vec_component_equal(float a, float b) { return st_equalf(a, b); }
+inline bool st_vec_component_equal(double a, double b) { return st_equald(a, b); }
+
+/*
+** N component vector of T.
+**
+** The engine's vector names are aliases, declared in st_math_fwd.h:
+** st_vec2f/3f/4f for float, st_vec2d/3d/4d for double, and st_vec2h/3h/4h
+** for half precision storage, which only supports conversion.
+**
+** Everything that does not need a square root is constexpr.
+*/
+template<int N, typename T>
+struct st_vec : st_vec_data<N, T>
+{
+	using st_vec_data<N, T>::axes;
+
+	st_vec() = default;
+
+	/*
+	** Construct from one value per component.
+	*/
+	template<
+		typename... Args,
+		typename = typename std::enable_if<
+			sizeof...(Args) == N &&
+			std::conjunction<std::is_constructible<T, Args>...>::value>::type>
+	constexpr st_vec(Args... args) : st_vec_data<N, T>(static_cast<T>(args)...) {}
+
+	/*
+	** Construct from a vector with one fewer component and a final value,
+	** for example a position and w.
+	*/
+	template<int M = N, typename = typename std::enable_if<(M > 1)>::type>
+	constexpr st_vec(const st_vec<M - 1, T>& v, T last) : st_vec(v, last, std::make_integer_sequence<int, M - 1>()) {}
+
+	/*
+	** Convert from a vector with another component type.
+	*/
+	template<typename U>
+	explicit constexpr st_vec(const st_vec<N, U>& v) : st_vec(v, std::make_integer_sequence<int, N>()) {}
+
+	/*
+	** Build a vector with every component set to a value.
+	*/
+	static constexpr st_vec splat(T value)
+	{
+		st_vec result = {};
+		for (int i = 0; i < N; ++i) result.axes[i] = value;
+		return result;
+	}
+
+	/*
+	** Build the unit vector along an axis.
+	*/
+	static constexpr st_vec axis_vector(int axis)
+	{
+		st_vec result = splat(T(0));
+		result.axes[axis] = T(1);
+		return result;
+	}
+
+	static constexpr st_vec zero_vector() { return splat(T(0)); }
+	static constexpr st_vec one_vector() { return splat(T(1)); }
+	static constexpr st_vec x_vector() { return axis_vector(0); }
+	static constexpr st_vec y_vector() { static_assert(N > 1, "No y axis."); return axis_vector(1); }
+	static constexpr st_vec z_vector() { static_assert(N > 2, "No z axis."); return axis_vector(2); }
+	static constexpr st_vec w_vector() { static_assert(N > 3, "No w axis."); return axis_vector(3); }
+
+	/*
+	** Negate the vector in place.
+	*/
+	constexpr void negate()
+	{
+		for (int i = 0; i < N; ++i) axes[i] = -axes[i];
+	}
+
+	/*
+	** Return a negated version of the vector.
+	*/
+	constexpr st_vec operator-() const
+	{
+		st_vec result = (*this);
+		result.negate();
+		return result;
+	}
+
+	/*
+	** Add the vector by another and return the result.
+	*/
+	constexpr st_vec operator+(const st_vec& __restrict b) const
+	{
+		st_vec result = (*this);
+		st_vec_kernels<N, T>::add(result.axes, axes, b.axes);
+		return result;
+	}
+
+	/*
+	** Add the vector by another in place.
+	*/
+	constexpr st_vec& operator+=(const st_vec& __restrict b)
+	{
+		(*this) = (*this) + b;
+		return (*this);
+	}
+
+	/*
+	** Subtract the vector by another and return the result.
+	*/
+	constexpr st_vec operator-(const st_vec& __restrict b) const
+	{
+		st_vec result = (*this);
+		st_vec_kernels<N, T>::sub(result.axes, axes, b.axes);
+		return result;
+	}
+
+	/*
+	** Subtract the vector by another in place.
+	*/
+	constexpr st_vec& operator-=(const st_vec& __restrict b)
+	{
+		(*this) = (*this) - b;
+		return (*this);
+	}
+
+	/*
+	** Multiply the vector by another vector and return the result.
+	*/
+	constexpr st_vec operator*(const st_vec& __restrict b) const
+	{
+		st_vec result = (*this);
+		st_vec_kernels<N, T>::mul(result.axes, axes, b.axes);
+		return result;
+	}
+
+	/*
+	** Multiply the vector in place.
+	*/
+	constexpr st_vec& operator*=(const st_vec& __restrict b)
+	{
+		(*this) = (*this) * b;
+		return (*this);
+	}
+
+	/*
+	** Divide the vector by another vector and return the result.
+	*/
+	constexpr st_vec operator/(const st_vec& __restrict b) const
+	{
+		st_vec result = (*this);
+		st_vec_kernels<N, T>::div(result.axes, axes, b.axes);
+		return result;
+	}
+
+	/*
+	** Divide the vector in place.
+	*/
+	constexpr st_vec& operator/=(const st_vec& __restrict b)
+	{
+		(*this) = (*this) / b;
+		return (*this);
+	}
+
+	/*
+	** Equality operator.
+	*/
+	inline bool operator==(const st_vec& __restrict b) const
+	{
+		return equal(b);
+	}
+
+	/*
+	** Scale the vector in place.
+	*/
+	constexpr void scale(T s)
+	{
+		st_vec_kernels<N, T>::scale(axes, axes, s);
+	}
+
+	/*
+	** Return a vector equal to this vector scaled.
+	*/
+	constexpr st_vec scale_result(T s) const
+	{
+		st_vec result = (*this);
+		st_vec_kernels<N, T>::scale(result.axes, axes, s);
+		return result;
+	}
+
+	/*
+	** Compute the squared magnitude of the vector.
+	*/
+	constexpr T mag2() const
+	{
+		T result = T(0);
+		for (int i = 0; i < N; ++i) result += axes[i] * axes[i];
+		return result;
+	}
+
+	/*
+	** Compute the magnitude of the vector.
+	*/
+	inline T mag() const
+	{
+		return std::sqrt(mag2());
+	}
+
+	/*
+	** Compute the squared distance between this vector and another.
+	*/
+	constexpr T dist2(const st_vec& __restrict b) const
+	{
+		T result = T(0);
+		for (int i = 0; i < N; ++i)
+		{
+			T d = axes[i] - b.axes[i];
+			result += d * d;
+		}
+		return result;
+	}
+
+	/*
+	** Compute the distance between this vector and another.
+	*/
+	inline T dist(const st_vec& __restrict b) const
+	{
+		return std::sqrt(dist2(b));
+	}
+
+	/*
+	** Normalize the vector in place.
+	*/
+	inline void normalize()
+	{
+		T m = mag();
+		scale(T(1) / m);
+	}
+
+	/*
+	** Compute the normalized vector and return it.
+	*/
+	inline st_vec normal() const
+	{
+		st_vec result = (*this);
+		result.normalize();
+		return result;
+	}
+
+	/*
+	** Normalize the vector in place using st_rsqrtf_fast.
+	** Relative error below 1e-6; the vector must be non-zero.
+	** Double precision vectors use the exact path.
+	*/
+	inline void normalize_fast()
+	{
+		if constexpr (std::is_same<T, float>::value)
+		{
+			scale(st_rsqrtf_fast(mag2()));
+		}
+		else
+		{
+			normalize();
+		}
+	}
+
+	/*
+	** Compute the normalized vector using st_rsqrtf_fast and return it.
+	*/
+	inline st_vec normal_fast() const
+	{
+		st_vec result = (*this);
+		result.normalize_fast();
+		return result;
+	}
+
+	/*
+	** Compute the dot product between this vector and another.
+	*/
+	constexpr T dot(const st_vec& __restrict b) const
+	{
+		T result = T(0);
+		for (int i = 0; i < N; ++i) result += axes[i] * b.axes[i];
+		return result;
+	}
+
+	/*
+	** Determine if this vector is largely equivalent to another.
+	*/
+	inline bool equal(const st_vec& __restrict b) const
+	{
+		bool is_not_equal = false;
+		for (int i = 0; i < N; ++i) is_not_equal = is_not_equal || !st_vec_component_equal(axes[i], b.axes[i]);
+		return !is_not_equal;
+	}
+
+	/*
+	** Project this vector onto another and return the result.
+	*/
+	inline st_vec project_onto(const st_vec& __restrict b) const
+	{
+		st_vec b_norm = b.normal();
+		st_vec result = b_norm.scale_result(dot(b_norm));
+		return result;
+	}
+
+	/*
+	** Absolute value projection.
+	*/
+	inline st_vec project_onto_abs(const st_vec& __restrict b) const
+	{
+		st_vec b_norm = b.normal();
+		st_vec result = b_norm.scale_result(std::abs(dot(b_norm)));
+		return result;
+	}
+
+private:
+	template<int... I>
+	constexpr st_vec(const st_vec<N - 1, T>& v, T last, std::integer_sequence<int, I...>)
+		: st_vec_data<N, T>(v.axes[I]..., last) {}
+
+	template<typename U, int... I>
+	constexpr st_vec(const st_vec<N, U>& v, std::integer_sequence<int, I...>)
+		: st_vec_data<N, T>(static_cast<T>(v.axes[I])...) {}
+};
+
+/*
+** Compute the cross product between two vectors.
+*/
+template<typename T>
+constexpr st_vec<3, T> st_vec_cross(const st_vec<3, T>& __restrict a, const st_vec<3, T>& __restrict b)
+{
+	return
+	{
+		(a.axes[1] * b.axes[2]) - (a.axes[2] * b.axes[1]),
+		(a.axes[2] * b.axes[0]) - (a.axes[0] * b.axes[2]),
+		(a.axes[0] * b.axes[1]) - (a.axes[1] * b.axes[0]),
+	};
+}
@@ -0,0 +1,159 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_vec.tests.h"
+#include "st_half.h"
+#include "st_mat.h"
+#include "st_vec.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static_assert(sizeof(st_vec3f) == 3 * sizeof(float), "st_vec3f must pack.");
+static_assert(sizeof(st_vec4d) == 4 * sizeof(double), "st_vec4d must pack.");
+static_assert(sizeof(st_vec3h) == 3 * sizeof(uint16_t), "st_vec3h must pack.");
+static_assert(std::is_trivially_copyable<st_vec4f>::value, "Vectors must stay trivially copyable.");
+static_assert(std::is_trivially_default_constructible<st_vec3f>::value, "Vectors must stay uninitialized by default.");
+
+// Double precision keeps what float cannot: a metre at planetary radius.
+static constexpr st_vec3d k_test_planet = { 6360000.0, 0.0, 0.0 };
+static constexpr st_vec3d k_test_offset = { 0.001, 0.0, 0.0 };
+static_assert((k_test_planet + k_test_offset - k_test_planet).axes[0] == 0.0010000001639127731, "double add");
+static_assert(st_vec_cross(st_vec3d::x_vector(), st_vec3d::y_vector()).axes[2] == 1.0, "double cross");
+static_assert(st_vec4d(k_test_planet, 1.0).axes[3] == 1.0, "double extend");
+static_assert(st_vec3f(k_test_planet).axes[0] == 6360000.0f, "double to float");
+
+static constexpr st_mat4d _st_vec_test_translation(const st_vec3d& t)
+{
+	st_mat4d m = {};
+	m.make_translation(t);
+	return m;
+}
+static_assert(_st_vec_test_translation(k_test_planet).transform_point(k_test_offset).axes[0] == 6360000.001, "double transform");
+
+static st_test_random _st_vec_test_random(0x2468ace0);
+
+template<int N, typename T>
+static st_vec<N, T> _st_vec_test_random_vector()
+{
+	st_vec<N, T> v;
+	for (int i = 0; i < N; ++i)
+	{
+		v.axes[i] = T(_st_vec_test_random.next(-10.0f, 10.0f));
+	}
+	return v;
+}
+
+template<int N, typename T>
+static void _st_vec_test_kernels()
+{
+	// The SIMD kernels must match the scalar loops they replace bit for bit.
+	for (int i = 0; i < 1000; ++i)
+	{
+		st_vec<N, T> a = _st_vec_test_random_vector<N, T>();
+		st_vec<N, T> b = _st_vec_test_random_vector<N, T>();
+		T s = T(_st_vec_test_random.next(-10.0f, 10.0f));
+
+		st_vec<N, T> expected;
+		st_vec<N, T> result;
+
+		st_vec_kernels_scalar<N, T>::add(expected.axes, a.axes, b.axes);
+		result = a + b;
+		assert(memcmp(&result, &expected, sizeof(result)) == 0);
+
+		st_vec_kernels_scalar<N, T>::sub(expected.axes, a.axes, b.axes);
+		result = a - b;
+		assert(memcmp(&result, &expected, sizeof(result)) == 0);
+
+		st_vec_kernels_scalar<N, T>::mul(expected.axes, a.axes, b.axes);
+		result = a * b;
+		assert(memcmp(&result, &expected, sizeof(result)) == 0);
+
+		st_vec_kernels_scalar<N, T>::div(expected.axes, a.axes, b.axes);
+		result = a / b;
+		assert(memcmp(&result, &expected, sizeof(result)) == 0);
+
+		st_vec_kernels_scalar<N, T>::scale(expected.axes, a.axes, s);
+		result = a.scale_result(s);
+		assert(memcmp(&result, &expected, sizeof(result)) == 0);
+	}
+}
+
+void st_vec_unit_tests()
+{
+	_st_vec_test_kernels<4, float>();
+	_st_vec_test_kernels<4, double>();
+	_st_vec_test_kernels<3, float>();
+
+	// Test every half converts to float and back unchanged, NaNs aside.
+	for (uint32_t bits = 0; bits < 0x10000; ++bits)
+	{
+		float f = st_half_bits_to_float(uint16_t(bits));
+		if (std::isnan(f))
+		{
+			assert(std::isnan(float(st_half(f))));
+			continue;
+		}
+		assert(st_float_to_half_bits(f) == bits);
+	}
+
+	// Test rounding to nearest even against a double precision reference.
+	for (uint32_t bits = 0; bits < 0x7bff; ++bits)
+	{
+		double lo = st_half_bits_to_float(uint16_t(bits));
+		double hi = st_half_bits_to_float(uint16_t(bits + 1));
+		float mid = float((lo + hi) * 0.5);
+		uint16_t rounded = st_float_to_half_bits(mid);
+		assert(rounded == ((bits & 1) ? bits + 1 : bits));
+		assert(st_float_to_half_bits(std::nextafter(mid, float(lo))) == bits);
+	}
+	assert(st_float_to_half_bits(65520.0f) == 0x7c00);
+	assert(st_float_to_half_bits(-0.0f) == 0x8000);
+
+	// Test batched conversion, including the scalar tail.
+	std::vector<float> in(1003);
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		in[i] = _st_vec_test_random.next(-10.0f, 10.0f) * 1000.0f;
+	}
+	std::vector<st_half> packed(in.size());
+	std::vector<float> unpacked(in.size());
+	st_half_from_float_batch(in.data(), packed.data(), int(in.size()));
+	st_half_to_float_batch(packed.data(), unpacked.data(), int(in.size()));
+	for (size_t i = 0; i < in.size(); ++i)
+	{
+		assert(packed[i].bits == st_float_to_half_bits(in[i]));
+		assert(unpacked[i] == st_half_bits_to_float(packed[i].bits));
+	}
+
+	// Test packed vectors round trip through float.
+	st_vec3f position = { 1.5f, -2.25f, 1024.0f };
+	st_vec3h position_h(position);
+	assert(st_vec3f(position_h).axes[1] == -2.25f);
+
+	// Test the generic matrix against the float specialization.
+	st_quatf rotation;
+	rotation.make_axis_angle(st_vec3f(1.0f, 2.0f, 3.0f).normal(), 0.7f);
+	st_mat4f m;
+	m.make_rotation(rotation);
+	m.set_translation({ 4.0f, -5.0f, 6.0f });
+	st_mat4d m_d = st_mat_cast<double>(m);
+	st_mat4d identity = m_d * m_d.inverse();
+	st_mat4d expected_identity;
+	expected_identity.make_identity();
+	assert(identity.equal(expected_identity));
+
+	st_vec3f p = { 0.5f, 7.0f, -3.0f };
+	st_vec3d p_d = m_d.transform_point(st_vec3d(p));
+	assert(st_vec3f(p_d).equal(m.transform_point(p)));
+	st_mat4f m_round_trip = st_mat_cast<float>(m_d);
+	assert(memcmp(&m, &m_round_trip, sizeof(m)) == 0);
+}
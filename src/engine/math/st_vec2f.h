@@ -6,25 +6,10 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "st_vecnf.h"
+#include "math/st_vec.h"
 
 /*
 ** Two component floating point vector.
+**
+** st_vec2f is an alias of st_vec<2, float>, declared in st_math_fwd.h.
 */
-struct st_vec2f
-{
-	union
-	{
-		struct { float x, y; };
-		float axes[2];
-	};
-
-	ST_VECN_FUNCTIONS(2)
-
-	static st_vec2f zero_vector();
-	static st_vec2f one_vector();
-	static st_vec2f x_vector();
-	static st_vec2f y_vector();
-};
-
-#undef ST_VECN_FUNCTIONS
@@ -6,38 +6,18 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "math/st_vecnf.h"
+#include "math/st_vec.h"
 
 /*
 ** Three component floating point vector.
+**
+** st_vec3f is an alias of st_vec<3, float>, declared in st_math_fwd.h.
 */
-struct st_vec3f
-{
-	union
-	{
-		struct { float x, y, z; };
-		float axes[3];
-	};
-
-	ST_VECN_FUNCTIONS(3)
-
-	static st_vec3f zero_vector();
-	static st_vec3f one_vector();
-	static st_vec3f x_vector();
-	static st_vec3f y_vector();
-	static st_vec3f z_vector();
-};
-
-#undef ST_VECN_FUNCTIONS
 
 /*
 ** Compute the cross product between two vectors.
 */
-inline st_vec3f st_vec3f_cross(const st_vec3f& __restrict a, const st_vec3f& __restrict b)
+constexpr st_vec3f st_vec3f_cross(const st_vec3f& __restrict a, const st_vec3f& __restrict b)
 {
-	st_vec3f result;
-	result.x = (a.y * b.z) - (a.z * b.y);
-	result.y = (a.z * b.x) - (a.x * b.z);
-	result.z = (a.x * b.y) - (a.y * b.x);
-	return result;
+	return st_vec_cross(a, b);
 }
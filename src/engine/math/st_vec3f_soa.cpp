@@ -0,0 +1,456 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_vec3f_soa.h"
+
+#include "math/st_mat4f.h"
+#include "math/st_soa.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cstring>
+#include <new>
+
+static_assert(k_st_vec3f_soa_padding % k_st_soa_width == 0, "SoA padding must be a multiple of the lane width.");
+
+/*
+** Dot product accumulated from zero, in the same order as st_vec3f::dot.
+*/
+static inline st_soa_lane_t _st_soa_dot(
+	st_soa_lane_t ax, st_soa_lane_t ay, st_soa_lane_t az,
+	st_soa_lane_t bx, st_soa_lane_t by, st_soa_lane_t bz)
+{
+	st_soa_lane_t result = _st_soa_add(_st_soa_splat(0.0f), _st_soa_mul(ax, bx));
+	result = _st_soa_add(result, _st_soa_mul(ay, by));
+	return _st_soa_add(result, _st_soa_mul(az, bz));
+}
+
+st_vec3f_soa::st_vec3f_soa()
+{
+}
+
+st_vec3f_soa::st_vec3f_soa(int count)
+{
+	resize(count);
+}
+
+st_vec3f_soa::st_vec3f_soa(const std::vector<st_vec3f>& vectors)
+{
+	from_aos(vectors);
+}
+
+st_vec3f_soa::st_vec3f_soa(const st_vec3f_soa& other)
+{
+	(*this) = other;
+}
+
+st_vec3f_soa::st_vec3f_soa(st_vec3f_soa&& other)
+{
+	(*this) = std::move(other);
+}
+
+st_vec3f_soa::~st_vec3f_soa()
+{
+	if (_x)
+	{
+		operator delete[](_x, std::align_val_t(k_st_soa_alignment));
+	}
+}
+
+st_vec3f_soa& st_vec3f_soa::operator=(const st_vec3f_soa& other)
+{
+	if (&other != this)
+	{
+		resize(other._count);
+		if (_count > 0)
+		{
+			memcpy(_x, other._x, sizeof(float) * _count);
+			memcpy(_y, other._y, sizeof(float) * _count);
+			memcpy(_z, other._z, sizeof(float) * _count);
+		}
+	}
+	return *this;
+}
+
+st_vec3f_soa& st_vec3f_soa::operator=(st_vec3f_soa&& other)
+{
+	if (&other != this)
+	{
+		std::swap(_x, other._x);
+		std::swap(_y, other._y);
+		std::swap(_z, other._z);
+		std::swap(_count, other._count);
+		std::swap(_capacity, other._capacity);
+	}
+	return *this;
+}
+
+void st_vec3f_soa::reserve(int capacity)
+{
+	capacity = (capacity + k_st_vec3f_soa_padding - 1) & ~(k_st_vec3f_soa_padding - 1);
+	if (capacity <= _capacity)
+	{
+		return;
+	}
+
+	/* All three arrays share one allocation. */
+	float* data = static_cast<float*>(operator new[](
+		sizeof(float) * 3 * capacity,
+		std::align_val_t(k_st_soa_alignment)));
+	memset(data, 0, sizeof(float) * 3 * capacity);
+
+	if (_x)
+	{
+		memcpy(data, _x, sizeof(float) * _count);
+		memcpy(data + capacity, _y, sizeof(float) * _count);
+		memcpy(data + 2 * capacity, _z, sizeof(float) * _count);
+		operator delete[](_x, std::align_val_t(k_st_soa_alignment));
+	}
+
+	_x = data;
+	_y = data + capacity;
+	_z = data + 2 * capacity;
+	_capacity = capacity;
+}
+
+void st_vec3f_soa::resize(int count)
+{
+	assert(count >= 0);
+	reserve(count);
+	_count = count;
+}
+
+st_vec3f st_vec3f_soa::get(int index) const
+{
+	assert(index >= 0 && index < _count);
+	return { _x[index], _y[index], _z[index] };
+}
+
+void st_vec3f_soa::set(int index, const st_vec3f& v)
+{
+	assert(index >= 0 && index < _count);
+	_x[index] = v.x;
+	_y[index] = v.y;
+	_z[index] = v.z;
+}
+
+void st_vec3f_soa::from_aos(const st_vec3f* vectors, int count)
+{
+	resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		_x[i] = vectors[i].x;
+		_y[i] = vectors[i].y;
+		_z[i] = vectors[i].z;
+	}
+}
+
+void st_vec3f_soa::from_aos(const std::vector<st_vec3f>& vectors)
+{
+	from_aos(vectors.data(), int(vectors.size()));
+}
+
+void st_vec3f_soa::to_aos(st_vec3f* vectors) const
+{
+	for (int i = 0; i < _count; ++i)
+	{
+		vectors[i] = { _x[i], _y[i], _z[i] };
+	}
+}
+
+void st_vec3f_soa::to_aos(std::vector<st_vec3f>& vectors) const
+{
+	vectors.resize(_count);
+	to_aos(vectors.data());
+}
+
+void st_vec3f_soa_dot(const st_vec3f_soa& a, const st_vec3f_soa& b, float* out)
+{
+	assert(a.size() == b.size());
+
+	const float* ax = a.get_x();
+	const float* ay = a.get_y();
+	const float* az = a.get_z();
+	const float* bx = b.get_x();
+	const float* by = b.get_y();
+	const float* bz = b.get_z();
+
+	/* The output is not padded, so the last partial register is done one at a time. */
+	int count = a.size();
+	int i = 0;
+	for (; i + k_st_soa_width <= count; i += k_st_soa_width)
+	{
+		_st_soa_storeu(out + i, _st_soa_dot(
+			_st_soa_load(ax + i), _st_soa_load(ay + i), _st_soa_load(az + i),
+			_st_soa_load(bx + i), _st_soa_load(by + i), _st_soa_load(bz + i)));
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = a.get(i).dot(b.get(i));
+	}
+}
+
+void st_vec3f_soa_dot(const st_vec3f_soa& a, const st_vec3f& b, float* out)
+{
+	const float* ax = a.get_x();
+	const float* ay = a.get_y();
+	const float* az = a.get_z();
+	st_soa_lane_t bx = _st_soa_splat(b.x);
+	st_soa_lane_t by = _st_soa_splat(b.y);
+	st_soa_lane_t bz = _st_soa_splat(b.z);
+
+	int count = a.size();
+	int i = 0;
+	for (; i + k_st_soa_width <= count; i += k_st_soa_width)
+	{
+		_st_soa_storeu(out + i, _st_soa_dot(
+			_st_soa_load(ax + i), _st_soa_load(ay + i), _st_soa_load(az + i),
+			bx, by, bz));
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = a.get(i).dot(b);
+	}
+}
+
+void st_vec3f_soa_cross(const st_vec3f_soa& a, const st_vec3f_soa& b, st_vec3f_soa& out)
+{
+	assert(a.size() == b.size());
+	out.resize(a.size());
+
+	const float* ax = a.get_x();
+	const float* ay = a.get_y();
+	const float* az = a.get_z();
+	const float* bx = b.get_x();
+	const float* by = b.get_y();
+	const float* bz = b.get_z();
+	float* ox = out.get_x();
+	float* oy = out.get_y();
+	float* oz = out.get_z();
+
+	int count = _st_soa_lane_count(a.size());
+	for (int i = 0; i < count; i += k_st_soa_width)
+	{
+		st_soa_lane_t x0 = _st_soa_load(ax + i);
+		st_soa_lane_t y0 = _st_soa_load(ay + i);
+		st_soa_lane_t z0 = _st_soa_load(az + i);
+		st_soa_lane_t x1 = _st_soa_load(bx + i);
+		st_soa_lane_t y1 = _st_soa_load(by + i);
+		st_soa_lane_t z1 = _st_soa_load(bz + i);
+		_st_soa_store(ox + i, _st_soa_sub(_st_soa_mul(y0, z1), _st_soa_mul(z0, y1)));
+		_st_soa_store(oy + i, _st_soa_sub(_st_soa_mul(z0, x1), _st_soa_mul(x0, z1)));
+		_st_soa_store(oz + i, _st_soa_sub(_st_soa_mul(x0, y1), _st_soa_mul(y0, x1)));
+	}
+}
+
+void st_vec3f_soa_lerp(const st_vec3f_soa& a, const st_vec3f_soa& b, float t, st_vec3f_soa& out)
+{
+	assert(a.size() == b.size());
+	out.resize(a.size());
+
+	const float* a_components[3] = { a.get_x(), a.get_y(), a.get_z() };
+	const float* b_components[3] = { b.get_x(), b.get_y(), b.get_z() };
+	float* out_components[3] = { out.get_x(), out.get_y(), out.get_z() };
+	st_soa_lane_t weight_a = _st_soa_splat(1.0f - t);
+	st_soa_lane_t weight_b = _st_soa_splat(t);
+
+	int count = _st_soa_lane_count(a.size());
+	for (int c = 0; c < 3; ++c)
+	{
+		for (int i = 0; i < count; i += k_st_soa_width)
+		{
+			_st_soa_store(out_components[c] + i, _st_soa_add(
+				_st_soa_mul(_st_soa_load(a_components[c] + i), weight_a),
+				_st_soa_mul(_st_soa_load(b_components[c] + i), weight_b)));
+		}
+	}
+}
+
+void st_vec3f_soa_normalize(st_vec3f_soa& v)
+{
+	float* x = v.get_x();
+	float* y = v.get_y();
+	float* z = v.get_z();
+	st_soa_lane_t one = _st_soa_splat(1.0f);
+
+	int count = _st_soa_lane_count(v.size());
+	for (int i = 0; i < count; i += k_st_soa_width)
+	{
+		st_soa_lane_t vx = _st_soa_load(x + i);
+		st_soa_lane_t vy = _st_soa_load(y + i);
+		st_soa_lane_t vz = _st_soa_load(z + i);
+
+		/* Scale by the reciprocal of the magnitude, like st_vec3f::normalize. */
+		st_soa_lane_t scale = _st_soa_div(one, _st_soa_sqrt(_st_soa_dot(vx, vy, vz, vx, vy, vz)));
+		_st_soa_store(x + i, _st_soa_mul(vx, scale));
+		_st_soa_store(y + i, _st_soa_mul(vy, scale));
+		_st_soa_store(z + i, _st_soa_mul(vz, scale));
+	}
+}
+
+static void _st_vec3f_soa_transform(const st_mat4f& m, const st_vec3f_soa& in, st_vec3f_soa& out, bool is_point)
+{
+	out.resize(in.size());
+
+	const float* ix = in.get_x();
+	const float* iy = in.get_y();
+	const float* iz = in.get_z();
+	float* ox = out.get_x();
+	float* oy = out.get_y();
+	float* oz = out.get_z();
+
+	st_soa_lane_t d[3][4];
+	for (int r = 0; r < 3; ++r)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			d[r][c] = _st_soa_splat(m.data[r][c]);
+		}
+	}
+	st_soa_lane_t w = _st_soa_splat(is_point ? 1.0f : 0.0f);
+
+	int count = _st_soa_lane_count(in.size());
+	for (int i = 0; i < count; i += k_st_soa_width)
+	{
+		st_soa_lane_t x = _st_soa_load(ix + i);
+		st_soa_lane_t y = _st_soa_load(iy + i);
+		st_soa_lane_t z = _st_soa_load(iz + i);
+
+		st_soa_lane_t result[3];
+		for (int r = 0; r < 3; ++r)
+		{
+			result[r] = _st_soa_mul(x, d[r][0]);
+			result[r] = _st_soa_add(result[r], _st_soa_mul(y, d[r][1]));
+			result[r] = _st_soa_add(result[r], _st_soa_mul(z, d[r][2]));
+			result[r] = _st_soa_add(result[r], _st_soa_mul(w, d[r][3]));
+		}
+
+		_st_soa_store(ox + i, result[0]);
+		_st_soa_store(oy + i, result[1]);
+		_st_soa_store(oz + i, result[2]);
+	}
+}
+
+void st_vec3f_soa_transform_points(const st_mat4f& m, const st_vec3f_soa& in, st_vec3f_soa& out)
+{
+	_st_vec3f_soa_transform(m, in, out, true);
+}
+
+void st_vec3f_soa_transform_vectors(const st_mat4f& m, const st_vec3f_soa& in, st_vec3f_soa& out)
+{
+	_st_vec3f_soa_transform(m, in, out, false);
+}
+
+template<bool k_is_min>
+static st_vec3f _st_vec3f_soa_reduce(const st_vec3f_soa& v)
+{
+	const float k_initial = k_is_min ? FLT_MAX : -FLT_MAX;
+	const float* components[3] = { v.get_x(), v.get_y(), v.get_z() };
+	int count = v.size();
+
+	st_vec3f result;
+	for (int c = 0; c < 3; ++c)
+	{
+		const float* p = components[c];
+
+		st_soa_lane_t lanes = _st_soa_splat(k_initial);
+		int i = 0;
+		for (; i + k_st_soa_width <= count; i += k_st_soa_width)
+		{
+			lanes = k_is_min ? _st_soa_min(lanes, _st_soa_load(p + i)) : _st_soa_max(lanes, _st_soa_load(p + i));
+		}
+
+		float lane_values[k_st_soa_width];
+		_st_soa_storeu(lane_values, lanes);
+
+		float value = k_initial;
+		for (int l = 0; l < k_st_soa_width; ++l)
+		{
+			value = k_is_min ? st_min(value, lane_values[l]) : st_max(value, lane_values[l]);
+		}
+		for (; i < count; ++i)
+		{
+			value = k_is_min ? st_min(value, p[i]) : st_max(value, p[i]);
+		}
+
+		result.axes[c] = value;
+	}
+	return result;
+}
+
+st_vec3f st_vec3f_soa_min(const st_vec3f_soa& v)
+{
+	return _st_vec3f_soa_reduce<true>(v);
+}
+
+st_vec3f st_vec3f_soa_max(const st_vec3f_soa& v)
+{
+	return _st_vec3f_soa_reduce<false>(v);
+}
+
+int st_vec3f_soa_farthest(const st_vec3f_soa& v, const st_vec3f& direction)
+{
+	/* Indices are tracked in float lanes, which are exact up to 2^24. */
+	assert(v.size() < (1 << 24));
+
+	const float* x = v.get_x();
+	const float* y = v.get_y();
+	const float* z = v.get_z();
+	st_soa_lane_t dx = _st_soa_splat(direction.x);
+	st_soa_lane_t dy = _st_soa_splat(direction.y);
+	st_soa_lane_t dz = _st_soa_splat(direction.z);
+
+	/* Each lane keeps the first index with its greatest projection. */
+	st_soa_lane_t best = _st_soa_splat(-FLT_MAX);
+	st_soa_lane_t best_index = _st_soa_splat(-1.0f);
+	st_soa_lane_t index = _st_soa_iota();
+	st_soa_lane_t step = _st_soa_splat(float(k_st_soa_width));
+
+	int count = v.size();
+	int i = 0;
+	for (; i + k_st_soa_width <= count; i += k_st_soa_width)
+	{
+		st_soa_lane_t d = _st_soa_dot(_st_soa_load(x + i), _st_soa_load(y + i), _st_soa_load(z + i), dx, dy, dz);
+		st_soa_mask_t is_greater = _st_soa_greater(d, best);
+		best = _st_soa_select(is_greater, d, best);
+		best_index = _st_soa_select(is_greater, index, best_index);
+		index = _st_soa_add(index, step);
+	}
+
+	float lane_best[k_st_soa_width];
+	float lane_index[k_st_soa_width];
+	_st_soa_storeu(lane_best, best);
+	_st_soa_storeu(lane_index, best_index);
+
+	float max_dot = -FLT_MAX;
+	int result = -1;
+	for (int l = 0; l < k_st_soa_width; ++l)
+	{
+		int lane_result = int(lane_index[l]);
+		if (lane_result < 0)
+		{
+			continue;
+		}
+		if (lane_best[l] > max_dot || (lane_best[l] == max_dot && lane_result < result))
+		{
+			max_dot = lane_best[l];
+			result = lane_result;
+		}
+	}
+
+	for (; i < count; ++i)
+	{
+		float d = v.get(i).dot(direction);
+		if (d > max_dot)
+		{
+			max_dot = d;
+			result = i;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_math_fwd.h"
+#include "math/st_vec3f.h"
+
+#include <vector>
+
+/*
+** Each component array is padded to a multiple of this many lanes, which
+** covers the widest SIMD register the kernels may use.
+*/
+const int k_st_vec3f_soa_padding = 16;
+
+/*
+** Three component vectors stored as separate x, y and z arrays.
+**
+** The arrays are cache line aligned and padded to k_st_vec3f_soa_padding so
+** that kernels can always operate on whole registers. Lanes past size() are
+** padding and hold unspecified values.
+*/
+class st_vec3f_soa
+{
+public:
+	st_vec3f_soa();
+	explicit st_vec3f_soa(int count);
+	explicit st_vec3f_soa(const std::vector<st_vec3f>& vectors);
+	st_vec3f_soa(const st_vec3f_soa& other);
+	st_vec3f_soa(st_vec3f_soa&& other);
+	~st_vec3f_soa();
+
+	st_vec3f_soa& operator=(const st_vec3f_soa& other);
+	st_vec3f_soa& operator=(st_vec3f_soa&& other);
+
+	/*
+	** Change the number of vectors, preserving existing values.
+	*/
+	void resize(int count);
+	int size() const { return _count; }
+
+	st_vec3f get(int index) const;
+	void set(int index, const st_vec3f& v);
+
+	/*
+	** Convert from and to the array of structures layout.
+	*/
+	void from_aos(const st_vec3f* vectors, int count);
+	void from_aos(const std::vector<st_vec3f>& vectors);
+	void to_aos(st_vec3f* vectors) const;
+	void to_aos(std::vector<st_vec3f>& vectors) const;
+
+	float* get_x() { return _x; }
+	float* get_y() { return _y; }
+	float* get_z() { return _z; }
+	const float* get_x() const { return _x; }
+	const float* get_y() const { return _y; }
+	const float* get_z() const { return _z; }
+
+private:
+	void reserve(int capacity);
+
+	float* _x = nullptr;
+	float* _y = nullptr;
+	float* _z = nullptr;
+	int _count = 0;
+	int _capacity = 0;
+};
+
+/*
+** Batched kernels over st_vec3f_soa.
+**
+** Each produces the same result per element as the equivalent st_vec3f or
+** st_mat4f operation. Outputs of type st_vec3f_soa are resized to match the
+** input and may alias it.
+*/
+
+/*
+** Dot product of each pair of vectors, written to out[0..a.size()).
+*/
+void st_vec3f_soa_dot(const st_vec3f_soa& a, const st_vec3f_soa& b, float* out);
+
+/*
+** Dot product of each vector with a single vector, written to out[0..a.size()).
+*/
+void st_vec3f_soa_dot(const st_vec3f_soa& a, const st_vec3f& b, float* out);
+
+/*
+** Cross product of each pair of vectors.
+*/
+void st_vec3f_soa_cross(const st_vec3f_soa& a, const st_vec3f_soa& b, st_vec3f_soa& out);
+
+/*
+** Linear interpolation of each pair, as a.scale_result(1 - t) + b.scale_result(t).
+*/
+void st_vec3f_soa_lerp(const st_vec3f_soa& a, const st_vec3f_soa& b, float t, st_vec3f_soa& out);
+
+/*
+** Normalize each vector in place.
+*/
+void st_vec3f_soa_normalize(st_vec3f_soa& v);
+
+/*
+** Transform each vector by a matrix, as points or ignoring translation.
+*/
+void st_vec3f_soa_transform_points(const st_mat4f& m, const st_vec3f_soa& in, st_vec3f_soa& out);
+void st_vec3f_soa_transform_vectors(const st_mat4f& m, const st_vec3f_soa& in, st_vec3f_soa& out);
+
+/*
+** Componentwise minimum and maximum over all vectors.
+** An empty array returns FLT_MAX and -FLT_MAX respectively.
+*/
+st_vec3f st_vec3f_soa_min(const st_vec3f_soa& v);
+st_vec3f st_vec3f_soa_max(const st_vec3f_soa& v);
+
+/*
+** Index of the first vector farthest along the given direction, or -1 if
+** there is none.
+*/
+int st_vec3f_soa_farthest(const st_vec3f_soa& v, const st_vec3f& direction);
@@ -0,0 +1,163 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_vec3f_soa.tests.h"
+#include "st_vec3f_soa.h"
+
+#include "st_mat4f.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cfloat>
+#include <cstring>
+
+static st_test_random _st_vec3f_soa_test_random(0x9e3779b9);
+
+static std::vector<st_vec3f> _st_vec3f_soa_test_random_vectors(int count)
+{
+	std::vector<st_vec3f> vectors(count);
+	for (int i = 0; i < count; ++i)
+	{
+		vectors[i] = { _st_vec3f_soa_test_random.next(-10.0f, 10.0f), _st_vec3f_soa_test_random.next(-10.0f, 10.0f), _st_vec3f_soa_test_random.next(-10.0f, 10.0f) };
+	}
+	return vectors;
+}
+
+static bool _st_vec3f_soa_test_bitwise_equal(const st_vec3f& a, const st_vec3f& b)
+{
+	return memcmp(&a, &b, sizeof(st_vec3f)) == 0;
+}
+
+void st_vec3f_soa_unit_tests()
+{
+	// Odd sizes exercise the partial register at the end of each array.
+	const int k_counts[] = { 0, 1, 3, 8, 17, 100 };
+
+	for (int count : k_counts)
+	{
+		std::vector<st_vec3f> a = _st_vec3f_soa_test_random_vectors(count);
+		std::vector<st_vec3f> b = _st_vec3f_soa_test_random_vectors(count);
+		st_vec3f_soa soa_a(a);
+		st_vec3f_soa soa_b(b);
+
+		// Test conversion round trip.
+		{
+			std::vector<st_vec3f> round_trip;
+			soa_a.to_aos(round_trip);
+			assert(int(round_trip.size()) == count);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_vec3f_soa_test_bitwise_equal(round_trip[i], a[i]));
+			}
+		}
+
+		// Test dot products.
+		{
+			std::vector<float> dots(count + 1, 0.0f);
+			st_vec3f_soa_dot(soa_a, soa_b, dots.data());
+			for (int i = 0; i < count; ++i)
+			{
+				assert(dots[i] == a[i].dot(b[i]));
+			}
+			assert(dots[count] == 0.0f);
+
+			st_vec3f direction = { 0.25f, -1.0f, 2.0f };
+			st_vec3f_soa_dot(soa_a, direction, dots.data());
+			for (int i = 0; i < count; ++i)
+			{
+				assert(dots[i] == a[i].dot(direction));
+			}
+		}
+
+		// Test cross products.
+		{
+			st_vec3f_soa cross;
+			st_vec3f_soa_cross(soa_a, soa_b, cross);
+			assert(cross.size() == count);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_vec3f_soa_test_bitwise_equal(cross.get(i), st_vec3f_cross(a[i], b[i])));
+			}
+		}
+
+		// Test normalization in place.
+		{
+			st_vec3f_soa normals = soa_a;
+			st_vec3f_soa_normalize(normals);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_vec3f_soa_test_bitwise_equal(normals.get(i), a[i].normal()));
+			}
+		}
+
+		// Test transforms, writing over the input.
+		{
+			st_mat4f m;
+			for (int r = 0; r < 4; ++r)
+			{
+				for (int c = 0; c < 4; ++c)
+				{
+					m.data[r][c] = _st_vec3f_soa_test_random.next(-10.0f, 10.0f);
+				}
+			}
+
+			st_vec3f_soa points = soa_a;
+			st_vec3f_soa_transform_points(m, points, points);
+			st_vec3f_soa vectors;
+			st_vec3f_soa_transform_vectors(m, soa_a, vectors);
+			for (int i = 0; i < count; ++i)
+			{
+				assert(_st_vec3f_soa_test_bitwise_equal(points.get(i), m.transform_point(a[i])));
+				assert(_st_vec3f_soa_test_bitwise_equal(vectors.get(i), m.transform_vector(a[i])));
+			}
+		}
+
+		// Test reductions.
+		{
+			st_vec3f min = { FLT_MAX, FLT_MAX, FLT_MAX };
+			st_vec3f max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (int i = 0; i < count; ++i)
+			{
+				for (int c = 0; c < 3; ++c)
+				{
+					min.axes[c] = st_min(min.axes[c], a[i].axes[c]);
+					max.axes[c] = st_max(max.axes[c], a[i].axes[c]);
+				}
+			}
+			assert(_st_vec3f_soa_test_bitwise_equal(st_vec3f_soa_min(soa_a), min));
+			assert(_st_vec3f_soa_test_bitwise_equal(st_vec3f_soa_max(soa_a), max));
+		}
+
+		// Test farthest point, matching the first of any ties.
+		{
+			st_vec3f direction = { 1.0f, 0.5f, -0.25f };
+			int expected = -1;
+			float max_dot = -FLT_MAX;
+			for (int i = 0; i < count; ++i)
+			{
+				if (a[i].dot(direction) > max_dot)
+				{
+					max_dot = a[i].dot(direction);
+					expected = i;
+				}
+			}
+			assert(st_vec3f_soa_farthest(soa_a, direction) == expected);
+
+			if (count > 2)
+			{
+				st_vec3f_soa ties = soa_a;
+				for (int i = 0; i < count; ++i)
+				{
+					ties.set(i, { 0.0f, 0.0f, 0.0f });
+				}
+				ties.set(count - 1, direction);
+				ties.set(1, direction);
+				assert(st_vec3f_soa_farthest(ties, direction) == 1);
+			}
+		}
+	}
+}
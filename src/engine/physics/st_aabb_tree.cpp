@@ -0,0 +1,351 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_aabb_tree.h"
+
+#include "math/st_math.h"
+
+#include <cfloat>
+
+st_aabb_tree::st_aabb_tree()
+{
+}
+
+int32_t st_aabb_tree::insert(const st_aabb3f& bounds, int32_t user_index)
+{
+	int32_t leaf = allocate_node();
+	_nodes[leaf]._bounds = bounds;
+	_nodes[leaf]._user_index = user_index;
+	_nodes[leaf]._height = 0;
+
+	insert_leaf(leaf);
+	return leaf;
+}
+
+void st_aabb_tree::remove(int32_t leaf)
+{
+	assert(_nodes[leaf].is_leaf());
+
+	remove_leaf(leaf);
+	free_node(leaf);
+}
+
+void st_aabb_tree::update(int32_t leaf, const st_aabb3f& bounds)
+{
+	assert(_nodes[leaf].is_leaf());
+
+	remove_leaf(leaf);
+	_nodes[leaf]._bounds = bounds;
+	insert_leaf(leaf);
+}
+
+int32_t st_aabb_tree::allocate_node()
+{
+	if (_free_list == k_null_node)
+	{
+		_nodes.emplace_back();
+		return int32_t(_nodes.size() - 1);
+	}
+
+	int32_t node = _free_list;
+	_free_list = _nodes[node]._parent;
+	_nodes[node] = st_aabb_tree_node();
+	return node;
+}
+
+void st_aabb_tree::free_node(int32_t node)
+{
+	_nodes[node]._parent = _free_list;
+	_nodes[node]._height = -1;
+	_free_list = node;
+}
+
+int32_t st_aabb_tree::find_best_sibling(const st_aabb3f& bounds) const
+{
+	st_vec3f center = bounds.get_center();
+	float area = bounds.get_surface_area();
+
+	// Pairing with a node costs the area of the new parent, plus the growth of every node above it.
+	int32_t index = _root;
+	float node_area = _nodes[index]._bounds.get_surface_area();
+	st_aabb3f combined = _nodes[index]._bounds;
+	combined.merge(bounds);
+	float direct_cost = combined.get_surface_area();
+	float inherited_cost = 0.0f;
+
+	int32_t best_sibling = index;
+	float best_cost = direct_cost;
+
+	while (!_nodes[index].is_leaf())
+	{
+		const st_aabb_tree_node& node = _nodes[index];
+
+		float cost = direct_cost + inherited_cost;
+		if (cost < best_cost)
+		{
+			best_sibling = index;
+			best_cost = cost;
+		}
+
+		inherited_cost += direct_cost - node_area;
+
+		// A leaf child is costed exactly; an internal one gets a lower bound for everything beneath it.
+		float lower_costs[2];
+		float child_direct_costs[2];
+		float child_areas[2];
+		bool child_is_leaf[2];
+		for (int c = 0; c < 2; ++c)
+		{
+			const st_aabb_tree_node& child = _nodes[node._children[c]];
+			st_aabb3f child_combined = child._bounds;
+			child_combined.merge(bounds);
+			child_direct_costs[c] = child_combined.get_surface_area();
+			child_areas[c] = child._bounds.get_surface_area();
+			child_is_leaf[c] = child.is_leaf();
+
+			if (child_is_leaf[c])
+			{
+				float child_cost = child_direct_costs[c] + inherited_cost;
+				if (child_cost < best_cost)
+				{
+					best_sibling = node._children[c];
+					best_cost = child_cost;
+				}
+				lower_costs[c] = FLT_MAX;
+			}
+			else
+			{
+				lower_costs[c] = inherited_cost + child_direct_costs[c] + st_min(area - child_areas[c], 0.0f);
+			}
+		}
+
+		if (child_is_leaf[0] && child_is_leaf[1])
+		{
+			break;
+		}
+
+		if (best_cost <= lower_costs[0] && best_cost <= lower_costs[1])
+		{
+			break;
+		}
+
+		if (lower_costs[0] == lower_costs[1] && !child_is_leaf[0])
+		{
+			// Both children contain the box; head for the nearer one.
+			lower_costs[0] = (_nodes[node._children[0]]._bounds.get_center() - center).mag2();
+			lower_costs[1] = (_nodes[node._children[1]]._bounds.get_center() - center).mag2();
+		}
+
+		int c = lower_costs[0] < lower_costs[1] && !child_is_leaf[0] ? 0 : 1;
+		index = node._children[c];
+		node_area = child_areas[c];
+		direct_cost = child_direct_costs[c];
+	}
+
+	return best_sibling;
+}
+
+void st_aabb_tree::insert_leaf(int32_t leaf)
+{
+	if (_root == k_null_node)
+	{
+		_root = leaf;
+		_nodes[leaf]._parent = k_null_node;
+		return;
+	}
+
+	int32_t sibling = find_best_sibling(_nodes[leaf]._bounds);
+	int32_t old_parent = _nodes[sibling]._parent;
+
+	// Allocating may grow the node array, so take no references across it.
+	int32_t new_parent = allocate_node();
+	st_aabb_tree_node& parent = _nodes[new_parent];
+	parent._parent = old_parent;
+	parent._bounds = _nodes[leaf]._bounds;
+	parent._bounds.merge(_nodes[sibling]._bounds);
+	parent._height = _nodes[sibling]._height + 1;
+	parent._children[0] = sibling;
+	parent._children[1] = leaf;
+	_nodes[sibling]._parent = new_parent;
+	_nodes[leaf]._parent = new_parent;
+
+	if (old_parent == k_null_node)
+	{
+		_root = new_parent;
+	}
+	else
+	{
+		int c = _nodes[old_parent]._children[0] == sibling ? 0 : 1;
+		_nodes[old_parent]._children[c] = new_parent;
+	}
+
+	refit(new_parent, true);
+}
+
+void st_aabb_tree::remove_leaf(int32_t leaf)
+{
+	if (leaf == _root)
+	{
+		_root = k_null_node;
+		return;
+	}
+
+	int32_t parent = _nodes[leaf]._parent;
+	int32_t grandparent = _nodes[parent]._parent;
+	int32_t sibling = _nodes[parent]._children[0] == leaf ? _nodes[parent]._children[1] : _nodes[parent]._children[0];
+
+	// The sibling takes the place of the parent.
+	_nodes[sibling]._parent = grandparent;
+	free_node(parent);
+
+	if (grandparent == k_null_node)
+	{
+		_root = sibling;
+	}
+	else
+	{
+		int c = _nodes[grandparent]._children[0] == parent ? 0 : 1;
+		_nodes[grandparent]._children[c] = sibling;
+		refit(grandparent, false);
+	}
+}
+
+void st_aabb_tree::refit(int32_t node, bool should_rotate)
+{
+	for (int32_t index = node; index != k_null_node; index = _nodes[index]._parent)
+	{
+		st_aabb_tree_node& n = _nodes[index];
+		const st_aabb_tree_node& a = _nodes[n._children[0]];
+		const st_aabb_tree_node& b = _nodes[n._children[1]];
+		n._bounds = a._bounds;
+		n._bounds.merge(b._bounds);
+		n._height = 1 + st_max(a._height, b._height);
+
+		if (should_rotate)
+		{
+			rotate(index);
+		}
+	}
+}
+
+void st_aabb_tree::swap_grandchild(int32_t node, int child, int grandchild)
+{
+	/*
+	** Swap the child on the other side of node with a child of the given child.
+	** Only the given child's bounds change, so nothing above node is touched.
+	*/
+	st_aabb_tree_node& n = _nodes[node];
+	int32_t low_index = n._children[child];
+	int32_t high_index = n._children[1 - child];
+	st_aabb_tree_node& low = _nodes[low_index];
+	int32_t moved_index = low._children[grandchild];
+	int32_t kept_index = low._children[1 - grandchild];
+
+	n._children[1 - child] = moved_index;
+	low._children[grandchild] = high_index;
+	_nodes[moved_index]._parent = node;
+	_nodes[high_index]._parent = low_index;
+
+	const st_aabb_tree_node& kept = _nodes[kept_index];
+	const st_aabb_tree_node& high = _nodes[high_index];
+	low._bounds = kept._bounds;
+	low._bounds.merge(high._bounds);
+	low._height = 1 + st_max(kept._height, high._height);
+	n._height = 1 + st_max(low._height, _nodes[moved_index]._height);
+}
+
+void st_aabb_tree::rotate(int32_t node)
+{
+	const st_aabb_tree_node& n = _nodes[node];
+	if (n._height < 2)
+	{
+		return;
+	}
+
+	/*
+	** Try swapping each child with each grandchild on the other side, and keep
+	** whichever swap most reduces the area of the two children.
+	*/
+	float child_areas[2];
+	for (int c = 0; c < 2; ++c)
+	{
+		child_areas[c] = _nodes[n._children[c]]._bounds.get_surface_area();
+	}
+
+	float best_cost = child_areas[0] + child_areas[1];
+	int best_child = -1;
+	int best_grandchild = -1;
+	for (int c = 0; c < 2; ++c)
+	{
+		const st_aabb_tree_node& low = _nodes[n._children[c]];
+		if (low.is_leaf())
+		{
+			continue;
+		}
+
+		const st_aabb_tree_node& high = _nodes[n._children[1 - c]];
+		for (int g = 0; g < 2; ++g)
+		{
+			// The grandchild moves up and the other child takes its place beside the remaining one.
+			st_aabb3f swapped = _nodes[low._children[1 - g]]._bounds;
+			swapped.merge(high._bounds);
+			float cost = child_areas[1 - c] + swapped.get_surface_area();
+			if (cost < best_cost)
+			{
+				best_cost = cost;
+				best_child = c;
+				best_grandchild = g;
+			}
+		}
+	}
+
+	if (best_child >= 0)
+	{
+		swap_grandchild(node, best_child, best_grandchild);
+	}
+}
+
+void st_aabb_tree::validate() const
+{
+	if (_root != k_null_node)
+	{
+		assert(_nodes[_root]._parent == k_null_node);
+		validate_node(_root);
+	}
+
+	int free_count = 0;
+	for (int32_t node = _free_list; node != k_null_node; node = _nodes[node]._parent)
+	{
+		assert(_nodes[node]._height == -1);
+		++free_count;
+	}
+
+	int used_count = 0;
+	for (const st_aabb_tree_node& node : _nodes)
+	{
+		used_count += node._height >= 0 ? 1 : 0;
+	}
+	assert(used_count + free_count == int(_nodes.size()));
+}
+
+void st_aabb_tree::validate_node(int32_t node) const
+{
+	const st_aabb_tree_node& n = _nodes[node];
+	if (n.is_leaf())
+	{
+		assert(n._height == 0);
+		return;
+	}
+
+	const st_aabb_tree_node& a = _nodes[n._children[0]];
+	const st_aabb_tree_node& b = _nodes[n._children[1]];
+	assert(a._parent == node && b._parent == node);
+	assert(n._height == 1 + st_max(a._height, b._height));
+	assert(n._bounds.contains(a._bounds) && n._bounds.contains(b._bounds));
+
+	validate_node(n._children[0]);
+	validate_node(n._children[1]);
+}
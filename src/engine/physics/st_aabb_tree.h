@@ -0,0 +1,144 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_aabb3f.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/*
+** A node of the tree. Leaves hold the boxes inserted by the user; internal
+** nodes always have two children and bound both of them.
+*/
+struct st_aabb_tree_node
+{
+	st_aabb3f _bounds;
+
+	int32_t _user_index = -1;
+
+	// The parent of a node in the tree, or the next node on the free list.
+	int32_t _parent = -1;
+	int32_t _children[2] = { -1, -1 };
+
+	// Zero for leaves, -1 for nodes on the free list.
+	int32_t _height = -1;
+
+	bool is_leaf() const { return _children[0] == -1; }
+};
+
+/*
+** A bounding volume hierarchy that supports insertion, removal and update of
+** single boxes, as used by the broadphase.
+**
+** New leaves pair with the sibling that least increases the total surface
+** area of the tree, found by branch and bound, and the nodes above them swap
+** children with grandchildren where that shrinks the area further. This keeps
+** the tree close to one built from scratch as boxes come and go.
+*/
+class st_aabb_tree
+{
+public:
+	static const int32_t k_null_node = -1;
+
+	st_aabb_tree();
+
+	/*
+	** Add a box to the tree.
+	** @param user_index A value returned with the leaf from queries.
+	** @returns The leaf holding the box.
+	*/
+	int32_t insert(const st_aabb3f& bounds, int32_t user_index);
+
+	void remove(int32_t leaf);
+
+	/*
+	** Replace the box held by a leaf, moving it in the tree.
+	*/
+	void update(int32_t leaf, const st_aabb3f& bounds);
+
+	const st_aabb3f& get_bounds(int32_t leaf) const { return _nodes[leaf]._bounds; }
+	int32_t get_user_index(int32_t leaf) const { return _nodes[leaf]._user_index; }
+
+	int32_t get_height() const { return _root == k_null_node ? 0 : _nodes[_root]._height; }
+
+	/*
+	** Call callback(leaf) for every leaf whose box overlaps bounds.
+	** Safe to call from several threads while the tree is not being modified.
+	*/
+	template<typename T>
+	void query(const st_aabb3f& bounds, const T& callback) const;
+
+	/*
+	** Check the structure of the tree with asserts.
+	*/
+	void validate() const;
+
+private:
+	// Far deeper than the surface area heuristic builds in practice.
+	static const int k_max_query_depth = 256;
+
+	int32_t allocate_node();
+	void free_node(int32_t node);
+
+	int32_t find_best_sibling(const st_aabb3f& bounds) const;
+
+	void insert_leaf(int32_t leaf);
+	void remove_leaf(int32_t leaf);
+
+	/*
+	** Refit bounds and heights from a node up to the root, optionally rotating on the way.
+	*/
+	void refit(int32_t node, bool should_rotate);
+
+	/*
+	** Swap a child of a node with a grandchild under the other child, if that
+	** reduces the surface area of the node's children.
+	*/
+	void rotate(int32_t node);
+	void swap_grandchild(int32_t node, int child, int grandchild);
+
+	void validate_node(int32_t node) const;
+
+	std::vector<st_aabb_tree_node> _nodes;
+	int32_t _root = k_null_node;
+	int32_t _free_list = k_null_node;
+};
+
+template<typename T>
+void st_aabb_tree::query(const st_aabb3f& bounds, const T& callback) const
+{
+	if (_root == k_null_node)
+	{
+		return;
+	}
+
+	int32_t stack[k_max_query_depth];
+	int stack_size = 0;
+	stack[stack_size++] = _root;
+
+	while (stack_size > 0)
+	{
+		const st_aabb_tree_node& node = _nodes[stack[--stack_size]];
+		if (!node._bounds.intersects(bounds))
+		{
+			continue;
+		}
+
+		if (node.is_leaf())
+		{
+			callback(int32_t(&node - _nodes.data()));
+		}
+		else
+		{
+			assert(stack_size + 2 <= k_max_query_depth);
+			stack[stack_size++] = node._children[0];
+			stack[stack_size++] = node._children[1];
+		}
+	}
+}
@@ -0,0 +1,169 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_broadphase.h"
+
+#include "math/st_math.h"
+
+#include <algorithm>
+#include <cassert>
+
+static st_broadphase_pair _st_broadphase_make_pair(int32_t a, int32_t b)
+{
+	return a < b ? st_broadphase_pair{ a, b } : st_broadphase_pair{ b, a };
+}
+
+int32_t st_broadphase::add_proxy(const st_aabb3f* bounds, bool is_static, void* user_data)
+{
+	int32_t proxy = _free_list;
+	if (proxy == k_null_proxy)
+	{
+		_proxies.emplace_back();
+		proxy = int32_t(_proxies.size() - 1);
+	}
+	else
+	{
+		_free_list = _proxies[proxy]._next_free;
+	}
+
+	st_broadphase_proxy& p = _proxies[proxy];
+	p = st_broadphase_proxy();
+	p._user_data = user_data;
+	p._is_static = is_static;
+	p._is_unbounded = bounds == nullptr;
+	p._in_use = true;
+
+	if (p._is_unbounded)
+	{
+		_unbounded.push_back(proxy);
+	}
+	else
+	{
+		p._bounds = *bounds;
+		st_aabb_tree& tree = is_static ? _static_tree : _moving_tree;
+		p._leaf = tree.insert(fatten(*bounds, st_vec3f::zero_vector()), proxy);
+	}
+
+	return proxy;
+}
+
+void st_broadphase::remove_proxy(int32_t proxy)
+{
+	st_broadphase_proxy& p = _proxies[proxy];
+	assert(p._in_use);
+
+	if (p._is_unbounded)
+	{
+		_unbounded.erase(std::find(_unbounded.begin(), _unbounded.end(), proxy));
+	}
+	else
+	{
+		st_aabb_tree& tree = p._is_static ? _static_tree : _moving_tree;
+		tree.remove(p._leaf);
+	}
+
+	p._in_use = false;
+	p._leaf = st_aabb_tree::k_null_node;
+	p._next_free = _free_list;
+	_free_list = proxy;
+}
+
+bool st_broadphase::move_proxy(int32_t proxy, const st_aabb3f& bounds, const st_vec3f& displacement)
+{
+	st_broadphase_proxy& p = _proxies[proxy];
+	assert(p._in_use && !p._is_unbounded);
+
+	p._bounds = bounds;
+
+	st_aabb_tree& tree = p._is_static ? _static_tree : _moving_tree;
+	if (tree.get_bounds(p._leaf).contains(bounds))
+	{
+		return false;
+	}
+
+	tree.update(p._leaf, fatten(bounds, displacement));
+	return true;
+}
+
+void st_broadphase::find_pairs(std::vector<st_broadphase_pair>& pairs) const
+{
+	pairs.clear();
+	for (int32_t proxy = 0; proxy < int32_t(_proxies.size()); ++proxy)
+	{
+		if (_proxies[proxy]._in_use && !_proxies[proxy]._is_static)
+		{
+			find_pairs_for_proxy(proxy, pairs);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+}
+
+void st_broadphase::find_pairs_for_proxy(int32_t proxy, std::vector<st_broadphase_pair>& pairs) const
+{
+	const st_broadphase_proxy& p = _proxies[proxy];
+	assert(p._in_use && !p._is_static);
+
+	if (p._is_unbounded)
+	{
+		// Bounded moving proxies find this one themselves.
+		for (int32_t other = 0; other < int32_t(_proxies.size()); ++other)
+		{
+			const st_broadphase_proxy& o = _proxies[other];
+			if (o._in_use && o._is_static && !o._is_unbounded)
+			{
+				pairs.push_back(_st_broadphase_make_pair(proxy, other));
+			}
+		}
+		for (int32_t other : _unbounded)
+		{
+			if (other != proxy && (_proxies[other]._is_static || other > proxy))
+			{
+				pairs.push_back(_st_broadphase_make_pair(proxy, other));
+			}
+		}
+		return;
+	}
+
+	// The tree bounds are fattened, so check the exact bounds before reporting a pair.
+	_moving_tree.query(p._bounds, [&](int32_t leaf)
+	{
+		int32_t other = _moving_tree.get_user_index(leaf);
+		if (other > proxy && _proxies[other]._bounds.intersects(p._bounds))
+		{
+			pairs.push_back({ proxy, other });
+		}
+	});
+
+	_static_tree.query(p._bounds, [&](int32_t leaf)
+	{
+		int32_t other = _static_tree.get_user_index(leaf);
+		if (_proxies[other]._bounds.intersects(p._bounds))
+		{
+			pairs.push_back(_st_broadphase_make_pair(proxy, other));
+		}
+	});
+
+	for (int32_t other : _unbounded)
+	{
+		pairs.push_back(_st_broadphase_make_pair(proxy, other));
+	}
+}
+
+st_aabb3f st_broadphase::fatten(const st_aabb3f& bounds, const st_vec3f& displacement)
+{
+	st_aabb3f fat = bounds;
+	for (int i = 0; i < 3; ++i)
+	{
+		fat.min.axes[i] -= k_fat_margin;
+		fat.max.axes[i] += k_fat_margin;
+
+		// Stretch only in the direction of travel.
+		float reach = displacement.axes[i] * k_displacement_multiplier;
+		fat.min.axes[i] += st_min(reach, 0.0f);
+		fat.max.axes[i] += st_max(reach, 0.0f);
+	}
+	return fat;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_aabb_tree.h"
+
+#include "math/st_aabb3f.h"
+#include "math/st_vec3f.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+** Two proxies whose bounds overlap, lower proxy first.
+*/
+struct st_broadphase_pair
+{
+	int32_t _a;
+	int32_t _b;
+
+	bool operator<(const st_broadphase_pair& other) const
+	{
+		return _a < other._a || (_a == other._a && _b < other._b);
+	}
+};
+
+/*
+** Finds the pairs of bodies that may be touching, for the narrowphase.
+**
+** Static and moving proxies live in separate trees, so static pairs are never
+** visited. Each tree holds fattened bounds, and a proxy only moves in its tree
+** once its bounds leave the fattened ones. Unbounded proxies, such as planes,
+** pair with every other proxy that is not static along with them.
+*/
+class st_broadphase
+{
+public:
+	static const int32_t k_null_proxy = -1;
+
+	/*
+	** Add a proxy.
+	** @param bounds World bounds, or nullptr for an unbounded proxy.
+	** @param user_data Returned by get_user_data, typically the body.
+	** @returns The proxy, numbered from zero and reused after removal.
+	*/
+	int32_t add_proxy(const st_aabb3f* bounds, bool is_static, void* user_data);
+
+	void remove_proxy(int32_t proxy);
+
+	/*
+	** Update the bounds of a bounded proxy.
+	** @param displacement Expected motion over the next step, which stretches
+	** the fattened bounds so moving proxies are reinserted less often.
+	** @returns True if the proxy was moved in its tree.
+	*/
+	bool move_proxy(int32_t proxy, const st_aabb3f& bounds, const st_vec3f& displacement);
+
+	void* get_user_data(int32_t proxy) const { return _proxies[proxy]._user_data; }
+	bool is_static(int32_t proxy) const { return _proxies[proxy]._is_static; }
+	const st_aabb3f& get_bounds(int32_t proxy) const { return _proxies[proxy]._bounds; }
+
+	/*
+	** Find every pair of proxies with overlapping bounds, skipping pairs that
+	** are both static. The pairs are sorted, so the order does not depend on
+	** the shape of the trees.
+	*/
+	void find_pairs(std::vector<st_broadphase_pair>& pairs) const;
+
+	/*
+	** Find the pairs for one moving proxy, each pair once across all proxies.
+	** Independent per proxy, so callers may split proxies across threads.
+	*/
+	void find_pairs_for_proxy(int32_t proxy, std::vector<st_broadphase_pair>& pairs) const;
+
+	int32_t get_proxy_capacity() const { return int32_t(_proxies.size()); }
+
+	const st_aabb_tree& get_static_tree() const { return _static_tree; }
+	const st_aabb_tree& get_moving_tree() const { return _moving_tree; }
+
+private:
+	// Fattening added on every side, in meters.
+	static constexpr float k_fat_margin = 0.1f;
+	// How many steps of displacement the fattened bounds allow for.
+	static constexpr float k_displacement_multiplier = 2.0f;
+
+	struct st_broadphase_proxy
+	{
+		st_aabb3f _bounds;
+		void* _user_data = nullptr;
+		int32_t _leaf = st_aabb_tree::k_null_node;
+		int32_t _next_free = k_null_proxy;
+		bool _is_static = false;
+		bool _is_unbounded = false;
+		bool _in_use = false;
+	};
+
+	static st_aabb3f fatten(const st_aabb3f& bounds, const st_vec3f& displacement);
+
+	std::vector<st_broadphase_proxy> _proxies;
+	int32_t _free_list = k_null_proxy;
+
+	std::vector<int32_t> _unbounded;
+
+	st_aabb_tree _static_tree;
+	st_aabb_tree _moving_tree;
+};
@@ -0,0 +1,145 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_broadphase.tests.h"
+#include "st_broadphase.h"
+
+#include "core/st_test_random.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+static st_test_random _st_broadphase_test_random(0x9e3779b9);
+
+static st_aabb3f _st_broadphase_test_random_box()
+{
+	st_vec3f center = { _st_broadphase_test_random.next(-20.0f, 20.0f), _st_broadphase_test_random.next(-20.0f, 20.0f), _st_broadphase_test_random.next(-20.0f, 20.0f) };
+	st_vec3f extents = { _st_broadphase_test_random.next(0.1f, 2.0f), _st_broadphase_test_random.next(0.1f, 2.0f), _st_broadphase_test_random.next(0.1f, 2.0f) };
+
+	st_aabb3f box;
+	box.make_from_center(center, extents);
+	return box;
+}
+
+/*
+** Every pair the broadphase should report, by testing all of them.
+*/
+static void _st_broadphase_test_brute_force(
+	const st_broadphase& broadphase,
+	const std::vector<bool>& live,
+	const std::vector<bool>& unbounded,
+	std::vector<st_broadphase_pair>& pairs)
+{
+	pairs.clear();
+	for (int32_t a = 0; a < int32_t(live.size()); ++a)
+	{
+		for (int32_t b = a + 1; b < int32_t(live.size()); ++b)
+		{
+			if (!live[a] || !live[b] || (broadphase.is_static(a) && broadphase.is_static(b)))
+			{
+				continue;
+			}
+
+			if (unbounded[a] || unbounded[b] || broadphase.get_bounds(a).intersects(broadphase.get_bounds(b)))
+			{
+				pairs.push_back({ a, b });
+			}
+		}
+	}
+}
+
+static void _st_broadphase_test_check(
+	const st_broadphase& broadphase,
+	const std::vector<bool>& live,
+	const std::vector<bool>& unbounded)
+{
+	broadphase.get_static_tree().validate();
+	broadphase.get_moving_tree().validate();
+
+	std::vector<st_broadphase_pair> pairs;
+	broadphase.find_pairs(pairs);
+
+	std::vector<st_broadphase_pair> expected;
+	_st_broadphase_test_brute_force(broadphase, live, unbounded, expected);
+
+	assert(pairs.size() == expected.size());
+	for (size_t i = 0; i < pairs.size(); ++i)
+	{
+		assert(pairs[i]._a == expected[i]._a && pairs[i]._b == expected[i]._b);
+	}
+}
+
+void st_broadphase_unit_tests()
+{
+	const int k_count = 600;
+
+	st_broadphase broadphase;
+	std::vector<bool> live;
+	std::vector<bool> unbounded;
+
+	// A mix of static and moving boxes, and a static and a moving plane.
+	for (int i = 0; i < k_count; ++i)
+	{
+		bool is_unbounded = i == 10 || i == 300;
+		bool is_static = i % 4 == 0;
+
+		st_aabb3f box = _st_broadphase_test_random_box();
+		int32_t proxy = broadphase.add_proxy(is_unbounded ? nullptr : &box, is_static, nullptr);
+		assert(proxy == i);
+
+		live.push_back(true);
+		unbounded.push_back(is_unbounded);
+	}
+	_st_broadphase_test_check(broadphase, live, unbounded);
+
+	// Test small moves, which stay inside the fattened bounds, and large ones, which do not.
+	for (int step = 0; step < 4; ++step)
+	{
+		int reinserted = 0;
+		for (int32_t i = 0; i < k_count; ++i)
+		{
+			if (unbounded[i] || broadphase.is_static(i))
+			{
+				continue;
+			}
+
+			st_vec3f displacement = step % 2 == 0
+				? st_vec3f{ 0.01f, -0.01f, 0.02f }
+				: st_vec3f{ _st_broadphase_test_random.next(-3.0f, 3.0f), _st_broadphase_test_random.next(-3.0f, 3.0f), _st_broadphase_test_random.next(-3.0f, 3.0f) };
+
+			st_aabb3f box = broadphase.get_bounds(i);
+			box.min += displacement;
+			box.max += displacement;
+			reinserted += broadphase.move_proxy(i, box, displacement) ? 1 : 0;
+		}
+		assert(step % 2 == 1 || reinserted == 0);
+		_st_broadphase_test_check(broadphase, live, unbounded);
+	}
+
+	// Test removal, and reuse of the removed proxies.
+	for (int32_t i = 0; i < k_count; i += 3)
+	{
+		broadphase.remove_proxy(i);
+		live[i] = false;
+	}
+	_st_broadphase_test_check(broadphase, live, unbounded);
+
+	for (int32_t i = 0; i < k_count; i += 3)
+	{
+		st_aabb3f box = _st_broadphase_test_random_box();
+		int32_t proxy = broadphase.add_proxy(&box, i % 2 == 0, nullptr);
+		assert(proxy < k_count && !live[proxy]);
+		live[proxy] = true;
+		unbounded[proxy] = false;
+	}
+	_st_broadphase_test_check(broadphase, live, unbounded);
+
+	// The trees stay shallow.
+	assert(broadphase.get_moving_tree().get_height() < 24);
+	assert(broadphase.get_static_tree().get_height() < 24);
+}
@@ -0,0 +1,121 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_contact_manifold.h"
+
+#include "math/st_math.h"
+
+/*
+** Twice the area of the quadrilateral through four points, in any order.
+** The largest cross product of opposite diagonals covers every ordering.
+*/
+static float _st_contact_patch_area(const st_vec3f& p0, const st_vec3f& p1, const st_vec3f& p2, const st_vec3f& p3)
+{
+	float a = st_vec3f_cross(p0 - p1, p2 - p3).mag2();
+	float b = st_vec3f_cross(p0 - p2, p1 - p3).mag2();
+	float c = st_vec3f_cross(p0 - p3, p1 - p2).mag2();
+	return st_max(a, st_max(b, c));
+}
+
+void st_contact_manifold::refresh(const st_affine3f& transform_a, const st_affine3f& transform_b)
+{
+	for (int i = 0; i < _point_count; )
+	{
+		st_contact_point& point = _points[i];
+		st_vec3f world_a = transform_a.transform_point(point._local_a);
+		st_vec3f world_b = transform_b.transform_point(point._local_b);
+
+		st_vec3f offset = world_a - world_b;
+		float penetration = offset.dot(point._info._normal);
+		st_vec3f drift = offset - point._info._normal.scale_result(penetration);
+
+		if (penetration < -k_breaking_distance || drift.mag2() > k_breaking_distance * k_breaking_distance)
+		{
+			_points[i] = _points[--_point_count];
+			continue;
+		}
+
+		point._info._point = (world_a + world_b).scale_result(0.5f);
+		point._info._penetration = penetration;
+		++i;
+	}
+}
+
+void st_contact_manifold::add_point(const st_collision_info& info, const st_affine3f& transform_a, const st_affine3f& transform_b)
+{
+	st_contact_point point;
+	point._info = info;
+
+	st_vec3f half_depth = info._normal.scale_result(0.5f * info._penetration);
+	point._local_a = transform_a.inverse().transform_point(info._point + half_depth);
+	point._local_b = transform_b.inverse().transform_point(info._point - half_depth);
+
+	int index = find_replacement(point);
+	if (index < _point_count)
+	{
+		point._normal_impulse = _points[index]._normal_impulse;
+		point._tangent_impulse = _points[index]._tangent_impulse;
+	}
+	else
+	{
+		++_point_count;
+	}
+	_points[index] = point;
+}
+
+int st_contact_manifold::find_replacement(const st_contact_point& point) const
+{
+	const float k_merge_distance2 = k_breaking_distance * k_breaking_distance;
+	for (int i = 0; i < _point_count; ++i)
+	{
+		if ((_points[i]._info._point - point._info._point).mag2() < k_merge_distance2)
+		{
+			return i;
+		}
+	}
+
+	if (_point_count < k_max_points)
+	{
+		return _point_count;
+	}
+
+	// Keep the deepest point, and whichever three give the largest patch with the new one.
+	int deepest = -1;
+	float deepest_penetration = point._info._penetration;
+	for (int i = 0; i < k_max_points; ++i)
+	{
+		if (_points[i]._info._penetration > deepest_penetration)
+		{
+			deepest = i;
+			deepest_penetration = _points[i]._info._penetration;
+		}
+	}
+
+	int best = 0;
+	float best_area = -1.0f;
+	for (int i = 0; i < k_max_points; ++i)
+	{
+		if (i == deepest)
+		{
+			continue;
+		}
+
+		st_vec3f corners[k_max_points];
+		for (int j = 0; j < k_max_points; ++j)
+		{
+			corners[j] = j == i ? point._info._point : _points[j]._info._point;
+		}
+
+		float area = _st_contact_patch_area(corners[0], corners[1], corners[2], corners[3]);
+		if (area > best_area)
+		{
+			best = i;
+			best_area = area;
+		}
+	}
+
+	return best;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_intersection.h"
+
+#include "math/st_affine3f.h"
+#include "math/st_vec3f.h"
+
+#include <cstdint>
+
+class st_rigid_body;
+
+/*
+** A point of contact kept between steps.
+*/
+struct st_contact_point
+{
+	// World space contact, refreshed from the anchors each step.
+	st_collision_info _info;
+
+	// The deepest point of each body, in that body's space.
+	st_vec3f _local_a;
+	st_vec3f _local_b;
+
+	// Impulses applied at the point last step, to warm start the solver with.
+	float _normal_impulse = 0.0f;
+	st_vec3f _tangent_impulse = st_vec3f::zero_vector();
+};
+
+/*
+** The contact points between a pair of bodies.
+**
+** The narrowphase finds one point a step for most pairs, and the whole patch
+** for boxes. Points are anchored to both bodies and kept while the bodies
+** stay together, so resting contacts build up to a full patch over a few
+** steps and the solver can pick up where it left off with the impulses from
+** the last step.
+*/
+struct st_contact_manifold
+{
+	static const int k_max_points = 4;
+
+	// Points further apart than this, along the normal or across it, are dropped.
+	static constexpr float k_breaking_distance = 0.02f;
+
+	st_rigid_body* _body_a = nullptr;
+	st_rigid_body* _body_b = nullptr;
+
+	st_contact_point _points[k_max_points];
+	int _point_count = 0;
+
+	/*
+	** Move the points with the bodies, dropping those that have come apart.
+	*/
+	void refresh(const st_affine3f& transform_a, const st_affine3f& transform_b);
+
+	/*
+	** Add a point found by the narrowphase. It replaces a point close to it,
+	** keeping that point's impulses, or when the manifold is full, whichever
+	** point leaves the largest patch behind.
+	*/
+	void add_point(const st_collision_info& info, const st_affine3f& transform_a, const st_affine3f& transform_b);
+
+private:
+	int find_replacement(const st_contact_point& point) const;
+};
@@ -0,0 +1,257 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_contact_solver.h"
+#include "st_contact_manifold.h"
+#include "st_rigid_body.h"
+#include "st_shape.h"
+
+#include "math/st_math.h"
+#include "math/st_quatf.h"
+
+bool st_contact_solver::is_static(const st_rigid_body* body)
+{
+	return (body->_flags & k_static) != 0;
+}
+
+float st_contact_solver::inverse_mass(const st_rigid_body* body)
+{
+	return is_static(body) ? 0.0f : 1.0f / body->_mass;
+}
+
+float st_contact_solver::inverse_mass_along(const st_rigid_body* body, const st_vec3f& r, const st_vec3f& direction)
+{
+	if (is_static(body))
+	{
+		return 0.0f;
+	}
+
+	st_vec3f angular = body->_world_inverse_inertia_tensor.transform(st_vec3f_cross(r, direction));
+	return 1.0f / body->_mass + st_vec3f_cross(angular, r).dot(direction);
+}
+
+float st_contact_solver::effective_mass(const st_rigid_body* body_a, const st_rigid_body* body_b, const st_vec3f& r_a, const st_vec3f& r_b, const st_vec3f& direction)
+{
+	float k = inverse_mass_along(body_a, r_a, direction) + inverse_mass_along(body_b, r_b, direction);
+	return k > 0.0f ? 1.0f / k : 0.0f;
+}
+
+void st_contact_solver::apply_impulse(st_rigid_body* body, const st_vec3f& r, const st_vec3f& impulse)
+{
+	if (is_static(body))
+	{
+		return;
+	}
+
+	st_vec3f angular = st_vec3f_cross(r, impulse);
+	body->_velocity += impulse.scale_result(1.0f / body->_mass);
+	body->_angular_momentum += angular;
+	body->_angular_velocity += body->_world_inverse_inertia_tensor.transform(angular);
+}
+
+st_vec3f st_contact_solver::relative_velocity(const st_rigid_body* body_a, const st_rigid_body* body_b, const st_vec3f& r_a, const st_vec3f& r_b)
+{
+	st_vec3f velocity_a = body_a->_velocity + st_vec3f_cross(body_a->_angular_velocity, r_a);
+	st_vec3f velocity_b = body_b->_velocity + st_vec3f_cross(body_b->_angular_velocity, r_b);
+	return velocity_b - velocity_a;
+}
+
+void st_contact_solver::move_body(st_rigid_body* body, const st_vec3f& translation, const st_vec3f& rotation)
+{
+	if (is_static(body))
+	{
+		return;
+	}
+
+	st_quatf spin = { rotation.x, rotation.y, rotation.z, 0.0f };
+	body->_orientation += (spin * body->_orientation).scale_result(0.5f);
+	body->_orientation.normalize_fast();
+
+	st_vec3f position = body->_transform.get_translation() + translation;
+	body->_transform.make_rotation(body->_orientation);
+	body->_transform.set_translation(position);
+	body->update_world_inertia();
+}
+
+st_vec3f st_contact_solver::offset_to_point(const st_rigid_body* body, const st_vec3f& point)
+{
+	return body->_shape->get_offset_to_point(body->_transform, point);
+}
+
+/*
+** Any two directions perpendicular to the normal and to each other. They
+** only need to be consistent for a given normal, as the impulses kept
+** between steps are stored as vectors.
+*/
+static void _st_contact_tangents(const st_vec3f& normal, st_vec3f& tangent_a, st_vec3f& tangent_b)
+{
+	if (st_absf(normal.x) >= 0.57735f)
+	{
+		tangent_a = { normal.y, -normal.x, 0.0f };
+	}
+	else
+	{
+		tangent_a = { 0.0f, normal.z, -normal.y };
+	}
+	tangent_a.normalize();
+	tangent_b = st_vec3f_cross(normal, tangent_a);
+}
+
+void st_contact_solver::prepare(st_contact_manifold* manifolds, const int32_t* indices, int count, float dt)
+{
+	float inverse_dt = dt > 0.0f ? 1.0f / dt : 0.0f;
+
+	_constraints.clear();
+	for (int m = 0; m < count; ++m)
+	{
+		st_contact_manifold& manifold = manifolds[indices[m]];
+		st_rigid_body* body_a = manifold._body_a;
+		st_rigid_body* body_b = manifold._body_b;
+
+		float restitution = (body_a->_coefficient_of_restitution + body_b->_coefficient_of_restitution) / 2.0f;
+		float friction = st_sqrtf(body_a->_coefficient_of_friction * body_b->_coefficient_of_friction);
+
+		for (int p = 0; p < manifold._point_count; ++p)
+		{
+			st_contact_point& point = manifold._points[p];
+
+			st_contact_constraint constraint;
+			constraint._body_a = body_a;
+			constraint._body_b = body_b;
+			constraint._point = &point;
+			constraint._normal = point._info._normal;
+			constraint._r_a = offset_to_point(body_a, point._info._point);
+			constraint._r_b = offset_to_point(body_b, point._info._point);
+			constraint._friction = friction;
+
+			_st_contact_tangents(constraint._normal, constraint._tangents[0], constraint._tangents[1]);
+
+			constraint._normal_mass = effective_mass(body_a, body_b, constraint._r_a, constraint._r_b, constraint._normal);
+			for (int t = 0; t < 2; ++t)
+			{
+				constraint._tangent_mass[t] = effective_mass(body_a, body_b, constraint._r_a, constraint._r_b, constraint._tangents[t]);
+			}
+
+			/*
+			** Points kept from earlier steps may not touch yet; let the bodies
+			** close the gap this step and no further. Touching points bounce
+			** if they hit hard enough.
+			*/
+			float normal_velocity = relative_velocity(body_a, body_b, constraint._r_a, constraint._r_b).dot(constraint._normal);
+			constraint._velocity_bias = 0.0f;
+			if (point._info._penetration < 0.0f)
+			{
+				constraint._velocity_bias = point._info._penetration * inverse_dt;
+			}
+			else if (normal_velocity < -k_restitution_threshold)
+			{
+				constraint._velocity_bias = -restitution * normal_velocity;
+			}
+
+			constraint._normal_impulse = point._normal_impulse;
+			for (int t = 0; t < 2; ++t)
+			{
+				constraint._tangent_impulse[t] = point._tangent_impulse.dot(constraint._tangents[t]);
+			}
+
+			_constraints.push_back(constraint);
+		}
+	}
+
+	warm_start();
+}
+
+void st_contact_solver::warm_start()
+{
+	for (const st_contact_constraint& c : _constraints)
+	{
+		st_vec3f impulse = c._normal.scale_result(c._normal_impulse) +
+			c._tangents[0].scale_result(c._tangent_impulse[0]) +
+			c._tangents[1].scale_result(c._tangent_impulse[1]);
+
+		apply_impulse(c._body_a, c._r_a, -impulse);
+		apply_impulse(c._body_b, c._r_b, impulse);
+	}
+}
+
+void st_contact_solver::solve_velocities()
+{
+	for (int iteration = 0; iteration < _velocity_iterations; ++iteration)
+	{
+		for (st_contact_constraint& c : _constraints)
+		{
+			// Friction first, so the normal impulse has the last word on penetration.
+			float max_friction = c._friction * c._normal_impulse;
+			for (int t = 0; t < 2; ++t)
+			{
+				st_vec3f velocity = relative_velocity(c._body_a, c._body_b, c._r_a, c._r_b);
+				float lambda = -c._tangent_mass[t] * velocity.dot(c._tangents[t]);
+
+				float accumulated = st_min(st_max(c._tangent_impulse[t] + lambda, -max_friction), max_friction);
+				lambda = accumulated - c._tangent_impulse[t];
+				c._tangent_impulse[t] = accumulated;
+
+				st_vec3f impulse = c._tangents[t].scale_result(lambda);
+				apply_impulse(c._body_a, c._r_a, -impulse);
+				apply_impulse(c._body_b, c._r_b, impulse);
+			}
+
+			st_vec3f velocity = relative_velocity(c._body_a, c._body_b, c._r_a, c._r_b);
+			float lambda = -c._normal_mass * (velocity.dot(c._normal) - c._velocity_bias);
+
+			// Clamp the total rather than each step, so later iterations can take back too much push.
+			float accumulated = st_max(c._normal_impulse + lambda, 0.0f);
+			lambda = accumulated - c._normal_impulse;
+			c._normal_impulse = accumulated;
+
+			st_vec3f impulse = c._normal.scale_result(lambda);
+			apply_impulse(c._body_a, c._r_a, -impulse);
+			apply_impulse(c._body_b, c._r_b, impulse);
+		}
+	}
+
+	for (const st_contact_constraint& c : _constraints)
+	{
+		c._point->_normal_impulse = c._normal_impulse;
+		c._point->_tangent_impulse = c._tangents[0].scale_result(c._tangent_impulse[0]) + c._tangents[1].scale_result(c._tangent_impulse[1]);
+	}
+}
+
+void st_contact_solver::solve_positions()
+{
+	for (int iteration = 0; iteration < _position_iterations; ++iteration)
+	{
+		for (const st_contact_constraint& c : _constraints)
+		{
+			// Earlier corrections have moved the bodies, so find the points afresh.
+			st_vec3f world_a = c._body_a->_transform.transform_point(c._point->_local_a);
+			st_vec3f world_b = c._body_b->_transform.transform_point(c._point->_local_b);
+			float penetration = (world_a - world_b).dot(c._normal);
+
+			float correction = st_min(k_baumgarte * (penetration - k_slop), k_max_correction);
+			if (correction <= 0.0f)
+			{
+				continue;
+			}
+
+			st_vec3f midpoint = (world_a + world_b).scale_result(0.5f);
+			st_vec3f r_a = offset_to_point(c._body_a, midpoint);
+			st_vec3f r_b = offset_to_point(c._body_b, midpoint);
+
+			float mass = effective_mass(c._body_a, c._body_b, r_a, r_b, c._normal);
+			st_vec3f impulse = c._normal.scale_result(mass * correction);
+
+			move_body(
+				c._body_a,
+				impulse.scale_result(-inverse_mass(c._body_a)),
+				c._body_a->_world_inverse_inertia_tensor.transform(st_vec3f_cross(r_a, -impulse)));
+			move_body(
+				c._body_b,
+				impulse.scale_result(inverse_mass(c._body_b)),
+				c._body_b->_world_inverse_inertia_tensor.transform(st_vec3f_cross(r_b, impulse)));
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "math/st_vec3f.h"
+
+#include <cstdint>
+#include <vector>
+
+struct st_contact_manifold;
+struct st_contact_point;
+class st_rigid_body;
+
+/*
+** Resolves contacts with sequential impulses.
+**
+** Each iteration visits every contact point in turn and applies the impulse
+** that brings its relative velocity to what the contact allows: friction
+** first, within the cone the normal impulse allows, then the normal impulse,
+** which may only push. Iterating spreads the impulses through stacks and
+** piles, and starting from last step's impulses means resting contacts
+** need few iterations to settle.
+**
+** Penetration is left out of the velocities, so it adds no energy. Once
+** the bodies have moved, a few position iterations push them apart directly.
+**
+** A step is prepare, solve_velocities, integrating positions, then
+** solve_positions.
+*/
+class st_contact_solver
+{
+public:
+	void set_velocity_iterations(int count) { _velocity_iterations = count; }
+	int get_velocity_iterations() const { return _velocity_iterations; }
+
+	void set_position_iterations(int count) { _position_iterations = count; }
+	int get_position_iterations() const { return _position_iterations; }
+
+	/*
+	** Set up constraints for the points of the given manifolds, solved in
+	** the order given, and apply the impulses they kept from the last step.
+	*/
+	void prepare(st_contact_manifold* manifolds, const int32_t* indices, int count, float dt);
+
+	/*
+	** Iterate on the velocities, then store the impulses in the manifolds.
+	*/
+	void solve_velocities();
+
+	/*
+	** Iterate on the positions, after they have been integrated.
+	*/
+	void solve_positions();
+
+private:
+	// Penetration allowed to remain, so resting contacts stay in the manifolds.
+	static constexpr float k_slop = 0.005f;
+	// Fraction of the remaining penetration removed per position iteration.
+	static constexpr float k_baumgarte = 0.2f;
+	// Largest correction made to a point in one position iteration, in meters.
+	static constexpr float k_max_correction = 0.2f;
+	// Bodies approaching more slowly than this, in meters per second, don't bounce.
+	static constexpr float k_restitution_threshold = 1.0f;
+
+	struct st_contact_constraint
+	{
+		st_rigid_body* _body_a;
+		st_rigid_body* _body_b;
+		st_contact_point* _point;
+
+		st_vec3f _normal;
+		st_vec3f _tangents[2];
+		st_vec3f _r_a;
+		st_vec3f _r_b;
+
+		float _normal_mass;
+		float _tangent_mass[2];
+		float _velocity_bias;
+		float _friction;
+
+		float _normal_impulse;
+		float _tangent_impulse[2];
+	};
+
+	static bool is_static(const st_rigid_body* body);
+	static float inverse_mass(const st_rigid_body* body);
+
+	/*
+	** Offset of a world space point from a body's center of mass.
+	*/
+	static st_vec3f offset_to_point(const st_rigid_body* body, const st_vec3f& point);
+
+	/*
+	** How readily one body gives way to an impulse along a direction, at an offset from its center of mass.
+	*/
+	static float inverse_mass_along(const st_rigid_body* body, const st_vec3f& r, const st_vec3f& direction);
+	static float effective_mass(const st_rigid_body* body_a, const st_rigid_body* body_b, const st_vec3f& r_a, const st_vec3f& r_b, const st_vec3f& direction);
+
+	static void apply_impulse(st_rigid_body* body, const st_vec3f& r, const st_vec3f& impulse);
+	static st_vec3f relative_velocity(const st_rigid_body* body_a, const st_rigid_body* body_b, const st_vec3f& r_a, const st_vec3f& r_b);
+
+	/*
+	** Move a body directly, turning it by a small rotation vector.
+	*/
+	static void move_body(st_rigid_body* body, const st_vec3f& translation, const st_vec3f& rotation);
+
+	void warm_start();
+
+	std::vector<st_contact_constraint> _constraints;
+
+	int _velocity_iterations = 8;
+	int _position_iterations = 3;
+};
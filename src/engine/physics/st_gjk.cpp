@@ -0,0 +1,635 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_gjk.h"
+
+#include "math/st_math.h"
+
+#include <cassert>
+#include <float.h>
+#include <utility>
+
+// GJK moves toward the origin in at most this many steps, and EPA grows its polytope at most this many times.
+static const int k_gjk_max_iterations = 32;
+static const int k_epa_max_iterations = 32;
+
+static const int k_epa_max_vertices = 4 + k_epa_max_iterations;
+static const int k_epa_max_faces = 128;
+
+// GJK stops once a step gets this much closer to the origin, relative to the distance squared.
+static const float k_gjk_tolerance = 1.0e-6f;
+// Closer to the origin than this, squared, the cores are taken to overlap.
+static const float k_gjk_overlap_distance2 = 1.0e-10f;
+// EPA stops once the surface is this close beyond its nearest face, in meters.
+static const float k_epa_tolerance = 1.0e-4f;
+// New points nearer the polytope than this, squared, don't grow it.
+static const float k_epa_degenerate_distance2 = 1.0e-10f;
+
+st_gjk_shape::st_gjk_shape(const st_shape* shape, const st_affine3f& transform) :
+	_shape(shape), _type(shape->get_type()), _transform(transform)
+{
+	// Each shape is placed as its dedicated intersection test places it.
+	switch (_type)
+	{
+	case k_shape_sphere:
+	{
+		const st_sphere* sphere = reinterpret_cast<const st_sphere*>(shape);
+		_center = sphere->_center + transform.get_translation();
+		_margin = sphere->_radius;
+		break;
+	}
+	case k_shape_aabb:
+	{
+		// Axis-aligned boxes only ever translate.
+		const st_aabb* aabb = reinterpret_cast<const st_aabb*>(shape);
+		_center = (aabb->_min + aabb->_max).scale_result(0.5f) + transform.get_translation();
+		_half_vectors[0] = (aabb->_max - aabb->_min).scale_result(0.5f);
+		break;
+	}
+	case k_shape_oobb:
+	{
+		const st_oobb* oobb = reinterpret_cast<const st_oobb*>(shape);
+		_center = oobb->_center + transform.get_translation();
+		for (int i = 0; i < 3; ++i)
+		{
+			_half_vectors[i] = transform.transform_vector(oobb->_half_vectors[i]);
+		}
+		break;
+	}
+	case k_shape_convex_hull:
+	{
+		// The point farthest along d in the transformed hull is the transformed point farthest along M^T d.
+		const st_convex_hull* hull = reinterpret_cast<const st_convex_hull*>(shape);
+		_direction_to_local = transform.get_linear();
+		_direction_to_local.transpose();
+		_center = transform.transform_point(hull->get_positions()[0]);
+		break;
+	}
+	default:
+		// Planes are unbounded, and have tests of their own.
+		assert(false);
+		break;
+	}
+}
+
+st_vec3f st_gjk_shape::support(const st_vec3f& direction) const
+{
+	switch (_type)
+	{
+	case k_shape_sphere:
+		return _center;
+	case k_shape_aabb:
+	{
+		const st_vec3f& extents = _half_vectors[0];
+		return _center + st_vec3f
+		{
+			direction.x >= 0.0f ? extents.x : -extents.x,
+			direction.y >= 0.0f ? extents.y : -extents.y,
+			direction.z >= 0.0f ? extents.z : -extents.z,
+		};
+	}
+	case k_shape_oobb:
+	{
+		st_vec3f point = _center;
+		for (int i = 0; i < 3; ++i)
+		{
+			point += _half_vectors[i].dot(direction) >= 0.0f ? _half_vectors[i] : -_half_vectors[i];
+		}
+		return point;
+	}
+	case k_shape_convex_hull:
+	{
+		const st_convex_hull* hull = reinterpret_cast<const st_convex_hull*>(_shape);
+		return _transform.transform_point(hull->get_support(_direction_to_local.transform(direction)));
+	}
+	default:
+		assert(false);
+		return _center;
+	}
+}
+
+static st_gjk_vertex _st_gjk_support(const st_gjk_shape& a, const st_gjk_shape& b, const st_vec3f& direction)
+{
+	st_gjk_vertex vertex;
+	vertex._a = a.support(direction);
+	vertex._b = b.support(-direction);
+	vertex._w = vertex._a - vertex._b;
+	return vertex;
+}
+
+/*
+** Reduce the simplex to the vertices nearest the origin, returning the nearest point.
+*/
+static st_vec3f _st_gjk_keep(st_gjk_simplex& simplex, int i)
+{
+	simplex._vertices[0] = simplex._vertices[i];
+	simplex._weights[0] = 1.0f;
+	simplex._count = 1;
+	return simplex._vertices[0]._w;
+}
+
+static st_vec3f _st_gjk_keep(st_gjk_simplex& simplex, int i, int j, float t)
+{
+	st_gjk_vertex start = simplex._vertices[i];
+	st_gjk_vertex end = simplex._vertices[j];
+	simplex._vertices[0] = start;
+	simplex._vertices[1] = end;
+	simplex._weights[0] = 1.0f - t;
+	simplex._weights[1] = t;
+	simplex._count = 2;
+	return start._w + (end._w - start._w).scale_result(t);
+}
+
+static st_vec3f _st_gjk_closest_on_segment(st_gjk_simplex& simplex)
+{
+	const st_vec3f& a = simplex._vertices[0]._w;
+	st_vec3f ab = simplex._vertices[1]._w - a;
+
+	float length2 = ab.mag2();
+	float t = length2 > 0.0f ? -a.dot(ab) / length2 : 0.0f;
+	if (t <= 0.0f)
+	{
+		return _st_gjk_keep(simplex, 0);
+	}
+	if (t >= 1.0f)
+	{
+		return _st_gjk_keep(simplex, 1);
+	}
+	return _st_gjk_keep(simplex, 0, 1, t);
+}
+
+static st_vec3f _st_gjk_closest_on_triangle(st_gjk_simplex& simplex)
+{
+	// Voronoi regions of the triangle, after Ericson's Real-Time Collision Detection, 5.1.5.
+	st_vec3f a = simplex._vertices[0]._w;
+	st_vec3f b = simplex._vertices[1]._w;
+	st_vec3f c = simplex._vertices[2]._w;
+	st_vec3f ab = b - a;
+	st_vec3f ac = c - a;
+
+	float d1 = -ab.dot(a);
+	float d2 = -ac.dot(a);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+	{
+		return _st_gjk_keep(simplex, 0);
+	}
+
+	float d3 = -ab.dot(b);
+	float d4 = -ac.dot(b);
+	if (d3 >= 0.0f && d4 <= d3)
+	{
+		return _st_gjk_keep(simplex, 1);
+	}
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+	{
+		return _st_gjk_keep(simplex, 0, 1, d1 / (d1 - d3));
+	}
+
+	float d5 = -ab.dot(c);
+	float d6 = -ac.dot(c);
+	if (d6 >= 0.0f && d5 <= d6)
+	{
+		return _st_gjk_keep(simplex, 2);
+	}
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+	{
+		return _st_gjk_keep(simplex, 0, 2, d2 / (d2 - d6));
+	}
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+	{
+		return _st_gjk_keep(simplex, 1, 2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	}
+
+	// A triangle with no area lands here only through rounding; its first corner will do.
+	float sum = va + vb + vc;
+	if (sum <= 0.0f)
+	{
+		return _st_gjk_keep(simplex, 0);
+	}
+
+	float v = vb / sum;
+	float w = vc / sum;
+	simplex._weights[0] = 1.0f - v - w;
+	simplex._weights[1] = v;
+	simplex._weights[2] = w;
+	return a + ab.scale_result(v) + ac.scale_result(w);
+}
+
+static st_vec3f _st_gjk_closest_on_tetrahedron(st_gjk_simplex& simplex)
+{
+	// The corners of each face, then the corner opposite it.
+	static const int k_faces[4][4] =
+	{
+		{ 0, 1, 2, 3 },
+		{ 0, 3, 1, 2 },
+		{ 0, 2, 3, 1 },
+		{ 1, 3, 2, 0 },
+	};
+
+	st_gjk_simplex best_simplex;
+	st_vec3f best = st_vec3f::zero_vector();
+	float best_distance2 = FLT_MAX;
+
+	for (int f = 0; f < 4; ++f)
+	{
+		const st_vec3f& a = simplex._vertices[k_faces[f][0]]._w;
+		const st_vec3f& b = simplex._vertices[k_faces[f][1]]._w;
+		const st_vec3f& c = simplex._vertices[k_faces[f][2]]._w;
+		const st_vec3f& d = simplex._vertices[k_faces[f][3]]._w;
+
+		// The origin is inside this face if it is on the same side as the opposite corner.
+		st_vec3f normal = st_vec3f_cross(b - a, c - a);
+		if (-a.dot(normal) * (d - a).dot(normal) > 0.0f)
+		{
+			continue;
+		}
+
+		st_gjk_simplex face;
+		face._vertices[0] = simplex._vertices[k_faces[f][0]];
+		face._vertices[1] = simplex._vertices[k_faces[f][1]];
+		face._vertices[2] = simplex._vertices[k_faces[f][2]];
+		face._count = 3;
+
+		st_vec3f closest = _st_gjk_closest_on_triangle(face);
+		if (closest.mag2() < best_distance2)
+		{
+			best_simplex = face;
+			best = closest;
+			best_distance2 = closest.mag2();
+		}
+	}
+
+	// Inside every face, so the tetrahedron holds the origin and the simplex stays whole.
+	if (best_distance2 < FLT_MAX)
+	{
+		simplex = best_simplex;
+	}
+	return best;
+}
+
+static st_vec3f _st_gjk_closest(st_gjk_simplex& simplex)
+{
+	switch (simplex._count)
+	{
+	case 1: return _st_gjk_keep(simplex, 0);
+	case 2: return _st_gjk_closest_on_segment(simplex);
+	case 3: return _st_gjk_closest_on_triangle(simplex);
+	default: return _st_gjk_closest_on_tetrahedron(simplex);
+	}
+}
+
+float st_gjk_distance(
+	const st_gjk_shape& a,
+	const st_gjk_shape& b,
+	st_gjk_simplex& simplex,
+	st_vec3f& point_a,
+	st_vec3f& point_b)
+{
+	// Start from the side of the difference facing the origin.
+	st_vec3f direction = b.get_center() - a.get_center();
+	if (direction.mag2() == 0.0f)
+	{
+		direction = st_vec3f::x_vector();
+	}
+
+	simplex._vertices[0] = _st_gjk_support(a, b, direction);
+	simplex._weights[0] = 1.0f;
+	simplex._count = 1;
+
+	st_vec3f closest = simplex._vertices[0]._w;
+	bool is_overlapping = false;
+	for (int iteration = 0; iteration < k_gjk_max_iterations; ++iteration)
+	{
+		float distance2 = closest.mag2();
+		if (distance2 <= k_gjk_overlap_distance2)
+		{
+			is_overlapping = true;
+			break;
+		}
+
+		st_gjk_vertex vertex = _st_gjk_support(a, b, -closest);
+
+		// Nothing in the difference reaches further toward the origin than the new point, so we are as close as we get.
+		if (distance2 - closest.dot(vertex._w) <= k_gjk_tolerance * distance2)
+		{
+			break;
+		}
+
+		// Rounding can return a point the simplex already has, which would cycle.
+		bool is_repeat = false;
+		for (int i = 0; i < simplex._count; ++i)
+		{
+			is_repeat |= simplex._vertices[i]._w == vertex._w;
+		}
+		if (is_repeat)
+		{
+			break;
+		}
+
+		simplex._vertices[simplex._count++] = vertex;
+		closest = _st_gjk_closest(simplex);
+
+		if (simplex._count == 4)
+		{
+			is_overlapping = true;
+			break;
+		}
+
+		if (closest.mag2() >= distance2)
+		{
+			break;
+		}
+	}
+
+	point_a = st_vec3f::zero_vector();
+	point_b = st_vec3f::zero_vector();
+	for (int i = 0; i < simplex._count && !is_overlapping; ++i)
+	{
+		point_a += simplex._vertices[i]._a.scale_result(simplex._weights[i]);
+		point_b += simplex._vertices[i]._b.scale_result(simplex._weights[i]);
+	}
+
+	return is_overlapping ? 0.0f : st_sqrtf(closest.mag2());
+}
+
+struct st_epa_face
+{
+	int _indices[3];
+	st_vec3f _normal;
+	float _distance;
+};
+
+static bool _st_epa_add_face(st_epa_face* faces, int& face_count, const st_gjk_vertex* vertices, int i0, int i1, int i2)
+{
+	if (face_count == k_epa_max_faces)
+	{
+		return false;
+	}
+
+	st_epa_face& face = faces[face_count++];
+	face._indices[0] = i0;
+	face._indices[1] = i1;
+	face._indices[2] = i2;
+
+	const st_vec3f& w0 = vertices[i0]._w;
+	st_vec3f normal = st_vec3f_cross(vertices[i1]._w - w0, vertices[i2]._w - w0);
+	float length = normal.mag();
+	if (length > 0.0f)
+	{
+		face._normal = normal.scale_result(1.0f / length);
+		face._distance = face._normal.dot(w0);
+	}
+	else
+	{
+		// A sliver gives no direction. It keeps the polytope closed, but is never the nearest face.
+		face._normal = st_vec3f::zero_vector();
+		face._distance = FLT_MAX;
+	}
+	return true;
+}
+
+static int _st_epa_closest_face(const st_epa_face* faces, int face_count)
+{
+	int closest = 0;
+	for (int f = 1; f < face_count; ++f)
+	{
+		if (faces[f]._distance < faces[closest]._distance)
+		{
+			closest = f;
+		}
+	}
+	return closest;
+}
+
+/*
+** GJK can stop with fewer than four points when the origin lies on the
+** simplex. Search for points off it until there is a tetrahedron.
+*/
+static bool _st_epa_make_tetrahedron(const st_gjk_shape& a, const st_gjk_shape& b, st_gjk_vertex* vertices, int& count)
+{
+	if (count == 1)
+	{
+		static const st_vec3f k_axes[] =
+		{
+			{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f },
+		};
+		for (const st_vec3f& axis : k_axes)
+		{
+			st_gjk_vertex vertex = _st_gjk_support(a, b, axis);
+			if ((vertex._w - vertices[0]._w).mag2() > k_epa_degenerate_distance2)
+			{
+				vertices[count++] = vertex;
+				break;
+			}
+		}
+		if (count == 1)
+		{
+			return false;
+		}
+	}
+
+	if (count == 2)
+	{
+		// Turn a direction across the line about it, a sixth of a circle at a time.
+		st_vec3f line = vertices[1]._w - vertices[0]._w;
+		line.normalize();
+		st_vec3f axis = st_absf(line.x) < st_absf(line.y) ? st_vec3f::x_vector() : st_vec3f::y_vector();
+		st_vec3f across = st_vec3f_cross(line, axis).normal();
+		st_vec3f across_too = st_vec3f_cross(line, across);
+
+		for (int i = 0; i < 6; ++i)
+		{
+			float angle = float(i) * st_PI / 3.0f;
+			st_vec3f direction = across.scale_result(cosf(angle)) + across_too.scale_result(sinf(angle));
+
+			st_gjk_vertex vertex = _st_gjk_support(a, b, direction);
+			if (st_vec3f_cross(vertex._w - vertices[0]._w, line).mag2() > k_epa_degenerate_distance2)
+			{
+				vertices[count++] = vertex;
+				break;
+			}
+		}
+		if (count == 2)
+		{
+			return false;
+		}
+	}
+
+	if (count == 3)
+	{
+		st_vec3f normal = st_vec3f_cross(vertices[1]._w - vertices[0]._w, vertices[2]._w - vertices[0]._w).normal();
+		for (int side = 0; side < 2 && count == 3; ++side)
+		{
+			st_gjk_vertex vertex = _st_gjk_support(a, b, side == 0 ? normal : -normal);
+			float height = normal.dot(vertex._w - vertices[0]._w);
+			if (height * height > k_epa_degenerate_distance2)
+			{
+				vertices[count++] = vertex;
+			}
+		}
+		if (count == 3)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool st_epa_penetration(
+	const st_gjk_shape& a,
+	const st_gjk_shape& b,
+	const st_gjk_simplex& simplex,
+	st_vec3f& normal,
+	float& depth,
+	st_vec3f& point_a,
+	st_vec3f& point_b)
+{
+	st_gjk_vertex vertices[k_epa_max_vertices];
+	int vertex_count = simplex._count;
+	for (int i = 0; i < vertex_count; ++i)
+	{
+		vertices[i] = simplex._vertices[i];
+	}
+
+	if (!_st_epa_make_tetrahedron(a, b, vertices, vertex_count))
+	{
+		return false;
+	}
+
+	// Order the corners so that every face below winds outward.
+	const st_vec3f& w0 = vertices[0]._w;
+	if (st_vec3f_cross(vertices[1]._w - w0, vertices[2]._w - w0).dot(vertices[3]._w - w0) > 0.0f)
+	{
+		std::swap(vertices[1], vertices[2]);
+	}
+
+	st_epa_face faces[k_epa_max_faces];
+	int face_count = 0;
+	_st_epa_add_face(faces, face_count, vertices, 0, 1, 2);
+	_st_epa_add_face(faces, face_count, vertices, 0, 3, 1);
+	_st_epa_add_face(faces, face_count, vertices, 0, 2, 3);
+	_st_epa_add_face(faces, face_count, vertices, 1, 3, 2);
+
+	// The edges around the hole left by the faces a new point removes. Each face adds at most three.
+	int edges[k_epa_max_faces * 3][2];
+
+	for (int iteration = 0; iteration < k_epa_max_iterations && vertex_count < k_epa_max_vertices; ++iteration)
+	{
+		st_epa_face closest = faces[_st_epa_closest_face(faces, face_count)];
+		if (closest._distance == FLT_MAX)
+		{
+			return false;
+		}
+
+		// The surface reaches no further along the nearest face's normal than the face, so the face is on it.
+		st_gjk_vertex vertex = _st_gjk_support(a, b, closest._normal);
+		if (vertex._w.dot(closest._normal) - closest._distance <= k_epa_tolerance)
+		{
+			break;
+		}
+
+		int new_index = vertex_count;
+		vertices[vertex_count++] = vertex;
+
+		// Remove every face the new point can see. Edges shared by two of them are inside the hole.
+		int edge_count = 0;
+		for (int f = 0; f < face_count; )
+		{
+			const st_epa_face& face = faces[f];
+			if (face._normal.dot(vertex._w - vertices[face._indices[0]]._w) <= 0.0f)
+			{
+				++f;
+				continue;
+			}
+
+			for (int e = 0; e < 3; ++e)
+			{
+				int start = face._indices[e];
+				int end = face._indices[(e + 1) % 3];
+
+				bool is_shared = false;
+				for (int i = 0; i < edge_count; ++i)
+				{
+					if (edges[i][0] == end && edges[i][1] == start)
+					{
+						edges[i][0] = edges[edge_count - 1][0];
+						edges[i][1] = edges[edge_count - 1][1];
+						--edge_count;
+						is_shared = true;
+						break;
+					}
+				}
+
+				if (!is_shared)
+				{
+					edges[edge_count][0] = start;
+					edges[edge_count][1] = end;
+					++edge_count;
+				}
+			}
+
+			faces[f] = faces[--face_count];
+		}
+
+		// Close the hole with a fan of faces to the new point.
+		bool is_full = false;
+		for (int i = 0; i < edge_count && !is_full; ++i)
+		{
+			is_full = !_st_epa_add_face(faces, face_count, vertices, edges[i][0], edges[i][1], new_index);
+		}
+		if (is_full)
+		{
+			break;
+		}
+	}
+
+	const st_epa_face& face = faces[_st_epa_closest_face(faces, face_count)];
+	if (face._distance == FLT_MAX)
+	{
+		return false;
+	}
+
+	normal = face._normal;
+	depth = st_max(face._distance, 0.0f);
+
+	// Weight the corners of the face by where the origin projects onto it.
+	const st_gjk_vertex& v0 = vertices[face._indices[0]];
+	const st_gjk_vertex& v1 = vertices[face._indices[1]];
+	const st_gjk_vertex& v2 = vertices[face._indices[2]];
+	st_vec3f e0 = v1._w - v0._w;
+	st_vec3f e1 = v2._w - v0._w;
+	st_vec3f e2 = normal.scale_result(face._distance) - v0._w;
+
+	float d00 = e0.dot(e0);
+	float d01 = e0.dot(e1);
+	float d11 = e1.dot(e1);
+	float d20 = e2.dot(e0);
+	float d21 = e2.dot(e1);
+	float denominator = d00 * d11 - d01 * d01;
+
+	float u = 1.0f;
+	float v = 0.0f;
+	float w = 0.0f;
+	if (denominator > 0.0f)
+	{
+		v = (d11 * d20 - d01 * d21) / denominator;
+		w = (d00 * d21 - d01 * d20) / denominator;
+		u = 1.0f - v - w;
+	}
+
+	point_a = v0._a.scale_result(u) + v1._a.scale_result(v) + v2._a.scale_result(w);
+	point_b = v0._b.scale_result(u) + v1._b.scale_result(v) + v2._b.scale_result(w);
+	return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_shape.h"
+
+#include "math/st_affine3f.h"
+#include "math/st_mat3f.h"
+#include "math/st_vec3f.h"
+
+/*
+** A convex shape placed in the world, as GJK and EPA see it: a core found
+** through its support function, grown by a margin in every direction.
+**
+** Spheres are a single point grown by their radius, so EPA never has to
+** build a polytope around a curved surface. Everything the support function
+** needs from the transform is worked out once, when the shape is placed,
+** and each search after that only scans the shape itself.
+*/
+class st_gjk_shape
+{
+public:
+	st_gjk_shape(const st_shape* shape, const st_affine3f& transform);
+
+	/*
+	** Returns the point of the core farthest along a world space direction.
+	*/
+	st_vec3f support(const st_vec3f& direction) const;
+
+	// A point inside the core.
+	const st_vec3f& get_center() const { return _center; }
+	float get_margin() const { return _margin; }
+
+private:
+	const st_shape* _shape;
+	st_shape_t _type;
+
+	st_vec3f _center;
+	float _margin = 0.0f;
+
+	// World space half vectors of boxes, and the extents of axis-aligned boxes about their center.
+	st_vec3f _half_vectors[3];
+
+	// Hulls search in their own space, so only the direction is transformed rather than every point.
+	st_affine3f _transform;
+	st_mat3f _direction_to_local;
+};
+
+/*
+** A point of the Minkowski difference of two shapes, a - b, along with the
+** points of each shape it came from.
+*/
+struct st_gjk_vertex
+{
+	st_vec3f _a;
+	st_vec3f _b;
+	st_vec3f _w;
+};
+
+/*
+** The points GJK is working with. The point of the simplex closest to the
+** origin is the weighted sum of its vertices.
+*/
+struct st_gjk_simplex
+{
+	st_gjk_vertex _vertices[4];
+	float _weights[4];
+	int _count = 0;
+};
+
+/*
+** Find the closest points between the cores of two shapes.
+** @param simplex Left holding the simplex GJK stopped with, which EPA starts from when the cores overlap.
+** @returns The distance between the cores, or zero if they overlap.
+*/
+float st_gjk_distance(
+	const st_gjk_shape& a,
+	const st_gjk_shape& b,
+	st_gjk_simplex& simplex,
+	st_vec3f& point_a,
+	st_vec3f& point_b);
+
+/*
+** Find how deeply two overlapping cores penetrate, growing the simplex GJK
+** stopped with into a polytope until it meets the surface of the Minkowski
+** difference.
+** @param normal The direction b must move to separate the cores, from a toward b.
+** @param point_a, point_b The deepest point of each core in the other.
+** @returns False if the Minkowski difference is too flat to hold a polytope.
+*/
+bool st_epa_penetration(
+	const st_gjk_shape& a,
+	const st_gjk_shape& b,
+	const st_gjk_simplex& simplex,
+	st_vec3f& normal,
+	float& depth,
+	st_vec3f& point_a,
+	st_vec3f& point_b);
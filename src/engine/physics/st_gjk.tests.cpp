@@ -0,0 +1,280 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_gjk.tests.h"
+#include "st_gjk.h"
+#include "st_intersection.h"
+
+#include "st_shape.h"
+
+#include "math/st_math.h"
+#include "math/st_quatf.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <cfloat>
+#include <vector>
+
+static st_test_random _st_gjk_test_random(0x9e3779b9);
+
+static st_affine3f _st_gjk_test_random_transform()
+{
+	st_vec3f axis = { _st_gjk_test_random.next(-1.0f, 1.0f), _st_gjk_test_random.next(-1.0f, 1.0f), _st_gjk_test_random.next(-1.0f, 1.0f) };
+	axis.normalize();
+	st_quatf rotation;
+	rotation.make_axis_angle(axis, _st_gjk_test_random.next(-st_PI, st_PI));
+
+	st_affine3f transform;
+	transform.make_rotation(rotation);
+	transform.set_translation({ _st_gjk_test_random.next(-1.5f, 1.5f), _st_gjk_test_random.next(-1.5f, 1.5f), _st_gjk_test_random.next(-1.5f, 1.5f) });
+	return transform;
+}
+
+/*
+** How far the points of a reach past the points of b along an axis.
+*/
+static float _st_gjk_test_reach(const std::vector<st_vec3f>& a, const std::vector<st_vec3f>& b, const st_vec3f& axis)
+{
+	float max_a = -FLT_MAX;
+	float min_b = FLT_MAX;
+	for (const st_vec3f& point : a)
+	{
+		max_a = st_max(max_a, point.dot(axis));
+	}
+	for (const st_vec3f& point : b)
+	{
+		min_b = st_min(min_b, point.dot(axis));
+	}
+	return max_a - min_b;
+}
+
+/*
+** Penetration depth of the hulls of two point sets, by brute force SAT.
+** Every face of the Minkowski difference has the normal of a triangle of
+** points from one set, or of a pair of edges between points from each, so
+** the least overlap over all of those axes is the depth. Negative if apart.
+*/
+static float _st_gjk_test_brute_force_depth(const std::vector<st_vec3f>& a, const std::vector<st_vec3f>& b)
+{
+	float depth = FLT_MAX;
+	auto test_axis = [&](st_vec3f axis)
+	{
+		float length2 = axis.mag2();
+		if (length2 < 1.0e-10f)
+		{
+			return;
+		}
+		axis.scale(1.0f / st_sqrtf(length2));
+		depth = st_min(depth, st_min(_st_gjk_test_reach(a, b, axis), _st_gjk_test_reach(b, a, axis)));
+	};
+
+	for (const std::vector<st_vec3f>* points : { &a, &b })
+	{
+		const std::vector<st_vec3f>& p = *points;
+		for (size_t i = 0; i < p.size(); ++i)
+		{
+			for (size_t j = i + 1; j < p.size(); ++j)
+			{
+				for (size_t k = j + 1; k < p.size(); ++k)
+				{
+					test_axis(st_vec3f_cross(p[j] - p[i], p[k] - p[i]));
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		for (size_t j = i + 1; j < a.size(); ++j)
+		{
+			for (size_t k = 0; k < b.size(); ++k)
+			{
+				for (size_t l = k + 1; l < b.size(); ++l)
+				{
+					test_axis(st_vec3f_cross(a[j] - a[i], b[l] - b[k]));
+				}
+			}
+		}
+	}
+
+	return depth;
+}
+
+static void _st_gjk_test_random_hull(st_convex_hull& hull, const st_affine3f& transform, std::vector<st_vec3f>& world_points)
+{
+	std::vector<st_vec3f> positions;
+	int count = 6 + int(_st_gjk_test_random.next(0.0f, 5.0f));
+	for (int i = 0; i < count; ++i)
+	{
+		st_vec3f direction = { _st_gjk_test_random.next(-1.0f, 1.0f), _st_gjk_test_random.next(-1.0f, 1.0f), _st_gjk_test_random.next(-1.0f, 1.0f) };
+		direction.normalize();
+		positions.push_back(direction.scale_result(_st_gjk_test_random.next(0.4f, 1.0f)));
+	}
+	hull.set_positions(positions);
+
+	world_points.clear();
+	for (const st_vec3f& position : positions)
+	{
+		world_points.push_back(transform.transform_point(position));
+	}
+}
+
+static void _st_gjk_test_random_oobb(st_oobb& oobb, const st_affine3f& transform, std::vector<st_vec3f>& world_points)
+{
+	oobb._center = st_vec3f::zero_vector();
+	oobb._half_vectors[0] = { _st_gjk_test_random.next(0.2f, 1.0f), 0.0f, 0.0f };
+	oobb._half_vectors[1] = { 0.0f, _st_gjk_test_random.next(0.2f, 1.0f), 0.0f };
+	oobb._half_vectors[2] = { 0.0f, 0.0f, _st_gjk_test_random.next(0.2f, 1.0f) };
+
+	std::vector<st_vec3f> corners;
+	oobb.get_corners(corners);
+
+	world_points.clear();
+	for (const st_vec3f& corner : corners)
+	{
+		world_points.push_back(transform.transform_point(corner));
+	}
+}
+
+/*
+** Check gjk against the brute force depth of the same shapes as point sets.
+** Returns true if the pair was overlapping.
+*/
+static bool _st_gjk_test_against_brute_force(
+	const st_shape* a,
+	const st_affine3f& transform_a,
+	const std::vector<st_vec3f>& points_a,
+	const st_shape* b,
+	const st_affine3f& transform_b,
+	const std::vector<st_vec3f>& points_b)
+{
+	// EPA stops within a tenth of a millimeter; allow for rounding on top of that.
+	const float k_tolerance = 2.0e-3f;
+
+	float expected = _st_gjk_test_brute_force_depth(points_a, points_b);
+
+	st_collision_info info;
+	bool collision = gjk(a, transform_a, b, transform_b, &info);
+
+	// Shapes only just touching could fairly go either way.
+	if (st_absf(expected) < k_tolerance)
+	{
+		return false;
+	}
+
+	assert(collision == (expected > 0.0f));
+	if (!collision)
+	{
+		return false;
+	}
+
+	assert(st_absf(info._penetration - expected) < k_tolerance);
+
+	// The normal points from a to b, and moving b along it by the penetration separates them.
+	assert(st_equalf(info._normal.mag(), 1.0f));
+	assert(st_absf(_st_gjk_test_reach(points_a, points_b, info._normal) - expected) < k_tolerance);
+
+	// The point lies midway through the overlap along the normal.
+	float reach_a = -FLT_MAX;
+	for (const st_vec3f& point : points_a)
+	{
+		reach_a = st_max(reach_a, point.dot(info._normal));
+	}
+	assert(st_absf(info._point.dot(info._normal) - (reach_a - 0.5f * expected)) < k_tolerance);
+
+	return true;
+}
+
+void st_gjk_unit_tests()
+{
+	const int k_fuzz_count = 300;
+
+	// Fuzz convex hulls and boxes against brute force SAT.
+	{
+		int overlapping = 0;
+		for (int i = 0; i < k_fuzz_count; ++i)
+		{
+			st_affine3f transform_a = _st_gjk_test_random_transform();
+			st_affine3f transform_b = _st_gjk_test_random_transform();
+			std::vector<st_vec3f> points_a;
+			std::vector<st_vec3f> points_b;
+
+			st_convex_hull hull_a;
+			st_convex_hull hull_b;
+			_st_gjk_test_random_hull(hull_a, transform_a, points_a);
+			_st_gjk_test_random_hull(hull_b, transform_b, points_b);
+			overlapping += _st_gjk_test_against_brute_force(&hull_a, transform_a, points_a, &hull_b, transform_b, points_b) ? 1 : 0;
+
+			st_oobb oobb;
+			_st_gjk_test_random_oobb(oobb, transform_b, points_b);
+			overlapping += _st_gjk_test_against_brute_force(&hull_a, transform_a, points_a, &oobb, transform_b, points_b) ? 1 : 0;
+			overlapping += _st_gjk_test_against_brute_force(&oobb, transform_b, points_b, &hull_a, transform_a, points_a) ? 1 : 0;
+		}
+
+		// The fuzzing covers both outcomes.
+		assert(overlapping > k_fuzz_count / 4 && overlapping < 3 * k_fuzz_count - k_fuzz_count / 4);
+	}
+
+	// Test a sphere against a box, separate, overlapping its surface, and with its center inside.
+	{
+		st_sphere sphere;
+		sphere._center = st_vec3f::zero_vector();
+		sphere._radius = 0.5f;
+
+		st_oobb oobb;
+		oobb._center = st_vec3f::zero_vector();
+		oobb._half_vectors[0] = { 1.0f, 0.0f, 0.0f };
+		oobb._half_vectors[1] = { 0.0f, 1.0f, 0.0f };
+		oobb._half_vectors[2] = { 0.0f, 0.0f, 1.0f };
+
+		st_affine3f trans_sphere, trans_oobb;
+		trans_sphere.make_translation({ 0.0f, 1.6f, 0.0f });
+		trans_oobb.make_identity();
+
+		st_collision_info info;
+		bool collision = gjk(&sphere, trans_sphere, &oobb, trans_oobb, &info);
+		assert(!collision);
+
+		trans_sphere.make_translation({ 0.0f, 1.3f, 0.0f });
+		collision = gjk(&sphere, trans_sphere, &oobb, trans_oobb, &info);
+		assert(collision);
+		assert(info._normal.equal({ 0.0f, -1.0f, 0.0f }));
+		assert(st_equalf(info._penetration, 0.2f));
+		assert(info._point.equal({ 0.0f, 0.9f, 0.0f }));
+
+		trans_sphere.make_translation({ 0.0f, 0.8f, 0.0f });
+		collision = gjk(&oobb, trans_oobb, &sphere, trans_sphere, &info);
+		assert(collision);
+		assert(info._normal.equal({ 0.0f, 1.0f, 0.0f }));
+		assert(st_equalf(info._penetration, 0.7f));
+	}
+
+	// Test a hull against a plane.
+	{
+		st_convex_hull hull;
+		hull.set_positions({ { -1.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } });
+
+		st_plane plane;
+		plane._point = st_vec3f::zero_vector();
+		plane._normal = st_vec3f::y_vector();
+
+		st_affine3f trans_hull, trans_plane;
+		trans_hull.make_translation({ 0.0f, 0.75f, 0.0f });
+		trans_plane.make_identity();
+
+		st_collision_info info;
+		bool collision = convex_vs_plane(&hull, trans_hull, &plane, trans_plane, &info);
+		assert(collision);
+		assert(info._normal.equal({ 0.0f, -1.0f, 0.0f }));
+		assert(st_equalf(info._penetration, 0.25f));
+		assert(info._point.equal({ 0.0f, -0.125f, 0.0f }));
+
+		trans_hull.make_translation({ 0.0f, 1.25f, 0.0f });
+		collision = convex_vs_plane(&plane, trans_plane, &hull, trans_hull, &info);
+		assert(!collision);
+	}
+}
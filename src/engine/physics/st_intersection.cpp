@@ -6,6 +6,7 @@
 
 #include "st_intersection.h"
 
+#include "st_gjk.h"
 #include "st_shape.h"
 
 #include <cassert>
@@ -73,13 +74,19 @@ st_vec3f farthest_along_vector(const std::vector<st_vec3f>& points, const st_vec
 	return best;
 }
 
-bool intersection_unimplemented(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+st_vec3f farthest_along_vector(const st_vec3f_soa& points, const st_vec3f& vector)
+{
+	int index = st_vec3f_soa_farthest(points, vector);
+	return index >= 0 ? points.get(index) : st_vec3f::zero_vector();
+}
+
+bool intersection_unimplemented(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
 	assert(false);
 	return false;
 }
 
-bool sphere_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+bool sphere_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
 	// Figure out which shape is which.
 	st_sphere sphere;
@@ -104,10 +111,52 @@ bool sphere_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_sh
 
 	float distance = distance_to_plane(sphere._center, &plane);
 
-	return distance < sphere._radius;
+	bool collision = distance < sphere._radius;
+	if (collision)
+	{
+		info->_penetration = sphere._radius - distance;
+		info->_normal = a->get_type() == k_shape_sphere ? -plane._normal : plane._normal;
+
+		// Midway between the deepest point of the sphere and the plane.
+		info->_point = sphere._center - plane._normal.scale_result(0.5f * (sphere._radius + distance));
+	}
+
+	return collision;
+}
+
+bool convex_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
+{
+	// Figure out which shape is which.
+	bool is_plane_a = a->get_type() == k_shape_plane;
+	const st_affine3f& plane_transform = is_plane_a ? transform_a : transform_b;
+
+	st_plane plane = *reinterpret_cast<const st_plane*>(is_plane_a ? a : b);
+	plane._normal = plane_transform.transform_vector(plane._normal);
+	plane._point += plane_transform.get_translation();
+
+	st_gjk_shape convex(is_plane_a ? b : a, is_plane_a ? transform_b : transform_a);
+
+	// The deepest point of the shape is the one farthest against the plane's normal.
+	st_vec3f deepest = convex.support(-plane._normal) - plane._normal.scale_result(convex.get_margin());
+	float distance = distance_to_plane(deepest, &plane);
+
+	bool collision = distance < 0.0f;
+	if (collision)
+	{
+		info->_penetration = -distance;
+		info->_normal = is_plane_a ? plane._normal : -plane._normal;
+		info->_point = deepest + plane._normal.scale_result(0.5f * info->_penetration);
+	}
+
+	return collision;
 }
 
-bool oobb_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+bool plane_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
+{
+	return false;
+}
+
+bool oobb_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
 	// Figure out which shape is which.
 	st_oobb oobb;
@@ -149,7 +198,7 @@ bool oobb_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_shap
 	if (collision)
 	{
 		info->_penetration = radius - distance;
-		info->_normal = plane._normal;
+		info->_normal = a->get_type() == k_shape_oobb ? -plane._normal : plane._normal;
 
 		const int32_t k_num_corners = 8;
 		// We can find the collision point by finding the point penetrating farthest into the plane.
@@ -194,13 +243,13 @@ bool oobb_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_shap
 		}
 		average.scale(1.0f / static_cast<float>(max_corners.size()));
 
-		info->_point = average + info->_normal.scale_result(info->_penetration);
+		info->_point = average + plane._normal.scale_result(0.5f * info->_penetration);
 	}
 
 	return collision;
 }
 
-bool sphere_vs_sphere(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+bool sphere_vs_sphere(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
 	const st_sphere* sphere_a = reinterpret_cast<const st_sphere*>(a);
 	const st_sphere* sphere_b = reinterpret_cast<const st_sphere*>(b);
@@ -208,16 +257,31 @@ bool sphere_vs_sphere(const st_shape* a, const st_mat4f& transform_a, const st_s
 	st_vec3f center_a = sphere_a->_center + transform_a.get_translation();
 	st_vec3f center_b = sphere_b->_center + transform_b.get_translation();
 
-	float radii2 = powf(sphere_a->_radius + sphere_b->_radius, 2.0f);
-	return center_a.dist2(center_b) < radii2;
+	float radii = sphere_a->_radius + sphere_b->_radius;
+	float distance2 = center_a.dist2(center_b);
+
+	bool collision = distance2 < radii * radii;
+	if (collision)
+	{
+		float distance = sqrtf(distance2);
+
+		// Concentric spheres have no preferred direction; push them apart vertically.
+		info->_normal = distance > 0.0f ? (center_b - center_a).scale_result(1.0f / distance) : st_vec3f::y_vector();
+		info->_penetration = radii - distance;
+
+		float offset = sphere_a->_radius - 0.5f * info->_penetration;
+		info->_point = center_a + info->_normal.scale_result(offset);
+	}
+
+	return collision;
 }
 
-bool capsule_vs_capsule(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+bool capsule_vs_capsule(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
 	return false;
 }
 
-bool aabb_vs_aabb(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+bool aabb_vs_aabb(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
 	const st_aabb* aabb_a = reinterpret_cast<const st_aabb*>(a);
 	const st_aabb* aabb_b = reinterpret_cast<const st_aabb*>(b);
@@ -231,6 +295,30 @@ bool aabb_vs_aabb(const st_shape* a, const st_mat4f& transform_a, const st_shape
 	bool collide = !((min_a.x > max_b.x || max_a.x < min_b.x) ||
 					 (min_a.y > max_b.y || max_a.y < min_b.y) ||
 					 (min_a.z > max_b.z || max_a.z < min_b.z));
+	if (collide)
+	{
+		// Push apart along the axis that overlaps least.
+		st_vec3f overlap_min = { st_max(min_a.x, min_b.x), st_max(min_a.y, min_b.y), st_max(min_a.z, min_b.z) };
+		st_vec3f overlap_max = { st_min(max_a.x, max_b.x), st_min(max_a.y, max_b.y), st_min(max_a.z, max_b.z) };
+		st_vec3f overlap = overlap_max - overlap_min;
+
+		int axis = 0;
+		for (int i = 1; i < 3; ++i)
+		{
+			if (overlap.axes[i] < overlap.axes[axis])
+			{
+				axis = i;
+			}
+		}
+
+		st_vec3f a_to_b = (min_b + max_b) - (min_a + max_a);
+		info->_normal = st_vec3f::zero_vector();
+		info->_normal.axes[axis] = a_to_b.axes[axis] < 0.0f ? -1.0f : 1.0f;
+		info->_penetration = overlap.axes[axis];
+
+		// The middle of the overlap lies midway between the faces along the normal.
+		info->_point = (overlap_min + overlap_max).scale_result(0.5f);
+	}
 	return collide;
 }
 
@@ -346,23 +434,27 @@ st_vec3f separating_axis_point_of_collision(const st_oobb* oobb_a, const st_oobb
 	return point_of_intersection;
 }
 
-bool separating_axis_test(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+/*
+** A box's shape moved into world space.
+*/
+static st_oobb _st_oobb_to_world(const st_shape* shape, const st_affine3f& transform)
+{
+	st_oobb oobb = *reinterpret_cast<const st_oobb*>(shape);
+	oobb._center += transform.get_translation();
+	oobb._half_vectors[0] = transform.transform_vector(oobb._half_vectors[0]);
+	oobb._half_vectors[1] = transform.transform_vector(oobb._half_vectors[1]);
+	oobb._half_vectors[2] = transform.transform_vector(oobb._half_vectors[2]);
+	return oobb;
+}
+
+/*
+** Find the axis of least overlap between two boxes in world space.
+** Indices below 3 are a's face axes, below 6 b's, and the rest edge crosses.
+** @returns False if some axis separates the boxes.
+*/
+static bool _st_separating_axis(const st_oobb& oobb_a, const st_oobb& oobb_b, st_vec3f& min_penetration_axis, float& min_penetration, uint32_t& min_penetration_index)
 {
-	bool collision = true;
 	std::vector<st_vec3f> axes;
-	st_oobb oobb_a, oobb_b;
-
-	oobb_a = *reinterpret_cast<const st_oobb*>(a);
-	oobb_a._center += transform_a.get_translation();
-	oobb_a._half_vectors[0] = transform_a.transform_vector(oobb_a._half_vectors[0]);
-	oobb_a._half_vectors[1] = transform_a.transform_vector(oobb_a._half_vectors[1]);
-	oobb_a._half_vectors[2] = transform_a.transform_vector(oobb_a._half_vectors[2]);
-
-	oobb_b = *reinterpret_cast<const st_oobb*>(b);
-	oobb_b._center += transform_b.get_translation();
-	oobb_b._half_vectors[0] = transform_b.transform_vector(oobb_b._half_vectors[0]);
-	oobb_b._half_vectors[1] = transform_b.transform_vector(oobb_b._half_vectors[1]);
-	oobb_b._half_vectors[2] = transform_b.transform_vector(oobb_b._half_vectors[2]);
 
 	// The axes we need to check are the primary axes of each oriented box.
 	axes.push_back(oobb_a._half_vectors[0]);
@@ -381,14 +473,22 @@ bool separating_axis_test(const st_shape* a, const st_mat4f& transform_a, const
 		}
 	}
 
-	float min_penetration = FLT_MAX;
-	st_vec3f min_penetration_axis;
-	uint32_t min_penetration_index = INT_MAX;
+	min_penetration = FLT_MAX;
+	min_penetration_index = INT_MAX;
+
+	// Edges that are parallel, or nearly so, give no usable axis.
+	const float k_min_axis_length2 = 1.0e-8f;
+	// How much less overlap a later axis needs to be chosen over an earlier one.
+	const float k_axis_tolerance = 1.0e-3f;
 
 	for (uint32_t i = 0; i < axes.size(); ++i)
 	{
 		st_vec3f axis = axes[i];
-		axis.normalize();
+		if (axis.mag2() < k_min_axis_length2)
+		{
+			continue;
+		}
+		axis.normalize_fast();
 
 		// Project the half vectors to get half the projected shape.
 		// We use absolution value projection otherwise one projection may subtract from the half projection.
@@ -414,12 +514,16 @@ bool separating_axis_test(const st_shape* a, const st_mat4f& transform_a, const
 
 		if (penetration < 0.0f)
 		{
-			collision = false;
-			break;
+			return false;
 		}
 
-		// Update the minimum penetration value.
-		if (penetration < min_penetration)
+		/*
+		** Update the minimum penetration value. Faces nearly parallel give
+		** nearly equal overlaps along both boxes' axes and the edges crossed,
+		** so a later axis has to win clearly, or the choice flips from step to
+		** step as the boxes rock.
+		*/
+		if (penetration + k_axis_tolerance < min_penetration || min_penetration_index == INT_MAX)
 		{
 			min_penetration = penetration;
 			min_penetration_axis = axis;
@@ -427,111 +531,297 @@ bool separating_axis_test(const st_shape* a, const st_mat4f& transform_a, const
 		} 
 	}
 
-	if (collision && min_penetration_index < INT_MAX)
+	// The normal of the collision is the axis of minimum penetration, pointing from a to b.
+	if (min_penetration_index < INT_MAX && min_penetration_axis.dot(oobb_b._center - oobb_a._center) < 0.0f)
+	{
+		min_penetration_axis = -min_penetration_axis;
+	}
+
+	return min_penetration_index < INT_MAX;
+}
+
+bool separating_axis_test(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
+{
+	st_oobb oobb_a = _st_oobb_to_world(a, transform_a);
+	st_oobb oobb_b = _st_oobb_to_world(b, transform_b);
+
+	st_vec3f min_penetration_axis;
+	float min_penetration;
+	uint32_t min_penetration_index;
+	bool collision = _st_separating_axis(oobb_a, oobb_b, min_penetration_axis, min_penetration, min_penetration_index);
+
+	if (collision)
 	{
-		// The normal of the collision is the axis of minimum penetration.
 		info->_normal = min_penetration_axis;
 		info->_penetration = min_penetration;
 		info->_point = separating_axis_point_of_collision(&oobb_a, &oobb_b, min_penetration_index);
+
+		// Face contacts find the corners of one box; move them halfway to the other's face.
+		if (min_penetration_index < 3)
+		{
+			info->_point += min_penetration_axis.scale_result(0.5f * min_penetration);
+		}
+		else if (min_penetration_index < 6)
+		{
+			info->_point -= min_penetration_axis.scale_result(0.5f * min_penetration);
+		}
 	}
 
 	return collision;
 }
 
-st_vec3f gjk_support(const st_convex_hull* hull, const st_vec3f& dir)
+/*
+** Clip a convex polygon to the side of a plane its normal points away from.
+** The output may hold one more point than the input.
+*/
+static int _st_clip_polygon(const st_vec3f* points, int point_count, const st_vec3f& normal, float offset, st_vec3f* clipped)
 {
-	float max_dot = -FLT_MAX;
-	st_vec3f best;
-
-	for (uint32_t i = 0; i < hull->_positions.size(); ++i)
+	int clipped_count = 0;
+	for (int i = 0; i < point_count; ++i)
 	{
-		st_vec3f point = hull->_positions[i];
-		if (point.dot(dir) > max_dot)
+		const st_vec3f& start = points[i];
+		const st_vec3f& end = points[(i + 1) % point_count];
+		float start_distance = start.dot(normal) - offset;
+		float end_distance = end.dot(normal) - offset;
+
+		if (start_distance <= 0.0f)
 		{
-			max_dot = point.dot(dir);
-			best = point;
+			clipped[clipped_count++] = start;
+		}
+		if ((start_distance < 0.0f && end_distance > 0.0f) || (start_distance > 0.0f && end_distance < 0.0f))
+		{
+			clipped[clipped_count++] = start + (end - start).scale_result(start_distance / (start_distance - end_distance));
 		}
 	}
-
-	return best;
+	return clipped_count;
 }
 
-bool gjk_internal(
-	const st_convex_hull* a,
-	const st_convex_hull* b,
-	std::vector<st_vec3f>& simplex)
+/*
+** Cut a patch down to the four points that span it best: the deepest, the
+** farthest from it, the one making the widest triangle with those, and the
+** one adding the most across from the third.
+*/
+static int _st_reduce_patch(st_collision_info* points, int point_count)
 {
-	while (true)
+	if (point_count <= 4)
 	{
-		float distance_to_simplex = FLT_MAX;
-		st_vec3f new_point;
+		return point_count;
+	}
 
-		if (simplex.size() == 0)
+	int chosen[4] = { 0, 0, 0, -1 };
+	for (int i = 1; i < point_count; ++i)
+	{
+		if (points[i]._penetration > points[chosen[0]]._penetration)
 		{
-			// Start by picking an arbitrary direction.
-			st_vec3f dir = st_vec3f::x_vector();
-			new_point = gjk_support(a, dir) - gjk_support(b, -dir);
-			simplex.push_back(new_point);
+			chosen[0] = i;
 		}
-		else if (simplex.size() == 1)
+	}
+
+	const st_vec3f& a = points[chosen[0]]._point;
+	float best = -1.0f;
+	for (int i = 0; i < point_count; ++i)
+	{
+		float distance2 = (points[i]._point - a).mag2();
+		if (distance2 > best)
 		{
-			// Pick the direction from the point to the origin.
-			st_vec3f dir = -simplex[0];
-			new_point = gjk_support(a, dir) - gjk_support(b, -dir);
-			distance_to_simplex = (simplex[0] - new_point).mag();
+			chosen[1] = i;
+			best = distance2;
 		}
-		else if (simplex.size() == 2)
+	}
+
+	const st_vec3f ab = points[chosen[1]]._point - a;
+	st_vec3f side = st_vec3f::zero_vector();
+	best = -1.0f;
+	for (int i = 0; i < point_count; ++i)
+	{
+		st_vec3f cross = st_vec3f_cross(ab, points[i]._point - a);
+		if (cross.mag2() > best)
 		{
-			float dist_to_line = distance_to_line_segment({0.0f, 0.0f, 0.0f}, simplex[0], simplex[1]);
-			float dist_a = simplex[0].mag();
-			float dist_b = simplex[1].mag();
+			chosen[2] = i;
+			side = cross;
+			best = cross.mag2();
+		}
+	}
 
-			if (dist_to_line < dist_a && dist_to_line < dist_b)
-			{
-				// TODO: Direction is perpendicular to line in direction of origin.
-			}
-			else
-			{
-				// TODO: The farther point is deleted, then continue.
-			}
+	best = 0.0f;
+	for (int i = 0; i < point_count; ++i)
+	{
+		float across = -st_vec3f_cross(ab, points[i]._point - a).dot(side);
+		if (across > best)
+		{
+			chosen[3] = i;
+			best = across;
 		}
-		else if (simplex.size() == 3)
+	}
+
+	st_collision_info reduced[4];
+	int reduced_count = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (chosen[i] >= 0)
 		{
-			// TODO: Triangle case.
+			reduced[reduced_count++] = points[chosen[i]];
 		}
-		else
+	}
+	for (int i = 0; i < reduced_count; ++i)
+	{
+		points[i] = reduced[i];
+	}
+	return reduced_count;
+}
+
+int oobb_vs_oobb_patch(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* points)
+{
+	st_oobb oobb_a = _st_oobb_to_world(a, transform_a);
+	st_oobb oobb_b = _st_oobb_to_world(b, transform_b);
+
+	st_vec3f normal;
+	float penetration;
+	uint32_t index;
+	if (!_st_separating_axis(oobb_a, oobb_b, normal, penetration, index))
+	{
+		return 0;
+	}
+
+	// Edges crossing touch at a single point.
+	if (index >= 6)
+	{
+		return separating_axis_test(a, transform_a, b, transform_b, points) ? 1 : 0;
+	}
+
+	// The face the normal came from is the reference face. Whichever face of the other box faces it most squarely is clipped to it.
+	const st_oobb& reference = index < 3 ? oobb_a : oobb_b;
+	const st_oobb& incident = index < 3 ? oobb_b : oobb_a;
+	const st_vec3f reference_normal = index < 3 ? normal : -normal;
+	const uint32_t reference_axis = index % 3;
+
+	uint32_t incident_axis = 0;
+	float incident_dot = 0.0f;
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		float dot = incident._half_vectors[i].dot(reference_normal) / incident._half_vectors[i].mag();
+		if (st_absf(dot) > st_absf(incident_dot))
 		{
-			// TODO: Tetrahedron case.
+			incident_axis = i;
+			incident_dot = dot;
 		}
+	}
+
+	const st_vec3f& side_u = incident._half_vectors[(incident_axis + 1) % 3];
+	const st_vec3f& side_v = incident._half_vectors[(incident_axis + 2) % 3];
+	const st_vec3f incident_center = incident_dot > 0.0f ?
+		incident._center - incident._half_vectors[incident_axis] :
+		incident._center + incident._half_vectors[incident_axis];
+
+	const int k_max_clipped = 8;
+	st_vec3f polygon[k_max_clipped] =
+	{
+		incident_center + side_u + side_v,
+		incident_center + side_u - side_v,
+		incident_center - side_u - side_v,
+		incident_center - side_u + side_v,
+	};
+	int polygon_count = 4;
+
+	// Clip to the four sides of the reference face.
+	for (uint32_t i = 1; i < 3; ++i)
+	{
+		const st_vec3f& side = reference._half_vectors[(reference_axis + i) % 3];
+		st_vec3f side_normal = side.normal();
+		float extent = side.mag();
+		float center = reference._center.dot(side_normal);
+
+		st_vec3f clipped[k_max_clipped];
+		polygon_count = _st_clip_polygon(polygon, polygon_count, side_normal, center + extent, clipped);
+		polygon_count = _st_clip_polygon(clipped, polygon_count, -side_normal, extent - center, polygon);
+	}
 
-		if (new_point.mag() > distance_to_simplex)
+	// Keep the points below the reference face, halfway between them and the face.
+	float face = reference._center.dot(reference_normal) + reference._half_vectors[reference_axis].mag();
+	int point_count = 0;
+	for (int i = 0; i < polygon_count; ++i)
+	{
+		float depth = face - polygon[i].dot(reference_normal);
+		if (depth >= 0.0f)
 		{
-			return false;
+			points[point_count]._normal = normal;
+			points[point_count]._penetration = depth;
+			points[point_count]._point = polygon[i] + reference_normal.scale_result(0.5f * depth);
+			++point_count;
 		}
-		simplex.push_back(new_point);
 	}
 
-	return false;
+	// Clipping leaves nothing when the boxes only just overlap at the face's rim.
+	if (point_count == 0)
+	{
+		return separating_axis_test(a, transform_a, b, transform_b, points) ? 1 : 0;
+	}
+	return _st_reduce_patch(points, point_count);
+}
+
+int oobb_vs_plane_patch(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* points)
+{
+	bool oobb_is_a = a->get_type() == k_shape_oobb;
+	st_oobb oobb = oobb_is_a ? _st_oobb_to_world(a, transform_a) : _st_oobb_to_world(b, transform_b);
+
+	st_plane plane = *reinterpret_cast<const st_plane*>(oobb_is_a ? b : a);
+	const st_affine3f& plane_transform = oobb_is_a ? transform_b : transform_a;
+	plane._normal = plane_transform.transform_vector(plane._normal);
+	plane._point += plane_transform.get_translation();
+
+	// Every corner below the plane touches it.
+	std::vector<st_vec3f> corners;
+	oobb.get_corners(corners);
+
+	int point_count = 0;
+	for (const st_vec3f& corner : corners)
+	{
+		float depth = -distance_to_plane(corner, &plane);
+		if (depth > 0.0f)
+		{
+			points[point_count]._normal = oobb_is_a ? -plane._normal : plane._normal;
+			points[point_count]._penetration = depth;
+			points[point_count]._point = corner + plane._normal.scale_result(0.5f * depth);
+			++point_count;
+		}
+	}
+	return _st_reduce_patch(points, point_count);
 }
 
-bool gjk(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info)
+bool gjk(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info)
 {
-	st_convex_hull hull_a = *reinterpret_cast<const st_convex_hull*>(a);
-	st_convex_hull hull_b = *reinterpret_cast<const st_convex_hull*>(b);
+	st_gjk_shape shape_a(a, transform_a);
+	st_gjk_shape shape_b(b, transform_b);
+	float margin = shape_a.get_margin() + shape_b.get_margin();
+
+	st_gjk_simplex simplex;
+	st_vec3f point_a;
+	st_vec3f point_b;
+	float distance = st_gjk_distance(shape_a, shape_b, simplex, point_a, point_b);
+	if (distance > 0.0f && distance >= margin)
+	{
+		return false;
+	}
 
-	// Transform all of the positions into world space.
-	for (uint32_t i = 0; i < hull_a._positions.size(); ++i)
+	st_vec3f normal;
+	float depth;
+	if (distance > 0.0f)
 	{
-		st_vec3f point = hull_a._positions[i];
-		hull_a._positions[i] = transform_a.transform_vector(point);
+		// Only the margins overlap, so the closest points of the cores give the contact.
+		normal = (point_b - point_a).scale_result(1.0f / distance);
+		depth = -distance;
 	}
-	for (uint32_t i = 0; i < hull_b._positions.size(); ++i)
+	else if (!st_epa_penetration(shape_a, shape_b, simplex, normal, depth, point_a, point_b))
 	{
-		st_vec3f point = hull_b._positions[i];
-		hull_b._positions[i] = transform_b.transform_vector(point);
+		return false;
 	}
 
-	// Create a new simplex structure, empty initially.
-	std::vector<st_vec3f> simplex;
-	return gjk_internal(&hull_a, &hull_b, simplex);
+	// Grow the points on each core out to the surface of its shape.
+	st_vec3f surface_a = point_a + normal.scale_result(shape_a.get_margin());
+	st_vec3f surface_b = point_b - normal.scale_result(shape_b.get_margin());
+
+	info->_normal = normal;
+	info->_penetration = depth + margin;
+	info->_point = (surface_a + surface_b).scale_result(0.5f);
+	return true;
 }
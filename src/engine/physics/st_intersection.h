@@ -6,8 +6,9 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "math/st_mat4f.h"
+#include "math/st_affine3f.h"
 #include "math/st_vec3f.h"
+#include "math/st_vec3f_soa.h"
 
 #include <vector>
 
@@ -19,6 +20,10 @@ class st_rigid_body;
 ** Information returned when a collision is detected.
 ** Includes the point of collision, the normal at the collision point, and
 ** the amount the two objects are interpenetrating.
+**
+** The normal points from the first shape toward the second, and the point
+** lies midway between the deepest points of the two shapes, so the shapes'
+** surfaces are half the penetration to either side of it along the normal.
 */
 struct st_collision_info
 {
@@ -54,42 +59,78 @@ bool closest_points_on_lines(
 */
 st_vec3f farthest_along_vector(const std::vector<st_vec3f>& points, const st_vec3f& vector);
 
+/*
+** Compute the point farthest along a directional vector, searching several points at a time.
+*/
+st_vec3f farthest_along_vector(const st_vec3f_soa& points, const st_vec3f& vector);
+
 /*
 ** Stub function for unimplemented collision algorithms.
 */
-bool intersection_unimplemented(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool intersection_unimplemented(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 /*
 ** Check for a collision between sphere and plane.
 */
-bool sphere_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool sphere_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
+
+/*
+** Check for a collision between any convex shape and a plane, through the
+** shape's deepest point.
+*/
+bool convex_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
+
+/*
+** Planes are unbounded and only ever static, so two never report contact.
+*/
+bool plane_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 /*
 ** Check for a collision between bounding box and plane.
 */
-bool oobb_vs_plane(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool oobb_vs_plane(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 /*
 ** Check for a collision between two sphere shapes.
 */
-bool sphere_vs_sphere(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool sphere_vs_sphere(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 /*
 ** Check for a collision between two capsule shapes.
 */
-bool capsule_vs_capsule(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool capsule_vs_capsule(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 /*
 ** Check for a collision between two axis-aligned bounding boxes.
 */
-bool aabb_vs_aabb(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool aabb_vs_aabb(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 /*
 ** Check for a collision between two oriented bounding boxes.
 */
-bool separating_axis_test(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool separating_axis_test(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
+
+/*
+** Room a contact patch function needs for its points. It returns at most four.
+*/
+const int k_max_patch_points = 8;
+
+/*
+** Find every point where two boxes touch. Boxes meeting face to face clip
+** one face to the other, and edges crossing touch at one point.
+** @returns The number of points, none if the boxes are apart.
+*/
+int oobb_vs_oobb_patch(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* points);
+
+/*
+** Find every corner of a box below a plane.
+** @returns The number of points, none if the box is above the plane.
+*/
+int oobb_vs_plane_patch(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* points);
 
 /*
-** Check for a collision between two arbitrary convex hulls.
+** Check for a collision between any two convex shapes: spheres, boxes and
+** convex hulls. GJK finds the closest points of the shapes, and when they
+** overlap, EPA finds how deeply.
 */
-bool gjk(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+bool gjk(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
@@ -51,7 +51,7 @@ void st_intersection_unit_tests()
 		sphere_b._center = { 0.0f, 0.0f, 0.0f };
 		sphere_b._radius = 3.0f;
 
-		st_mat4f trans_a, trans_b;
+		st_affine3f trans_a, trans_b;
 		trans_a.make_translation({ 4.0f, 0.0f, 0.0f });
 		trans_b.make_identity();
 
@@ -59,11 +59,41 @@ void st_intersection_unit_tests()
 		bool collision = sphere_vs_sphere(&sphere_a, trans_a, &sphere_b, trans_b, &info);
 		assert(collision);
 
+		// The normal points from a to b, and the point sits midway through the overlap.
+		assert(info._normal.equal({ -1.0f, 0.0f, 0.0f }));
+		assert(st_equalf(info._penetration, 2.0f));
+		assert(info._point.equal({ 2.0f, 0.0f, 0.0f }));
+
 		trans_b.translate({ 0.0f, 5.0f, 0.0f });
 		collision = sphere_vs_sphere(&sphere_a, trans_a, &sphere_b, trans_b, &info);
 		assert(!collision);
 	}
 
+	// Test sphere to plane contacts from either side of the pair.
+	{
+		st_sphere sphere;
+		sphere._center = { 0.0f, 0.0f, 0.0f };
+		sphere._radius = 1.0f;
+		st_plane plane;
+		plane._point = { 0.0f, 0.0f, 0.0f };
+		plane._normal = st_vec3f::y_vector();
+
+		st_affine3f trans_sphere, trans_plane;
+		trans_sphere.make_translation({ 0.0f, 0.5f, 0.0f });
+		trans_plane.make_identity();
+
+		st_collision_info info;
+		bool collision = sphere_vs_plane(&sphere, trans_sphere, &plane, trans_plane, &info);
+		assert(collision);
+		assert(info._normal.equal({ 0.0f, -1.0f, 0.0f }));
+		assert(st_equalf(info._penetration, 0.5f));
+		assert(info._point.equal({ 0.0f, -0.25f, 0.0f }));
+
+		collision = sphere_vs_plane(&plane, trans_plane, &sphere, trans_sphere, &info);
+		assert(collision);
+		assert(info._normal.equal({ 0.0f, 1.0f, 0.0f }));
+	}
+
 	// Now test AABB collisions.
 	{
 		st_aabb aabb_a, aabb_b;
@@ -72,7 +102,7 @@ void st_intersection_unit_tests()
 		aabb_b._min = { -2.0f, -2.0f, -2.0f };
 		aabb_b._max = { 2.0f, 2.0f, 2.0f };
 
-		st_mat4f trans_a, trans_b;
+		st_affine3f trans_a, trans_b;
 		trans_a.make_identity();
 		trans_b.make_translation({ 1.0f, 1.5f, 0.5f });
 
@@ -97,13 +127,16 @@ void st_intersection_unit_tests()
 		oobb_b._half_vectors[1] = { 0.0f, 1.0f, 0.0f };
 		oobb_b._half_vectors[2] = { 0.0f, 0.0f, 1.0f };
 
-		st_mat4f trans_a, trans_b;
+		st_affine3f trans_a, trans_b;
 		trans_a.make_identity();
 		trans_b.make_translation({ -1.0f, 0.0f, 0.0f });
 
 		st_collision_info info;
 		bool collision = separating_axis_test(&oobb_a, trans_a, &oobb_b, trans_b, &info);
 		assert(collision);
+		assert(info._normal.dot({ -1.0f, 0.0f, 0.0f }) > 0.99f);
+		assert(st_equalf(info._normal.mag(), 1.0f));
+		assert(st_equalf(info._penetration, 0.6f));
 
 		st_quatf rotation_q;
 		rotation_q.make_axis_angle({ 0.0f, 0.0f, 1.0f }, st_degrees_to_radians(45.0f));
@@ -124,5 +157,54 @@ void st_intersection_unit_tests()
 		assert(!collision);
 	}
 
+	// Test OOBB contact patches.
+	{
+		st_oobb oobb;
+		oobb._center = { 0.0f, 0.0f, 0.0f };
+		oobb._half_vectors[0] = { 0.5f, 0.0f, 0.0f };
+		oobb._half_vectors[1] = { 0.0f, 0.5f, 0.0f };
+		oobb._half_vectors[2] = { 0.0f, 0.0f, 0.5f };
+
+		st_plane plane;
+		plane._point = { 0.0f, 0.0f, 0.0f };
+		plane._normal = { 0.0f, 1.0f, 0.0f };
+
+		// A box resting flat on another touches it across the whole face, not at its center.
+		st_affine3f trans_a, trans_b;
+		trans_a.make_identity();
+		trans_b.make_translation({ 0.2f, 0.99f, 0.0f });
+
+		st_collision_info points[k_max_patch_points];
+		int count = oobb_vs_oobb_patch(&oobb, trans_a, &oobb, trans_b, points);
+		assert(count == 4);
+		for (int i = 0; i < count; ++i)
+		{
+			assert(points[i]._normal.equal({ 0.0f, 1.0f, 0.0f }));
+			assert(st_equalf(points[i]._penetration, 0.01f));
+			assert(st_equalf(points[i]._point.y, 0.495f));
+			assert(points[i]._point.x > -0.31f && points[i]._point.x < 0.51f);
+		}
+
+		// Turned about the normal, the overlap is an octagon, cut down to four of its corners.
+		st_quatf rotation_q;
+		rotation_q.make_axis_angle({ 0.0f, 1.0f, 0.0f }, st_degrees_to_radians(30.0f));
+		trans_b.make_rotation(rotation_q);
+		trans_b.set_translation({ 0.0f, 0.99f, 0.0f });
+		count = oobb_vs_oobb_patch(&oobb, trans_a, &oobb, trans_b, points);
+		assert(count == 4);
+
+		trans_b.make_translation({ 0.0f, 1.5f, 0.0f });
+		assert(oobb_vs_oobb_patch(&oobb, trans_a, &oobb, trans_b, points) == 0);
+
+		// A box tipped onto an edge touches a plane along that edge.
+		rotation_q.make_axis_angle({ 0.0f, 0.0f, 1.0f }, st_degrees_to_radians(45.0f));
+		trans_a.make_rotation(rotation_q);
+		trans_a.set_translation({ 0.0f, 0.7f, 0.0f });
+		trans_b.make_identity();
+		count = oobb_vs_plane_patch(&oobb, trans_a, &plane, trans_b, points);
+		assert(count == 2);
+		assert(points[0]._normal.equal({ 0.0f, -1.0f, 0.0f }));
+	}
+
 	// TODO: Test GJK for convex hull collisions.
 }
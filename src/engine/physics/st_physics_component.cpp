@@ -15,6 +15,7 @@ st_physics_component::st_physics_component(st_entity* ent, st_shape* shape, floa
 {
 	_body = new st_rigid_body(shape, mass);
 	_body->_transform = ent->get_transform();
+	_body->update_world_inertia();
 }
 
 st_physics_component::~st_physics_component()
@@ -24,8 +25,18 @@ st_physics_component::~st_physics_component()
 
 void st_physics_component::update(st_frame_params* params)
 {
-	// First, re-sync the rigid body's transform with the entity's.
-	_body->_transform = get_entity()->get_transform();
+	/*
+	** First, re-sync the rigid body's transform with the entity's. Only an
+	** entity moved since late_update differs, and a moved body is woken, so
+	** the world refreshes its bounds and finds what it now touches.
+	*/
+	const st_affine3f& transform = get_entity()->get_transform();
+	if (!transform.equal(_body->_transform))
+	{
+		_body->_transform = transform;
+		_body->update_world_inertia();
+		_body->wake();
+	}
 
 #if st_PHYSICS_DEBUG_DRAW
 	st_dynamic_drawcall draw;
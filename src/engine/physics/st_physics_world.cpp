@@ -11,33 +11,63 @@
 
 #include "framework/st_frame_params.h"
 #include "graphics/st_drawcall.h"
+#include "jobs/st_job.h"
+#include "math/st_math.h"
 
 #include <algorithm>
 #include <assert.h>
-#include <ctime>
+#include <cfloat>
 
-typedef bool (*intersection_func_t)(const st_shape* a, const st_mat4f& transform_a, const st_shape* b, const st_mat4f& transform_b, st_collision_info* info);
+typedef bool (*intersection_func_t)(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* info);
 
 static intersection_func_t k_dispatch_table[k_shape_count][k_shape_count];
 
+/*
+** Pairs that can rest face to face give every point of the patch at once.
+** A manifold builds up a patch from the single points above as the bodies
+** rock, but a face lying flat reports the same point each step, and stands
+** on it as on a pin.
+*/
+typedef int (*contact_patch_func_t)(const st_shape* a, const st_affine3f& transform_a, const st_shape* b, const st_affine3f& transform_b, st_collision_info* points);
+static contact_patch_func_t k_patch_table[k_shape_count][k_shape_count];
+
 st_physics_world::st_physics_world()
 {
-	// Clear the dispatch table.
+	// Any two convex shapes can be tested with GJK, and any convex shape against a plane through its deepest point.
 	for (int i = 0; i < k_shape_count; ++i)
 	{
 		for (int j = 0; j < k_shape_count; ++j)
 		{
-			k_dispatch_table[i][j] = intersection_unimplemented;
+			bool is_plane_i = i == k_shape_plane;
+			bool is_plane_j = j == k_shape_plane;
+			if (is_plane_i && is_plane_j)
+			{
+				k_dispatch_table[i][j] = plane_vs_plane;
+			}
+			else if (is_plane_i || is_plane_j)
+			{
+				k_dispatch_table[i][j] = convex_vs_plane;
+			}
+			else
+			{
+				k_dispatch_table[i][j] = gjk;
+			}
 		}
 	}
 
+	// Pairs with a dedicated test use it instead, as it is faster or gives a better contact.
 	k_dispatch_table[k_shape_sphere][k_shape_sphere] = sphere_vs_sphere;
+	k_dispatch_table[k_shape_aabb][k_shape_aabb] = aabb_vs_aabb;
 	k_dispatch_table[k_shape_oobb][k_shape_oobb] = separating_axis_test;
 	k_dispatch_table[k_shape_plane][k_shape_oobb] = oobb_vs_plane;
 	k_dispatch_table[k_shape_oobb][k_shape_plane] = oobb_vs_plane;
 	k_dispatch_table[k_shape_plane][k_shape_sphere] = sphere_vs_plane;
 	k_dispatch_table[k_shape_sphere][k_shape_plane] = sphere_vs_plane;
 
+	k_patch_table[k_shape_oobb][k_shape_oobb] = oobb_vs_oobb_patch;
+	k_patch_table[k_shape_plane][k_shape_oobb] = oobb_vs_plane_patch;
+	k_patch_table[k_shape_oobb][k_shape_plane] = oobb_vs_plane_patch;
+
 	// Default gravity to Earth's constant.
 	_gravity = { 0.0f, -9.807f, 0.0f };
 }
@@ -51,6 +81,7 @@ void st_physics_world::add_rigid_body(st_rigid_body* body)
 {
 	while (_bodies_lock.test_and_set(std::memory_order_acquire)) {}
 	_bodies.push_back(body);
+	add_proxy(body);
 	_bodies_lock.clear(std::memory_order_release);
 }
 
@@ -58,213 +89,443 @@ void st_physics_world::remove_rigid_body(st_rigid_body* body)
 {
 	while (_bodies_lock.test_and_set(std::memory_order_acquire)) {}
 	_bodies.erase(std::remove(_bodies.begin(), _bodies.end(), body));
+	remove_contacts(body->_proxy);
+	_broadphase.remove_proxy(body->_proxy);
+	body->_proxy = st_broadphase::k_null_proxy;
 	_bodies_lock.clear(std::memory_order_release);
 }
 
+void st_physics_world::set_sleep_thresholds(float linear_velocity, float angular_velocity)
+{
+	_sleep_linear_velocity2 = linear_velocity * linear_velocity;
+	_sleep_angular_velocity2 = angular_velocity * angular_velocity;
+}
+
+void st_physics_world::add_proxy(st_rigid_body* body)
+{
+	st_aabb3f bounds;
+	bool is_bounded = body->_shape->get_bounds(body->_transform, bounds);
+	body->_proxy = _broadphase.add_proxy(is_bounded ? &bounds : nullptr, (body->_flags & k_static) != 0, body);
+}
+
 void st_physics_world::step(st_frame_params* params)
 {
 	while (_bodies_lock.test_and_set(std::memory_order_acquire)) {}
 
-	// Step the physics sim.
-	for (int i = 0; i < _bodies.size(); ++i)
-	{
-		if (_bodies[i]->_flags & k_static) continue;
+	float dt = std::chrono::duration_cast<std::chrono::duration<float>>(params->_delta_time).count();
+
+	// We should not attempt to resolve collisions if we're paused and have not single stepped.
+	bool should_resolve = params->_delta_time > std::chrono::milliseconds(0) || params->_single_step;
 
-		st_rigid_body* body = _bodies[i];
+	// Find contacts where the bodies are now.
+	update_broadphase(dt);
+	test_intersections();
+	build_islands();
 
-		if ((_bodies[i]->_flags & k_weightless) == 0)
+	// Step the physics sim. Bodies integrate independently of one another.
+	st_job::parallel_for(
+		0,
+		int(_bodies.size()),
+		k_integration_grain,
+		[this, dt](int begin, int end)
 		{
-			body->_forces.push_back(_gravity);
-		}
+			for (int i = begin; i < end; ++i)
+			{
+				if (is_inactive(_bodies[i])) continue;
 
-		step_linear_dynamics(params, body);
-		step_angular_dynamics(params, body);
+				st_rigid_body* body = _bodies[i];
+
+				if ((_bodies[i]->_flags & k_weightless) == 0)
+				{
+					body->_forces.push_back(_gravity);
+				}
+
+				integrate_velocities(dt, body);
+			}
+		},
+		st_job_priority_critical);
+
+	// Contacts change the velocities before the bodies move, so they never move apart into each other.
+	if (should_resolve)
+	{
+		_solver.prepare(_manifolds.data(), _touching.data(), int(_touching.size()), dt);
+		_solver.solve_velocities();
+	}
+
+	st_job::parallel_for(
+		0,
+		int(_bodies.size()),
+		k_integration_grain,
+		[this, dt](int begin, int end)
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				if (is_inactive(_bodies[i])) continue;
+
+				integrate_positions(dt, _bodies[i]);
+			}
+		},
+		st_job_priority_critical);
+
+	if (should_resolve)
+	{
+		_solver.solve_positions();
 	}
 
-	test_intersections(params);
+	update_sleep(dt);
+
+#if defined(st_PHYSICS_DEBUG_DRAW)
+	draw_contacts(params);
+#endif
 
 	_bodies_lock.clear(std::memory_order_release);
 }
 
-void st_physics_world::test_intersections(st_frame_params* params)
+void st_physics_world::update_broadphase(float dt)
 {
-	// Intersection tests. Naive N^2 comparisons.
-	for (int i = 0; i < _bodies.size(); ++i)
+	for (st_rigid_body* body : _bodies)
 	{
-		for (int j = i + 1; j < _bodies.size(); ++j)
+		// Bodies made static or dynamic since the last step change trees.
+		bool is_static = (body->_flags & k_static) != 0;
+		if (is_static != _broadphase.is_static(body->_proxy))
 		{
-			st_shape* shape_a = _bodies[i]->_shape;
-			st_shape* shape_b = _bodies[j]->_shape;
-			intersection_func_t func = k_dispatch_table[shape_a->get_type()][shape_b->get_type()];
-
-			st_collision_info info;
-			bool collision = func(shape_a, _bodies[i]->_transform, shape_b, _bodies[j]->_transform, &info);
-			if (collision)
-			{
-				std::time_t time = std::chrono::system_clock::to_time_t(
-					std::chrono::system_clock::now());
+			remove_contacts(body->_proxy);
+			_broadphase.remove_proxy(body->_proxy);
+			add_proxy(body);
+			continue;
+		}
 
-#if defined(st_PHYSICS_DEBUG_DRAW)
-				st_dynamic_drawcall collision_draw;
-				collision_draw._positions.push_back(st_vec3f::zero_vector());
-				collision_draw._positions.push_back(info._normal);
-				collision_draw._indices.push_back(0);
-				collision_draw._indices.push_back(1);
-				collision_draw._color = { 1.0f, 1.0f, 0.0f };
-				collision_draw._draw_mode = st_primitive_topology_lines;
-				collision_draw._material = nullptr;
-				collision_draw._transform.make_translation(info._point);
-
-				while (params->_dynamic_drawcall_lock.test_and_set(std::memory_order_acquire)) {}
-				params->_dynamic_drawcalls.push_back(collision_draw);
-				params->_dynamic_drawcall_lock.clear(std::memory_order_release);
-#endif
-				// We should not attempt to resolve collisions if we're paused and have not single stepped.
-				bool should_resolve = params->_delta_time > std::chrono::milliseconds(0) || params->_single_step;
+		if (body->_is_sleeping) continue;
 
-				if (should_resolve)
-				{
-					resolve_collision(_bodies[i], _bodies[j], &info);
-				}
-			}
+		st_aabb3f bounds;
+		if (body->_shape->get_bounds(body->_transform, bounds))
+		{
+			_broadphase.move_proxy(body->_proxy, bounds, body->_velocity.scale_result(dt));
 		}
 	}
 }
 
-void st_physics_world::step_linear_dynamics(st_frame_params* params, st_rigid_body* body)
+void st_physics_world::test_intersections()
 {
-	// Linear dynamics.
-	st_vec3f overall_force = st_vec3f::zero_vector();
-	while (body->_forces.size() > 0)
+	std::swap(_pairs, _previous_pairs);
+	std::swap(_manifolds, _previous_manifolds);
+	_broadphase.find_pairs(_pairs);
+
+	// Both lists of pairs are sorted, so the manifolds of pairs that still overlap are found in one pass.
+	_manifolds.resize(_pairs.size());
+	size_t previous = 0;
+	for (size_t i = 0; i < _pairs.size(); ++i)
 	{
-		overall_force += body->_forces.back();
-		body->_forces.pop_back();
-	}
+		while (previous < _previous_pairs.size() && _previous_pairs[previous] < _pairs[i])
+		{
+			++previous;
+		}
 
-	// Integrate using 4th order Runge-Kutta numerical integration.
-	float dt = std::chrono::duration_cast<std::chrono::duration<float>>(params->_delta_time).count();
-	st_vec3f position = body->_transform.get_translation();
-	st_vec3f p1 = position;
-	st_vec3f v1 = body->_velocity;
+		if (previous < _previous_pairs.size() && !(_pairs[i] < _previous_pairs[previous]))
+		{
+			_manifolds[i] = _previous_manifolds[previous];
+		}
+		else
+		{
+			_manifolds[i] = st_contact_manifold();
+			_manifolds[i]._body_a = static_cast<st_rigid_body*>(_broadphase.get_user_data(_pairs[i]._a));
+			_manifolds[i]._body_b = static_cast<st_rigid_body*>(_broadphase.get_user_data(_pairs[i]._b));
+		}
+	}
 
-	st_vec3f p2 = position + v1.scale_result(0.5f * dt);
-	st_vec3f v2 = body->_velocity + overall_force.scale_result(0.5f * dt);
+	/*
+	** Narrowphase for each pair whose bounds overlap. Each pair only touches
+	** its own manifold, so pairs are split across the workers, and each
+	** thread notes the manifolds left touching in its own buffer.
+	*/
+	_thread_contacts.resize(st_job::get_thread_count());
+	for (st_physics_contact_buffer& buffer : _thread_contacts)
+	{
+		buffer._touching.clear();
+	}
 
-	st_vec3f p3 = position + v2.scale_result(0.5f * dt);
-	st_vec3f v3 = body->_velocity + overall_force.scale_result(0.5f * dt);
+	st_job::parallel_for(
+		0,
+		int(_pairs.size()),
+		k_narrowphase_grain,
+		[this](int begin, int end)
+		{
+			std::vector<int32_t>& touching = _thread_contacts[st_job::get_thread_index()]._touching;
+			for (int i = begin; i < end; ++i)
+			{
+				st_contact_manifold& manifold = _manifolds[i];
+				st_rigid_body* body_a = manifold._body_a;
+				st_rigid_body* body_b = manifold._body_b;
 
-	st_vec3f p4 = position + v3.scale_result(dt);
-	st_vec3f v4 = body->_velocity + overall_force.scale_result(dt);
+				// A pair that has not moved since its manifold was updated keeps it as it is.
+				if (!is_inactive(body_a) || !is_inactive(body_b))
+				{
+					manifold.refresh(body_a->_transform, body_b->_transform);
+
+					st_shape* shape_a = body_a->_shape;
+					st_shape* shape_b = body_b->_shape;
+					contact_patch_func_t patch = k_patch_table[shape_a->get_type()][shape_b->get_type()];
+					if (patch)
+					{
+						st_collision_info points[k_max_patch_points];
+						int point_count = patch(shape_a, body_a->_transform, shape_b, body_b->_transform, points);
+						for (int p = 0; p < point_count; ++p)
+						{
+							manifold.add_point(points[p], body_a->_transform, body_b->_transform);
+						}
+					}
+					else
+					{
+						intersection_func_t func = k_dispatch_table[shape_a->get_type()][shape_b->get_type()];
+
+						st_collision_info info;
+						if (func(shape_a, body_a->_transform, shape_b, body_b->_transform, &info))
+						{
+							manifold.add_point(info, body_a->_transform, body_b->_transform);
+						}
+					}
+				}
 
-	st_vec3f new_position = position + (v1 + v2.scale_result(2.0f) + v3.scale_result(2.0f) + v4).scale_result(dt / 6.0f);
-	st_vec3f new_velocity = body->_velocity + (overall_force.scale_result(6.0f)).scale_result(dt / 6.0f);
+				if (manifold._point_count > 0)
+				{
+					touching.push_back(i);
+				}
+			}
+		},
+		st_job_priority_critical);
 
-	body->_velocity = new_velocity;
-	body->_transform.set_translation(new_position);
+	gather_contacts();
 }
 
-void st_physics_world::step_angular_dynamics(st_frame_params* params, st_rigid_body* body)
+void st_physics_world::gather_contacts()
 {
-	// Save the translation.
-	st_vec3f translation = body->_transform.get_translation();
-
-	// Angular dynamics.
-	st_vec3f overall_torque = st_vec3f::zero_vector();
-	while (body->_torques.size() > 0)
+	_touching.clear();
+	for (const st_physics_contact_buffer& buffer : _thread_contacts)
 	{
-		overall_torque += body->_torques.back();
-		body->_torques.pop_back();
+		_touching.insert(_touching.end(), buffer._touching.begin(), buffer._touching.end());
 	}
-	
-	float dt = std::chrono::duration_cast<std::chrono::duration<float>>(params->_delta_time).count();
-	body->_angular_momentum += overall_torque.scale_result(dt);
-	st_mat4f inertia_tensor_inv = body->_inertia_tensor;
-	inertia_tensor_inv.invert();
-	body->_angular_velocity = inertia_tensor_inv.transform_vector(body->_angular_momentum);
-	st_quatf ang_velocity = { body->_angular_velocity.x, body->_angular_velocity.y, body->_angular_velocity.z, 0.0f };
-	body->_orientation += (ang_velocity * body->_orientation).scale_result(0.5f * dt);
-	body->_orientation.normalize();
 
-	// Assemble the new transform.
-	body->_transform.make_rotation(body->_orientation);
+	/*
+	** Which thread tests which pair changes from run to run. The pairs are
+	** sorted, so sorting the manifolds by pair gives the order a single
+	** thread would have found them in.
+	*/
+	if (_deterministic)
+	{
+		std::sort(_touching.begin(), _touching.end());
+	}
+}
 
-	// Restore the translation.
-	body->_transform.set_translation(translation);
+bool st_physics_world::is_inactive(const st_rigid_body* body)
+{
+	return body->_is_sleeping || (body->_flags & k_static) != 0;
 }
 
-void st_physics_world::resolve_collision(st_rigid_body* body_a, st_rigid_body* body_b, st_collision_info* info)
+void st_physics_world::build_islands()
 {
-	// Calculate the velocities of A and B at the point of collision.
-	st_vec3f r_ap = body_a->_shape->get_offset_to_point(body_a->_transform, info->_point);
-	st_vec3f r_bp = body_b->_shape->get_offset_to_point(body_b->_transform, info->_point);
-
-	st_vec3f angular_velocity_a = st_vec3f_cross(body_a->_angular_velocity, r_ap);
-	st_vec3f angular_velocity_b = st_vec3f_cross(body_b->_angular_velocity, r_bp);
-
-	st_vec3f velocity_a = body_a->_velocity + angular_velocity_a;
-	st_vec3f velocity_b = body_b->_velocity + angular_velocity_b;
-	
-	// First move the objects so they no longer intersect.
-	// Each object will be moved proportionally to their incoming velocities.
-	// If an object is static, it won't be moved.
-	float total_velocity = velocity_a.mag() + velocity_b.mag();
-	float percentage_a = (body_a->_flags & k_static) ? 0.0f : velocity_a.mag() / total_velocity;
-	float percentage_b = (body_b->_flags & k_static) ? 0.0f : velocity_b.mag() / total_velocity;
-
-	if ((body_a->_flags & k_static) == 0 && velocity_a.mag2() > 0.0f)
+	int32_t proxy_count = _broadphase.get_proxy_capacity();
+	_island_parents.resize(proxy_count);
+	for (int32_t proxy = 0; proxy < proxy_count; ++proxy)
 	{
-		float pen_a = info->_penetration * percentage_a + 0.001f;
-		body_a->_transform.set_translation(body_a->_transform.get_translation() - velocity_a.normal().scale_result(pen_a));
+		_island_parents[proxy] = proxy;
 	}
-	if ((body_b->_flags & k_static) == 0 && velocity_b.mag2() > 0.0f)
+
+	// Static bodies hold up any number of islands without joining them together.
+	for (int32_t index : _touching)
 	{
-		float pen_b = info->_penetration * percentage_b + 0.001f;
-		body_b->_transform.set_translation(body_b->_transform.get_translation() - velocity_b.normal().scale_result(pen_b));
+		const st_contact_manifold& manifold = _manifolds[index];
+		if ((manifold._body_a->_flags & k_static) || (manifold._body_b->_flags & k_static))
+		{
+			continue;
+		}
+
+		int32_t island_a = find_island(manifold._body_a->_proxy);
+		int32_t island_b = find_island(manifold._body_b->_proxy);
+		if (island_a != island_b)
+		{
+			_island_parents[st_max(island_a, island_b)] = st_min(island_a, island_b);
+		}
 	}
 
-	// Average the coefficients of restitution.
-	float cor_average = (body_a->_coefficient_of_restitution + body_b->_coefficient_of_restitution) / 2.0f;
-	float one_over_mass_a = 1.0f / body_a->_mass;
-	float one_over_mass_b = 1.0f / body_b->_mass;
+	/*
+	** A body awake in an island wakes the rest of it, as it may be about to
+	** push them. This is how sleeping bodies wake on contact, since their
+	** manifolds with the awake body have joined them to its island.
+	*/
+	_island_awake.assign(proxy_count, 0);
+	for (st_rigid_body* body : _bodies)
+	{
+		if (body->_flags & k_static) continue;
+
+		if (body->_is_sleeping && !_sleeping_enabled)
+		{
+			body->wake();
+		}
+
+		if (!body->_is_sleeping)
+		{
+			_island_awake[find_island(body->_proxy)] = 1;
+		}
+	}
 
-	// Now, calculate impulse j.
-	float j = 0.0f;
-	if (body_a->_flags & k_static)
+	for (st_rigid_body* body : _bodies)
 	{
-		float numerator = -velocity_b.dot(info->_normal) * (1 + cor_average);
-		float denominator = one_over_mass_b + st_vec3f_cross(body_b->_inertia_tensor.inverse().transform_vector(st_vec3f_cross(r_bp, info->_normal)), r_bp).dot(info->_normal);
-		j = numerator / denominator;
+		if (body->_is_sleeping && _island_awake[find_island(body->_proxy)])
+		{
+			body->wake();
+		}
 	}
-	else if (body_b->_flags & k_static)
+
+	// The solver only needs the contacts that can move.
+	_touching.erase(
+		std::remove_if(
+			_touching.begin(),
+			_touching.end(),
+			[this](int32_t index)
+			{
+				return is_inactive(_manifolds[index]._body_a) && is_inactive(_manifolds[index]._body_b);
+			}),
+		_touching.end());
+}
+
+int32_t st_physics_world::find_island(int32_t proxy)
+{
+	// Point each node on the way at its grandparent, so later finds take fewer hops.
+	while (_island_parents[proxy] != proxy)
 	{
-		float numerator = -velocity_a.dot(info->_normal) * (1 + cor_average);
-		float denominator = one_over_mass_a + st_vec3f_cross(body_a->_inertia_tensor.inverse().transform_vector(st_vec3f_cross(r_ap, info->_normal)), r_ap).dot(info->_normal);
-		j = numerator / denominator;
+		_island_parents[proxy] = _island_parents[_island_parents[proxy]];
+		proxy = _island_parents[proxy];
 	}
-	else
+	return proxy;
+}
+
+void st_physics_world::update_sleep(float dt)
+{
+	_island_sleep_times.assign(_island_parents.size(), FLT_MAX);
+	for (st_rigid_body* body : _bodies)
 	{
-		st_vec3f a_ang_denom = body_a->_inertia_tensor.inverse().transform_vector(st_vec3f_cross(r_ap, info->_normal));
-		a_ang_denom = st_vec3f_cross(a_ang_denom, r_ap);
-		st_vec3f b_ang_denom = body_b->_inertia_tensor.inverse().transform_vector(st_vec3f_cross(r_bp, info->_normal));
-		b_ang_denom = st_vec3f_cross(b_ang_denom, r_bp);
+		if (is_inactive(body)) continue;
 
-		float denominator = one_over_mass_a + one_over_mass_b + info->_normal.dot(a_ang_denom + b_ang_denom);
-		float numerator = (1 + cor_average) * (velocity_b.dot(info->_normal) - velocity_a.dot(info->_normal));
+		bool is_resting =
+			body->_velocity.mag2() < _sleep_linear_velocity2 &&
+			body->_angular_velocity.mag2() < _sleep_angular_velocity2;
+		body->_sleep_time = is_resting ? body->_sleep_time + dt : 0.0f;
 
-		j = numerator / denominator;
+		float& island_sleep_time = _island_sleep_times[find_island(body->_proxy)];
+		island_sleep_time = st_min(island_sleep_time, body->_sleep_time);
 	}
 
-	st_vec3f impulse = info->_normal.scale_result(j);
+	_active_body_count = 0;
+	_sleeping_body_count = 0;
+	for (st_rigid_body* body : _bodies)
+	{
+		if (body->_flags & k_static) continue;
 
-	if ((body_a->_flags & k_static) == 0)
+		if (!body->_is_sleeping && _sleeping_enabled && _island_sleep_times[find_island(body->_proxy)] >= k_time_to_sleep)
+		{
+			body->_is_sleeping = true;
+			body->_velocity = st_vec3f::zero_vector();
+			body->_angular_momentum = st_vec3f::zero_vector();
+			body->_angular_velocity = st_vec3f::zero_vector();
+		}
+
+		if (body->_is_sleeping)
+		{
+			++_sleeping_body_count;
+		}
+		else
+		{
+			++_active_body_count;
+		}
+	}
+}
+
+void st_physics_world::remove_contacts(int32_t proxy)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < _pairs.size(); ++i)
+	{
+		if (_pairs[i]._a != proxy && _pairs[i]._b != proxy)
+		{
+			_pairs[count] = _pairs[i];
+			_manifolds[count] = _manifolds[i];
+			++count;
+		}
+		else if (_manifolds[i]._point_count > 0)
+		{
+			_manifolds[i]._body_a->wake();
+			_manifolds[i]._body_b->wake();
+		}
+	}
+	_pairs.resize(count);
+	_manifolds.resize(count);
+
+	// The solver reads the touching list until the next step rebuilds it.
+	_touching.clear();
+}
+
+void st_physics_world::draw_contacts(st_frame_params* params)
+{
+	for (int32_t index : _touching)
+	{
+		const st_contact_manifold& manifold = _manifolds[index];
+		for (int p = 0; p < manifold._point_count; ++p)
+		{
+			const st_collision_info& info = manifold._points[p]._info;
+
+			st_dynamic_drawcall collision_draw;
+			collision_draw._positions.push_back(st_vec3f::zero_vector());
+			collision_draw._positions.push_back(info._normal);
+			collision_draw._indices.push_back(0);
+			collision_draw._indices.push_back(1);
+			collision_draw._color = { 1.0f, 1.0f, 0.0f };
+			collision_draw._draw_mode = st_primitive_topology_lines;
+			collision_draw._material = nullptr;
+			collision_draw._transform.make_translation(info._point);
+
+			while (params->_dynamic_drawcall_lock.test_and_set(std::memory_order_acquire)) {}
+			params->_dynamic_drawcalls.push_back(collision_draw);
+			params->_dynamic_drawcall_lock.clear(std::memory_order_release);
+		}
+	}
+}
+
+void st_physics_world::integrate_velocities(float dt, st_rigid_body* body)
+{
+	// Linear dynamics.
+	st_vec3f overall_force = st_vec3f::zero_vector();
+	while (body->_forces.size() > 0)
 	{
-		body_a->_velocity += impulse.scale_result(1.0f / body_a->_mass);
-		body_a->_angular_momentum -= body_a->_inertia_tensor.inverse().transform_vector(st_vec3f_cross(impulse, r_ap));
+		overall_force += body->_forces.back();
+		body->_forces.pop_back();
 	}
+	body->_velocity += overall_force.scale_result(dt);
 
-	if ((body_b->_flags & k_static) == 0)
+	// Angular dynamics.
+	st_vec3f overall_torque = st_vec3f::zero_vector();
+	while (body->_torques.size() > 0)
 	{
-		body_b->_velocity -= impulse.scale_result(1.0f / body_b->_mass);
-		body_b->_angular_momentum += body_b->_inertia_tensor.inverse().transform_vector(st_vec3f_cross(impulse, r_bp));
+		overall_torque += body->_torques.back();
+		body->_torques.pop_back();
 	}
+	body->_angular_momentum += overall_torque.scale_result(dt);
+	body->_angular_velocity = body->_world_inverse_inertia_tensor.transform(body->_angular_momentum);
+}
+
+void st_physics_world::integrate_positions(float dt, st_rigid_body* body)
+{
+	/*
+	** Move with the velocities the solver left, rather than averaging over
+	** the step, so bodies resting on one another stay put.
+	*/
+	st_vec3f translation = body->_transform.get_translation() + body->_velocity.scale_result(dt);
+
+	st_quatf ang_velocity = { body->_angular_velocity.x, body->_angular_velocity.y, body->_angular_velocity.z, 0.0f };
+	body->_orientation += (ang_velocity * body->_orientation).scale_result(0.5f * dt);
+	body->_orientation.normalize_fast();
+
+	// Assemble the new transform.
+	body->_transform.make_rotation(body->_orientation);
+	body->_transform.set_translation(translation);
+	body->update_world_inertia();
 }
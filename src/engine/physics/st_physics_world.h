@@ -6,6 +6,10 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
+#include "st_broadphase.h"
+#include "st_contact_manifold.h"
+#include "st_contact_solver.h"
+
 #include "math/st_vec3f.h"
 
 #include <atomic>
@@ -13,7 +17,6 @@
 
 #define st_PHYSICS_DEBUG_DRAW 1
 
-struct st_collision_info;
 class st_rigid_body;
 struct st_frame_params;
 
@@ -32,16 +35,119 @@ public:
 
 	void step(st_frame_params* params);
 
+	/*
+	** When set, contacts are solved in the order of their pairs rather than
+	** the order the workers found them, so a step gives the same results bit
+	** for bit however many threads it runs on. On by default.
+	*/
+	void set_deterministic(bool deterministic) { _deterministic = deterministic; }
+	bool is_deterministic() const { return _deterministic; }
+
+	/*
+	** Iterations the contact solver makes over velocities and positions each step.
+	** More settle stacks sooner, at a cost per contact point.
+	*/
+	void set_velocity_iterations(int count) { _solver.set_velocity_iterations(count); }
+	void set_position_iterations(int count) { _solver.set_position_iterations(count); }
+
+	/*
+	** Bodies touching one another form islands. Once every body in an island
+	** has rested for a while, the island sleeps: its bodies skip integration,
+	** and the narrowphase skips their pairs with one another. Anything awake
+	** that touches a sleeping body wakes its whole island. On by default.
+	*/
+	void set_sleeping_enabled(bool enabled) { _sleeping_enabled = enabled; }
+	bool is_sleeping_enabled() const { return _sleeping_enabled; }
+
+	/*
+	** Speeds below which a body counts as resting, in meters and radians per second.
+	*/
+	void set_sleep_thresholds(float linear_velocity, float angular_velocity);
+
+	// Non-static bodies simulated and left sleeping by the last step.
+	int get_active_body_count() const { return _active_body_count; }
+	int get_sleeping_body_count() const { return _sleeping_body_count; }
+
 private:
+	// Bodies integrated per job.
+	static const int k_integration_grain = 64;
+	// Broadphase pairs tested per job.
+	static const int k_narrowphase_grain = 32;
+	// How long every body in an island must rest before it sleeps, in seconds.
+	static constexpr float k_time_to_sleep = 0.5f;
+
+	/*
+	** Manifolds found touching by one thread. Aligned so threads appending
+	** to neighboring buffers don't share a cache line.
+	*/
+	struct alignas(64) st_physics_contact_buffer
+	{
+		std::vector<int32_t> _touching;
+	};
+
 	std::vector<st_rigid_body*> _bodies;
 	std::atomic_flag _bodies_lock = ATOMIC_FLAG_INIT;
 
+	st_broadphase _broadphase;
+
+	// A manifold for each pair, kept from step to step while the pair overlaps.
+	std::vector<st_broadphase_pair> _pairs;
+	std::vector<st_contact_manifold> _manifolds;
+	std::vector<st_broadphase_pair> _previous_pairs;
+	std::vector<st_contact_manifold> _previous_manifolds;
+
+	std::vector<st_physics_contact_buffer> _thread_contacts;
+	std::vector<int32_t> _touching;
+	bool _deterministic = true;
+
+	st_contact_solver _solver;
+
+	// Islands as a forest over the proxies. Whether an island has a body awake, and its shortest rest, are kept at its root.
+	std::vector<int32_t> _island_parents;
+	std::vector<uint8_t> _island_awake;
+	std::vector<float> _island_sleep_times;
+
+	bool _sleeping_enabled = true;
+	float _sleep_linear_velocity2 = 0.05f * 0.05f;
+	float _sleep_angular_velocity2 = 0.05f * 0.05f;
+
+	int _active_body_count = 0;
+	int _sleeping_body_count = 0;
+
 	st_vec3f _gravity;
 
-	void step_linear_dynamics(st_frame_params* params, st_rigid_body* body);
-	void step_angular_dynamics(st_frame_params* params, st_rigid_body* body);
+	// Sleeping and static bodies don't move, so pairs of them need no narrowphase.
+	static bool is_inactive(const st_rigid_body* body);
+
+	void integrate_velocities(float dt, st_rigid_body* body);
+	void integrate_positions(float dt, st_rigid_body* body);
+
+	void add_proxy(st_rigid_body* body);
+	void update_broadphase(float dt);
+
+	void test_intersections();
+	void gather_contacts();
+
+	/*
+	** Join the bodies of touching manifolds into islands, wake every island
+	** with a body awake in it, and leave only the contacts of awake bodies
+	** for the solver.
+	*/
+	void build_islands();
+	int32_t find_island(int32_t proxy);
+
+	/*
+	** Time how long bodies have rested, and put islands that have rested
+	** long enough to sleep.
+	*/
+	void update_sleep(float dt);
 
-	void test_intersections(st_frame_params* params);
+	/*
+	** Drop the manifolds of a proxy before it is removed, so they don't pass
+	** to whichever body reuses it. Bodies it was touching are woken, as they
+	** may have been resting on it.
+	*/
+	void remove_contacts(int32_t proxy);
 
-	void resolve_collision(st_rigid_body* body_a, st_rigid_body* body_b, st_collision_info* info);
+	void draw_contacts(st_frame_params* params);
 };
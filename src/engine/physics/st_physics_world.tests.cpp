@@ -0,0 +1,316 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include "st_physics_world.tests.h"
+#include "st_physics_world.h"
+
+#include "st_physics_component.h"
+#include "st_rigid_body.h"
+#include "st_shape.h"
+
+#include "entity/st_entity.h"
+
+#include "framework/st_frame_params.h"
+
+#include "jobs/st_job.h"
+
+#include "math/st_math.h"
+#include "math/st_quatf.h"
+
+#include "system/st_cpu_topology.h"
+
+#include "core/st_test_random.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static void _st_physics_world_test_startup_jobs(int worker_count)
+{
+	const st_cpu_topology& topology = st_cpu_topology::get();
+	st_job_cpu_mask_t mask;
+	for (int i = 0; i < worker_count && i < topology.get_cpu_count(); ++i)
+	{
+		mask.set(topology.get_cpu(i)._id);
+	}
+	st_job::startup(mask, 1024, 256);
+}
+
+/*
+** A world of unit boxes and spheres over a ground plane.
+*/
+struct st_physics_world_test_scene_t
+{
+	st_physics_world _world;
+	st_plane _ground_shape;
+	st_oobb _box_shape;
+	st_sphere _sphere_shape;
+	std::vector<st_rigid_body*> _bodies;
+	st_frame_params _params;
+
+	st_physics_world_test_scene_t()
+	{
+		_ground_shape._point = st_vec3f::zero_vector();
+		_ground_shape._normal = st_vec3f::y_vector();
+		add(&_ground_shape, st_vec3f::zero_vector())->make_static();
+
+		_box_shape._center = st_vec3f::zero_vector();
+		_box_shape._half_vectors[0] = { 0.5f, 0.0f, 0.0f };
+		_box_shape._half_vectors[1] = { 0.0f, 0.5f, 0.0f };
+		_box_shape._half_vectors[2] = { 0.0f, 0.0f, 0.5f };
+
+		_sphere_shape._center = st_vec3f::zero_vector();
+		_sphere_shape._radius = 0.5f;
+
+		_params._delta_time = std::chrono::microseconds(16667);
+	}
+
+	~st_physics_world_test_scene_t()
+	{
+		for (st_rigid_body* body : _bodies)
+		{
+			_world.remove_rigid_body(body);
+			delete body;
+		}
+	}
+
+	st_rigid_body* add(st_shape* shape, const st_vec3f& position)
+	{
+		st_rigid_body* body = new st_rigid_body(shape, 1.0f);
+		body->set_translation(position);
+		_world.add_rigid_body(body);
+		_bodies.push_back(body);
+		return body;
+	}
+
+	void step(int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			_world.step(&_params);
+			_params._dynamic_drawcalls.clear();
+		}
+	}
+};
+
+/*
+** Transforms after dropping a pile of tumbling boxes and spheres, large
+** enough that both the narrowphase and integration split into several jobs.
+*/
+static std::vector<st_affine3f> _st_physics_world_test_pile(int worker_count)
+{
+	_st_physics_world_test_startup_jobs(worker_count);
+
+	std::vector<st_affine3f> transforms;
+	{
+		st_physics_world_test_scene_t scene;
+		scene._world.set_deterministic(true);
+
+		st_test_random random(0x2545f491);
+		const int k_side = 6;
+		for (int i = 0; i < k_side * k_side * 5; ++i)
+		{
+			const int layer = i / (k_side * k_side);
+			const int cell = i % (k_side * k_side);
+			st_vec3f position =
+			{
+				(cell % k_side) * 1.2f + random.next(-0.1f, 0.1f),
+				1.0f + layer * 1.2f,
+				(cell / k_side) * 1.2f + random.next(-0.1f, 0.1f),
+			};
+
+			st_rigid_body* body = scene.add((i & 1) ? (st_shape*)&scene._box_shape : &scene._sphere_shape, position);
+
+			st_vec3f axis = { random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f), random.next(-1.0f, 1.0f) };
+			axis.normalize();
+			st_quatf orientation;
+			orientation.make_axis_angle(axis, random.next(-1.0f, 1.0f));
+			body->set_orientation(orientation);
+		}
+
+		scene.step(90);
+
+		for (st_rigid_body* body : scene._bodies)
+		{
+			transforms.push_back(body->get_transform());
+		}
+	}
+
+	st_job::shutdown();
+	return transforms;
+}
+
+static void _st_physics_world_test_determinism()
+{
+	const std::vector<st_affine3f> expected = _st_physics_world_test_pile(1);
+
+	const int cpu_count = st_cpu_topology::get().get_cpu_count();
+	for (int worker_count = 2; worker_count <= cpu_count; worker_count *= 2)
+	{
+		const std::vector<st_affine3f> transforms = _st_physics_world_test_pile(worker_count);
+		assert(transforms.size() == expected.size());
+		assert(memcmp(transforms.data(), expected.data(), expected.size() * sizeof(st_affine3f)) == 0);
+	}
+}
+
+/*
+** A column of boxes comes to rest where it was stacked, without sinking,
+** sliding apart or toppling.
+*/
+static void _st_physics_world_test_stack()
+{
+	st_physics_world_test_scene_t scene;
+	scene._world.set_sleeping_enabled(false);
+
+	// Stacked a little untidily, so that any sliding shows up as drift.
+	st_test_random random(0x6c8e9cf5);
+	std::vector<st_vec3f> stacked;
+	const int k_box_count = 5;
+	for (int i = 0; i < k_box_count; ++i)
+	{
+		stacked.push_back({ random.next(-0.05f, 0.05f), 0.5f + i, random.next(-0.05f, 0.05f) });
+		st_rigid_body* body = scene.add(&scene._box_shape, stacked.back());
+
+		st_quatf orientation;
+		orientation.make_axis_angle(st_vec3f::y_vector(), random.next(-0.1f, 0.1f));
+		body->set_orientation(orientation);
+	}
+
+	// Five seconds.
+	scene.step(300);
+
+	std::vector<st_vec3f> settled;
+	for (int i = 0; i < k_box_count; ++i)
+	{
+		settled.push_back(scene._bodies[i + 1]->get_transform().get_translation());
+	}
+	scene.step(1);
+
+	for (int i = 0; i < k_box_count; ++i)
+	{
+		const st_affine3f& transform = scene._bodies[i + 1]->get_transform();
+		st_vec3f position = transform.get_translation();
+		st_vec3f drift = position - stacked[i];
+
+		// Each contact may sink by the solver's slop, and no more.
+		assert(st_absf(drift.y) < 0.01f * (i + 1));
+		assert(st_absf(drift.x) < 0.02f && st_absf(drift.z) < 0.02f);
+		assert(transform.get_linear().transform(st_vec3f::y_vector()).y > 0.999f);
+		assert((position - settled[i]).mag() < 1.0e-3f);
+	}
+}
+
+/*
+** An island sleeps once all of it has rested for the world's time to sleep,
+** half a second, while islands still moving stay awake. Anything touching
+** it or pushing it wakes the whole island.
+*/
+static void _st_physics_world_test_sleep()
+{
+	st_physics_world_test_scene_t scene;
+	const float dt = std::chrono::duration_cast<std::chrono::duration<float>>(scene._params._delta_time).count();
+	const float k_time_to_sleep = 0.5f;
+
+	st_rigid_body* bottom = scene.add(&scene._box_shape, { 0.0f, 0.5f, 0.0f });
+	st_rigid_body* top = scene.add(&scene._box_shape, { 0.0f, 1.5f, 0.0f });
+	st_rigid_body* falling = scene.add(&scene._sphere_shape, { 10.0f, 20.0f, 0.0f });
+
+	// Not yet rested long enough.
+	scene.step(int(0.8f * k_time_to_sleep / dt));
+	assert(!bottom->is_sleeping() && !top->is_sleeping());
+
+	scene.step(int(k_time_to_sleep / dt));
+	assert(bottom->is_sleeping() && top->is_sleeping());
+	assert(!falling->is_sleeping());
+	assert(scene._world.get_sleeping_body_count() == 2);
+	assert(scene._world.get_active_body_count() == 1);
+
+	// Sleeping bodies stay exactly where they are.
+	st_affine3f resting = top->get_transform();
+	scene.step(10);
+	assert(memcmp(&resting, &top->get_transform(), sizeof(resting)) == 0);
+
+	// A box dropped on top wakes both.
+	st_rigid_body* dropped = scene.add(&scene._box_shape, { 0.0f, 3.0f, 0.0f });
+	bool woken = false;
+	for (int i = 0; i < 60 && !woken; ++i)
+	{
+		scene.step(1);
+		woken = !bottom->is_sleeping() && !top->is_sleeping();
+	}
+	assert(woken);
+
+	scene.step(int(4.0f * k_time_to_sleep / dt));
+	assert(bottom->is_sleeping() && top->is_sleeping() && dropped->is_sleeping());
+
+	// A push on the top box wakes the boxes under it too.
+	top->add_force({ 50.0f, 0.0f, 0.0f });
+	assert(!top->is_sleeping());
+	scene.step(1);
+	assert(!top->is_sleeping() && !bottom->is_sleeping() && !dropped->is_sleeping());
+}
+
+/*
+** A sleeping body moved by its entity wakes, and falls onto what it was moved over.
+*/
+static void _st_physics_world_test_moved_while_sleeping()
+{
+	st_physics_world_test_scene_t scene;
+	st_rigid_body* base = scene.add(&scene._box_shape, { 0.0f, 0.5f, 0.0f });
+
+	st_entity entity;
+	entity.translate({ 5.0f, 0.5f, 0.0f });
+	st_physics_component* component = new st_physics_component(&entity, &scene._box_shape, 1.0f);
+	entity.add_component(std::unique_ptr<st_component>(component));
+	st_rigid_body* moved = component->get_rigid_body();
+	scene._world.add_rigid_body(moved);
+
+	// Steps as the frame runs them, the entity passing its transform to the body and back.
+	auto step = [&](int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			entity.update(&scene._params);
+			scene.step(1);
+			entity.late_update(&scene._params);
+		}
+	};
+
+	// Round trips between the entity and the body alone don't keep the body awake.
+	step(60);
+	assert(base->is_sleeping() && moved->is_sleeping());
+
+	// Lift it over the base, a little above it.
+	entity.translate({ -5.0f, 1.2f, 0.0f });
+	step(1);
+	assert(!moved->is_sleeping());
+
+	bool base_woken = false;
+	for (int i = 0; i < 30; ++i)
+	{
+		step(1);
+		base_woken = base_woken || !base->is_sleeping();
+	}
+	assert(base_woken);
+
+	// Resting on the base, not fallen through it.
+	assert(st_absf(moved->get_transform().get_translation().y - 1.5f) < 0.02f);
+
+	scene._world.remove_rigid_body(moved);
+}
+
+void st_physics_world_unit_tests()
+{
+	_st_physics_world_test_determinism();
+
+	_st_physics_world_test_startup_jobs(st_cpu_topology::get().get_cpu_count());
+	_st_physics_world_test_stack();
+	_st_physics_world_test_sleep();
+	_st_physics_world_test_moved_while_sleeping();
+	st_job::shutdown();
+}
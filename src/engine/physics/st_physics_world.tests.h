@@ -0,0 +1,12 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+/*
+** Starts and stops the job system itself, so must be called while it is not running.
+*/
+void st_physics_world_unit_tests();
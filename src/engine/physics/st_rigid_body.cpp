@@ -12,7 +12,14 @@ st_rigid_body::st_rigid_body(st_shape* shape, float mass) : _mass(mass), _shape(
 	_transform.make_identity();
 	_orientation.make_axis_angle(st_vec3f::y_vector(), 0);
 
+	// Shapes without an implementation leave the tensor untouched.
+	_inertia_tensor.make_identity();
 	_shape->get_inertia_tensor(_inertia_tensor, _mass);
+
+	// The body space tensor is constant, so invert it once up front.
+	_inverse_inertia_tensor = _inertia_tensor;
+	_inverse_inertia_tensor.invert();
+	update_world_inertia();
 }
 
 st_rigid_body::~st_rigid_body()
@@ -36,10 +43,74 @@ void st_rigid_body::make_weightless()
 
 void st_rigid_body::add_linear_velocity(const st_vec3f& v)
 {
+	wake();
 	_velocity += v;
 }
 
 void st_rigid_body::add_angular_momentum(const st_vec3f& v)
 {
+	wake();
 	_angular_momentum += v;
 }
+
+void st_rigid_body::add_force(const st_vec3f& force)
+{
+	wake();
+	_forces.push_back(force);
+}
+
+void st_rigid_body::add_torque(const st_vec3f& torque)
+{
+	wake();
+	_torques.push_back(torque);
+}
+
+void st_rigid_body::set_translation(const st_vec3f& translation)
+{
+	wake();
+	_transform.set_translation(translation);
+}
+
+void st_rigid_body::set_orientation(const st_quatf& orientation)
+{
+	wake();
+	st_vec3f translation = _transform.get_translation();
+	_orientation = orientation;
+	_transform.make_rotation(_orientation);
+	_transform.set_translation(translation);
+	update_world_inertia();
+}
+
+void st_rigid_body::update_world_inertia()
+{
+	st_mat3f rotation = _transform.get_linear();
+
+	st_mat3f rotated;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			rotated.data[i][j] =
+				rotation.data[i][0] * _inverse_inertia_tensor.data[0][j] +
+				rotation.data[i][1] * _inverse_inertia_tensor.data[1][j] +
+				rotation.data[i][2] * _inverse_inertia_tensor.data[2][j];
+		}
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			_world_inverse_inertia_tensor.data[i][j] =
+				rotated.data[i][0] * rotation.data[j][0] +
+				rotated.data[i][1] * rotation.data[j][1] +
+				rotated.data[i][2] * rotation.data[j][2];
+		}
+	}
+}
+
+void st_rigid_body::wake()
+{
+	_is_sleeping = false;
+	_sleep_time = 0.0f;
+}
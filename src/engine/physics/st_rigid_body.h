@@ -6,7 +6,8 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "math/st_mat4f.h"
+#include "math/st_affine3f.h"
+#include "math/st_mat3f.h"
 #include "math/st_vec3f.h"
 
 #include <cstdint>
@@ -33,24 +34,48 @@ public:
 	void make_static();
 	void make_weightless();
 
+	// Each of these wakes the body if it is sleeping.
 	void add_linear_velocity(const st_vec3f& v);
 	void add_angular_momentum(const st_vec3f& v);
+	void add_force(const st_vec3f& force);
+	void add_torque(const st_vec3f& torque);
+
+	void set_translation(const st_vec3f& translation);
+	void set_orientation(const st_quatf& orientation);
+	const st_affine3f& get_transform() const { return _transform; }
+
+	/*
+	** Sleeping bodies are left out of the simulation until something touches
+	** them or moves them. The world puts bodies to sleep once they come to rest.
+	*/
+	bool is_sleeping() const { return _is_sleeping; }
+	void wake();
 
 private:
-	st_mat4f _transform;
+	/*
+	** Rotate the inverse inertia tensor into world space. Must be called
+	** whenever the orientation changes.
+	*/
+	void update_world_inertia();
+
+	st_affine3f _transform;
 	st_quatf _orientation = { 0.0f, 0.0f, 0.0f, 0.0f };
 
 	st_vec3f _angular_momentum = st_vec3f::zero_vector();
 	st_vec3f _angular_velocity = st_vec3f::zero_vector();
 	st_vec3f _velocity = st_vec3f::zero_vector();
 
-	st_mat4f _inertia_tensor;
+	st_mat3f _inertia_tensor;
+	st_mat3f _inverse_inertia_tensor;
+	// R I^-1 R^T for the current orientation, for world space momentum and impulses.
+	st_mat3f _world_inverse_inertia_tensor;
 
 	float _mass;
 
-	// Ordinarily this would live in a collision material structure.
-	// We just include the value here for simplicity.
+	// Ordinarily these would live in a collision material structure.
+	// We just include the values here for simplicity.
 	float _coefficient_of_restitution = 0.5f;
+	float _coefficient_of_friction = 0.5f;
 
 	struct st_shape* _shape;
 
@@ -59,6 +84,14 @@ private:
 
 	uint32_t _flags;
 
+	// Broadphase proxy, while the body is in a world.
+	int32_t _proxy = -1;
+
+	// How long the body has been resting, in seconds.
+	float _sleep_time = 0.0f;
+	bool _is_sleeping = false;
+
+	friend class st_contact_solver;
 	friend class st_physics_world;
 	friend class st_physics_component;
 };
@@ -10,9 +10,10 @@
 #include <graphics/st_drawcall.h>
 #include <math/st_math.h>
 
+#include <cassert>
 #include <vector>
 
-void st_plane::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* drawcall)
+void st_plane::get_debug_draw(const st_affine3f& transform, st_dynamic_drawcall* drawcall)
 {
 	st_vec3f position = transform.get_translation() + _point;
 
@@ -52,38 +53,49 @@ void st_plane::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* dr
 
 	drawcall->_color = { 0.2f, 0.2f, 0.2f };
 	drawcall->_draw_mode = st_primitive_topology_triangles;
-	drawcall->_transform = transform;
+	drawcall->_transform = transform.to_mat4f();
 	drawcall->_material = nullptr;
 }
 
-void st_plane::get_inertia_tensor(st_mat4f& tensor, float mass)
+void st_plane::get_inertia_tensor(st_mat3f& tensor, float mass)
 {
 	// Unimplemented.
 }
 
-st_vec3f st_plane::get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const
+st_vec3f st_plane::get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const
 {
 	// Unimplemented.
 	return st_vec3f::zero_vector();
 }
 
-void st_sphere::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* drawcall)
+bool st_plane::get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const
 {
-	draw_debug_sphere(_radius, transform, drawcall);
+	return false;
 }
 
-void st_sphere::get_inertia_tensor(st_mat4f& tensor, float mass)
+void st_sphere::get_debug_draw(const st_affine3f& transform, st_dynamic_drawcall* drawcall)
+{
+	draw_debug_sphere(_radius, transform.to_mat4f(), drawcall);
+}
+
+void st_sphere::get_inertia_tensor(st_mat3f& tensor, float mass)
 {
 	// Unimplemented.
 }
 
-st_vec3f st_sphere::get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const
+st_vec3f st_sphere::get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const
 {
 	st_vec3f center = transform.transform_point(_center);
 	return point - center;
 }
 
-void st_aabb::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* drawcall)
+bool st_sphere::get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const
+{
+	bounds.make_from_center(_center + transform.get_translation(), st_vec3f::splat(_radius));
+	return true;
+}
+
+void st_aabb::get_debug_draw(const st_affine3f& transform, st_dynamic_drawcall* drawcall)
 {
 	drawcall->_positions.push_back({ _min.x, _min.y, _min.z });
 	drawcall->_positions.push_back({ _min.x, _min.y, _max.z });
@@ -122,22 +134,29 @@ void st_aabb::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* dra
 
 	drawcall->_color = { 0.0f, 1.0f, 0.0f };
 	drawcall->_draw_mode = st_primitive_topology_lines;
-	drawcall->_transform = transform;
+	drawcall->_transform = transform.to_mat4f();
 	drawcall->_material = nullptr;
 }
 
-void st_aabb::get_inertia_tensor(st_mat4f& tensor, float mass)
+void st_aabb::get_inertia_tensor(st_mat3f& tensor, float mass)
 {
 	// Unimplemented.
 }
 
-st_vec3f st_aabb::get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const
+st_vec3f st_aabb::get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const
 {
 	st_vec3f center = (_min + _max).scale_result(0.5f);
 	center = transform.transform_point(center);
 	return point - center;
 }
 
+bool st_aabb::get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const
+{
+	bounds.min = _min + transform.get_translation();
+	bounds.max = _max + transform.get_translation();
+	return true;
+}
+
 void st_oobb::get_corners(std::vector<st_vec3f>& corners) const
 {
 	st_vec3f x_hvec = _half_vectors[0];
@@ -154,7 +173,7 @@ void st_oobb::get_corners(std::vector<st_vec3f>& corners) const
 	corners.push_back(_center + x_hvec + y_hvec + z_hvec);
 }
 
-void st_oobb::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* drawcall)
+void st_oobb::get_debug_draw(const st_affine3f& transform, st_dynamic_drawcall* drawcall)
 {
 	get_corners(drawcall->_positions);
 	drawcall->_positions.push_back(st_vec3f::zero_vector());
@@ -188,11 +207,11 @@ void st_oobb::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* dra
 
 	drawcall->_color = { 0.0f, 1.0f, 0.0f };
 	drawcall->_draw_mode = st_primitive_topology_lines;
-	drawcall->_transform = transform;
+	drawcall->_transform = transform.to_mat4f();
 	drawcall->_material = nullptr;
 }
 
-void st_oobb::get_inertia_tensor(st_mat4f& tensor, float mass)
+void st_oobb::get_inertia_tensor(st_mat3f& tensor, float mass)
 {
 	float one_over_twelve = 1.0f / 12.0f;
 	float width2 = st_powf(_half_vectors[0].mag() * 2, 2);
@@ -205,24 +224,57 @@ void st_oobb::get_inertia_tensor(st_mat4f& tensor, float mass)
 	tensor.data[2][2] = one_over_twelve * mass * (width2 + height2);
 }
 
-st_vec3f st_oobb::get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const
+st_vec3f st_oobb::get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const
 {
 	st_vec3f center = transform.transform_point(_center);
 	return point - center;
 }
 
-void st_convex_hull::get_debug_draw(const st_mat4f& transform, st_dynamic_drawcall* drawcall)
+bool st_oobb::get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const
+{
+	// Each half vector reaches out along every axis by its absolute components.
+	st_vec3f extents = st_vec3f::zero_vector();
+	for (int i = 0; i < 3; ++i)
+	{
+		st_vec3f half_vector = transform.transform_vector(_half_vectors[i]);
+		extents += st_vec3f{ st_absf(half_vector.x), st_absf(half_vector.y), st_absf(half_vector.z) };
+	}
+
+	bounds.make_from_center(_center + transform.get_translation(), extents);
+	return true;
+}
+
+void st_convex_hull::get_debug_draw(const st_affine3f& transform, st_dynamic_drawcall* drawcall)
 {
 	// TODO
 }
 
-void st_convex_hull::get_inertia_tensor(st_mat4f& tensor, float mass)
+void st_convex_hull::get_inertia_tensor(st_mat3f& tensor, float mass)
 {
 	// Unimplemented.
 }
 
-st_vec3f st_convex_hull::get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const
+st_vec3f st_convex_hull::get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const
 {
-	// Unimplemented.
-	return st_vec3f::zero_vector();
+	// Without a mass distribution, the origin of the hull's space stands in for its center of mass.
+	return point - transform.get_translation();
+}
+
+bool st_convex_hull::get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const
+{
+	bounds.make_from_points(_positions.data(), int(_positions.size()));
+	bounds = bounds.transform(transform);
+	return true;
+}
+
+void st_convex_hull::set_positions(const std::vector<st_vec3f>& positions)
+{
+	_positions = positions;
+	_support_positions.from_aos(_positions);
+}
+
+st_vec3f st_convex_hull::get_support(const st_vec3f& direction) const
+{
+	assert(!_positions.empty());
+	return _positions[st_vec3f_soa_farthest(_support_positions, direction)];
 }
@@ -6,8 +6,10 @@
 ** This file is distributed under the MIT License. See LICENSE.txt.
 */
 
-#include "math/st_mat4f.h"
+#include "math/st_aabb3f.h"
+#include "math/st_affine3f.h"
 #include "math/st_vec3f.h"
+#include "math/st_vec3f_soa.h"
 
 #include <cstdint>
 #include <vector>
@@ -47,17 +49,23 @@ struct st_shape
 	/*
 	** Fills out a debug draw call with the geometry of the collision shape.
 	*/
-	virtual void get_debug_draw(const st_mat4f& transform, struct st_dynamic_drawcall* drawcall) = 0;
+	virtual void get_debug_draw(const st_affine3f& transform, struct st_dynamic_drawcall* drawcall) = 0;
 
 	/*
 	** Fills out the inertia tensor matrix for the shape, given the mass.
 	*/
-	virtual void get_inertia_tensor(st_mat4f& tensor, float mass) = 0;
+	virtual void get_inertia_tensor(st_mat3f& tensor, float mass) = 0;
 
 	/*
 	** Returns the vector from the center of mass to the point in space.
 	*/
-	virtual st_vec3f get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const = 0;
+	virtual st_vec3f get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const = 0;
+
+	/*
+	** Computes the world space bounds of the shape, placed as the intersection tests place it.
+	** Returns false for unbounded shapes, such as planes.
+	*/
+	virtual bool get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const = 0;
 };
 
 /*
@@ -69,9 +77,10 @@ struct st_plane final : st_shape
 	st_vec3f _normal;
 
 	st_shape_t get_type() const override { return k_shape_plane; }
-	void get_debug_draw(const st_mat4f& transform, struct st_dynamic_drawcall* drawcall) override;
-	void get_inertia_tensor(st_mat4f& tensor, float mass) override;
-	st_vec3f get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const override;
+	void get_debug_draw(const st_affine3f& transform, struct st_dynamic_drawcall* drawcall) override;
+	void get_inertia_tensor(st_mat3f& tensor, float mass) override;
+	st_vec3f get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const override;
+	bool get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const override;
 };
 
 /*
@@ -83,9 +92,10 @@ struct st_sphere final : st_shape
 	float _radius;
 
 	st_shape_t get_type() const override { return k_shape_sphere; }
-	void get_debug_draw(const st_mat4f& transform, struct st_dynamic_drawcall* drawcall) override;
-	void get_inertia_tensor(st_mat4f& tensor, float mass) override;
-	st_vec3f get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const override;
+	void get_debug_draw(const st_affine3f& transform, struct st_dynamic_drawcall* drawcall) override;
+	void get_inertia_tensor(st_mat3f& tensor, float mass) override;
+	st_vec3f get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const override;
+	bool get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const override;
 };
 
 /*
@@ -97,9 +107,10 @@ struct st_aabb final : st_shape
 	st_vec3f _max;
 
 	st_shape_t get_type() const override { return k_shape_aabb; }
-	void get_debug_draw(const st_mat4f& transform, struct st_dynamic_drawcall* drawcall) override;
-	void get_inertia_tensor(st_mat4f& tensor, float mass) override;
-	st_vec3f get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const override;
+	void get_debug_draw(const st_affine3f& transform, struct st_dynamic_drawcall* drawcall) override;
+	void get_inertia_tensor(st_mat3f& tensor, float mass) override;
+	st_vec3f get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const override;
+	bool get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const override;
 };
 
 /*
@@ -112,9 +123,10 @@ struct st_oobb final : st_shape
 	st_vec3f _half_vectors[3];
 
 	st_shape_t get_type() const override { return k_shape_oobb; }
-	void get_debug_draw(const st_mat4f& transform, struct st_dynamic_drawcall* drawcall) override;
-	void get_inertia_tensor(st_mat4f& tensor, float mass) override;
-	st_vec3f get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const override;
+	void get_debug_draw(const st_affine3f& transform, struct st_dynamic_drawcall* drawcall) override;
+	void get_inertia_tensor(st_mat3f& tensor, float mass) override;
+	st_vec3f get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const override;
+	bool get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const override;
 
 	void get_corners(std::vector<st_vec3f>& corners) const;
 };
@@ -124,10 +136,23 @@ struct st_oobb final : st_shape
 */
 struct st_convex_hull final : st_shape
 {
+	st_shape_t get_type() const override { return k_shape_convex_hull; }
+	void get_debug_draw(const st_affine3f& transform, struct st_dynamic_drawcall* drawcall) override;
+	void get_inertia_tensor(st_mat3f& tensor, float mass) override;
+	st_vec3f get_offset_to_point(const st_affine3f& transform, const st_vec3f& point) const override;
+	bool get_bounds(const st_affine3f& transform, st_aabb3f& bounds) const override;
+
+	void set_positions(const std::vector<st_vec3f>& positions);
+	const std::vector<st_vec3f>& get_positions() const { return _positions; }
+
+	/*
+	** Returns the point of the hull farthest along a direction in the hull's own space.
+	*/
+	st_vec3f get_support(const st_vec3f& direction) const;
+
+private:
 	std::vector<st_vec3f> _positions;
 
-	st_shape_t get_type() const override { return k_shape_convex_hull; }
-	void get_debug_draw(const st_mat4f& transform, struct st_dynamic_drawcall* drawcall) override;
-	void get_inertia_tensor(st_mat4f& tensor, float mass) override;
-	st_vec3f get_offset_to_point(const st_mat4f& transform, const st_vec3f& point) const override;
+	// The positions again, laid out for SIMD support searches.
+	st_vec3f_soa _support_positions;
 };
@@ -0,0 +1,296 @@
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <system/st_cpu_topology.h>
+
+#include <framework/st_compiler_defines.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <thread>
+#include <utility>
+
+#if defined(ST_WINDOWS)
+#include <Windows.h>
+#elif defined(ST_LINUX)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+const st_cpu_topology& st_cpu_topology::get()
+{
+	static st_cpu_topology topology;
+	return topology;
+}
+
+st_cpu_topology::st_cpu_topology()
+{
+	discover();
+
+	/* Without OS support, assume one core per hardware thread on a single node. */
+	if (_cpus.empty())
+	{
+		int count = std::max(int(std::thread::hardware_concurrency()), 1);
+		for (int i = 0; i < count; ++i)
+		{
+			_cpus.push_back({ i, i, 0, 0, 0 });
+		}
+	}
+
+	finalize();
+}
+
+const st_cpu_info_t* st_cpu_topology::find_cpu(int id) const
+{
+	for (auto& cpu : _cpus)
+	{
+		if (cpu._id == id)
+		{
+			return &cpu;
+		}
+	}
+	return nullptr;
+}
+
+void st_cpu_topology::finalize()
+{
+	/*
+	** Discovery fills _core with an id only unique within its package. Renumber
+	** cores densely across packages, and number hardware threads within each.
+	*/
+	std::sort(_cpus.begin(), _cpus.end(), [](const st_cpu_info_t& a, const st_cpu_info_t& b)
+	{
+		return a._id < b._id;
+	});
+
+	std::map<std::pair<int, int>, int> cores;
+	std::map<int, int> packages;
+	std::map<int, int> nodes;
+	std::vector<int> threads_per_core;
+	for (auto& cpu : _cpus)
+	{
+		auto core = cores.emplace(std::make_pair(cpu._package, cpu._core), int(cores.size()));
+		cpu._core = core.first->second;
+		if (core.second)
+		{
+			threads_per_core.push_back(0);
+		}
+		cpu._smt_index = threads_per_core[cpu._core]++;
+
+		packages.emplace(cpu._package, int(packages.size()));
+		nodes.emplace(cpu._numa_node, int(nodes.size()));
+	}
+
+	_core_count = int(cores.size());
+	_package_count = int(packages.size());
+	_numa_node_count = int(nodes.size());
+
+	/* Keep processors that share a node together. */
+	std::stable_sort(_cpus.begin(), _cpus.end(), [](const st_cpu_info_t& a, const st_cpu_info_t& b)
+	{
+		return a._numa_node < b._numa_node;
+	});
+}
+
+#if defined(ST_WINDOWS)
+
+void st_cpu_topology::discover()
+{
+	DWORD length = 0;
+	GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+	{
+		return;
+	}
+
+	std::vector<char> buffer(length);
+	if (!GetLogicalProcessorInformationEx(
+		RelationAll,
+		reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()),
+		&length))
+	{
+		return;
+	}
+
+	/* Processor ids combine the processor group and the bit within the group's mask. */
+	std::map<int, st_cpu_info_t> cpus;
+	auto for_each_cpu = [](const GROUP_AFFINITY& affinity, auto func)
+	{
+		for (int bit = 0; bit < 64; ++bit)
+		{
+			if (affinity.Mask & (KAFFINITY(1) << bit))
+			{
+				func(int(affinity.Group) * 64 + bit);
+			}
+		}
+	};
+
+	int core_index = 0;
+	int package_index = 0;
+	for (DWORD offset = 0; offset < length;)
+	{
+		auto info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+		switch (info->Relationship)
+		{
+		case RelationProcessorCore:
+			for (WORD g = 0; g < info->Processor.GroupCount; ++g)
+			{
+				for_each_cpu(info->Processor.GroupMask[g], [&](int id)
+				{
+					st_cpu_info_t& cpu = cpus[id];
+					cpu._id = id;
+					cpu._core = core_index;
+				});
+			}
+			core_index++;
+			break;
+		case RelationProcessorPackage:
+			for (WORD g = 0; g < info->Processor.GroupCount; ++g)
+			{
+				for_each_cpu(info->Processor.GroupMask[g], [&](int id)
+				{
+					cpus[id]._package = package_index;
+				});
+			}
+			package_index++;
+			break;
+		case RelationNumaNode:
+			for_each_cpu(info->NumaNode.GroupMask, [&](int id)
+			{
+				cpus[id]._numa_node = int(info->NumaNode.NodeNumber);
+			});
+			break;
+		default:
+			break;
+		}
+		offset += info->Size;
+	}
+
+	/* Only keep processors this process may run on. Affinity masks are per group. */
+	DWORD_PTR process_mask = 0;
+	DWORD_PTR system_mask = 0;
+	GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask);
+
+	for (auto& entry : cpus)
+	{
+		st_cpu_info_t cpu = entry.second;
+		bool in_group_zero = cpu._id < 64;
+		if (!in_group_zero || (process_mask & (DWORD_PTR(1) << cpu._id)))
+		{
+			_cpus.push_back(cpu);
+		}
+	}
+}
+
+bool st_cpu_topology::pin_current_thread(int id)
+{
+	GROUP_AFFINITY affinity = {};
+	affinity.Group = WORD(id / 64);
+	affinity.Mask = KAFFINITY(1) << (id % 64);
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+}
+
+#elif defined(ST_LINUX)
+
+static int _st_cpu_read_int(const char* path, int fallback)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+	{
+		return fallback;
+	}
+
+	int value;
+	if (fscanf(file, "%d", &value) != 1)
+	{
+		value = fallback;
+	}
+	fclose(file);
+	return value;
+}
+
+static int _st_cpu_read_node(int id)
+{
+	/* Each processor's sysfs directory links to its node as "nodeN". */
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", id);
+
+	DIR* dir = opendir(path);
+	if (!dir)
+	{
+		return 0;
+	}
+
+	int node = 0;
+	while (dirent* entry = readdir(dir))
+	{
+		if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+		{
+			node = atoi(entry->d_name + 4);
+			break;
+		}
+	}
+	closedir(dir);
+	return node;
+}
+
+void st_cpu_topology::discover()
+{
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+	{
+		return;
+	}
+
+	for (int id = 0; id < CPU_SETSIZE; ++id)
+	{
+		if (!CPU_ISSET(id, &allowed))
+		{
+			continue;
+		}
+
+		char path[128];
+		st_cpu_info_t cpu;
+		cpu._id = id;
+		cpu._smt_index = 0;
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", id);
+		cpu._core = _st_cpu_read_int(path, id);
+
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", id);
+		cpu._package = _st_cpu_read_int(path, 0);
+
+		cpu._numa_node = _st_cpu_read_node(id);
+
+		_cpus.push_back(cpu);
+	}
+}
+
+bool st_cpu_topology::pin_current_thread(int id)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(id, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#else
+
+void st_cpu_topology::discover()
+{
+}
+
+bool st_cpu_topology::pin_current_thread(int id)
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+** Stratos Rendering Engine
+**
+** This file is distributed under the MIT License. See LICENSE.txt.
+*/
+
+#include <vector>
+
+/*
+** A logical processor, i.e. one hardware thread.
+*/
+struct st_cpu_info_t
+{
+	// Operating system's number for the processor, as used for affinity.
+	int _id;
+
+	// Physical core, numbered from zero across all packages.
+	int _core;
+	int _package;
+	int _numa_node;
+
+	// Position among the hardware threads sharing the core. Zero for the first.
+	int _smt_index;
+};
+
+/*
+** The logical processors available to this process and how they share cores,
+** packages and NUMA nodes. Discovered once, on first use.
+*/
+class st_cpu_topology
+{
+public:
+	static const st_cpu_topology& get();
+
+	/*
+	** Processors are ordered by NUMA node, then by id.
+	*/
+	int get_cpu_count() const { return int(_cpus.size()); }
+	const st_cpu_info_t& get_cpu(int index) const { return _cpus[index]; }
+
+	/*
+	** Returns nullptr if the processor isn't available to this process.
+	*/
+	const st_cpu_info_t* find_cpu(int id) const;
+
+	int get_core_count() const { return _core_count; }
+	int get_package_count() const { return _package_count; }
+	int get_numa_node_count() const { return _numa_node_count; }
+
+	/*
+	** Restrict the calling thread to a single logical processor.
+	*/
+	static bool pin_current_thread(int id);
+
+private:
+	st_cpu_topology();
+
+	void discover();
+	void finalize();
+
+	std::vector<st_cpu_info_t> _cpus;
+
+	int _core_count = 0;
+	int _package_count = 0;
+	int _numa_node_count = 0;
+};